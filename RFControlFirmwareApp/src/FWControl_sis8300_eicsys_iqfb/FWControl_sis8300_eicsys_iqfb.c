@@ -26,8 +26,407 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include "FWControl_sis8300_eicsys_iqfb.h"
+#include "FWControl_sis8300_eicsys_iqfb_upLink.h"
+
+/*======================================
+ * Private Data and Routines 
+ *======================================*/   
+/**
+ * Get the features of an RF waveform, the id is in the order of RFCFW_CONST_FEAT_CH_*
+ */
+static RFCFW_struc_pulseFeature *FWC_sis8300_eicsys_iqfb_func_getFeature(FWC_sis8300_eicsys_iqfb_struc_data *arg, long id)
+{
+    switch(id) {
+        case 0:  return &arg -> feat_refCh;
+        case 1:  return &arg -> feat_fbkCh;
+        case 2:  return &arg -> feat_tracked;
+        case 3:  return &arg -> feat_err;
+        case 4:  return &arg -> feat_act;
+        case 5:  return &arg -> feat_DACOut;
+        default: return NULL;
+    }
+}
+
+/**
+ * Get the mask bit of an RF waveform, 0 for illegal id
+ */
+static long FWC_sis8300_eicsys_iqfb_func_getFeatureMask(long id)
+{
+    return (id >= 0 && id < 6) ? (1 << id) : 0;
+}
+
+/**
+ * Calculate the per-pulse scalar features for the selected RF waveforms, return the mask of the waveforms with valid features
+ */
+static long FWC_sis8300_eicsys_iqfb_func_calcFeatures(FWC_sis8300_eicsys_iqfb_struc_data *arg, long pno, long chMask)
+{
+    int  i;
+    long var_validMask = 0;
+
+    RFLIB_struc_RFWaveform *wf[6] = {&arg -> rfData_refCh,  &arg -> rfData_fbkCh,
+                                     &arg -> rfData_tracked, &arg -> rfData_err,
+                                     &arg -> rfData_act,     &arg -> rfData_DACOut};
+
+    for(i = 0; i < 6; i ++) {
+        if((chMask & (1 << i)) && 
+           RFCFW_func_calcPulseFeature(wf[i] -> wfI, wf[i] -> wfQ, pno, wf[i] -> sampleFreq_MHz, wf[i] -> sampleDelay_ns,
+                                       arg -> feat_winStart_ns, arg -> feat_winEnd_ns, FWC_sis8300_eicsys_iqfb_func_getFeature(arg, i)) == 0)
+            var_validMask |= (1 << i);
+    }
+
+    return var_validMask;
+}
+
+/**
+ * Write the parameters to the firmware
+ * Input:
+ *   arg        : Data of the module
+ *   mask       : Parameters to write, see the _CONST_PARAM_*
+ */
+static void FWC_sis8300_eicsys_iqfb_func_writeParamToFw(FWC_sis8300_eicsys_iqfb_struc_data *arg, unsigned long mask)
+{
+    if(!arg -> board_handle) return;
+
+    if(mask & FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_GAIN) {
+        FWC_sis8300_eicsys_iqfb_func_setGain_I(arg -> board_handle, arg -> board_gainI * arg -> board_fbEnable);
+        FWC_sis8300_eicsys_iqfb_func_setGain_Q(arg -> board_handle, arg -> board_gainQ * arg -> board_fbEnable);
+    }
+
+    if(mask & FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_FF) {
+        FWC_sis8300_eicsys_iqfb_func_setFeedforward_I(arg -> board_handle, arg -> board_feedforwardI_MV, arg -> board_voltageFactor_perMV);
+        FWC_sis8300_eicsys_iqfb_func_setFeedforward_Q(arg -> board_handle, arg -> board_feedforwardQ_MV, arg -> board_voltageFactor_perMV);
+    }
+
+    if(mask & FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_IQ_CORR) {
+        FWC_sis8300_eicsys_iqfb_func_setImbalanceCorrMatrix(arg -> board_handle, arg -> board_imbalanceMatrixA11, 
+                                                            arg -> board_imbalanceMatrixA12, 
+                                                            arg -> board_imbalanceMatrixA21, 
+                                                            arg -> board_imbalanceMatrixA22);
+    }
+
+    if(mask & FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_ROT) {
+        FWC_sis8300_eicsys_iqfb_func_setFbkVectorRotation(arg -> board_handle, arg -> board_fbkRotationGain, arg -> board_fbkRotationAngle_deg);
+        FWC_sis8300_eicsys_iqfb_func_setActVectorRotation(arg -> board_handle, arg -> board_actRotationGain, arg -> board_actRotationAngle_deg);
+    }
+}
+
+/**
+ * Write the parameters to the firmware immediately, or mark them as pending if the staged commit is enabled, so that
+ *   the parameters belong together (e.g. the gains of I/Q) can not be seen half-updated by a pulse
+ * Input:
+ *   arg        : Data of the module
+ *   mask       : Parameters to write, see the _CONST_PARAM_*
+ */
+void FWC_sis8300_eicsys_iqfb_func_writeParam(FWC_sis8300_eicsys_iqfb_struc_data *arg, unsigned long mask)
+{
+    if(!arg) return;
+
+    if(arg -> stage_enable && arg -> stage_mutex) {
+        epicsMutexLock(arg -> stage_mutex);
+        arg -> stage_pending |= mask;
+        epicsMutexUnlock(arg -> stage_mutex);
+    } else {
+        FWC_sis8300_eicsys_iqfb_func_writeParamToFw(arg, mask);
+    }
+}
+
+/**
+ * Commit all staged parameters, called right after the interrupt so that they are written together in the gap 
+ *   between two pulses
+ * Input:
+ *   arg        : Data of the module
+ */
+static void FWC_sis8300_eicsys_iqfb_func_commitParam(FWC_sis8300_eicsys_iqfb_struc_data *arg)
+{
+    unsigned long var_mask;
+    double var_startTime_us;
+
+    if(!arg -> stage_mutex) return;
+
+    epicsMutexLock(arg -> stage_mutex);
+    var_mask             = arg -> stage_pending;
+    arg -> stage_pending = 0;
+    epicsMutexUnlock(arg -> stage_mutex);
+
+    if(!var_mask) return;
+
+    var_startTime_us = RFCFW_func_getTime_us();
+
+    FWC_sis8300_eicsys_iqfb_func_writeParamToFw(arg, var_mask);
+
+    RFCFW_func_timeStatsUpdate(&arg -> stage_commitTime, RFCFW_func_getTime_us() - var_startTime_us, arg -> pfb_budget_us);
+}
+
+/**
+ * Apply the phase and amplitude adjustment to: 1). measurement chain rotation; 2). driving chain rotation. 
+ *   Only the settings are changed, the caller writes both rotations to the firmware together (PARAM_ROT)
+ * Input:
+ *   arg        : Data of the module
+ *   pha_deg    : Phase change in degree
+ *   ampRatio   : Relative change of the amplitude (1.0 for no change)
+ */
+static void FWC_sis8300_eicsys_iqfb_func_applyRotation(FWC_sis8300_eicsys_iqfb_struc_data *arg, double pha_deg, double ampRatio)
+{
+    double var_scale = arg -> board_ampScale * ampRatio;
+
+    if(var_scale < RFCFW_CONST_AMP_SCALE_MIN) var_scale = RFCFW_CONST_AMP_SCALE_MIN;
+    if(var_scale > RFCFW_CONST_AMP_SCALE_MAX) var_scale = RFCFW_CONST_AMP_SCALE_MAX;
+
+    arg -> board_fbkRotationAngle_deg -= pha_deg;
+    arg -> board_actRotationAngle_deg += pha_deg;
+
+    arg -> board_fbkRotationGain     *= arg -> board_ampScale / var_scale;      /* keep the calibrated feedback gain, only follow the relative change */
+    arg -> board_actRotationGain      = var_scale;
+    arg -> board_ampScale             = var_scale;
+}
+
+/**
+ * Run the pulse-to-pulse feedback with the features of this pulse, the corrections are applied with the vector rotations
+ * Input:
+ *   arg        : Data of the module
+ *   validMask  : Mask of the waveforms with valid features of this pulse
+ *   startTime  : Time (us) when the processing of this pulse started
+ */
+static void FWC_sis8300_eicsys_iqfb_func_runPulseFeedback(FWC_sis8300_eicsys_iqfb_struc_data *arg, long validMask, double startTime_us)
+{
+    double var_err;
+    double var_corrAmp;
+    double var_corrPha;
+    double var_time_us;
+
+    RFCFW_struc_pulseFeature *feat = FWC_sis8300_eicsys_iqfb_func_getFeature(arg, arg -> pfb_srcCh);
+
+    /* the measurement must be updated in this pulse */
+    if(!feat || !(validMask & FWC_sis8300_eicsys_iqfb_func_getFeatureMask(arg -> pfb_srcCh))) return;
+
+    /* amplitude error normalized to the set point */
+    var_err     = arg -> pfb_ampCtrl.sp > 0.0 ? (arg -> pfb_ampCtrl.sp - feat -> amp) / arg -> pfb_ampCtrl.sp : 0.0;
+    var_corrAmp = RFCFW_func_piCtrlUpdate(&arg -> pfb_ampCtrl, var_err);
+
+    /* phase error wrapped to [-180, 180) */
+    var_err     = arg -> pfb_phaCtrl.sp - feat -> pha_deg;
+    var_err    -= 360.0 * floor((var_err + 180.0) / 360.0);
+    var_corrPha = RFCFW_func_piCtrlUpdate(&arg -> pfb_phaCtrl, var_err);
+
+    /* apply the corrections */
+    if(!arg -> pfb_ampCtrl.enable && !arg -> pfb_phaCtrl.enable) return;
+
+    FWC_sis8300_eicsys_iqfb_func_applyRotation(arg, var_corrPha, 1.0 + var_corrAmp);
+    FWC_sis8300_eicsys_iqfb_func_writeParamToFw(arg, FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_ROT);                   /* already in the gap between pulses, no need to stage */
+
+    /* timing */
+    var_time_us = RFCFW_func_getTime_us();
+
+    RFCFW_func_timeStatsUpdate(&arg -> pfb_procTime, var_time_us - startTime_us, arg -> pfb_budget_us);
+
+    if(arg -> pfb_intrTime_us > 0.0)
+        RFCFW_func_timeStatsUpdate(&arg -> pfb_loopTime, var_time_us - arg -> pfb_intrTime_us, arg -> pfb_budget_us);
+}
+
+/**
+ * Run the iterative learning of the set point table with the error waveform of this pulse, and upload the changed
+ *   region of the table
+ * Input:
+ *   arg        : Data of the module
+ *   pno        : Point number of the error waveform
+ */
+static void FWC_sis8300_eicsys_iqfb_func_runILC(FWC_sis8300_eicsys_iqfb_struc_data *arg, long pno)
+{
+    long var_updStart;
+    long var_updPno;
+    double var_startTime_us;
+
+    if(RFCFW_func_ilcUpdate(&arg -> ilc, arg -> rfData_err.wfI, arg -> rfData_err.wfQ, pno, &var_updStart, &var_updPno) != 0 || var_updPno <= 0) return;
+
+    var_startTime_us = RFCFW_func_getTime_us();
+
+    if(arg -> board_tabMutex) epicsMutexMustLock(arg -> board_tabMutex);
+    FWC_sis8300_eicsys_iqfb_func_setIQSPTableRange(arg -> board_handle, (unsigned int)var_updStart, (unsigned int)var_updPno, arg -> ilc.tabUpI, arg -> ilc.tabUpQ);
+    if(arg -> board_tabMutex) epicsMutexUnlock(arg -> board_tabMutex);
+
+    RFCFW_func_timeStatsUpdate(&arg -> ilc.uploadTime, RFCFW_func_getTime_us() - var_startTime_us, arg -> pfb_budget_us);
+}
+
+/**
+ * Point number of the DAQ, the setpoint or the automatic one derived from the RF pulse length, the DAQ trigger delay and
+ *   the tail margin (rounded up to 16 points, granularity of the firmware). Checked every pulse, so that a change of the
+ *   timing is applied at the pulse boundary. The setpoint is not changed
+ * Input:
+ *   arg        : Data of the module
+ * Return:
+ *   Point number
+ */
+static long FWC_sis8300_eicsys_iqfb_func_getSamplePno(FWC_sis8300_eicsys_iqfb_struc_data *arg)
+{
+    long var_pnoMax;
+
+    if(!arg -> board_ADCAutoPno) return arg -> board_ADCSamplePno;
+
+    var_pnoMax = FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX;
+    if(var_pnoMax > RFLIB_CONST_WF_SIZE)                       var_pnoMax = RFLIB_CONST_WF_SIZE;
+    if(var_pnoMax > FWC_SIS8300_EICSYS_IQFB_CONST_DAQ_BANK_PNO) var_pnoMax = FWC_SIS8300_EICSYS_IQFB_CONST_DAQ_BANK_PNO;     /* fit in a ping-pong bank */
+
+    return RFCFW_func_roiWindowPno(arg -> board_RFPulseLength_ns, arg -> board_DAQTriggerDelay_ns, arg -> board_ADCTailMargin_ns,
+                                   arg -> board_sampleFreq_MHz, 16, var_pnoMax);
+}
+
+/* Wait for the interrupt of the board, for the wake-up */
+static int FWC_sis8300_eicsys_iqfb_func_pullIntr(void *boardHandle)
+{
+    return FWC_sis8300_eicsys_iqfb_func_pullInterrupt(boardHandle);
+}
+
+/**
+ * Execute the ramps of the settings for one pulse. The new values of all ramps are calculated first, then each changed 
+ *   setting is written to the firmware once (the scalar settings go through the staged commit if enabled)
+ * Input:
+ *   arg        : Data of the module
+ */
+static void FWC_sis8300_eicsys_iqfb_func_runRamp(FWC_sis8300_eicsys_iqfb_struc_data *arg)
+{
+    int i;
+    int var_gainChanged = 0;
+    int var_FFChanged   = 0;
+    int var_SPStatus;
+    double var_frac;
+
+    /* scalar settings */
+    if(RFCFW_func_rampScalar(&arg -> ramp_gainI, &arg -> board_gainI) == 0)           var_gainChanged = 1;
+    if(RFCFW_func_rampScalar(&arg -> ramp_gainQ, &arg -> board_gainQ) == 0)           var_gainChanged = 1;
+    if(RFCFW_func_rampScalar(&arg -> ramp_FFI,   &arg -> board_feedforwardI_MV) == 0) var_FFChanged   = 1;
+    if(RFCFW_func_rampScalar(&arg -> ramp_FFQ,   &arg -> board_feedforwardQ_MV) == 0) var_FFChanged   = 1;
+
+    /* set point table */
+    var_SPStatus = RFCFW_func_rampStep(&arg -> ramp_SP, &var_frac);
+
+    if(var_SPStatus > 0) {
+        memcpy((void *)arg -> ramp_SPFromI, (void *)arg -> board_setPointTable_I, sizeof(arg -> ramp_SPFromI));
+        memcpy((void *)arg -> ramp_SPFromQ, (void *)arg -> board_setPointTable_Q, sizeof(arg -> ramp_SPFromQ));
+    }
+
+    if(var_SPStatus >= 0) {
+        for(i = 0; i < FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH; i ++) {
+            arg -> board_setPointTable_I[i] = arg -> ramp_SPFromI[i] + (arg -> ramp_SPTargetI[i] - arg -> ramp_SPFromI[i]) * var_frac;
+            arg -> board_setPointTable_Q[i] = arg -> ramp_SPFromQ[i] + (arg -> ramp_SPTargetQ[i] - arg -> ramp_SPFromQ[i]) * var_frac;
+        }
+    }
+
+    /* write to the firmware */
+    if(!arg -> board_handle) return;
+
+    if(var_gainChanged || var_FFChanged)
+        FWC_sis8300_eicsys_iqfb_func_writeParam(arg, (var_gainChanged ? FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_GAIN : 0) | (var_FFChanged ? FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_FF : 0));
+
+    if(var_SPStatus >= 0) {
+        if(arg -> board_tabMutex) epicsMutexMustLock(arg -> board_tabMutex);
+        FWC_sis8300_eicsys_iqfb_func_setIQSPTable(arg -> board_handle, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH, arg -> board_setPointTable_I, arg -> board_setPointTable_Q);
+        if(arg -> board_tabMutex) epicsMutexUnlock(arg -> board_tabMutex);
+        RFCFW_func_ilcSetBase(&arg -> ilc, arg -> board_setPointTable_I, arg -> board_setPointTable_Q, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH, 1);
+    }
+}
+
+/**
+ * Queue the waveforms of this pulse for the EPICS publishing, never waits for the publishing
+ * Input:
+ *   arg        : Data of the module
+ *   pno        : Point number of the waveforms
+ *   shareSel   : Internal data set read in this pulse, the waveforms of the other set are from its latest readout
+ */
+static void FWC_sis8300_eicsys_iqfb_func_pubPush(FWC_sis8300_eicsys_iqfb_struc_data *arg, long pno, unsigned short shareSel)
+{
+    int i;
+    FWC_sis8300_eicsys_iqfb_struc_pubFrame *ptr_frame;
+
+    RFLIB_struc_RFWaveform *wf[FWC_SIS8300_EICSYS_IQFB_CONST_PUB_WF_NUM] = {&arg -> rfData_refCh,  &arg -> rfData_fbkCh,
+                                                                            &arg -> rfData_tracked, &arg -> rfData_err,
+                                                                            &arg -> rfData_act,     &arg -> rfData_DACOut};
+
+    arg -> pub_seq ++;
+    arg -> pub_setSeq[shareSel & 0x1] = arg -> pub_seq;
+
+    ptr_frame = (FWC_sis8300_eicsys_iqfb_struc_pubFrame *)RFCFW_func_pubQueuePutBegin(&arg -> pub_queue);
+    if(!ptr_frame) return;                                                  /* dropped, the queue is full */
+
+    if(pno < 0)                                            pno = 0;
+    if(pno > FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX) pno = FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX;
+
+    ptr_frame -> seq = arg -> pub_seq;
+    ptr_frame -> pno  = pno;
+    ptr_frame -> bank = arg -> board_DAQBank;
+
+    ptr_frame -> shareSel  = (long)(shareSel & 0x1);
+    ptr_frame -> setSeq[0] = arg -> pub_setSeq[0];
+    ptr_frame -> setSeq[1] = arg -> pub_setSeq[1];
+
+    ptr_frame -> segNum = arg -> board_DAQSegNum;
+
+    for(i = 0; i < RFCFW_CONST_ROI_NUM; i ++) {
+        ptr_frame -> segStart[i] = (i < arg -> board_DAQSegNum) ? arg -> board_DAQSeg[i].start : 0;
+        ptr_frame -> segPno[i]   = (i < arg -> board_DAQSegNum) ? arg -> board_DAQSeg[i].pno   : 0;
+    }
+
+    for(i = 0; i < FWC_SIS8300_EICSYS_IQFB_CONST_PUB_WF_NUM; i ++) {
+        memcpy((void *)ptr_frame -> wfI[i], (void *)wf[i] -> wfI, sizeof(short) * pno);
+        memcpy((void *)ptr_frame -> wfQ[i], (void *)wf[i] -> wfQ, sizeof(short) * pno);
+
+        ptr_frame -> feat[i] = *FWC_sis8300_eicsys_iqfb_func_getFeature(arg, i);
+    }
+
+    RFCFW_func_pubQueuePutCommit(&arg -> pub_queue);
+}
+
+/**
+ * Alternate the internal data shared to the last 6 DAQ channels. The data read in this pulse was captured with the
+ *   selection written at the former pulse boundary, the selection is switched for the next pulse every N pulses
+ * Input:
+ *   arg        : Data of the module
+ * Return:
+ *   Internal data set of the pulse being read
+ */
+static unsigned short FWC_sis8300_eicsys_iqfb_func_runShareAlt(FWC_sis8300_eicsys_iqfb_struc_data *arg)
+{
+    unsigned short var_sel = arg -> board_DAQShareSel & 0x1;
+
+    if(!arg -> board_DAQShareAlt) return var_sel;
+
+    arg -> board_DAQShareCnt ++;
+
+    if(arg -> board_DAQShareCnt >= (arg -> board_DAQShareAltPulses > 1 ? arg -> board_DAQShareAltPulses : 1)) {
+        arg -> board_DAQShareCnt = 0;
+        arg -> board_DAQShareSel = var_sel ^ 0x1;
+
+        if(arg -> board_switchMutex) epicsMutexMustLock(arg -> board_switchMutex);
+        FWC_sis8300_eicsys_iqfb_func_setDAQShareSel(arg -> board_handle, (unsigned int)arg -> board_DAQShareSel);
+        if(arg -> board_switchMutex) epicsMutexUnlock(arg -> board_switchMutex);
+    }
+
+    return var_sel;
+}
+
+/**
+ * Clear the waveforms when the regions of interest are changed, the points out of the regions are not read any more
+ * Input:
+ *   arg        : Data of the module
+ */
+static void FWC_sis8300_eicsys_iqfb_func_clearRoiGaps(FWC_sis8300_eicsys_iqfb_struc_data *arg)
+{
+    int i;
+
+    RFLIB_struc_RFWaveform *wf[FWC_SIS8300_EICSYS_IQFB_CONST_PUB_WF_NUM] = {&arg -> rfData_refCh,  &arg -> rfData_fbkCh,
+                                                                            &arg -> rfData_tracked, &arg -> rfData_err,
+                                                                            &arg -> rfData_act,     &arg -> rfData_DACOut};
+
+    for(i = 0; i < 10; i ++)
+        memset((void *)arg -> board_ADC_data[i], 0, sizeof(arg -> board_ADC0_raw));
+
+    for(i = 0; i < FWC_SIS8300_EICSYS_IQFB_CONST_PUB_WF_NUM; i ++) {
+        memset((void *)wf[i] -> wfI, 0, sizeof(short) * RFLIB_CONST_WF_SIZE);
+        memset((void *)wf[i] -> wfQ, 0, sizeof(short) * RFLIB_CONST_WF_SIZE);
+    }
+}
                   
 /*======================================
  * Public Routines (virtual function implementation)
@@ -55,6 +454,37 @@ int FWC_sis8300_eicsys_iqfb_func_init(void *module)
     RFLIB_initRFWaveform(&arg -> rfData_act,           RFLIB_CONST_WF_SIZE);
     RFLIB_initRFWaveform(&arg -> rfData_DACOut,        RFLIB_CONST_WF_SIZE);
 
+    /* Init the vector rotations and the pulse-to-pulse feedback */
+    arg -> board_ampScale = 1.0;
+    arg -> pfb_srcCh      = 1;                                              /* feedback channel */
+    arg -> pfb_budget_us  = RFCFW_CONST_PULSE_BUDGET_US;
+
+    /* Init the staged commit, the parameters are written immediately by default */
+    arg -> stage_mutex    = epicsMutexCreate();
+
+    /* Init the restore of the configuration at the pulse boundary */
+    RFCFW_func_configPendingInit(&arg -> config_pending);
+
+    /* Init the lock of the table uploads */
+    arg -> board_tabMutex = epicsMutexCreate();
+
+    /* Init the lock of the switch control register */
+    arg -> board_switchMutex = epicsMutexCreate();
+
+    /* Init the status snapshot */
+    arg -> stat_maxAge_ms = FWC_SIS8300_EICSYS_IQFB_CONST_STAT_MAX_AGE_MS;
+
+    /* Init the wake-up, the interrupt is used by default */
+    RFCFW_func_wakeInit(&arg -> wake);
+
+    /* Init the iterative learning control, learn the whole table with the error waveform sampled point by point */
+    arg -> ilc.filterLen  = 1;
+    arg -> ilc.errStep    = 1.0;
+    arg -> ilc.tabEnd     = FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH;
+
+    RFCFW_func_ilcInit(&arg -> ilc);
+    RFCFW_func_ilcSetBase(&arg -> ilc, arg -> board_setPointTable_I, arg -> board_setPointTable_Q, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH, 0);
+
     /* Init others */
     arg -> board_ADC_data[0] = arg -> board_ADC0_raw;
     arg -> board_ADC_data[1] = arg -> board_ADC1_raw;
@@ -70,6 +500,59 @@ int FWC_sis8300_eicsys_iqfb_func_init(void *module)
     return 0;       
 }
 
+/**
+ * Release the resources of the firmware data, called before the module is freed
+ */
+int FWC_sis8300_eicsys_iqfb_func_deinit(void *module)
+{
+    FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)module;
+
+    if(!arg) return -1;
+
+    /* Queue of the readouts to the EPICS publishing */
+    RFCFW_func_pubQueueDeinit(&arg -> pub_queue);
+
+    /* Staged commit */
+    if(arg -> stage_mutex) {
+        epicsMutexDestroy(arg -> stage_mutex);
+        arg -> stage_mutex = NULL;
+    }
+
+    /* Restore of the configuration */
+    RFCFW_func_configPendingDeinit(&arg -> config_pending);
+
+    /* Table uploads */
+    if(arg -> board_tabMutex) {
+        epicsMutexDestroy(arg -> board_tabMutex);
+        arg -> board_tabMutex = NULL;
+    }
+
+    /* Switch control register */
+    if(arg -> board_switchMutex) {
+        epicsMutexDestroy(arg -> board_switchMutex);
+        arg -> board_switchMutex = NULL;
+    }
+
+    /* Iterative learning control */
+    RFCFW_func_ilcDeinit(&arg -> ilc);
+
+    return 0;
+}
+
+/**
+ * Share the lock of the control writes of the RFControlFirmware module, called after the init
+ */
+int FWC_sis8300_eicsys_iqfb_func_setLock(void *module, epicsMutexId lock)
+{
+    FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)module;
+
+    if(!arg) return -1;
+
+    arg -> fw_mutex = lock;
+
+    return 0;
+}
+
 /**
  * Get the board module handle for this firmware module
  */ 
@@ -80,6 +563,7 @@ int FWC_sis8300_eicsys_iqfb_func_getBoard(void *module, const char *boardModuleN
     if(!arg) return -1;
 
     arg -> board_handle = FWC_sis8300_eicsys_iqfb_func_getBoardHandle(boardModuleName);
+    arg -> info_valid   = 0;                                                /* read the firmware information of the new board */
 
     if(arg -> board_handle) return 0;
     else return -1;
@@ -93,13 +577,73 @@ int FWC_sis8300_eicsys_iqfb_func_getDAQData(void *module)
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)module;
 
     unsigned int coefId;
+    long var_pno;
+    long var_chMask;
+    long var_validMask;
+    unsigned int var_bank;
+    unsigned int var_bankNext;
+    unsigned int var_mapPno;
+    unsigned int var_capPno;
+    unsigned int var_offset;
+    unsigned int var_offsetNext;
+    unsigned int var_bankPno;
+    unsigned short var_shareSel;
+    int var_roiChanged;
+    double var_startTime_us = RFCFW_func_getTime_us();
 
     if(!arg) return -1;
 
     if(arg -> board_handle) {
-        /* get the DRAM data */
-        if(arg -> board_DAQShareSel == 0)
-            FWC_sis8300_eicsys_iqfb_func_getAllDAQData(arg -> board_handle, (unsigned int)arg -> board_ADCSamplePno, (unsigned int)arg -> board_ADCSamplePno_old,
+        RFCFW_LAT_BEGIN();
+
+        /* internal data set of this pulse, switched for the next pulse if alternating */
+        var_shareSel = FWC_sis8300_eicsys_iqfb_func_runShareAlt(arg);
+
+        /* the point number of the data in the DMA pool (set up with the old point number) */
+        var_pno = arg -> board_ADCSamplePno_old;
+        if(var_pno > FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX) var_pno = FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX;
+        if(var_pno > RFLIB_CONST_WF_SIZE)                          var_pno = RFLIB_CONST_WF_SIZE;
+
+        /* bank of the data, captured with the DAQ settings written at the former pulse */
+        var_bank     = arg -> board_DAQBankCapture;
+        var_offset   = arg -> board_DAQCapOffset;
+
+        /* point number of the DAQ (setpoint or automatic from the timing), the new DAQ size is set to the FPGA below (the
+           change is detected with the regions of interest) */
+        arg -> board_ADCSamplePnoEff = FWC_sis8300_eicsys_iqfb_func_getSamplePno(arg);
+
+        /* regions of interest, applied at the pulse boundary. The FPGA captures up to the end of the last region from next
+           pulse (capture segments, roi.seg), the bank read now was captured with the former ones (readout segments,
+           board_DAQSeg). When the readout switches to the new segments, the points out of the segments are cleared once
+           so that the waveforms do not show the former data */
+        var_roiChanged = RFCFW_func_roiCheck(&arg -> roi, arg -> board_sampleFreq_MHz, arg -> board_ADCSamplePnoEff, 1);
+
+        if(arg -> board_DAQSegChanged) {
+            arg -> board_DAQSegChanged = 0;
+            if(arg -> board_DAQSegNum > 0) FWC_sis8300_eicsys_iqfb_func_clearRoiGaps(arg);
+        }
+
+        /* ping-pong of the capture banks, the FPGA is switched to the other bank before the readout so that the next pulse
+           is captured there while this bank is read. The bank 1 starts right after the bank 0 (capture point number rounded
+           up to 16) and the DMA pool is mapped for both banks, only the bank 0 is used if both do not fit in the pool. The
+           DAQ settings (also changed by CA) are written here at the pulse boundary only */
+        var_capPno   = (unsigned int)FWC_sis8300_eicsys_iqfb_func_getCapturePno(arg);
+        var_bankPno  = (var_capPno + 15) / 16 * 16;
+        var_bankNext = (arg -> board_DAQPingPong && var_bankPno <= FWC_SIS8300_EICSYS_IQFB_CONST_DAQ_BANK_PNO) ? (var_bank ^ 0x1) : 0;
+
+        var_offsetNext = var_bankNext * var_bankPno;
+        var_mapPno     = (var_bankNext != 0 || var_bank != 0) ? 2 * var_bankPno : var_capPno;
+
+        if(var_offsetNext != var_offset || var_capPno != (unsigned int)arg -> board_ADCSamplePno_old || var_roiChanged)
+            FWC_sis8300_eicsys_iqfb_func_setDAQ(arg -> board_handle, var_offsetNext, var_capPno);
+
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_READ_DAQ);
+
+        /* get the DRAM data, the data has been transferred by the DMA before the interrupt, the copy is the deinterleave
+           of the channels */
+        if(var_shareSel == 0)
+            FWC_sis8300_eicsys_iqfb_func_getAllDAQData(arg -> board_handle, (unsigned int)var_pno, var_offset,
+                                                       arg -> board_DAQSeg, (int)arg -> board_DAQSegNum,
                                                        arg -> board_ADC0_raw,     arg -> board_ADC1_raw,
                                                        arg -> board_ADC2_raw,     arg -> board_ADC3_raw,
                                                        arg -> board_ADC4_raw,     arg -> board_ADC5_raw,
@@ -110,7 +654,8 @@ int FWC_sis8300_eicsys_iqfb_func_getDAQData(void *module)
                                                        arg -> rfData_tracked.wfI, arg -> rfData_tracked.wfQ); 
 
         else
-            FWC_sis8300_eicsys_iqfb_func_getAllDAQData(arg -> board_handle, (unsigned int)arg -> board_ADCSamplePno,  (unsigned int)arg -> board_ADCSamplePno_old,
+            FWC_sis8300_eicsys_iqfb_func_getAllDAQData(arg -> board_handle, (unsigned int)var_pno, var_offset,
+                                                       arg -> board_DAQSeg, (int)arg -> board_DAQSegNum,
                                                        arg -> board_ADC0_raw,     arg -> board_ADC1_raw,
                                                        arg -> board_ADC2_raw,     arg -> board_ADC3_raw,
                                                        arg -> board_ADC4_raw,     arg -> board_ADC5_raw,
@@ -120,8 +665,55 @@ int FWC_sis8300_eicsys_iqfb_func_getDAQData(void *module)
                                                        arg -> rfData_act.wfI,     arg -> rfData_act.wfQ,
                                                        arg -> rfData_DACOut.wfI,  arg -> rfData_DACOut.wfQ);
 
-        /* remember the point number */
-        arg -> board_ADCSamplePno_old = arg -> board_ADCSamplePno;
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_DEINTLV);
+
+        /* remap the DMA pool for the next pulse if the size is changed */
+        FWC_sis8300_eicsys_iqfb_func_setDAQMap(arg -> board_handle, var_mapPno, arg -> board_DAQMapPno);
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_READ_DAQ);
+
+        arg -> board_DAQMapPno      = var_mapPno;
+        arg -> board_DAQBank        = (long)var_bank;
+        arg -> board_DAQBankCapture = var_bankNext;
+        arg -> board_DAQCapOffset   = var_offsetNext;
+
+        /* the next pulse is captured with the new segments, read with them from the next pulse */
+        if(var_roiChanged) {
+            memcpy((void *)arg -> board_DAQSeg, (void *)arg -> roi.seg, sizeof(arg -> board_DAQSeg));
+            arg -> board_DAQSegNum     = arg -> roi.segNum;
+            arg -> board_DAQSegChanged = 1;
+        }
+
+        /* scalar features of the waveforms (the one used by the pulse-to-pulse feedback is always calculated), 
+           only the ones shared to the DAQ in this pulse are updated */
+        var_chMask = arg -> feat_chSel | FWC_sis8300_eicsys_iqfb_func_getFeatureMask(arg -> pfb_srcCh);
+
+        if(var_shareSel == 0)
+            var_chMask &= (RFCFW_CONST_FEAT_CH_REF | RFCFW_CONST_FEAT_CH_FBK | RFCFW_CONST_FEAT_CH_TRACKED);
+        else
+            var_chMask &= (RFCFW_CONST_FEAT_CH_ERR | RFCFW_CONST_FEAT_CH_ACT | RFCFW_CONST_FEAT_CH_DAC_OUT);
+
+        var_validMask = FWC_sis8300_eicsys_iqfb_func_calcFeatures(arg, var_pno, var_chMask);
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_FEATURE);
+
+        /* pulse-to-pulse feedback */
+        FWC_sis8300_eicsys_iqfb_func_runPulseFeedback(arg, var_validMask, var_startTime_us);
+
+        /* iterative learning of the set point table, only when the error waveform is shared to the DAQ in this pulse */
+        if(var_shareSel != 0)
+            FWC_sis8300_eicsys_iqfb_func_runILC(arg, var_pno);
+
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_CONTROL);
+
+        /* queue the waveforms for the EPICS publishing */
+        FWC_sis8300_eicsys_iqfb_func_pubPush(arg, var_pno, var_shareSel);
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_PUBLISH);
+
+        /* remember the point number captured */
+        arg -> board_ADCSamplePno_old = (long)var_capPno;
+
+        /* ramps of the settings, at the pulse boundary */
+        FWC_sis8300_eicsys_iqfb_func_runRamp(arg);
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_CONTROL);
 
         /* get the current coefficient id for demod in CPU */
         FWC_sis8300_eicsys_iqfb_func_getNonIQCoefCur(arg -> board_handle, &coefId);
@@ -179,7 +771,7 @@ int FWC_sis8300_eicsys_iqfb_func_getIntData(void *module)
 }
 
 /**
- * Set the phase adjustment
+ * Set the phase adjustment, the input is the phase change respect to the current setting
  */
 int FWC_sis8300_eicsys_iqfb_func_setPha_deg(void *module, double pha_deg)
 {
@@ -188,26 +780,25 @@ int FWC_sis8300_eicsys_iqfb_func_setPha_deg(void *module, double pha_deg)
     /* check the input */
     if(!arg) return -1;
 
-    /* Apply the adjustement to: 1). measurement chain rotation; 2). driving chain rotation */
-    arg -> board_fbkRotationAngle_deg -= pha_deg;
-    arg -> board_actRotationAngle_deg += pha_deg;
-             
-    /*arg -> board_fbkRotationGain = 1.0; */   /* these rotations are only used for fast phase rotation! */
-    arg -> board_actRotationGain = 1.0;
-
-    if(arg -> board_handle) {
-        FWC_sis8300_eicsys_iqfb_func_setFbkVectorRotation(arg -> board_handle, arg -> board_fbkRotationGain, arg -> board_fbkRotationAngle_deg);
-        FWC_sis8300_eicsys_iqfb_func_setActVectorRotation(arg -> board_handle, arg -> board_actRotationGain, arg -> board_actRotationAngle_deg);
-    }
+    FWC_sis8300_eicsys_iqfb_func_applyRotation(arg, pha_deg, 1.0);
+    FWC_sis8300_eicsys_iqfb_func_writeParam(arg, FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_ROT);
 
     return 0;
 }
 
 /**
- * Set amplitude (not supported now)
+ * Set the amplitude adjustment, the input is the ratio of the amplitude respect to the current setting (e.g. 1.01 to increase 1%)
  */
 int FWC_sis8300_eicsys_iqfb_func_setAmp(void *module, double amp)
 {
+    FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)module;
+
+    /* check the input */
+    if(!arg || amp <= 0.0) return -1;
+
+    FWC_sis8300_eicsys_iqfb_func_applyRotation(arg, 0.0, amp);
+    FWC_sis8300_eicsys_iqfb_func_writeParam(arg, FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_ROT);
+
     return 0;
 }
 
@@ -216,6 +807,7 @@ int FWC_sis8300_eicsys_iqfb_func_setAmp(void *module, double amp)
  */
 int FWC_sis8300_eicsys_iqfb_func_waitIntr(void *module)
 {
+    int status;
     unsigned int data;
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)module;
 
@@ -242,8 +834,24 @@ int FWC_sis8300_eicsys_iqfb_func_waitIntr(void *module)
                
 
        
-        /* wait for interrupt */
-        return FWC_sis8300_eicsys_iqfb_func_pullInterrupt(arg -> board_handle);
+        /* wait for interrupt, it is the DMA-done interrupt and the DMA pool is not complete when the pulse counter
+           changes, so the hybrid mode is not used (no pulse counter given) */
+        status = RFCFW_func_wakeWait(&arg -> wake, arg -> board_handle, arg -> board_meaTriggerPeriod_ms, 0.0,
+                                     FWC_sis8300_eicsys_iqfb_func_pullIntr, NULL);
+
+        arg -> pfb_intrTime_us = RFCFW_func_getTime_us();
+
+        /* start the latency breakdown of the pulse */
+        RFCFW_LAT_START();
+
+        /* restore the configuration if requested, before the commit so that its staged parameters are written with it */
+        FWC_sis8300_eicsys_iqfb_func_commitConfig(arg);
+
+        /* commit the staged parameters at the beginning of the gap between pulses */
+        FWC_sis8300_eicsys_iqfb_func_commitParam(arg);
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_COMMIT);
+
+        return status;
 
     } else {
         return -1;
@@ -261,6 +869,7 @@ int FWC_sis8300_eicsys_iqfb_func_meaIntrLatency(void *module, long *latencyCnt,
     unsigned int data       = 0;
     unsigned int dataRead   = 0;
     unsigned int dataRead2  = 0;
+    double       var_stopTime_us;
 
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)module;
 
@@ -268,34 +877,166 @@ int FWC_sis8300_eicsys_iqfb_func_meaIntrLatency(void *module, long *latencyCnt,
     if(!arg || !latencyCnt || !pulseCnt) return -1;
     
     if(arg -> board_handle) {
+        RFCFW_LAT_BEGIN();
+
         /* stop the counter */
+        if(arg -> board_switchMutex) epicsMutexMustLock(arg -> board_switchMutex);
         FWC_sis8300_eicsys_iqfb_func_getBits(arg->board_handle, &data);        
         data &= 0xFFFFFFBF;
         FWC_sis8300_eicsys_iqfb_func_setBits(arg->board_handle, data);
+        if(arg -> board_switchMutex) epicsMutexUnlock(arg -> board_switchMutex);
+        var_stopTime_us = RFCFW_func_getTime_us();
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_CNT_STOP);
 
         /* read the register */            
-        RFCB_API_readRegister((RFCB_struc_moduleData *)arg->board_handle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_IRQ_DELAY_CNT, &dataRead, RFCB_DEV_USR);
-        RFCB_API_readRegister((RFCB_struc_moduleData *)arg->board_handle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_PUL_CNT,       &dataRead2, RFCB_DEV_USR);
+        FWC_SIS8300_EICSYS_IQFB_REG_READ(arg->board_handle, IRQ_DELAY_CNT, &dataRead);
+        FWC_SIS8300_EICSYS_IQFB_REG_READ(arg->board_handle, PUL_CNT,       &dataRead2);
 
         *(latencyCnt) = (long)dataRead;
         *(pulseCnt)   = (long)dataRead2;
 
-        /* enable the counter which will be started by the coming trigger */                    
+        /* wake-up latency for the breakdown and for the source of the wake-up, the counter runs with the sampling clock
+           from the trigger to the stop above */
+        if(arg -> board_sampleFreq_MHz > 0.0) {
+            RFCFW_LAT_SET_WAKE((double)dataRead / arg -> board_sampleFreq_MHz);
+            RFCFW_func_wakeLatency(&arg -> wake, (double)dataRead / arg -> board_sampleFreq_MHz - (var_stopTime_us - arg -> wake.wakeTime_us));
+        }
+
+        /* enable the counter which will be started by the coming trigger, read the register again as the other bits may
+           have been changed since the stop */
+        if(arg -> board_switchMutex) epicsMutexMustLock(arg -> board_switchMutex);
+        FWC_sis8300_eicsys_iqfb_func_getBits(arg->board_handle, &data);
         data |= 0x00000040;
         FWC_sis8300_eicsys_iqfb_func_setBits(arg->board_handle, data);  
+        if(arg -> board_switchMutex) epicsMutexUnlock(arg -> board_switchMutex);
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_CNT_ARM);
     }
 
     return 0;
 }
 
+/**
+ * Point number captured by the FPGA. If the regions of interest are applied, the capture ends at the last region
+ * Input:
+ *   arg        : Data of the module
+ * Return:
+ *   Point number of the DAQ
+ */
+long FWC_sis8300_eicsys_iqfb_func_getCapturePno(FWC_sis8300_eicsys_iqfb_struc_data *arg)
+{
+    if(!arg) return 0;
+
+    if(arg -> roi.segNum > 0 && arg -> roi.segEnd < arg -> board_ADCSamplePnoEff) return arg -> roi.segEnd;
+
+    return arg -> board_ADCSamplePnoEff;
+}
+
+/**
+ * Read the information of the firmware and the board (firmware name, versions, device status...). The firmware
+ *   information does not change while the board is opened, it is read from the registers only once
+ * Input:
+ *   arg        : Data of the module
+ */
+void FWC_sis8300_eicsys_iqfb_func_readFwInfo(FWC_sis8300_eicsys_iqfb_struc_data *arg)
+{
+    unsigned int firmwareName;
+    unsigned int majorVer;
+    unsigned int minorVer;
+    unsigned int buildNum;
+
+    int deviceOpened;
+
+    unsigned int platformFwId;
+
+    if(!arg) return;
 
+    if(arg -> board_handle) {
+        FWC_sis8300_eicsys_iqfb_func_getBoardInfo(arg -> board_handle, arg -> board_deviceName, &deviceOpened);
 
+        arg -> board_deviceOpened   = (long)deviceOpened;
 
+        if(deviceOpened && !arg -> info_valid) {
+            FWC_sis8300_eicsys_iqfb_func_getAppFwInfo(arg -> board_handle, &firmwareName, &majorVer, &minorVer, &buildNum);
+            FWC_sis8300_eicsys_iqfb_func_getPlatformInfo(arg -> board_handle, &platformFwId, arg -> board_FPGAType, arg -> board_platformFwCompileTime,
+                                                         &arg -> board_clkMainFreq_MHz, &arg -> board_clkExt0Freq_MHz, &arg -> board_clkExt1Freq_MHz, 
+                                                         &arg -> board_clkDDR00Freq_MHz, &arg -> board_clkDDR90Freq_MHz, &arg -> board_clkDDRDvFreq_MHz, 
+                                                         &arg -> board_clkIDelayFreq_MHz, &arg ->board_clkSPIFreq_MHz);
 
+            arg -> board_firmwareName   = (long)firmwareName;
+            arg -> board_majorVer       = (long)majorVer;
+            arg -> board_minorVer       = (long)minorVer;
+            arg -> board_buildNum       = (long)buildNum;
 
+            arg -> board_platformFwId   = (long)platformFwId;
 
+            arg -> info_valid           = 1;
+        }
+    }
+}
 
+/**
+ * Update the status of the firmware from the snapshot of the status registers. The snapshot is read from the board
+ *   only if it is older than the maximum age, so that all status records of a scan share one reading
+ * Input:
+ *   arg        : Data of the module
+ */
+void FWC_sis8300_eicsys_iqfb_func_readStatus(FWC_sis8300_eicsys_iqfb_struc_data *arg)
+{
+    double var_time_us;
 
+    if(!arg || !arg -> board_handle) return;
 
+    var_time_us = RFCFW_func_getTime_us();
+
+    if(arg -> stat_readCnt > 0 && var_time_us - arg -> stat_time_us < arg -> stat_maxAge_ms * 1000.0) {
+        arg -> stat_hitCnt ++;
+        return;
+    }
 
+    FWC_sis8300_eicsys_iqfb_func_getStatusSnapshot(arg -> board_handle, &arg -> stat_snapshot);
 
+    arg -> stat_time_us = var_time_us;
+    arg -> stat_readCnt ++;
+
+    arg -> board_pulseCnt                 = (long)arg -> stat_snapshot.pulseCnt;
+    arg -> board_ADCClkWdCnt              = (long)arg -> stat_snapshot.WDCnt;
+    arg -> board_platformStatus           = (long)arg -> stat_snapshot.platformStatus;
+    arg -> board_usageStatus              = (long)arg -> stat_snapshot.useStatus;
+    arg -> board_RFCtrlStatus             = (long)arg -> stat_snapshot.RFCtrlStatus;
+
+    arg -> board_raceConditionFlags_acc   = (long)arg -> stat_snapshot.RCFlagsAcc;
+    arg -> board_raceConditionFlags_stdby = (long)arg -> stat_snapshot.RCFlagsStdby;
+    arg -> board_raceConditionFlags_spare = (long)arg -> stat_snapshot.RCFlagsSpare;
+
+    arg -> board_meaTriggerPeriod_ms      = (double)arg -> stat_snapshot.trigPeriod / arg -> board_sampleFreq_MHz / 1000.0;
+}
+
+/**
+ * Bring up the board at the IOC start: setup the SPI (clock divider, ADC chips and DAC chips) and read the firmware
+ *   information. Only the board of this module is accessed, so that the bring-up of different modules can run in parallel
+ * Input:
+ *   module     : Data of the module
+ *   setupSPI   : 1 to setup the SPI with the current settings
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed
+ */
+int FWC_sis8300_eicsys_iqfb_func_bringUp(void *module, int setupSPI)
+{
+    int status = 0;
+
+    FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)module;
+
+    if(!arg || !arg -> board_handle) return -1;
+
+    if(setupSPI) {
+        status = FWC_sis8300_eicsys_iqfb_func_setSPI(arg -> board_handle, (unsigned int)arg -> board_clkDiv2);
+    }
+
+    arg -> info_valid = 0;
+    FWC_sis8300_eicsys_iqfb_func_readFwInfo(arg);
+
+    if(!arg -> board_deviceOpened) status = -1;
+
+    return status;
+}
@@ -27,6 +27,18 @@
 #include "RFLib_signalProcess.h"                            /* use the library data definitions and routines */
 #include "MathLib_dataProcess.h"
 #include "EPICSLib_wrapper.h"
+#include "epicsMutex.h"
+
+#include "RFControlFirmware_pulseFeature.h"                   /* per-pulse scalar features of the RF waveforms */
+#include "RFControlFirmware_pulseCtrl.h"                      /* pulse-to-pulse feedback controller */
+#include "RFControlFirmware_timeStats.h"                      /* timing statistics of the real-time processing */
+#include "RFControlFirmware_ilc.h"                            /* iterative learning control of the set point table */
+#include "RFControlFirmware_ramp.h"                           /* ramps of the settings */
+#include "RFControlFirmware_pubQueue.h"                       /* queue of the readouts to the EPICS publishing */
+#include "RFControlFirmware_roi.h"                            /* regions of interest of the DAQ readout */
+#include "RFControlFirmware_wake.h"                           /* wake-up of the pulse thread */
+#include "RFControlFirmware_latency.h"                        /* latency breakdown of the pulse pipeline */
+#include "RFControlFirmware_config.h"                         /* restore of the configuration at the pulse boundary */
 
 #include "FWControl_sis8300_eicsys_iqfb_board.h"            /* use the functions talking to board */
 
@@ -34,6 +46,39 @@
 extern "C" {
 #endif
 
+/**
+ * Default maximum age of the status snapshot
+ */
+#define FWC_SIS8300_EICSYS_IQFB_CONST_STAT_MAX_AGE_MS 500.0
+
+/**
+ * Parameters written to the firmware together, used as the bit mask of the staged commit
+ */
+#define FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_GAIN       0x01                 /* feedback gain of I/Q */
+#define FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_FF         0x02                 /* feedforward of I/Q */
+#define FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_IQ_CORR    0x04                 /* imbalance correction matrix */
+#define FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_ROT        0x08                 /* feedback and actuation vector rotations */
+
+/**
+ * Readout of a pulse published to EPICS, the waveforms and their features are in the order of RFCFW_CONST_FEAT_CH_*
+ */
+#define FWC_SIS8300_EICSYS_IQFB_CONST_PUB_WF_NUM          6                    /* RF waveforms published */
+
+typedef struct {
+    long  seq;                                              /* sequence number of the readout */
+    long  pno;                                              /* valid points of the waveforms */
+    long  bank;                                             /* capture bank of the DMA pool the waveforms were read from */
+    long  shareSel;                                         /* internal data set read in this pulse (board_DAQShareSel) */
+    long  setSeq[2];                                        /* sequence number of the readout each internal data set was read in,
+                                                               [0] for ref/fbk/tracked and [1] for err/act/DAC output */
+    long  segNum;                                           /* segments (regions of interest) read, 0 for the full readout */
+    long  segStart[RFCFW_CONST_ROI_NUM];                    /* first point of the segments */
+    long  segPno[RFCFW_CONST_ROI_NUM];                      /* points of the segments */
+    short wfI[FWC_SIS8300_EICSYS_IQFB_CONST_PUB_WF_NUM][FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX];
+    short wfQ[FWC_SIS8300_EICSYS_IQFB_CONST_PUB_WF_NUM][FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX];
+    RFCFW_struc_pulseFeature feat[FWC_SIS8300_EICSYS_IQFB_CONST_PUB_WF_NUM];    /* features of the waveforms of the same pulse */
+} FWC_sis8300_eicsys_iqfb_struc_pubFrame;
+
 /**
  * Define the data structure for the firmware. Here defines most of data that will be connect to EPICS PVs
  * some EPICS data types:
@@ -88,6 +133,9 @@ typedef struct {
                                                                OUP_DAQ_DATA_BUS(14) <= smath_resizeVector(sig_diag_tracked_i, CON_DAQ_DATA_SIZE) when (reg_daq_share_sel = '0') else smath_resizeVector(sig_data_dac_i, CON_DAQ_DATA_SIZE);
                                                                OUP_DAQ_DATA_BUS(15) <= smath_resizeVector(sig_diag_tracked_q, CON_DAQ_DATA_SIZE) when (reg_daq_share_sel = '0') else smath_resizeVector(sig_data_dac_q, CON_DAQ_DATA_SIZE);
                                                             */
+    volatile unsigned short board_DAQShareAlt;              /* 1 to alternate board_DAQShareSel at the pulse boundary, both internal data sets are read at reduced rate */
+    volatile long board_DAQShareAltPulses;                  /* pulses of each set before the selection is switched */
+    long          board_DAQShareCnt;                        /* pulses of the current set */
         
     volatile unsigned short board_fbEnable;                 /* 1 to enable the intra-pulse feedback */
 
@@ -118,8 +166,20 @@ typedef struct {
     volatile long board_ampLimitLo;                         /* Limit of the DAC output low */
     
     volatile long board_ADCSamplePno;                       /* ADC sample point number */
+    volatile unsigned short board_ADCAutoPno;               /* 1 to derive the point number from the RF pulse length and the DAQ trigger delay */
+    volatile double board_ADCTailMargin_ns;                 /* margin after the RF pulse end for the automatic point number (decay tail) */
+    volatile long board_ADCSamplePnoEff;                    /* point number of the DAQ in use (setpoint or automatic), readback */
     volatile long board_ADCSamplePno_old;                   /* Temp variable helped to detect the changes of the board_ADCSamplePno */
 
+    volatile unsigned short board_DAQPingPong;              /* 1 to alternate the capture bank in the DMA pool every pulse, the readout overlaps the next capture */
+    volatile long board_DAQBank;                            /* bank of the DAQ data read (tag of the latest frame) */
+    unsigned int  board_DAQBankCapture;                     /* bank the FPGA is writing for the next pulse */
+    unsigned int  board_DAQCapOffset;                       /* start (points) of the bank the FPGA is writing, the bank 1 starts at the capture point number rounded up to 16 */
+    unsigned int  board_DAQMapPno;                          /* point number of the DMA pool mapped */
+    long          board_DAQSegNum;                          /* segments of the readout, the ones the bank captured was set up with (roi.seg is */
+    RFCFW_struc_roiSeg board_DAQSeg[RFCFW_CONST_ROI_NUM];   /*   the capture of the next pulse), taken from roi.seg one pulse after the change */
+    int           board_DAQSegChanged;                      /* 1 if the segments of the readout are taken from roi.seg at the former pulse */
+
     volatile long board_coefIdOffset;                       /* the non-IQ coefficient ID offset, this is to compensate the sampling start point uncertainty after power cycle */
     volatile long board_coefIdCur;                          /* current coefficient Id for the first point of the DAQ buffer (ADC) */
 
@@ -142,6 +202,8 @@ typedef struct {
     
     volatile double  board_actRotationGain;                 /* rotation gain of the actuation signal */
     volatile double  board_actRotationAngle_deg;            /* rotation angle of the actuation signal */
+
+    volatile double  board_ampScale;                        /* amplitude scale applied with the vector rotations, changed by setAmp (1.0 by default) */
     
     volatile double  board_feedforwardI_MV;                 /* feed forward value I component, MV */
     volatile double  board_feedforwardQ_MV;                 /* feed forward value Q component, MV */
@@ -195,12 +257,98 @@ typedef struct {
     double DAQTimeAxis_ns[FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX];       /* time axis in ns for internal DAQ */
     double ADCTimeAxis_ns[FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX];       /* time axis in ns for ADC waveform */
 
+    /* --- per-pulse scalar features of the RF waveforms --- */
+    volatile double  feat_winStart_ns;                      /* start time of the flat-top window in ns (same time base as the waveform time axis) */
+    volatile double  feat_winEnd_ns;                        /* end time of the flat-top window in ns */
+    volatile long    feat_chSel;                            /* bit mask to select the waveforms for the calculation, see RFCFW_CONST_FEAT_CH_* */
+
+    RFCFW_struc_pulseFeature feat_refCh;                    /* features of the waveforms above */
+    RFCFW_struc_pulseFeature feat_fbkCh;
+    RFCFW_struc_pulseFeature feat_tracked;
+    RFCFW_struc_pulseFeature feat_err;
+    RFCFW_struc_pulseFeature feat_act;
+    RFCFW_struc_pulseFeature feat_DACOut;
+
+    /* --- pulse-to-pulse amplitude/phase feedback with the vector rotations --- */
+    volatile long    pfb_srcCh;                             /* waveform (0 - 5, in the order of RFCFW_CONST_FEAT_CH_*) whose features are used as the measurement */
+    volatile double  pfb_budget_us;                         /* time budget of the loop, from the interrupt to the correction applied */
+    double           pfb_intrTime_us;                       /* time when the latest interrupt was received */
+
+    RFCFW_struc_piCtrl    pfb_ampCtrl;                      /* amplitude controller, the error is normalized to the set point */
+    RFCFW_struc_piCtrl    pfb_phaCtrl;                      /* phase controller, in degree */
+
+    RFCFW_struc_timeStats pfb_procTime;                     /* time from the data ready to the correction applied */
+    RFCFW_struc_timeStats pfb_loopTime;                     /* time from the interrupt to the correction applied */
+
+    /* --- iterative learning control of the set point table --- */
+    RFCFW_struc_ilc ilc;                                    /* learns from the error waveform, the base table is board_setPointTable_I/Q */
+
+    /* --- ramps of the settings, one step is applied per pulse --- */
+    RFCFW_struc_ramp ramp_gainI;                            /* ramps of board_gainI/Q */
+    RFCFW_struc_ramp ramp_gainQ;
+    RFCFW_struc_ramp ramp_FFI;                              /* ramps of board_feedforwardI/Q_MV */
+    RFCFW_struc_ramp ramp_FFQ;
+    RFCFW_struc_ramp ramp_SP;                               /* ramp of the set point table, the target is ramp_SPTargetI/Q */
+
+    double ramp_SPTargetI[FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH];     /* target of the set point table */
+    double ramp_SPTargetQ[FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH];
+    double ramp_SPFromI[FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH];       /* set point table when the ramp started */
+    double ramp_SPFromQ[FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH];
+
+    /* --- regions of interest of the DAQ readout, applied at the pulse boundary. The DAQ size is trimmed to the end of the
+           last region and only the regions are copied from the DMA pool --- */
+    RFCFW_struc_roi roi;
+
+    /* --- the switch control register is read-modify-written by the EPICS threads (settings, watchdog) and by the pulse
+           thread (DAQ share alternation, IRQ latency counter), all of them hold this lock --- */
+    epicsMutexId    board_switchMutex;
+
+    /* --- lock of the control writes of the RFControlFirmware module (fwMutex), taken by the record callbacks writing the
+           loop parameters, which are also written by the pulse feedback of the asynchronous readout, NULL if not set --- */
+    epicsMutexId    fw_mutex;
+
+    /* --- the tables are uploaded through the shared pair of BUF_WR_ADDR/BUF_WR_DATA by the EPICS threads (table records,
+           restore) and by the pulse thread (ILC, ramp), each upload holds this lock for its whole address/data sequence --- */
+    epicsMutexId    board_tabMutex;
+
+    /* --- staged commit of the parameters, all pending parameters are written right after the interrupt --- */
+    volatile unsigned short stage_enable;                   /* 1 to stage the writes of the parameters, 0 to write them immediately */
+    unsigned long   stage_pending;                          /* mask of the parameters waiting for the commit, see the _CONST_PARAM_* */
+    epicsMutexId    stage_mutex;                            /* protect the pending mask */
+
+    RFCFW_struc_timeStats stage_commitTime;                 /* time to write all pending parameters */
+
+    /* --- restore of the configuration, handed to the pulse thread and applied right after the interrupt --- */
+    RFCFW_struc_configPending config_pending;
+    IOSCANPVT       config_ioScan;                          /* I/O interrupt scan of the records of the settings, requested after a restore */
+
+    /* --- queue of the readouts from the pulse thread to the EPICS publishing, the waveform nodes point to pub_frame --- */
+    RFCFW_struc_pubQueue pub_queue;
+    volatile long   pub_seq;                                /* sequence number of the latest readout queued */
+    long            pub_setSeq[2];                          /* sequence number of the latest readout of each internal data set */
+
+    FWC_sis8300_eicsys_iqfb_struc_pubFrame pub_frame;       /* published readout */
+
+    /* --- cached snapshot of the status registers, all status records are served from it --- */
+    FWC_sis8300_eicsys_iqfb_struc_status stat_snapshot;
+    double          stat_time_us;                           /* time when the snapshot was read */
+    volatile double stat_maxAge_ms;                         /* the snapshot is reused if it is younger than this */
+    volatile long   stat_readCnt;                           /* number of snapshots read from the board */
+    volatile long   stat_hitCnt;                            /* number of status readings served from the snapshot */
+
+    volatile unsigned short info_valid;                     /* 1 if the static firmware information (name, version) has been read */
+
+    /* --- wake-up of the pulse thread, always the DMA-done interrupt (the hybrid mode is not used) --- */
+    RFCFW_struc_wake wake;
+
 } FWC_sis8300_eicsys_iqfb_struc_data;
 
 /**
  * Implementation of the virtual functions
  */
 int FWC_sis8300_eicsys_iqfb_func_init(void *module);
+int FWC_sis8300_eicsys_iqfb_func_deinit(void *module);
+int FWC_sis8300_eicsys_iqfb_func_setLock(void *module, epicsMutexId lock);
 int FWC_sis8300_eicsys_iqfb_func_getBoard(void *module, const char *boardModuleName);
 
 int FWC_sis8300_eicsys_iqfb_func_getDAQData(void *module);
@@ -213,6 +361,16 @@ int FWC_sis8300_eicsys_iqfb_func_setAmp(void *module, double amp);
 int FWC_sis8300_eicsys_iqfb_func_waitIntr(void *module);
 int FWC_sis8300_eicsys_iqfb_func_meaIntrLatency(void *module, long *latencyCnt, long *pulseCnt);
 
+int FWC_sis8300_eicsys_iqfb_func_bringUp(void *module, int setupSPI);
+
+/**
+ * Other routines
+ */
+void FWC_sis8300_eicsys_iqfb_func_writeParam(FWC_sis8300_eicsys_iqfb_struc_data *arg, unsigned long mask);                 /* write the parameters, or stage them if enabled */
+void FWC_sis8300_eicsys_iqfb_func_readFwInfo(FWC_sis8300_eicsys_iqfb_struc_data *arg);                                       /* read the firmware and board information */
+void FWC_sis8300_eicsys_iqfb_func_readStatus(FWC_sis8300_eicsys_iqfb_struc_data *arg);                                       /* update the status from the snapshot */
+long FWC_sis8300_eicsys_iqfb_func_getCapturePno(FWC_sis8300_eicsys_iqfb_struc_data *arg);                                    /* DAQ size in the FPGA, trimmed by the regions of interest */
+
 #ifdef __cplusplus
 }
 #endif
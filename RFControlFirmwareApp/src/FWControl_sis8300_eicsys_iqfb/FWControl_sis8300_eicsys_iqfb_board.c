@@ -69,12 +69,15 @@ void FWC_sis8300_eicsys_iqfb_func_getBoardInfo(void *boardHandle, char *deviceNa
  *      -- Out 5    (ADC5-CLK, ch8/9)           : LVDS 3.5 mA
  *      -- Out 6    (ADC4-CLK, ch6/7)           : LVDS 3.5 mA
  *      -- Out 7    (Frontpanel Clk, Harlink)   : LVDS 3.5 mA
+ *
+ * Return -1 as it is not implemented yet (the backend does not have RFCFW_CAP_SPI_SETUP)
  */
-void FWC_sis8300_eicsys_iqfb_func_setSPI(void *boardHandle, unsigned int clkDiv2)
+int FWC_sis8300_eicsys_iqfb_func_setSPI(void *boardHandle, unsigned int clkDiv2)
 {
     RFCB_struc_moduleData *board = (RFCB_struc_moduleData *)boardHandle;
     
 	/* to be implemented later, use the tools provided by EICSYS for testing */
+    return -1;
 }
 
 /**
@@ -123,21 +126,41 @@ void FWC_sis8300_eicsys_iqfb_func_getPlatformInfo(void *boardHandle,
  */
 void  FWC_sis8300_eicsys_iqfb_func_setBits(void *boardHandle, unsigned int data)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_SWITCH_CTRL, data, RFCB_DEV_USR);   /* Write to the register */
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, SWITCH_CTRL, data);   /* Write to the register */
 }
 
 void  FWC_sis8300_eicsys_iqfb_func_getBits(void *boardHandle, unsigned int *data)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_SWITCH_CTRL, data, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, SWITCH_CTRL, data);
+}
+
+/**
+ * Select the internal data shared to the last 6 DAQ channels (bit 8 of the switch control), the other bits are kept. The
+ *   caller holds the lock of the switch control register (board_switchMutex) as the register is also written by the
+ *   EPICS threads
+ * Input:
+ *   sel            : 0 for ref/fbk/tracked, 1 for err/act/DAC output
+ */
+void  FWC_sis8300_eicsys_iqfb_func_setDAQShareSel(void *boardHandle, unsigned int sel)
+{
+    unsigned int data;
+
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, SWITCH_CTRL, &data);
+
+    data &= ~0x00000100;
+    data += (sel & 0x1) << 8;
+
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, SWITCH_CTRL, data);
 }
 
 /**
  * Setup the DAQ module in FPGA. The offset is the memory starting address for data saving, pno is the point numer (16-bit data for 16 channels) that will be saved
+ *   Both are given in points (256 bits), the offset is converted to the unit of the DAQ address register
  */
 void  FWC_sis8300_eicsys_iqfb_func_setDAQ(void *boardHandle, unsigned int offset, unsigned int pno)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_DAQ_ADDR, offset, RFCB_DEV_USR);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_DAQ_SIZE, pno,    RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, DAQ_ADDR, offset * FWC_SIS8300_EICSYS_IQFB_CONST_DAQ_ADDR_PER_PNO);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, DAQ_SIZE, pno);
 }
 
 /**
@@ -150,19 +173,19 @@ void  FWC_sis8300_eicsys_iqfb_func_setDAQ(void *boardHandle, unsigned int offset
 void  FWC_sis8300_eicsys_iqfb_func_setExtTrigDelayAcc(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_DELAY_ACC, data, RFCB_DEV_USR);    
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, DELAY_ACC, data);    
 }
 
 void  FWC_sis8300_eicsys_iqfb_func_setExtTrigDelayStdby(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_DELAY_STDBY, data, RFCB_DEV_USR);    
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, DELAY_STDBY, data);    
 }
 
 void  FWC_sis8300_eicsys_iqfb_func_setExtTrigDelaySpare(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_DELAY_SPARE, data, RFCB_DEV_USR);    
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, DELAY_SPARE, data);    
 }
 
 /**
@@ -175,7 +198,7 @@ void  FWC_sis8300_eicsys_iqfb_func_setExtTrigDelaySpare(void *boardHandle, doubl
 void  FWC_sis8300_eicsys_iqfb_func_setIntTrigPeriod(void *boardHandle, double value_ms, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ms * freq_MHz * 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_TRIG_INT_PERIOD, data, RFCB_DEV_USR);        
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, TRIG_INT_PERIOD, data);        
 }
 
 /**
@@ -188,7 +211,7 @@ void  FWC_sis8300_eicsys_iqfb_func_setIntTrigPeriod(void *boardHandle, double va
 void  FWC_sis8300_eicsys_iqfb_func_setRFPulseLength(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_RF_PULSE_LENGTH, data, RFCB_DEV_USR);     
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, RF_PULSE_LENGTH, data);     
 }
 
 /**
@@ -201,7 +224,7 @@ void  FWC_sis8300_eicsys_iqfb_func_setRFPulseLength(void *boardHandle, double va
 void  FWC_sis8300_eicsys_iqfb_func_setDAQTrigDelay(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_DAQ_TRIG_DELAY, data, RFCB_DEV_USR);     
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, DAQ_TRIG_DELAY, data);     
 }
 
 /**
@@ -214,7 +237,7 @@ void  FWC_sis8300_eicsys_iqfb_func_setDAQTrigDelay(void *boardHandle, double val
 void  FWC_sis8300_eicsys_iqfb_func_selectRefFbkChannel(void *boardHandle, unsigned int refCh, unsigned int fbkCh)
 {
     unsigned int data = (refCh << 16) + (fbkCh & 0x0000FFFF);       
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_REF_FBK_SEL, data, RFCB_DEV_USR);    
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, REF_FBK_SEL, data);    
 }
 
 /**
@@ -222,7 +245,7 @@ void  FWC_sis8300_eicsys_iqfb_func_selectRefFbkChannel(void *boardHandle, unsign
  */
 void  FWC_sis8300_eicsys_iqfb_func_selectTrigMode(void *boardHandle, unsigned int trigMode)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_TRIG_MODE_SEL, trigMode, RFCB_DEV_USR);    
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, TRIG_MODE_SEL, trigMode);    
 }
 
 /**
@@ -230,7 +253,7 @@ void  FWC_sis8300_eicsys_iqfb_func_selectTrigMode(void *boardHandle, unsigned in
  */
 void  FWC_sis8300_eicsys_iqfb_func_setUsageStatus(void *boardHandle, unsigned int useStatus)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_USE_STATUS, useStatus, RFCB_DEV_USR);    
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, USE_STATUS, useStatus);    
 }
 
 /**
@@ -238,7 +261,7 @@ void  FWC_sis8300_eicsys_iqfb_func_setUsageStatus(void *boardHandle, unsigned in
  */
 void  FWC_sis8300_eicsys_iqfb_func_setTrigRateDiv(void *boardHandle, unsigned int trigRateDiv)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_DIV_RATIO, trigRateDiv, RFCB_DEV_USR);    
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, DIV_RATIO, trigRateDiv);    
 }
 
 /**
@@ -248,7 +271,7 @@ void  FWC_sis8300_eicsys_iqfb_func_setTrigRateDiv(void *boardHandle, unsigned in
 void  FWC_sis8300_eicsys_iqfb_func_setRefPhaSP(void *boardHandle, double phaSP_deg)
 {
     unsigned int pha = (unsigned int)(RFLIB_degToRad(phaSP_deg) * pow(2, FWC_SIS8300_EICSYS_IQFB_CONST_PHS_FRACTION));
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_REF_PHAS_SP, pha, RFCB_DEV_USR);      
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, REF_PHAS_SP, pha);      
 }
 
 /**
@@ -264,7 +287,7 @@ void  FWC_sis8300_eicsys_iqfb_func_setFbkVectorRotation(void *boardHandle, doubl
     unsigned int cs   = (unsigned int)(scale * cos(RFLIB_degToRad(rotAngle_deg)) * pow(2, FWC_SIS8300_EICSYS_IQFB_CONST_ROT_COEF_FRACTION));
     unsigned int sn   = (unsigned int)(scale * sin(RFLIB_degToRad(rotAngle_deg)) * pow(2, FWC_SIS8300_EICSYS_IQFB_CONST_ROT_COEF_FRACTION));    
     unsigned int data = (cs << 16) + (sn & 0x0000FFFF);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_ROT_COEF_FBK, data, RFCB_DEV_USR);      
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, ROT_COEF_FBK, data);      
 }
 
 /**
@@ -280,7 +303,7 @@ void  FWC_sis8300_eicsys_iqfb_func_setActVectorRotation(void *boardHandle, doubl
     unsigned int cs   = (unsigned int)(scale * cos(RFLIB_degToRad(rotAngle_deg)) * pow(2, FWC_SIS8300_EICSYS_IQFB_CONST_ROT_COEF_FRACTION));
     unsigned int sn   = (unsigned int)(scale * sin(RFLIB_degToRad(rotAngle_deg)) * pow(2, FWC_SIS8300_EICSYS_IQFB_CONST_ROT_COEF_FRACTION));    
     unsigned int data = (cs << 16) + (sn & 0x0000FFFF);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_ROT_COEF_ACT, data, RFCB_DEV_USR);     
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, ROT_COEF_ACT, data);     
 }
 
 /**
@@ -293,13 +316,13 @@ void  FWC_sis8300_eicsys_iqfb_func_setActVectorRotation(void *boardHandle, doubl
 void  FWC_sis8300_eicsys_iqfb_func_setFeedforward_I(void *boardHandle, double value_MV, double factor)
 {
     unsigned int data = (unsigned int)(value_MV * factor);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_FEEDFORWARD_I, data, RFCB_DEV_USR);     
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, FEEDFORWARD_I, data);     
 }
 
 void  FWC_sis8300_eicsys_iqfb_func_setFeedforward_Q(void *boardHandle, double value_MV, double factor)
 {
     unsigned int data = (unsigned int)(value_MV * factor);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_FEEDFORWARD_Q, data, RFCB_DEV_USR);     
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, FEEDFORWARD_Q, data);     
 }
 
 /**
@@ -311,13 +334,13 @@ void  FWC_sis8300_eicsys_iqfb_func_setFeedforward_Q(void *boardHandle, double va
 void  FWC_sis8300_eicsys_iqfb_func_setGain_I(void *boardHandle, double value)
 {
     unsigned int data = (unsigned int)(value * pow(2, FWC_SIS8300_EICSYS_IQFB_CONST_GAIN_FRACTION));
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_GAIN_I, data, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, GAIN_I, data);
 }
 
 void  FWC_sis8300_eicsys_iqfb_func_setGain_Q(void *boardHandle, double value)
 {
     unsigned int data = (unsigned int)(value * pow(2, FWC_SIS8300_EICSYS_IQFB_CONST_GAIN_FRACTION));
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_GAIN_Q, data, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, GAIN_Q, data);
 }
 
 /**
@@ -325,8 +348,8 @@ void  FWC_sis8300_eicsys_iqfb_func_setGain_Q(void *boardHandle, double value)
  */
 void  FWC_sis8300_eicsys_iqfb_func_setFeedbackCorrLimits(void *boardHandle, unsigned int limit_i, unsigned int limit_q)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_CORR_LIMIT_I, limit_i, RFCB_DEV_USR);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_CORR_LIMIT_Q, limit_q, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, CORR_LIMIT_I, limit_i);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, CORR_LIMIT_Q, limit_q);
 }
 
 /**
@@ -339,13 +362,13 @@ void  FWC_sis8300_eicsys_iqfb_func_setFeedbackCorrLimits(void *boardHandle, unsi
 void  FWC_sis8300_eicsys_iqfb_func_setIntgStart(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_INTG_START, data, RFCB_DEV_USR);       
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, INTG_START, data);       
 }
 
 void  FWC_sis8300_eicsys_iqfb_func_setIntgEnd(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_INTG_END, data, RFCB_DEV_USR);       
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, INTG_END, data);       
 }            
 
 /**
@@ -358,13 +381,13 @@ void  FWC_sis8300_eicsys_iqfb_func_setIntgEnd(void *boardHandle, double value_ns
 void  FWC_sis8300_eicsys_iqfb_func_setApplStart(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_APPL_START, data, RFCB_DEV_USR);       
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, APPL_START, data);       
 }    
 
 void  FWC_sis8300_eicsys_iqfb_func_setApplEnd(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_APPL_END, data, RFCB_DEV_USR);         
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, APPL_END, data);         
 }
 
 /**
@@ -375,12 +398,12 @@ void  FWC_sis8300_eicsys_iqfb_func_setApplEnd(void *boardHandle, double value_ns
  */
 void  FWC_sis8300_eicsys_iqfb_func_setDACOffset_I(void *boardHandle, unsigned int offset)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_OFFSET_I, offset, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, OFFSET_I, offset);
 }
 
 void  FWC_sis8300_eicsys_iqfb_func_setDACOffset_Q(void *boardHandle, unsigned int offset)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_OFFSET_Q, offset, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, OFFSET_Q, offset);
 }
 
 /**
@@ -390,12 +413,12 @@ void  FWC_sis8300_eicsys_iqfb_func_setDACOffset_Q(void *boardHandle, unsigned in
  */
 void  FWC_sis8300_eicsys_iqfb_func_setAmpLimitHi(void *boardHandle, unsigned int limit)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_AMP_LIMIT_HI , limit, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, AMP_LIMIT_HI, limit);
 }
 
 void  FWC_sis8300_eicsys_iqfb_func_setAmpLimitLo(void *boardHandle, unsigned int limit)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_AMP_LIMIT_LO , limit, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, AMP_LIMIT_LO, limit);
 }
 
 /**
@@ -407,24 +430,39 @@ void  FWC_sis8300_eicsys_iqfb_func_setAmpLimitLo(void *boardHandle, unsigned int
  *   QSPTable           : set point table for Q
  */
 void  FWC_sis8300_eicsys_iqfb_func_setIQSPTable(void *boardHandle, unsigned int pno, double *ISPTable, double *QSPTable)
+{
+    FWC_sis8300_eicsys_iqfb_func_setIQSPTableRange(boardHandle, 0, pno, ISPTable, QSPTable);
+}
+
+/**
+ * Set a region of the I/Q set point table, the other entries in the firmware are not touched. The caller holds the
+ *   lock of the table uploads (board_tabMutex), the address/data registers are shared by all tables
+ * Input:
+ *   boardHandle        : Address of the data structure of the board moudle
+ *   start              : First entry of the region
+ *   pno                : Number of the points of the region
+ *   ISPTable           : set point table for I (the whole table, only the entries in the region are used)
+ *   QSPTable           : set point table for Q
+ */
+void  FWC_sis8300_eicsys_iqfb_func_setIQSPTableRange(void *boardHandle, unsigned int start, unsigned int pno, double *ISPTable, double *QSPTable)
 {
     unsigned int i;
     unsigned int Idata;
     unsigned int Qdata;
     unsigned int data;
       
-    for(i = 0; i < pno; i ++) {
+    for(i = start; i < start + pno; i ++) {
         /* Make up the data */
         Idata = (unsigned int)(*(ISPTable + i));
         Qdata = (unsigned int)(*(QSPTable + i)); 
         data = (Idata << 16) + (Qdata & 0x0000FFFF);
 
         /* Write to the firmware via two registers */
-        RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_BUF_WR_ADDR, CON_SIS8300_EICSYS_IQFB_IQ_SP_TABLE_OFFSET + i, RFCB_DEV_USR);         /* address */
-        RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_BUF_WR_DATA, data, RFCB_DEV_USR);                                                   /* data */        
+        FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, BUF_WR_ADDR, CON_SIS8300_EICSYS_IQFB_IQ_SP_TABLE_OFFSET + i);         /* address */
+        FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, BUF_WR_DATA, data);                                                   /* data */        
     }
     
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_BUF_WR_ADDR, 0, RFCB_DEV_USR);      /* disable the writing */    
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, BUF_WR_ADDR, 0);      /* disable the writing */    
 }
 
 /**
@@ -450,11 +488,11 @@ void  FWC_sis8300_eicsys_iqfb_func_setDrvRotationTable(void *boardHandle, unsign
         data = (cs << 16) + (sn & 0x0000FFFF);
 
         /* Write to the firmware via two registers */
-        RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_BUF_WR_ADDR, CON_SIS8300_EICSYS_IQFB_DRV_ROT_TABLE_OFFSET + i, RFCB_DEV_USR);       /* address */
-        RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_BUF_WR_DATA, data, RFCB_DEV_USR);                                                   /* data */        
+        FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, BUF_WR_ADDR, CON_SIS8300_EICSYS_IQFB_DRV_ROT_TABLE_OFFSET + i);       /* address */
+        FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, BUF_WR_DATA, data);                                                   /* data */        
     }
     
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_BUF_WR_ADDR, 0, RFCB_DEV_USR);      /* disable the writing */    
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, BUF_WR_ADDR, 0);      /* disable the writing */    
 }
 
 /** 
@@ -462,7 +500,7 @@ void  FWC_sis8300_eicsys_iqfb_func_setDrvRotationTable(void *boardHandle, unsign
  */
 void  FWC_sis8300_eicsys_iqfb_func_setNonIQCoefOffset(void *boardHandle, unsigned int offset)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_COEF_ID_OFF, offset, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, COEF_ID_OFF, offset);
 }
 
 /**
@@ -485,8 +523,8 @@ void  FWC_sis8300_eicsys_iqfb_func_setImbalanceCorrMatrix(void *boardHandle, dou
     a1x   = (hw1x << 16) + (lw1x & 0x0000FFFF);
     a2x   = (hw2x << 16) + (lw2x & 0x0000FFFF);
 
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_IMBALANCE_MATRIX_A1X, a1x, RFCB_DEV_USR);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_IMBALANCE_MATRIX_A2X, a2x, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, IMBALANCE_MATRIX_A1X, a1x);
+    FWC_SIS8300_EICSYS_IQFB_REG_WRITE(boardHandle, IMBALANCE_MATRIX_A2X, a2x);
 }
 
 /*-------------------------------------------------------------
@@ -500,8 +538,8 @@ void FWC_sis8300_eicsys_iqfb_func_getAppFwInfo(void *boardHandle, unsigned int *
     unsigned int var_version;
     
     /* read the registers */    
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_FRIMWARE_NAME,     firmwareName, RFCB_DEV_USR);
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_FIRMWARE_VERSION,  &var_version, RFCB_DEV_USR);    
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, FRIMWARE_NAME,     firmwareName);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, FIRMWARE_VERSION,  &var_version);    
 
     /* build up the data */   
     *majorVer   = (var_version >> 24) & 0xFF;
@@ -514,7 +552,7 @@ void FWC_sis8300_eicsys_iqfb_func_getAppFwInfo(void *boardHandle, unsigned int *
  */
 void  FWC_sis8300_eicsys_iqfb_func_getUsageStatus(void *boardHandle, unsigned int *useStatus)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_USE_STATUS, useStatus, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, USE_STATUS, useStatus);
 }
 
 /**
@@ -522,9 +560,9 @@ void  FWC_sis8300_eicsys_iqfb_func_getUsageStatus(void *boardHandle, unsigned in
  */
 void  FWC_sis8300_eicsys_iqfb_func_getRaceConditionFlags(void *boardHandle, unsigned int *accFlags, unsigned int *stdbyFlags, unsigned int *spareFlags)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_RCFLAGS_ACC,   accFlags, RFCB_DEV_USR);
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_RCFLAGS_STDBY, stdbyFlags, RFCB_DEV_USR);
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_RCFLAGS_SPARE, spareFlags, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, RCFLAGS_ACC,   accFlags);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, RCFLAGS_STDBY, stdbyFlags);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, RCFLAGS_SPARE, spareFlags);
 }
 
 /**
@@ -532,7 +570,7 @@ void  FWC_sis8300_eicsys_iqfb_func_getRaceConditionFlags(void *boardHandle, unsi
  */
 void FWC_sis8300_eicsys_iqfb_func_getPulseCounter(void *boardHandle, unsigned int *pulseCnt)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_PUL_CNT, pulseCnt, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, PUL_CNT, pulseCnt);
 }
 
 /**
@@ -541,7 +579,7 @@ void FWC_sis8300_eicsys_iqfb_func_getPulseCounter(void *boardHandle, unsigned in
 void  FWC_sis8300_eicsys_iqfb_func_getMeaTrigPeriod(void *boardHandle, double *value_ms, double freq_MHz)
 {
     unsigned int data;
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_DIAG_TRIG_PERIOD, &data, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, DIAG_TRIG_PERIOD, &data);
     *value_ms = (double)data / freq_MHz / 1000.0;
 }
 
@@ -550,7 +588,7 @@ void  FWC_sis8300_eicsys_iqfb_func_getMeaTrigPeriod(void *boardHandle, double *v
  */
 void  FWC_sis8300_eicsys_iqfb_func_getNonIQCoefCur(void *boardHandle, unsigned int *cur)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_COEF_ID_TRIG, cur, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, COEF_ID_TRIG, cur);
 }
 
 /**
@@ -558,7 +596,7 @@ void  FWC_sis8300_eicsys_iqfb_func_getNonIQCoefCur(void *boardHandle, unsigned i
  */
 void  FWC_sis8300_eicsys_iqfb_func_getWatchDogCnt(void *boardHandle, unsigned int *cnt)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_WD_CNT, cnt, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, WD_CNT, cnt);
 }
 
 /**
@@ -566,19 +604,61 @@ void  FWC_sis8300_eicsys_iqfb_func_getWatchDogCnt(void *boardHandle, unsigned in
  */
 void  FWC_sis8300_eicsys_iqfb_func_getFwStatus(void *boardHandle, unsigned int *platformStatus, unsigned int *RFCtrlStatus)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_PLATFORM_STATUS, platformStatus, RFCB_DEV_USR);
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_EICSYS_IQFB_REG_ADDR_RFCTRL_STATUS,   RFCtrlStatus, RFCB_DEV_USR);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, PLATFORM_STATUS, platformStatus);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, RFCTRL_STATUS,   RFCtrlStatus);
+}
+
+/**
+ * Read all status registers, the neighbouring registers are read with one block read (the global block and two parts
+ *   of the trigger block), the others one by one
+ * Input:
+ *   boardHandle        : Address of the data structure of the board moudle
+ * Output:
+ *   status             : Snapshot of the status registers
+ */
+void FWC_sis8300_eicsys_iqfb_func_getStatusSnapshot(void *boardHandle, FWC_sis8300_eicsys_iqfb_struc_status *status)
+{
+    unsigned int var_global[3];                             /* WD_CNT, PLATFORM_STATUS, USE_STATUS */
+    unsigned int var_RCFlags[3];                            /* RCFLAGS_ACC, RCFLAGS_STDBY, RCFLAGS_SPARE */
+    unsigned int var_trig[2];                               /* DIAG_TRIG_PERIOD, PUL_CNT */
+
+    if(!status) return;
+
+    memset(var_global,  0, sizeof(var_global));
+    memset(var_RCFlags, 0, sizeof(var_RCFlags));
+    memset(var_trig,    0, sizeof(var_trig));
+
+    FWC_SIS8300_EICSYS_IQFB_REG_READ_BLOCK(boardHandle, WD_CNT,           3, var_global);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ_BLOCK(boardHandle, RCFLAGS_ACC,      3, var_RCFlags);
+    FWC_SIS8300_EICSYS_IQFB_REG_READ_BLOCK(boardHandle, DIAG_TRIG_PERIOD, 2, var_trig);
+
+    status -> WDCnt          = var_global[(CON_SIS8300_EICSYS_IQFB_REG_ADDR_WD_CNT          - CON_SIS8300_EICSYS_IQFB_REG_ADDR_WD_CNT) / FWC_SIS8300_EICSYS_IQFB_CONST_REG_STRIDE];
+    status -> platformStatus = var_global[(CON_SIS8300_EICSYS_IQFB_REG_ADDR_PLATFORM_STATUS - CON_SIS8300_EICSYS_IQFB_REG_ADDR_WD_CNT) / FWC_SIS8300_EICSYS_IQFB_CONST_REG_STRIDE];
+    status -> useStatus      = var_global[(CON_SIS8300_EICSYS_IQFB_REG_ADDR_USE_STATUS      - CON_SIS8300_EICSYS_IQFB_REG_ADDR_WD_CNT) / FWC_SIS8300_EICSYS_IQFB_CONST_REG_STRIDE];
+
+    status -> RCFlagsAcc     = var_RCFlags[(CON_SIS8300_EICSYS_IQFB_REG_ADDR_RCFLAGS_ACC   - CON_SIS8300_EICSYS_IQFB_REG_ADDR_RCFLAGS_ACC) / FWC_SIS8300_EICSYS_IQFB_CONST_REG_STRIDE];
+    status -> RCFlagsStdby   = var_RCFlags[(CON_SIS8300_EICSYS_IQFB_REG_ADDR_RCFLAGS_STDBY - CON_SIS8300_EICSYS_IQFB_REG_ADDR_RCFLAGS_ACC) / FWC_SIS8300_EICSYS_IQFB_CONST_REG_STRIDE];
+    status -> RCFlagsSpare   = var_RCFlags[(CON_SIS8300_EICSYS_IQFB_REG_ADDR_RCFLAGS_SPARE - CON_SIS8300_EICSYS_IQFB_REG_ADDR_RCFLAGS_ACC) / FWC_SIS8300_EICSYS_IQFB_CONST_REG_STRIDE];
+
+    status -> trigPeriod     = var_trig[(CON_SIS8300_EICSYS_IQFB_REG_ADDR_DIAG_TRIG_PERIOD - CON_SIS8300_EICSYS_IQFB_REG_ADDR_DIAG_TRIG_PERIOD) / FWC_SIS8300_EICSYS_IQFB_CONST_REG_STRIDE];
+    status -> pulseCnt       = var_trig[(CON_SIS8300_EICSYS_IQFB_REG_ADDR_PUL_CNT          - CON_SIS8300_EICSYS_IQFB_REG_ADDR_DIAG_TRIG_PERIOD) / FWC_SIS8300_EICSYS_IQFB_CONST_REG_STRIDE];
+
+    FWC_SIS8300_EICSYS_IQFB_REG_READ(boardHandle, RFCTRL_STATUS, &status -> RFCtrlStatus);
 }
 
 /**
  * Get all DAQ data from the FPGA
  * Input:
  *   boardHandle        : Address of the data structure of the board moudle
- *   pno                : Point number to be read (may be updated by CA put)
- *   pno_old            : Old point number match to the DMA transfer size and memery map size
+ *   pno                : Point number to be read, matching the DAQ size when the data was captured
+ *   offset             : Point offset of the data in the DMA pool (start of the capture bank)
+ *   seg                : Segments to copy (regions of interest), placed at the same position of the buffers as the full
+ *                        readout, the other points are not touched
+ *   segNum             : Number of segments, 0 to copy all points
  *   *data*             : Buffer to store the data, not the buffer should be large enough to store all data
  */
-void  FWC_sis8300_eicsys_iqfb_func_getAllDAQData(void *boardHandle, unsigned int pno, unsigned int pno_old,                            
+void  FWC_sis8300_eicsys_iqfb_func_getAllDAQData(void *boardHandle, unsigned int pno, unsigned int offset,
+                                                            const RFCFW_struc_roiSeg *seg, int segNum,
                                                             short *ADC0Data, short *ADC1Data,                               /* fixed for Ch0 and Ch1 */            
                                                             short *ADC2Data, short *ADC3Data,                               /* fixed for Ch2 and Ch3 */  
                                                             short *ADC4Data, short *ADC5Data,                               /* fixed for Ch4 and Ch5 */  
@@ -588,11 +668,14 @@ void  FWC_sis8300_eicsys_iqfb_func_getAllDAQData(void *boardHandle, unsigned int
                                                             short *dataCh12, short *dataCh13,                               /* Ch12 - fbk_i or act_i; Ch13 - fbk_q or act_q */
                                                             short *dataCh14, short *dataCh15)                               /* Ch14 - tracked_i or dac_i; Ch11 - tracked_q or dac_q */
 {
-    int i;
+    int i, j;
     unsigned int bufSize, loc_pno;
+    unsigned int var_start, var_end;
     short *bufDAQ = NULL;
 	
     /* check the input */
+    if(!seg) segNum = 0;
+
     if(!boardHandle ||
        !ADC0Data || !ADC1Data || !ADC2Data || !ADC3Data || !ADC4Data || !ADC5Data || !ADC6Data || !ADC7Data || !ADC8Data || !ADC9Data ||
        !dataCh10 || !dataCh11 || !dataCh12 || !dataCh13 || !dataCh14 || !dataCh15) return;
@@ -603,45 +686,74 @@ void  FWC_sis8300_eicsys_iqfb_func_getAllDAQData(void *boardHandle, unsigned int
     /* get the DMA pool address and current transfer size */
     bufDAQ = (short *)RFCB_API_getDMADataPoolPtr(board, &bufSize);
 
-    /* handle the point number (each point has 16 2-byte data) */
-	if(pno_old > bufSize / 32) 
-       loc_pno = (unsigned int)(bufSize / 32);
+    /* handle the point number (each point has 16 2-byte data), the data must be inside the mapped pool */
+    if(offset >= bufSize / 32)
+       loc_pno = 0;
+    else if(pno > bufSize / 32 - offset) 
+       loc_pno = (unsigned int)(bufSize / 32 - offset);
     else
-       loc_pno = pno_old;
+       loc_pno = pno;
 
-    /* get the data */
+    /* get the data, the full readout is a single segment */
     if(bufDAQ && loc_pno > 0) {
-    	for(i = 0; i < loc_pno; i ++) {
-            *(ADC0Data + i) = *(bufDAQ + 16 * i + 8);
-            *(ADC1Data + i) = *(bufDAQ + 16 * i + 9);
-            *(ADC2Data + i) = *(bufDAQ + 16 * i + 10);
-            *(ADC3Data + i) = *(bufDAQ + 16 * i + 11);
-            *(ADC4Data + i) = *(bufDAQ + 16 * i + 12);
-            *(ADC5Data + i) = *(bufDAQ + 16 * i + 13);
-            *(ADC6Data + i) = *(bufDAQ + 16 * i + 14);
-            *(ADC7Data + i) = *(bufDAQ + 16 * i + 15);
-            *(ADC8Data + i) = *(bufDAQ + 16 * i + 0);
-            *(ADC9Data + i) = *(bufDAQ + 16 * i + 1);
-            *(dataCh10 + i) = *(bufDAQ + 16 * i + 2);
-            *(dataCh11 + i) = *(bufDAQ + 16 * i + 3);
-            *(dataCh12 + i) = *(bufDAQ + 16 * i + 4);
-            *(dataCh13 + i) = *(bufDAQ + 16 * i + 5);
-            *(dataCh14 + i) = *(bufDAQ + 16 * i + 6);
-            *(dataCh15 + i) = *(bufDAQ + 16 * i + 7);
+        bufDAQ += 16 * offset;
+
+        for(j = 0; j < (segNum > 0 ? segNum : 1); j ++) {
+            if(segNum > 0) {
+                var_start = (unsigned int)seg[j].start;
+                var_end   = (unsigned int)(seg[j].start + seg[j].pno);
+                if(var_end > loc_pno) var_end = loc_pno;
+            } else {
+                var_start = 0;
+                var_end   = loc_pno;
+            }
+
+            for(i = (int)var_start; i < (int)var_end; i ++) {
+                *(ADC0Data + i) = *(bufDAQ + 16 * i + 8);
+                *(ADC1Data + i) = *(bufDAQ + 16 * i + 9);
+                *(ADC2Data + i) = *(bufDAQ + 16 * i + 10);
+                *(ADC3Data + i) = *(bufDAQ + 16 * i + 11);
+                *(ADC4Data + i) = *(bufDAQ + 16 * i + 12);
+                *(ADC5Data + i) = *(bufDAQ + 16 * i + 13);
+                *(ADC6Data + i) = *(bufDAQ + 16 * i + 14);
+                *(ADC7Data + i) = *(bufDAQ + 16 * i + 15);
+                *(ADC8Data + i) = *(bufDAQ + 16 * i + 0);
+                *(ADC9Data + i) = *(bufDAQ + 16 * i + 1);
+                *(dataCh10 + i) = *(bufDAQ + 16 * i + 2);
+                *(dataCh11 + i) = *(bufDAQ + 16 * i + 3);
+                *(dataCh12 + i) = *(bufDAQ + 16 * i + 4);
+                *(dataCh13 + i) = *(bufDAQ + 16 * i + 5);
+                *(dataCh14 + i) = *(bufDAQ + 16 * i + 6);
+                *(dataCh15 + i) = *(bufDAQ + 16 * i + 7);
+            }
         }
+
+        /* the DMA pool is the buffer read (16 2-byte data per point) */
+        RFCFW_REG_TRACE(boardHandle, RFCFW_CONST_REG_TRACE_BUF_READ, offset * 32, *(unsigned int *)bufDAQ, loc_pno * 8, RFCB_DEV_DMA);
     } 
+}
 
-    /* set up the DMA for next pulse if the new pno is different than the old pno */
-    if(pno != pno_old) {
-        /* reuse the variable of loc_pno, limit the size to the maximum size of DMA pool (4MBytes) */
-    	if(pno > RFCB_EICSYS_CONST_DMA_POOL_SIZE / 32) 
-            loc_pno = (unsigned int)(RFCB_EICSYS_CONST_DMA_POOL_SIZE / 32);
-        else
-            loc_pno = pno;
-   
-        /* setup DMA, set the transfer size and remap the memory */
-        if(RFCB_API_setupDMA(board, 0, loc_pno * 32) != 0) return;
-    }
+/**
+ * Set up the DMA for next pulse if the new map size is different than the old one
+ * Input:
+ *   boardHandle        : Address of the data structure of the board moudle
+ *   mapPno             : Point number of the DMA pool to map for the next pulse (may be updated by CA put or the ping-pong)
+ *   mapPno_old         : Point number of the DMA pool currently mapped (DMA transfer size and memery map size)
+ */
+void  FWC_sis8300_eicsys_iqfb_func_setDAQMap(void *boardHandle, unsigned int mapPno, unsigned int mapPno_old)
+{
+    unsigned int loc_pno;
+
+    if(!boardHandle || mapPno == mapPno_old) return;
+
+    /* limit the size to the maximum size of DMA pool (4MBytes) */
+    if(mapPno > RFCB_EICSYS_CONST_DMA_POOL_SIZE / 32) 
+        loc_pno = (unsigned int)(RFCB_EICSYS_CONST_DMA_POOL_SIZE / 32);
+    else
+        loc_pno = mapPno;
+
+    /* setup DMA, set the transfer size and remap the memory */
+    RFCB_API_setupDMA((RFCB_struc_moduleData *)boardHandle, 0, loc_pno * 32);
 }
 
 
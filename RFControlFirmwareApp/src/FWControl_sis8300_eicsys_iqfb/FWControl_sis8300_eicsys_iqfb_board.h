@@ -29,6 +29,8 @@
 #include "RFControlBoard_availableInterface.h"                                          /* only point to interact with the RFControlBoard module */                     
 #include "addrMap_sis8300_eicsys_iqfb.h"                                                /* use the address map here */
 #include "RFLib_signalProcess.h"
+#include "RFControlFirmware_regAccess.h"                                               /* register accessors generated from the address map */
+#include "RFControlFirmware_roi.h"                                                     /* segments of the readout */
 
 /**
  * Constants for board access 
@@ -42,11 +44,43 @@
 #define FWC_SIS8300_EICSYS_IQFB_CONST_DRV_TAB_BUF_DEPTH CON_SIS8300_EICSYS_IQFB_DRV_ROT_TAB_DEPTH           /* buffer length for writing to FPGA (for driving chain rotation) */
 
 #define FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX    65536                                               /* 64k points (65536) */
+#define FWC_SIS8300_EICSYS_IQFB_CONST_DAQ_BANK_PNO      (RFCB_EICSYS_CONST_DMA_POOL_SIZE / 32 / 2)          /* max. points of a capture bank, 2 banks fit in the DMA pool for ping-pong */
+#define FWC_SIS8300_EICSYS_IQFB_CONST_DAQ_ADDR_PER_PNO  1                                                   /* steps of the DAQ address per point (256 bits), the address counts in points as the DAQ size */
+
+#define FWC_SIS8300_EICSYS_IQFB_CONST_REG_DEVICE     RFCB_DEV_USR                                        /* device of the application firmware registers */
+#define FWC_SIS8300_EICSYS_IQFB_CONST_REG_STRIDE     4                                                   /* address step between two neighbouring registers */
+
+#define FWC_SIS8300_EICSYS_IQFB_CONST_FW_NAME_ID     0x00000000                                          /* detection: firmware name of the application firmware, not fixed by the address map, */
+#define FWC_SIS8300_EICSYS_IQFB_CONST_FW_NAME_MASK   0x00000000                                          /*   set with RFCFW_setBackendFwId for the deployed firmware */
+
+/**
+ * Register accessors, the register is given by the name in the address map without the prefix, e.g. SWITCH_CTRL
+ */
+#define FWC_SIS8300_EICSYS_IQFB_REG_WRITE(handle, reg, data)  RFCFW_REG_WRITE(SIS8300_EICSYS_IQFB, FWC_SIS8300_EICSYS_IQFB_CONST_REG_DEVICE, handle, reg, data)
+#define FWC_SIS8300_EICSYS_IQFB_REG_READ(handle, reg, ptr)    RFCFW_REG_READ(SIS8300_EICSYS_IQFB, FWC_SIS8300_EICSYS_IQFB_CONST_REG_DEVICE, handle, reg, ptr)
+#define FWC_SIS8300_EICSYS_IQFB_REG_READ_BLOCK(handle, reg, num, ptr)  RFCFW_REG_READ_BLOCK(SIS8300_EICSYS_IQFB, FWC_SIS8300_EICSYS_IQFB_CONST_REG_DEVICE, FWC_SIS8300_EICSYS_IQFB_CONST_REG_STRIDE, handle, reg, num, ptr)
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Snapshot of the status registers, read together with block reads of the neighbouring registers
+ */
+typedef struct {
+    unsigned int WDCnt;                                     /* global block */
+    unsigned int platformStatus;
+    unsigned int useStatus;
+
+    unsigned int RCFlagsAcc;                                /* trigger block */
+    unsigned int RCFlagsStdby;
+    unsigned int RCFlagsSpare;
+    unsigned int trigPeriod;                                /* measured trigger period in sampling clocks */
+    unsigned int pulseCnt;
+
+    unsigned int RFCtrlStatus;                              /* RF control block */
+} FWC_sis8300_eicsys_iqfb_struc_status;
+
 /**
  * Interface functions
  */
@@ -61,7 +95,7 @@ void FWC_sis8300_eicsys_iqfb_func_getBoardInfo(void *boardHandle, char *deviceNa
 /*--------------------------
  * platform firmware 
  *-------------------------- */                    
-void FWC_sis8300_eicsys_iqfb_func_setSPI(void *boardHandle, unsigned int clkDiv2);                                          /* set the clock divider, ADC chips and DAC chips (with fixed value,later can make it changable) */
+int  FWC_sis8300_eicsys_iqfb_func_setSPI(void *boardHandle, unsigned int clkDiv2);                                          /* set the clock divider, ADC chips and DAC chips (with fixed value,later can make it changable) */
 void FWC_sis8300_eicsys_iqfb_func_setADCClockSource(void *boardHandle, unsigned int src);
 void FWC_sis8300_eicsys_iqfb_func_getPlatformInfo(void *boardHandle,                                                        /* get the board/platform firmware basic info, including the clock frequencies */
                                                   unsigned int *id, 
@@ -82,6 +116,7 @@ void FWC_sis8300_eicsys_iqfb_func_getPlatformInfo(void *boardHandle,
 /* Fimrware settings */
 __inline__ void  FWC_sis8300_eicsys_iqfb_func_setBits(void *boardHandle, unsigned int data);                                /* set the register for bits (switch control in the firmware) */
 __inline__ void  FWC_sis8300_eicsys_iqfb_func_getBits(void *boardHandle, unsigned int *data); 
+__inline__ void  FWC_sis8300_eicsys_iqfb_func_setDAQShareSel(void *boardHandle, unsigned int sel);                          /* select the internal data shared to the DAQ */
 
 __inline__ void  FWC_sis8300_eicsys_iqfb_func_setDAQ(void *boardHandle, unsigned int offset, unsigned int pno);             /* set the DAQ offset and point number (for 256 bits) in FPGA */
 
@@ -125,6 +160,7 @@ __inline__ void  FWC_sis8300_eicsys_iqfb_func_setAmpLimitHi(void *boardHandle,
 __inline__ void  FWC_sis8300_eicsys_iqfb_func_setAmpLimitLo(void *boardHandle,  unsigned int limit);
 
 __inline__ void  FWC_sis8300_eicsys_iqfb_func_setIQSPTable(void *boardHandle, unsigned int pno, double *ISPTable, double *QSPTable);                        /* set the set point table */
+__inline__ void  FWC_sis8300_eicsys_iqfb_func_setIQSPTableRange(void *boardHandle, unsigned int start, unsigned int pno, double *ISPTable, double *QSPTable);  /* set a region of the set point table */
 __inline__ void  FWC_sis8300_eicsys_iqfb_func_setDrvRotationTable(void *boardHandle, unsigned int pno, double *scaleTable, double *rotAngleTable_deg);      /* set the driving chain rotation table */
 
 __inline__ void  FWC_sis8300_eicsys_iqfb_func_setNonIQCoefOffset(void *boardHandle, unsigned int offset);                                                   /* set the offset for non-IQ demodulation coefficients */
@@ -146,7 +182,11 @@ __inline__ void  FWC_sis8300_eicsys_iqfb_func_getNonIQCoefCur(void *boardHandle,
 __inline__ void  FWC_sis8300_eicsys_iqfb_func_getWatchDogCnt(void *boardHandle, unsigned int *cnt);
 __inline__ void  FWC_sis8300_eicsys_iqfb_func_getFwStatus(void *boardHandle, unsigned int *platformStatus, unsigned int *RFCtrlStatus);
 
-__inline__ void  FWC_sis8300_eicsys_iqfb_func_getAllDAQData(void *boardHandle, unsigned int pno, unsigned int pno_old,      /* data from DRAM */
+void FWC_sis8300_eicsys_iqfb_func_getStatusSnapshot(void *boardHandle, FWC_sis8300_eicsys_iqfb_struc_status *status);                     /* read all status registers */
+
+__inline__ void  FWC_sis8300_eicsys_iqfb_func_setDAQMap(void *boardHandle, unsigned int mapPno, unsigned int mapPno_old);  /* DMA pool for the next pulse */
+__inline__ void  FWC_sis8300_eicsys_iqfb_func_getAllDAQData(void *boardHandle, unsigned int pno, unsigned int offset,       /* data from DRAM */
+                                                            const RFCFW_struc_roiSeg *seg, int segNum,
                                                             short *ADC0Data, short *ADC1Data,                               /* fixed for Ch0 and Ch1 */            
                                                             short *ADC2Data, short *ADC3Data,                               /* fixed for Ch2 and Ch3 */  
                                                             short *ADC4Data, short *ADC5Data,                               /* fixed for Ch4 and Ch5 */  
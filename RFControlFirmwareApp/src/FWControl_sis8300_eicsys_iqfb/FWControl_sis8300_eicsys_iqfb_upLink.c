@@ -20,36 +20,20 @@
 #include <string.h>
 
 #include "InternalData.h"                                               /* to create EPICS data node */
+#include "RFControlFirmware_config.h"                                    /* configuration snapshot */
 #include "FWControl_sis8300_eicsys_iqfb_upLink.h"
 #include "FWControl_sis8300_eicsys_iqfb_board.h"
 
 /*======================================
- * Private Data and Routines - call backs
+ * Private Data and Routines - write the settings (shared by the call backs and the restore of the configuration)
  *======================================*/
-/* Write callback function, set the SPI (AD9510, ADC, DAC) */
-static void w_setSPI(void *ptr)
-{
-    INTD_struc_node *dataNode = (INTD_struc_node *)ptr;
-    
-    if(!dataNode) return; 
-    FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
-
-    if(arg && arg -> board_handle && arg -> board_setupSPI == 1) {
-        FWC_sis8300_eicsys_iqfb_func_setSPI(arg -> board_handle, (unsigned int)arg -> board_clkDiv2);        
-    }
-}
-
-/* Write callback function, set bits (lower to higher) */
-static void w_setBits(void *ptr)
+/* Write the control bits (lower to higher) */
+static void FWC_sis8300_eicsys_iqfb_func_writeBits(FWC_sis8300_eicsys_iqfb_struc_data *arg)
 {
-    INTD_struc_node *dataNode = (INTD_struc_node *)ptr;
-    
-    if(!dataNode) return; 
-    FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
-
     unsigned int data;
 
-	if(arg && arg -> board_handle) {
+	if(arg -> board_handle) {
+        if(arg -> board_switchMutex) epicsMutexMustLock(arg -> board_switchMutex);
         FWC_sis8300_eicsys_iqfb_func_getBits(arg->board_handle, &data);
 
 		data &= 0x00000240;									/* keep bit 6 (IRQ latency counter) and bit 9 (DAQ enable) */
@@ -66,43 +50,94 @@ static void w_setBits(void *ptr)
         data += arg -> board_edgeSelSpare           << 18; 
     
         FWC_sis8300_eicsys_iqfb_func_setBits(arg -> board_handle, data);
+        if(arg -> board_switchMutex) epicsMutexUnlock(arg -> board_switchMutex);
     }
 }
 
-/* Read callback function, get the firmware info */
-static void r_getFwInfo(void *ptr)
+/* Write the timing of the board and build up the time axis of the waveforms */
+static void FWC_sis8300_eicsys_iqfb_func_writeTiming(FWC_sis8300_eicsys_iqfb_struc_data *arg)
+{
+    int i;
+
+    if(arg -> board_handle) {
+        /* set the timing items in the board */
+        FWC_sis8300_eicsys_iqfb_func_setExtTrigDelayAcc(arg -> board_handle,   arg -> board_extTriggerDelayAcc_ns,    arg -> board_sampleFreq_MHz);
+	    FWC_sis8300_eicsys_iqfb_func_setExtTrigDelayStdby(arg -> board_handle, arg -> board_extTriggerDelayStdby_ns,  arg -> board_sampleFreq_MHz);
+	    FWC_sis8300_eicsys_iqfb_func_setExtTrigDelaySpare(arg -> board_handle, arg -> board_extTriggerDelaySpare_ns,  arg -> board_sampleFreq_MHz);
+        FWC_sis8300_eicsys_iqfb_func_setIntTrigPeriod(arg -> board_handle,     arg -> board_intTriggerPeriod_ms,      arg -> board_sampleFreq_MHz);
+        FWC_sis8300_eicsys_iqfb_func_setRFPulseLength(arg -> board_handle,     arg -> board_RFPulseLength_ns,         arg -> board_sampleFreq_MHz);
+        FWC_sis8300_eicsys_iqfb_func_setDAQTrigDelay(arg -> board_handle,      arg -> board_DAQTriggerDelay_ns,       arg -> board_sampleFreq_MHz);
+        FWC_sis8300_eicsys_iqfb_func_setIntgStart(arg -> board_handle,         arg -> board_intgStart_ns,             arg -> board_sampleFreq_MHz);
+        FWC_sis8300_eicsys_iqfb_func_setIntgEnd(arg -> board_handle,           arg -> board_intgEnd_ns,               arg -> board_sampleFreq_MHz);
+        FWC_sis8300_eicsys_iqfb_func_setApplStart(arg -> board_handle,         arg -> board_applyStart_ns,            arg -> board_sampleFreq_MHz);
+        FWC_sis8300_eicsys_iqfb_func_setApplEnd(arg -> board_handle,           arg -> board_applyEnd_ns,              arg -> board_sampleFreq_MHz);
+        
+        /* build up the time axis for waveforms */
+        for(i = 0; i < FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX; i ++) {
+            arg->DAQTimeAxis_ns[i] = i * 1000 / arg -> board_sampleFreq_MHz + arg -> board_DAQTriggerDelay_ns;
+        }        
+
+        for(i = 0; i < FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX; i ++) {
+            arg->ADCTimeAxis_ns[i] = i * 1000 / arg -> board_sampleFreq_MHz + arg -> board_DAQTriggerDelay_ns;
+        }       
+                
+        /* set the average parameters for waveforms */       
+        arg->rfData_refCh.sampleFreq_MHz         = arg -> board_sampleFreq_MHz;
+        arg->rfData_fbkCh.sampleFreq_MHz         = arg -> board_sampleFreq_MHz;
+        
+        arg->rfData_tracked.sampleFreq_MHz       = arg -> board_sampleFreq_MHz;
+        arg->rfData_err.sampleFreq_MHz           = arg -> board_sampleFreq_MHz;
+        
+        arg->rfData_act.sampleFreq_MHz           = arg -> board_sampleFreq_MHz;
+        arg->rfData_DACOut.sampleFreq_MHz        = arg -> board_sampleFreq_MHz;
+                        
+        arg->rfData_refCh.sampleDelay_ns         = arg -> board_DAQTriggerDelay_ns;
+        arg->rfData_fbkCh.sampleDelay_ns         = arg -> board_DAQTriggerDelay_ns;
+               
+        arg->rfData_tracked.sampleDelay_ns       = arg -> board_DAQTriggerDelay_ns;
+        arg->rfData_err.sampleDelay_ns           = arg -> board_DAQTriggerDelay_ns;
+        
+        arg->rfData_act.sampleDelay_ns           = arg -> board_DAQTriggerDelay_ns;
+        arg->rfData_DACOut.sampleDelay_ns        = arg -> board_DAQTriggerDelay_ns;
+    }
+}
+
+/*======================================
+ * Private Data and Routines - call backs
+ *======================================*/
+/* Write callback function, set the SPI (AD9510, ADC, DAC) */
+static void w_setSPI(void *ptr)
 {
     INTD_struc_node *dataNode = (INTD_struc_node *)ptr;
     
     if(!dataNode) return; 
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
-       
-    unsigned int firmwareName;
-    unsigned int majorVer;
-    unsigned int minorVer;
-    unsigned int buildNum;
-
-    int deviceOpened;
 
-    unsigned int platformFwId;
+    if(arg && arg -> board_handle && arg -> board_setupSPI == 1) {
+        FWC_sis8300_eicsys_iqfb_func_setSPI(arg -> board_handle, (unsigned int)arg -> board_clkDiv2);        
+    }
+}
 
-    if(arg && arg -> board_handle) {        
-        FWC_sis8300_eicsys_iqfb_func_getAppFwInfo(arg -> board_handle, &firmwareName, &majorVer, &minorVer, &buildNum);
-        FWC_sis8300_eicsys_iqfb_func_getBoardInfo(arg -> board_handle, arg -> board_deviceName, &deviceOpened);
-        FWC_sis8300_eicsys_iqfb_func_getPlatformInfo(arg -> board_handle, &platformFwId, arg -> board_FPGAType, arg -> board_platformFwCompileTime,
-                                                     &arg -> board_clkMainFreq_MHz, &arg -> board_clkExt0Freq_MHz, &arg -> board_clkExt1Freq_MHz, 
-                                                     &arg -> board_clkDDR00Freq_MHz, &arg -> board_clkDDR90Freq_MHz, &arg -> board_clkDDRDvFreq_MHz, 
-                                                     &arg -> board_clkIDelayFreq_MHz, &arg ->board_clkSPIFreq_MHz);
+/* Write callback function, set bits (lower to higher) */
+static void w_setBits(void *ptr)
+{
+    INTD_struc_node *dataNode = (INTD_struc_node *)ptr;
+    
+    if(!dataNode) return; 
+    FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
-        arg -> board_firmwareName   = (long)firmwareName;
-        arg -> board_majorVer       = (long)majorVer;
-        arg -> board_minorVer       = (long)minorVer;
-        arg -> board_buildNum       = (long)buildNum;
+    if(arg) FWC_sis8300_eicsys_iqfb_func_writeBits(arg);
+}
 
-        arg -> board_deviceOpened   = (long)deviceOpened;
+/* Read callback function, get the firmware info */
+static void r_getFwInfo(void *ptr)
+{
+    INTD_struc_node *dataNode = (INTD_struc_node *)ptr;
+    
+    if(!dataNode) return; 
+    FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
-        arg -> board_platformFwId   = (long)platformFwId;
-    }
+    if(arg) FWC_sis8300_eicsys_iqfb_func_readFwInfo(arg);
 }
 
 /* Read callback function, get the firmware status (handle all 1s reading) */
@@ -113,34 +148,17 @@ static void r_getFwStatus(void *ptr)
     if(!dataNode) return; 
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
-    unsigned int pulCnt;
-    unsigned int ADCClkWdCnt;
-    unsigned int platformStatus;
-    unsigned int usageStatus;
-    unsigned int RFCtrlStatus;
-    double triggerPeriod;
-
 	unsigned int data;
 
     if(arg && arg -> board_handle) {  
-        FWC_sis8300_eicsys_iqfb_func_getPulseCounter(arg -> board_handle,   &pulCnt);
-        FWC_sis8300_eicsys_iqfb_func_getWatchDogCnt(arg -> board_handle,    &ADCClkWdCnt);
-        FWC_sis8300_eicsys_iqfb_func_getUsageStatus(arg -> board_handle,    &usageStatus);
-        FWC_sis8300_eicsys_iqfb_func_getFwStatus(arg -> board_handle,       &platformStatus, &RFCtrlStatus);
-
-        arg -> board_pulseCnt       = (long)pulCnt;
-        arg -> board_ADCClkWdCnt    = (long)ADCClkWdCnt;
-        arg -> board_platformStatus = (long)platformStatus;
-        arg -> board_usageStatus    = (long)usageStatus;
-        arg -> board_RFCtrlStatus   = (long)RFCtrlStatus;
-
-        FWC_sis8300_eicsys_iqfb_func_getMeaTrigPeriod(arg -> board_handle, &triggerPeriod, arg -> board_sampleFreq_MHz);
-        arg -> board_meaTriggerPeriod_ms = triggerPeriod;
+        FWC_sis8300_eicsys_iqfb_func_readStatus(arg);
 
 		/* update the watchdog for IRQ */
+        if(arg -> board_switchMutex) epicsMutexMustLock(arg -> board_switchMutex);
         FWC_sis8300_eicsys_iqfb_func_getBits(arg->board_handle, &data);        
         data ^= 0x200;
         FWC_sis8300_eicsys_iqfb_func_setBits(arg->board_handle, data);
+        if(arg -> board_switchMutex) epicsMutexUnlock(arg -> board_switchMutex);
     }
 }
 
@@ -152,17 +170,7 @@ static void r_getRCFlags(void *ptr)
     if(!dataNode) return; 
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
-    unsigned int accFlags;
-    unsigned int stdbyFlags;
-    unsigned int spareFlags;
-
-    if(arg && arg -> board_handle) {  
-        FWC_sis8300_eicsys_iqfb_func_getRaceConditionFlags(arg -> board_handle, &accFlags, &stdbyFlags, &spareFlags);
-    
-        arg -> board_raceConditionFlags_acc       = (long)accFlags;
-        arg -> board_raceConditionFlags_stdby     = (long)stdbyFlags;
-        arg -> board_raceConditionFlags_spare     = (long)spareFlags;
-    }
+    if(arg) FWC_sis8300_eicsys_iqfb_func_readStatus(arg);                   /* served from the status snapshot */
 }
 
 /* Write callback function, set the usage status */
@@ -235,54 +243,12 @@ static void w_setTrigMode(void *ptr)
 /* Write callback function, set the timing of the board */
 static void w_setTiming(void *ptr)
 {
-    int i;
-    
     INTD_struc_node *dataNode = (INTD_struc_node *)ptr;
     
     if(!dataNode) return; 
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
-    if(arg && arg -> board_handle) {
-        /* set the timing items in the board */
-        FWC_sis8300_eicsys_iqfb_func_setExtTrigDelayAcc(arg -> board_handle,   arg -> board_extTriggerDelayAcc_ns,    arg -> board_sampleFreq_MHz);
-	    FWC_sis8300_eicsys_iqfb_func_setExtTrigDelayStdby(arg -> board_handle, arg -> board_extTriggerDelayStdby_ns,  arg -> board_sampleFreq_MHz);
-	    FWC_sis8300_eicsys_iqfb_func_setExtTrigDelaySpare(arg -> board_handle, arg -> board_extTriggerDelaySpare_ns,  arg -> board_sampleFreq_MHz);
-        FWC_sis8300_eicsys_iqfb_func_setIntTrigPeriod(arg -> board_handle,     arg -> board_intTriggerPeriod_ms,      arg -> board_sampleFreq_MHz);
-        FWC_sis8300_eicsys_iqfb_func_setRFPulseLength(arg -> board_handle,     arg -> board_RFPulseLength_ns,         arg -> board_sampleFreq_MHz);
-        FWC_sis8300_eicsys_iqfb_func_setDAQTrigDelay(arg -> board_handle,      arg -> board_DAQTriggerDelay_ns,       arg -> board_sampleFreq_MHz);
-        FWC_sis8300_eicsys_iqfb_func_setIntgStart(arg -> board_handle,         arg -> board_intgStart_ns,             arg -> board_sampleFreq_MHz);
-        FWC_sis8300_eicsys_iqfb_func_setIntgEnd(arg -> board_handle,           arg -> board_intgEnd_ns,               arg -> board_sampleFreq_MHz);
-        FWC_sis8300_eicsys_iqfb_func_setApplStart(arg -> board_handle,         arg -> board_applyStart_ns,            arg -> board_sampleFreq_MHz);
-        FWC_sis8300_eicsys_iqfb_func_setApplEnd(arg -> board_handle,           arg -> board_applyEnd_ns,              arg -> board_sampleFreq_MHz);
-        
-        /* build up the time axis for waveforms */
-        for(i = 0; i < FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX; i ++) {
-            arg->DAQTimeAxis_ns[i] = i * 1000 / arg -> board_sampleFreq_MHz + arg -> board_DAQTriggerDelay_ns;
-        }        
-
-        for(i = 0; i < FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX; i ++) {
-            arg->ADCTimeAxis_ns[i] = i * 1000 / arg -> board_sampleFreq_MHz + arg -> board_DAQTriggerDelay_ns;
-        }       
-                
-        /* set the average parameters for waveforms */       
-        arg->rfData_refCh.sampleFreq_MHz         = arg -> board_sampleFreq_MHz;
-        arg->rfData_fbkCh.sampleFreq_MHz         = arg -> board_sampleFreq_MHz;
-        
-        arg->rfData_tracked.sampleFreq_MHz       = arg -> board_sampleFreq_MHz;
-        arg->rfData_err.sampleFreq_MHz           = arg -> board_sampleFreq_MHz;
-        
-        arg->rfData_act.sampleFreq_MHz           = arg -> board_sampleFreq_MHz;
-        arg->rfData_DACOut.sampleFreq_MHz        = arg -> board_sampleFreq_MHz;
-                        
-        arg->rfData_refCh.sampleDelay_ns         = arg -> board_DAQTriggerDelay_ns;
-        arg->rfData_fbkCh.sampleDelay_ns         = arg -> board_DAQTriggerDelay_ns;
-               
-        arg->rfData_tracked.sampleDelay_ns       = arg -> board_DAQTriggerDelay_ns;
-        arg->rfData_err.sampleDelay_ns           = arg -> board_DAQTriggerDelay_ns;
-        
-        arg->rfData_act.sampleDelay_ns           = arg -> board_DAQTriggerDelay_ns;
-        arg->rfData_DACOut.sampleDelay_ns        = arg -> board_DAQTriggerDelay_ns;
-    }
+    if(arg) FWC_sis8300_eicsys_iqfb_func_writeTiming(arg);
 }
 
 /* Write callback function, set the reference phase set point */
@@ -307,7 +273,9 @@ static void w_setFbkRot(void *ptr)
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
     if(arg && arg -> board_handle) {
-        FWC_sis8300_eicsys_iqfb_func_setFbkVectorRotation(arg -> board_handle, arg -> board_fbkRotationGain, arg -> board_fbkRotationAngle_deg);
+        if(arg -> fw_mutex) epicsMutexMustLock(arg -> fw_mutex);                     /* not while the pulse feedback writes them */
+        FWC_sis8300_eicsys_iqfb_func_writeParam(arg, FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_ROT);
+        if(arg -> fw_mutex) epicsMutexUnlock(arg -> fw_mutex);
     }
 }
 
@@ -320,7 +288,9 @@ static void w_setActRot(void *ptr)
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
     if(arg && arg -> board_handle) {
-        FWC_sis8300_eicsys_iqfb_func_setActVectorRotation(arg -> board_handle, arg -> board_actRotationGain, arg -> board_actRotationAngle_deg);
+        if(arg -> fw_mutex) epicsMutexMustLock(arg -> fw_mutex);                     /* not while the pulse feedback writes them */
+        FWC_sis8300_eicsys_iqfb_func_writeParam(arg, FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_ROT);
+        if(arg -> fw_mutex) epicsMutexUnlock(arg -> fw_mutex);
     }
 }
 
@@ -333,8 +303,9 @@ static void w_setFF(void *ptr)
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
     if(arg && arg -> board_handle) {
-        FWC_sis8300_eicsys_iqfb_func_setFeedforward_I(arg -> board_handle, arg -> board_feedforwardI_MV, arg -> board_voltageFactor_perMV);
-        FWC_sis8300_eicsys_iqfb_func_setFeedforward_Q(arg -> board_handle, arg -> board_feedforwardQ_MV, arg -> board_voltageFactor_perMV);
+        if(arg -> fw_mutex) epicsMutexMustLock(arg -> fw_mutex);                     /* not while the pulse feedback writes them */
+        FWC_sis8300_eicsys_iqfb_func_writeParam(arg, FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_FF);
+        if(arg -> fw_mutex) epicsMutexUnlock(arg -> fw_mutex);
     }
 }
 
@@ -347,8 +318,9 @@ static void w_setGain(void *ptr)
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
     if(arg && arg -> board_handle) {
-        FWC_sis8300_eicsys_iqfb_func_setGain_I(arg -> board_handle, arg -> board_gainI * arg -> board_fbEnable);
-        FWC_sis8300_eicsys_iqfb_func_setGain_Q(arg -> board_handle, arg -> board_gainQ * arg -> board_fbEnable);
+        if(arg -> fw_mutex) epicsMutexMustLock(arg -> fw_mutex);                     /* not while the pulse feedback writes them */
+        FWC_sis8300_eicsys_iqfb_func_writeParam(arg, FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_GAIN);
+        if(arg -> fw_mutex) epicsMutexUnlock(arg -> fw_mutex);
     }
 }
 
@@ -361,7 +333,10 @@ static void w_setSPTable(void *ptr)
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
     if(arg && arg -> board_handle) {
+        if(arg -> board_tabMutex) epicsMutexMustLock(arg -> board_tabMutex);
         FWC_sis8300_eicsys_iqfb_func_setIQSPTable(arg -> board_handle, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH, arg -> board_setPointTable_I, arg -> board_setPointTable_Q);
+        if(arg -> board_tabMutex) epicsMutexUnlock(arg -> board_tabMutex);
+        RFCFW_func_ilcSetBase(&arg -> ilc, arg -> board_setPointTable_I, arg -> board_setPointTable_Q, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH, 0);       /* the learning restarts from the new table */
     }
 }
 
@@ -374,7 +349,9 @@ static void w_setDrvRotTable(void *ptr)
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
     if(arg && arg -> board_handle) {
+        if(arg -> board_tabMutex) epicsMutexMustLock(arg -> board_tabMutex);
         FWC_sis8300_eicsys_iqfb_func_setDrvRotationTable(arg -> board_handle, FWC_SIS8300_EICSYS_IQFB_CONST_DRV_TAB_BUF_DEPTH, arg -> board_drvRotScaleTable, arg -> board_drvRotAngleTable);
+        if(arg -> board_tabMutex) epicsMutexUnlock(arg -> board_tabMutex);
     }
 }
 
@@ -426,10 +403,9 @@ static void w_setIQCorr(void *ptr)
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
     if(arg && arg -> board_handle) {
-        FWC_sis8300_eicsys_iqfb_func_setImbalanceCorrMatrix(arg -> board_handle, arg -> board_imbalanceMatrixA11, 
-                                                                                 arg -> board_imbalanceMatrixA12, 
-                                                                                 arg -> board_imbalanceMatrixA21, 
-                                                                                 arg -> board_imbalanceMatrixA22);
+        if(arg -> fw_mutex) epicsMutexMustLock(arg -> fw_mutex);                     /* not while the pulse feedback writes them */
+        FWC_sis8300_eicsys_iqfb_func_writeParam(arg, FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_IQ_CORR);
+        if(arg -> fw_mutex) epicsMutexUnlock(arg -> fw_mutex);
     }
 }
 
@@ -446,7 +422,8 @@ static void w_setTrigRateDiv(void *ptr)
     }
 }
 
-/* Write callback, set the DAQ */
+/* Write callback, set the DAQ. Written to the FPGA by the pulse thread at the next pulse boundary together with the
+   bank of the ping-pong, which is switched there */
 static void w_setDAQ(void *ptr)
 {
     INTD_struc_node *dataNode = (INTD_struc_node *)ptr;
@@ -454,35 +431,66 @@ static void w_setDAQ(void *ptr)
     if(!dataNode) return; 
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)dataNode->privateData;
 
-    if(arg && arg -> board_handle) {
-		FWC_sis8300_eicsys_iqfb_func_setDAQ(arg -> board_handle, 0, (unsigned int)arg -> board_ADCSamplePno);           /* each point for 2 byte data of 16 channels */		
-    }
+    if(arg) arg -> roi.pending = 1;
 }
 
 /*======================================
  * Private Data and Routines - others
  *======================================*/
 /**
- * Create data nodes for RF waveform objects
+ * Create data nodes for RF waveform objects, processed with the I/O interrupt when the readout is published
  */
-static int FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(const char *moduleName, const char *wfName, RFLIB_struc_RFWaveform *wf) 
+static int FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(const char *moduleName, const char *wfName, short *wfI, short *wfQ, IOSCANPVT *ioScan) 
 {
     int  status = 0;
     char var_dataName[64];
 
     /* check the input */
-    if(!moduleName || !moduleName[0] || !wfName || !wfName[0] || !wf) return -1;
+    if(!moduleName || !moduleName[0] || !wfName || !wfName[0] || !wfI || !wfQ || !ioScan) return -1;
 
-    /* create data node for I/Q items in the RF waveform structure (because here the intermediate data is only for diagnostics!) */
-    strncpy(var_dataName, wfName, 64); strcat(var_dataName, "_I");
-    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(wf->wfI), NULL, FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX, NULL, INTD_SHORT,  NULL, NULL, NULL, NULL, INTD_WFI, INTD_1S);  /* r */
+    /* create data node for I/Q items of the published RF waveform (because here the intermediate data is only for diagnostics!) */
+    snprintf(var_dataName, sizeof(var_dataName), "%s_I", wfName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)wfI, NULL, FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX, ioScan, INTD_SHORT,  NULL, NULL, NULL, NULL, INTD_WFI, INTD_IOINT);  /* r */
     
-    strncpy(var_dataName, wfName, 64); strcat(var_dataName, "_Q");
-    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(wf->wfQ), NULL, FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX, NULL, INTD_SHORT,  NULL, NULL, NULL, NULL, INTD_WFI, INTD_1S);  /* r */
+    snprintf(var_dataName, sizeof(var_dataName), "%s_Q", wfName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)wfQ, NULL, FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX, ioScan, INTD_SHORT,  NULL, NULL, NULL, NULL, INTD_WFI, INTD_IOINT);  /* r */
       
     return status;
 }             
 
+/**
+ * Create data nodes for the scalar features of an RF waveform, processed with the published waveforms
+ */
+static int FWC_sis8300_eicsys_iqfb_func_featCreateData(const char *moduleName, const char *featName, RFCFW_struc_pulseFeature *feat, IOSCANPVT *ioScan) 
+{
+    int  status = 0;
+    char var_dataName[64];
+
+    /* check the input */
+    if(!moduleName || !moduleName[0] || !featName || !featName[0] || !feat) return -1;
+
+    /* create data node for all items in the feature structure */
+    snprintf(var_dataName, sizeof(var_dataName), "%s_AMP", featName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&feat -> amp),         NULL, 1, ioScan, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AI, INTD_IOINT);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_PHA", featName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&feat -> pha_deg),     NULL, 1, ioScan, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AI, INTD_IOINT);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_PEAK", featName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&feat -> ampPeak),     NULL, 1, ioScan, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AI, INTD_IOINT);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_RISE", featName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&feat -> riseTime_ns), NULL, 1, ioScan, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AI, INTD_IOINT);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_DROOP", featName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&feat -> droop_pct),   NULL, 1, ioScan, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AI, INTD_IOINT);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_VALID", featName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&feat -> valid),       NULL, 1, ioScan, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_IOINT);  /* r */
+
+    return status;
+}
+
 /*======================================
  * Public Routines
  *======================================*/
@@ -497,11 +505,16 @@ static int FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(const char *moduleName, c
  */
 int FWC_sis8300_eicsys_iqfb_func_createEpicsData(void *module, const char *moduleName)
 {
-    int status = 0;
+    int  i;
+    int  status = 0;
+    char var_dataName[64];
     FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)module;
 
     if(!arg || !moduleName || !moduleName[0]) return -1;    
 
+    /* records of the settings are also scanned after a restore of the configuration */
+    scanIoInit(&arg -> config_ioScan);
+
     /*-----------------------------------
      * Direct writing/reading the board
      *-----------------------------------*/
@@ -509,8 +522,8 @@ int FWC_sis8300_eicsys_iqfb_func_createEpicsData(void *module, const char *modul
     status += INTD_API_createDataNode(moduleName, "B_DEV_OPENED",  (void *)(&arg -> board_deviceOpened),        (void *)arg, 1, NULL, INTD_LONG, r_getFwInfo, NULL,  NULL, NULL, INTD_LI, INTD_10S);
 
     status += INTD_API_createDataNode(moduleName, "B_SET_SPI",     (void *)(&arg -> board_setupSPI),            (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setSPI,  NULL, NULL, INTD_BO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_CLK_DIV2",    (void *)(&arg -> board_clkDiv2),             (void *)arg, 1, NULL, INTD_USHORT, NULL,     NULL,  NULL, NULL, INTD_BO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_ADC_CLK_SEL", (void *)(&arg -> board_ADCClockSel),         (void *)arg, 1, NULL, INTD_ULONG, NULL, w_ADCClkSrc, NULL, NULL, INTD_MBBO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_CLK_DIV2",    (void *)(&arg -> board_clkDiv2),             (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL,     NULL,  NULL, NULL, INTD_BO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_ADC_CLK_SEL", (void *)(&arg -> board_ADCClockSel),         (void *)arg, 1, &arg -> config_ioScan, INTD_ULONG, NULL, w_ADCClkSrc, NULL, NULL, INTD_MBBO, INTD_IOINT);
 
     status += INTD_API_createDataNode(moduleName, "B_PLFWID",      (void *)(&arg -> board_platformFwId),        (void *)arg, 1,   NULL, INTD_LONG, NULL, NULL, NULL, NULL, INTD_LI,  INTD_10S);
     status += INTD_API_createDataNode(moduleName, "B_FPGA_TYPE",   (void *)(arg -> board_FPGAType),             (void *)arg, 128, NULL, INTD_CHAR, NULL, NULL, NULL, NULL, INTD_WFI, INTD_10S);
@@ -526,22 +539,24 @@ int FWC_sis8300_eicsys_iqfb_func_createEpicsData(void *module, const char *modul
     status += INTD_API_createDataNode(moduleName, "B_SPI_CLK",     (void *)(&arg -> board_clkSPIFreq_MHz),      (void *)arg, 1, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AI, INTD_10S);
 
     status += INTD_API_createDataNode(moduleName, "B_RESET",       (void *)(&arg -> board_reset),               (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_TRG_SRC",     (void *)(&arg -> board_triggerSource),       (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_PASSIVE);    
-    status += INTD_API_createDataNode(moduleName, "B_ENA_TRACK",   (void *)(&arg -> board_refTrackEnabled),     (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_ENA_OUT",     (void *)(&arg -> board_DACOutputEnabled),    (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_ENA_COUT",    (void *)(&arg -> board_DACConOutputEnabled), (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_ENA_IRQ",     (void *)(&arg -> board_IRQEnabled),          (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_PASSIVE);    
-    status += INTD_API_createDataNode(moduleName, "B_DAC_OUT_SEL", (void *)(&arg -> board_DACOutSel),           (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_EGSEL_ACC",   (void *)(&arg -> board_edgeSelAcc),          (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_EGSEL_STDBY", (void *)(&arg -> board_edgeSelStdby),        (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_EGSEL_SPARE", (void *)(&arg -> board_edgeSelSpare),        (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_DAQ_SEL",     (void *)(&arg -> board_DAQShareSel),         (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_PASSIVE);
-
-    status += INTD_API_createDataNode(moduleName, "B_ENA_FB",      (void *)(&arg -> board_fbEnable),            (void *)arg, 1, NULL, INTD_USHORT, NULL, w_setGain, NULL, NULL, INTD_BO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_TRG_SRC",     (void *)(&arg -> board_triggerSource),       (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_IOINT);    
+    status += INTD_API_createDataNode(moduleName, "B_ENA_TRACK",   (void *)(&arg -> board_refTrackEnabled),     (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_ENA_OUT",     (void *)(&arg -> board_DACOutputEnabled),    (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_ENA_COUT",    (void *)(&arg -> board_DACConOutputEnabled), (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_ENA_IRQ",     (void *)(&arg -> board_IRQEnabled),          (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_IOINT);    
+    status += INTD_API_createDataNode(moduleName, "B_DAC_OUT_SEL", (void *)(&arg -> board_DACOutSel),           (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_EGSEL_ACC",   (void *)(&arg -> board_edgeSelAcc),          (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_EGSEL_STDBY", (void *)(&arg -> board_edgeSelStdby),        (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_EGSEL_SPARE", (void *)(&arg -> board_edgeSelSpare),        (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_DAQ_SEL",     (void *)(&arg -> board_DAQShareSel),         (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, w_setBits, NULL, NULL, INTD_BO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_DAQ_SEL_ALT", (void *)(&arg -> board_DAQShareAlt),         (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, NULL,      NULL, NULL, INTD_BO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_DAQ_SEL_ALT_N",(void *)(&arg -> board_DAQShareAltPulses),  (void *)arg, 1, &arg -> config_ioScan, INTD_LONG,   NULL, NULL,      NULL, NULL, INTD_LO, INTD_IOINT);
+
+    status += INTD_API_createDataNode(moduleName, "B_ENA_FB",      (void *)(&arg -> board_fbEnable),            (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, w_setGain, NULL, NULL, INTD_BO, INTD_IOINT);
  
-    status += INTD_API_createDataNode(moduleName, "B_REF_SEL",     (void *)(&arg -> board_refChSel),            (void *)arg, 1, NULL, INTD_ULONG, NULL, w_setRefFbkChId, NULL, NULL, INTD_MBBO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_FBK_SEL",     (void *)(&arg -> board_fbkChSel),            (void *)arg, 1, NULL, INTD_ULONG, NULL, w_setRefFbkChId, NULL, NULL, INTD_MBBO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_TRIGMODE_SEL",(void *)(&arg -> board_triggerModeSel),      (void *)arg, 1, NULL, INTD_ULONG, NULL, w_setTrigMode,   NULL, NULL, INTD_MBBO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_REF_SEL",     (void *)(&arg -> board_refChSel),            (void *)arg, 1, &arg -> config_ioScan, INTD_ULONG, NULL, w_setRefFbkChId, NULL, NULL, INTD_MBBO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_FBK_SEL",     (void *)(&arg -> board_fbkChSel),            (void *)arg, 1, &arg -> config_ioScan, INTD_ULONG, NULL, w_setRefFbkChId, NULL, NULL, INTD_MBBO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_TRIGMODE_SEL",(void *)(&arg -> board_triggerModeSel),      (void *)arg, 1, &arg -> config_ioScan, INTD_ULONG, NULL, w_setTrigMode,   NULL, NULL, INTD_MBBO, INTD_IOINT);
 
     status += INTD_API_createDataNode(moduleName, "B_FMNAME",      (void *)(&arg -> board_firmwareName),        (void *)arg, 1, NULL, INTD_LONG, r_getFwInfo, NULL, NULL, NULL, INTD_LI, INTD_10S);
     status += INTD_API_createDataNode(moduleName, "B_MJVERS",      (void *)(&arg -> board_majorVer),            (void *)arg, 1, NULL, INTD_LONG, NULL, NULL, NULL, NULL, INTD_LI, INTD_10S);
@@ -558,37 +573,42 @@ int FWC_sis8300_eicsys_iqfb_func_createEpicsData(void *module, const char *modul
     status += INTD_API_createDataNode(moduleName, "B_RCFLAGS_ACC",   (void *)(&arg -> board_raceConditionFlags_acc),   (void *)arg, 1, NULL, INTD_LONG, r_getRCFlags,     NULL, NULL, NULL, INTD_LI, INTD_1S);
     status += INTD_API_createDataNode(moduleName, "B_RCFLAGS_STDBY", (void *)(&arg -> board_raceConditionFlags_stdby), (void *)arg, 1, NULL, INTD_LONG, NULL,             NULL, NULL, NULL, INTD_LI, INTD_1S);
     status += INTD_API_createDataNode(moduleName, "B_RCFLAGS_SPARE", (void *)(&arg -> board_raceConditionFlags_spare), (void *)arg, 1, NULL, INTD_LONG, NULL,             NULL, NULL, NULL, INTD_LI, INTD_1S);
-    status += INTD_API_createDataNode(moduleName, "B_TRIGRATE_DIV",  (void *)(&arg -> board_extTriggerRateDivRatio),   (void *)arg, 1, NULL, INTD_LONG, NULL, w_setTrigRateDiv, NULL, NULL, INTD_LO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_TRIGRATE_DIV",  (void *)(&arg -> board_extTriggerRateDivRatio),   (void *)arg, 1, &arg -> config_ioScan, INTD_LONG, NULL, w_setTrigRateDiv, NULL, NULL, INTD_LO, INTD_IOINT);
 
-    status += INTD_API_createDataNode(moduleName, "B_OFFS_I",      (void *)(&arg -> board_DACOffsetI),          (void *)arg, 1, NULL, INTD_LONG, NULL, w_setOffset, NULL, NULL, INTD_LO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_OFFS_Q",      (void *)(&arg -> board_DACOffsetQ),          (void *)arg, 1, NULL, INTD_LONG, NULL, w_setOffset, NULL, NULL, INTD_LO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_OFFS_I",      (void *)(&arg -> board_DACOffsetI),          (void *)arg, 1, &arg -> config_ioScan, INTD_LONG, NULL, w_setOffset, NULL, NULL, INTD_LO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_OFFS_Q",      (void *)(&arg -> board_DACOffsetQ),          (void *)arg, 1, &arg -> config_ioScan, INTD_LONG, NULL, w_setOffset, NULL, NULL, INTD_LO, INTD_IOINT);
 
-    status += INTD_API_createDataNode(moduleName, "B_LIMIT_HI",    (void *)(&arg -> board_ampLimitHi),          (void *)arg, 1, NULL, INTD_LONG, NULL, w_setOLimit, NULL, NULL, INTD_LO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_LIMIT_LO",    (void *)(&arg -> board_ampLimitLo),          (void *)arg, 1, NULL, INTD_LONG, NULL, w_setOLimit, NULL, NULL, INTD_LO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_LIMIT_HI",    (void *)(&arg -> board_ampLimitHi),          (void *)arg, 1, &arg -> config_ioScan, INTD_LONG, NULL, w_setOLimit, NULL, NULL, INTD_LO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_LIMIT_LO",    (void *)(&arg -> board_ampLimitLo),          (void *)arg, 1, &arg -> config_ioScan, INTD_LONG, NULL, w_setOLimit, NULL, NULL, INTD_LO, INTD_IOINT);
        
-    status += INTD_API_createDataNode(moduleName, "B_ADCS_PNO",    (void *)(&arg -> board_ADCSamplePno),        (void *)arg, 1, NULL, INTD_LONG, NULL, w_setDAQ,    NULL, NULL, INTD_LO, INTD_PASSIVE);
-
-    status += INTD_API_createDataNode(moduleName, "B_COEF_ID_OFFS",(void *)(&arg -> board_coefIdOffset),        (void *)arg, 1, NULL, INTD_LONG, NULL, w_setCoefIdOffset,  NULL, NULL, INTD_LO, INTD_PASSIVE);
-
-    status += INTD_API_createDataNode(moduleName, "B_CORR_LIMIT_I",(void *)(&arg -> board_corrLimitI),           (void *)arg, 1, NULL, INTD_LONG, NULL, w_setCorrLimit,  NULL, NULL, INTD_LO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_CORR_LIMIT_Q",(void *)(&arg -> board_corrLimitQ),           (void *)arg, 1, NULL, INTD_LONG, NULL, w_setCorrLimit,  NULL, NULL, INTD_LO, INTD_PASSIVE);
-
-    status += INTD_API_createDataNode(moduleName, "B_FREQ",                (void *)(&arg -> board_sampleFreq_MHz),         (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_EXT_TRIG_DELAY_ACC",  (void *)(&arg -> board_extTriggerDelayAcc_ns),  (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_EXT_TRIG_DELAY_STDBY",(void *)(&arg -> board_extTriggerDelayStdby_ns),(void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_EXT_TRIG_DELAY_SPARE",(void *)(&arg -> board_extTriggerDelaySpare_ns),(void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_PASSIVE);    
-    status += INTD_API_createDataNode(moduleName, "B_INT_TRIG_PERIOD",     (void *)(&arg -> board_intTriggerPeriod_ms),    (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_ADCS_PNO",    (void *)(&arg -> board_ADCSamplePno),        (void *)arg, 1, &arg -> config_ioScan, INTD_LONG, NULL, w_setDAQ,    NULL, NULL, INTD_LO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_ADCS_AUTO",   (void *)(&arg -> board_ADCAutoPno),          (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, NULL,      NULL, NULL, INTD_BO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_ADCS_TAIL",   (void *)(&arg -> board_ADCTailMargin_ns),    (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, NULL,      NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_ADCS_PNO_RBK",(void *)(&arg -> board_ADCSamplePnoEff),     (void *)arg, 1, NULL, INTD_LONG, NULL, NULL,        NULL, NULL, INTD_LI, INTD_1S);
+    status += INTD_API_createDataNode(moduleName, "B_DAQ_PINGPONG",(void *)(&arg -> board_DAQPingPong),         (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, NULL,      NULL, NULL, INTD_BO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_DAQ_BANK",    (void *)(&arg -> board_DAQBank),             (void *)arg, 1, NULL, INTD_LONG, NULL, NULL,        NULL, NULL, INTD_LI, INTD_1S);
+
+    status += INTD_API_createDataNode(moduleName, "B_COEF_ID_OFFS",(void *)(&arg -> board_coefIdOffset),        (void *)arg, 1, &arg -> config_ioScan, INTD_LONG, NULL, w_setCoefIdOffset,  NULL, NULL, INTD_LO, INTD_IOINT);
+
+    status += INTD_API_createDataNode(moduleName, "B_CORR_LIMIT_I",(void *)(&arg -> board_corrLimitI),           (void *)arg, 1, &arg -> config_ioScan, INTD_LONG, NULL, w_setCorrLimit,  NULL, NULL, INTD_LO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_CORR_LIMIT_Q",(void *)(&arg -> board_corrLimitQ),           (void *)arg, 1, &arg -> config_ioScan, INTD_LONG, NULL, w_setCorrLimit,  NULL, NULL, INTD_LO, INTD_IOINT);
+
+    status += INTD_API_createDataNode(moduleName, "B_FREQ",                (void *)(&arg -> board_sampleFreq_MHz),         (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_EXT_TRIG_DELAY_ACC",  (void *)(&arg -> board_extTriggerDelayAcc_ns),  (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_EXT_TRIG_DELAY_STDBY",(void *)(&arg -> board_extTriggerDelayStdby_ns),(void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_EXT_TRIG_DELAY_SPARE",(void *)(&arg -> board_extTriggerDelaySpare_ns),(void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_IOINT);    
+    status += INTD_API_createDataNode(moduleName, "B_INT_TRIG_PERIOD",     (void *)(&arg -> board_intTriggerPeriod_ms),    (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_IOINT);
     status += INTD_API_createDataNode(moduleName, "B_MEA_TRIG_PERIOD",     (void *)(&arg -> board_meaTriggerPeriod_ms),    (void *)arg, 1, NULL, INTD_DOUBLE, NULL, NULL,         NULL, NULL, INTD_AI, INTD_1S);       
-    status += INTD_API_createDataNode(moduleName, "B_PUL_LENGTH",          (void *)(&arg -> board_RFPulseLength_ns),       (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_DAQ_TRIG_DELAY",      (void *)(&arg -> board_DAQTriggerDelay_ns),     (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_PUL_LENGTH",          (void *)(&arg -> board_RFPulseLength_ns),       (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_DAQ_TRIG_DELAY",      (void *)(&arg -> board_DAQTriggerDelay_ns),     (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setTiming,  NULL, NULL, INTD_AO, INTD_IOINT);
 
-    status += INTD_API_createDataNode(moduleName, "B_REF_PHA_SP",      (void *)(&arg -> board_refPhaseSP_deg),       (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setRefPhaSP, NULL, NULL, INTD_AO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_REF_PHA_SP",      (void *)(&arg -> board_refPhaseSP_deg),       (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setRefPhaSP, NULL, NULL, INTD_AO, INTD_IOINT);
 
-    status += INTD_API_createDataNode(moduleName, "B_FBK_ROT_GAIN",    (void *)(&arg -> board_fbkRotationGain),      (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setFbkRot, NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_FBK_ROT_ANGLE",   (void *)(&arg -> board_fbkRotationAngle_deg), (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setFbkRot, NULL, NULL, INTD_AO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_FBK_ROT_GAIN",    (void *)(&arg -> board_fbkRotationGain),      (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setFbkRot, NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_FBK_ROT_ANGLE",   (void *)(&arg -> board_fbkRotationAngle_deg), (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setFbkRot, NULL, NULL, INTD_AO, INTD_IOINT);
 
-    status += INTD_API_createDataNode(moduleName, "B_ACT_ROT_GAIN",    (void *)(&arg -> board_actRotationGain),      (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setActRot, NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_ACT_ROT_ANGLE",   (void *)(&arg -> board_actRotationAngle_deg), (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setActRot, NULL, NULL, INTD_AO, INTD_PASSIVE); 
+    status += INTD_API_createDataNode(moduleName, "B_ACT_ROT_GAIN",    (void *)(&arg -> board_actRotationGain),      (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setActRot, NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_ACT_ROT_ANGLE",   (void *)(&arg -> board_actRotationAngle_deg), (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setActRot, NULL, NULL, INTD_AO, INTD_IOINT); 
 
     /* note: the rotation parameters can also be set by the low level application, and unfortunetaly it can not be set back to the record, so we define PVs to read out the data */    
     status += INTD_API_createDataNode(moduleName, "B_FBK_ROT_GAIN_RB", (void *)(&arg -> board_fbkRotationGain),      (void *)arg, 1, NULL, INTD_DOUBLE, NULL, NULL,        NULL, NULL, INTD_AI, INTD_1S);
@@ -597,44 +617,46 @@ int FWC_sis8300_eicsys_iqfb_func_createEpicsData(void *module, const char *modul
     status += INTD_API_createDataNode(moduleName, "B_ACT_ROT_GAIN_RB", (void *)(&arg -> board_actRotationGain),      (void *)arg, 1, NULL, INTD_DOUBLE, NULL, NULL,        NULL, NULL, INTD_AI, INTD_1S);
     status += INTD_API_createDataNode(moduleName, "B_ACT_ROT_ANGLE_RB",(void *)(&arg -> board_actRotationAngle_deg), (void *)arg, 1, NULL, INTD_DOUBLE, NULL, NULL,        NULL, NULL, INTD_AI, INTD_1S);
 
-    status += INTD_API_createDataNode(moduleName, "B_FF_I",            (void *)(&arg -> board_feedforwardI_MV),      (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setFF,     NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_FF_Q",            (void *)(&arg -> board_feedforwardQ_MV),      (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setFF,     NULL, NULL, INTD_AO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_FF_I",            (void *)(&arg -> board_feedforwardI_MV),      (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setFF,     NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_FF_Q",            (void *)(&arg -> board_feedforwardQ_MV),      (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setFF,     NULL, NULL, INTD_AO, INTD_IOINT);
 
-    status += INTD_API_createDataNode(moduleName, "B_VOLT_COEF",       (void *)(&arg -> board_voltageFactor_perMV),  (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setFF,     NULL, NULL, INTD_AO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_VOLT_COEF",       (void *)(&arg -> board_voltageFactor_perMV),  (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setFF,     NULL, NULL, INTD_AO, INTD_IOINT);
 
-    status += INTD_API_createDataNode(moduleName, "B_GAIN_I",          (void *)(&arg -> board_gainI),                (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setGain,   NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_GAIN_Q",          (void *)(&arg -> board_gainQ),                (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setGain,   NULL, NULL, INTD_AO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_GAIN_I",          (void *)(&arg -> board_gainI),                (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setGain,   NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_GAIN_Q",          (void *)(&arg -> board_gainQ),                (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setGain,   NULL, NULL, INTD_AO, INTD_IOINT);
 
-    status += INTD_API_createDataNode(moduleName, "B_INTG_ST",         (void *)(&arg -> board_intgStart_ns),         (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setTiming, NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_INTG_ET",         (void *)(&arg -> board_intgEnd_ns),           (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setTiming, NULL, NULL, INTD_AO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_INTG_ST",         (void *)(&arg -> board_intgStart_ns),         (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setTiming, NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_INTG_ET",         (void *)(&arg -> board_intgEnd_ns),           (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setTiming, NULL, NULL, INTD_AO, INTD_IOINT);
 
-    status += INTD_API_createDataNode(moduleName, "B_APPL_ST",         (void *)(&arg -> board_applyStart_ns),        (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setTiming, NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_APPL_ET",         (void *)(&arg -> board_applyEnd_ns),          (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setTiming, NULL, NULL, INTD_AO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_APPL_ST",         (void *)(&arg -> board_applyStart_ns),        (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setTiming, NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_APPL_ET",         (void *)(&arg -> board_applyEnd_ns),          (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setTiming, NULL, NULL, INTD_AO, INTD_IOINT);
 
-    status += INTD_API_createDataNode(moduleName, "B_IQCORR_A11",      (void *)(&arg -> board_imbalanceMatrixA11),   (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setIQCorr, NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_IQCORR_A12",      (void *)(&arg -> board_imbalanceMatrixA12),   (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setIQCorr, NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_IQCORR_A21",      (void *)(&arg -> board_imbalanceMatrixA21),   (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setIQCorr, NULL, NULL, INTD_AO, INTD_PASSIVE);
-    status += INTD_API_createDataNode(moduleName, "B_IQCORR_A22",      (void *)(&arg -> board_imbalanceMatrixA22),   (void *)arg, 1, NULL, INTD_DOUBLE, NULL, w_setIQCorr, NULL, NULL, INTD_AO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "B_IQCORR_A11",      (void *)(&arg -> board_imbalanceMatrixA11),   (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setIQCorr, NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_IQCORR_A12",      (void *)(&arg -> board_imbalanceMatrixA12),   (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setIQCorr, NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_IQCORR_A21",      (void *)(&arg -> board_imbalanceMatrixA21),   (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setIQCorr, NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_IQCORR_A22",      (void *)(&arg -> board_imbalanceMatrixA22),   (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setIQCorr, NULL, NULL, INTD_AO, INTD_IOINT);
 
     /*-----------------------------------
      * Write only buffer - rotation tables and set point tables
      *-----------------------------------*/      
-    status += INTD_API_createDataNode(moduleName, "TAB_SP_I",          (void *)(arg -> board_setPointTable_I), (void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH,  NULL, INTD_DOUBLE, NULL, w_setSPTable,     NULL, NULL, INTD_WFO, INTD_PASSIVE);  /* w */
-    status += INTD_API_createDataNode(moduleName, "TAB_SP_Q",          (void *)(arg -> board_setPointTable_Q), (void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH,  NULL, INTD_DOUBLE, NULL, w_setSPTable,     NULL, NULL, INTD_WFO, INTD_PASSIVE);  /* w */
-    status += INTD_API_createDataNode(moduleName, "TAB_DRV_ROT_SCALE", (void *)(arg -> board_drvRotScaleTable),(void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_DRV_TAB_BUF_DEPTH, NULL, INTD_DOUBLE, NULL, w_setDrvRotTable, NULL, NULL, INTD_WFO, INTD_PASSIVE);  /* w */
-    status += INTD_API_createDataNode(moduleName, "TAB_DRV_ROT_ANGLE", (void *)(arg -> board_drvRotAngleTable),(void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_DRV_TAB_BUF_DEPTH, NULL, INTD_DOUBLE, NULL, w_setDrvRotTable, NULL, NULL, INTD_WFO, INTD_PASSIVE);  /* w */    
+    status += INTD_API_createDataNode(moduleName, "TAB_SP_I",          (void *)(arg -> board_setPointTable_I), (void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH,  &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setSPTable,     NULL, NULL, INTD_WFO, INTD_IOINT);  /* w */
+    status += INTD_API_createDataNode(moduleName, "TAB_SP_Q",          (void *)(arg -> board_setPointTable_Q), (void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH,  &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setSPTable,     NULL, NULL, INTD_WFO, INTD_IOINT);  /* w */
+    status += INTD_API_createDataNode(moduleName, "TAB_DRV_ROT_SCALE", (void *)(arg -> board_drvRotScaleTable),(void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_DRV_TAB_BUF_DEPTH, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setDrvRotTable, NULL, NULL, INTD_WFO, INTD_IOINT);  /* w */
+    status += INTD_API_createDataNode(moduleName, "TAB_DRV_ROT_ANGLE", (void *)(arg -> board_drvRotAngleTable),(void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_DRV_TAB_BUF_DEPTH, &arg -> config_ioScan, INTD_DOUBLE, NULL, w_setDrvRotTable, NULL, NULL, INTD_WFO, INTD_IOINT);  /* w */    
 
     /*-----------------------------------
      * DAQ buffers and settings - waveforms 
      *-----------------------------------*/     
-    status += FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(moduleName, "WF_REF_CH",         &arg->rfData_refCh);
-    status += FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(moduleName, "WF_FBK_CH",         &arg->rfData_fbkCh);
+    status += RFCFW_func_pubQueueInit(&arg -> pub_queue, moduleName, sizeof(FWC_sis8300_eicsys_iqfb_struc_pubFrame), RFCFW_CONST_PUBQ_SLOT_NUM, (void *)&arg -> pub_frame);
+
+    status += FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(moduleName, "WF_REF_CH",         arg->pub_frame.wfI[0], arg->pub_frame.wfQ[0], &arg->pub_queue.ioScan);
+    status += FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(moduleName, "WF_FBK_CH",         arg->pub_frame.wfI[1], arg->pub_frame.wfQ[1], &arg->pub_queue.ioScan);
     
-    status += FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(moduleName, "WF_TRACKED",        &arg->rfData_tracked);
-    status += FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(moduleName, "WF_ERR",            &arg->rfData_err);
+    status += FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(moduleName, "WF_TRACKED",        arg->pub_frame.wfI[2], arg->pub_frame.wfQ[2], &arg->pub_queue.ioScan);
+    status += FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(moduleName, "WF_ERR",            arg->pub_frame.wfI[3], arg->pub_frame.wfQ[3], &arg->pub_queue.ioScan);
     
-    status += FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(moduleName, "WF_ACT",            &arg->rfData_act);
-    status += FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(moduleName, "WF_DAC_OUT",        &arg->rfData_DACOut);
+    status += FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(moduleName, "WF_ACT",            arg->pub_frame.wfI[4], arg->pub_frame.wfQ[4], &arg->pub_queue.ioScan);
+    status += FWC_sis8300_eicsys_iqfb_func_rfWfCreateData(moduleName, "WF_DAC_OUT",        arg->pub_frame.wfI[5], arg->pub_frame.wfQ[5], &arg->pub_queue.ioScan);
 
     status += INTD_API_createDataNode(moduleName, "WF_DAQX", (void *)(arg -> DAQTimeAxis_ns), (void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX,  NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_WFI, INTD_1S); /* r */    
     status += INTD_API_createDataNode(moduleName, "WF_ADCX", (void *)(arg -> ADCTimeAxis_ns), (void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_WFI, INTD_1S); /* r */        
@@ -650,6 +672,96 @@ int FWC_sis8300_eicsys_iqfb_func_createEpicsData(void *module, const char *modul
     status += INTD_API_createDataNode(moduleName, "WF_ADC8", (void *)(arg -> board_ADC8_raw), (void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX, NULL, INTD_SHORT, NULL, NULL, NULL, NULL, INTD_WFI, INTD_1S);  /* r */    
     status += INTD_API_createDataNode(moduleName, "WF_ADC9", (void *)(arg -> board_ADC9_raw), (void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_ADC_SAMPLE_MAX, NULL, INTD_SHORT, NULL, NULL, NULL, NULL, INTD_WFI, INTD_1S);  /* r */    
 
+    /*-----------------------------------
+     * Per-pulse scalar features of the RF waveforms
+     *-----------------------------------*/
+    status += INTD_API_createDataNode(moduleName, "FEAT_WIN_ST",       (void *)(&arg -> feat_winStart_ns),           (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "FEAT_WIN_ET",       (void *)(&arg -> feat_winEnd_ns),             (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "FEAT_CH_SEL",       (void *)(&arg -> feat_chSel),                 (void *)arg, 1, &arg -> config_ioScan, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LO, INTD_IOINT);
+
+    status += FWC_sis8300_eicsys_iqfb_func_featCreateData(moduleName, "FEAT_REF_CH",      &arg->pub_frame.feat[0], &arg->pub_queue.ioScan);
+    status += FWC_sis8300_eicsys_iqfb_func_featCreateData(moduleName, "FEAT_FBK_CH",      &arg->pub_frame.feat[1], &arg->pub_queue.ioScan);
+
+    status += FWC_sis8300_eicsys_iqfb_func_featCreateData(moduleName, "FEAT_TRACKED",     &arg->pub_frame.feat[2], &arg->pub_queue.ioScan);
+    status += FWC_sis8300_eicsys_iqfb_func_featCreateData(moduleName, "FEAT_ERR",         &arg->pub_frame.feat[3], &arg->pub_queue.ioScan);
+
+    status += FWC_sis8300_eicsys_iqfb_func_featCreateData(moduleName, "FEAT_ACT",         &arg->pub_frame.feat[4], &arg->pub_queue.ioScan);
+    status += FWC_sis8300_eicsys_iqfb_func_featCreateData(moduleName, "FEAT_DAC_OUT",     &arg->pub_frame.feat[5], &arg->pub_queue.ioScan);
+
+    /*-----------------------------------
+     * Pulse-to-pulse amplitude/phase feedback
+     *-----------------------------------*/
+    status += INTD_API_createDataNode(moduleName, "PFB_SRC_CH",        (void *)(&arg -> pfb_srcCh),                  (void *)arg, 1, &arg -> config_ioScan, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "PFB_BUDGET",        (void *)(&arg -> pfb_budget_us),              (void *)arg, 1, &arg -> config_ioScan, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AO, INTD_IOINT);
+    status += INTD_API_createDataNode(moduleName, "B_AMP_SCALE_RB",    (void *)(&arg -> board_ampScale),             (void *)arg, 1, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AI, INTD_1S);
+
+    status += RFCFW_func_piCtrlCreateData(moduleName,    "PFB_AMP",        &arg->pfb_ampCtrl);
+    status += RFCFW_func_piCtrlCreateData(moduleName,    "PFB_PHA",        &arg->pfb_phaCtrl);
+
+    status += RFCFW_func_timeStatsCreateData(moduleName, "PFB_PROC_TIME",  &arg->pfb_procTime);
+    status += RFCFW_func_timeStatsCreateData(moduleName, "PFB_LOOP_TIME",  &arg->pfb_loopTime);
+
+    /*-----------------------------------
+     * Iterative learning control of the set point table
+     *-----------------------------------*/
+    status += RFCFW_func_ilcCreateData(moduleName,       "ILC",            &arg->ilc);
+
+    /*-----------------------------------
+     * Ramps of the settings
+     *-----------------------------------*/
+    status += RFCFW_func_rampCreateData(moduleName,      "RAMP_GAIN_I",    &arg->ramp_gainI, 1);
+    status += RFCFW_func_rampCreateData(moduleName,      "RAMP_GAIN_Q",    &arg->ramp_gainQ, 1);
+    status += RFCFW_func_rampCreateData(moduleName,      "RAMP_FF_I",      &arg->ramp_FFI,   1);
+    status += RFCFW_func_rampCreateData(moduleName,      "RAMP_FF_Q",      &arg->ramp_FFQ,   1);
+    status += RFCFW_func_rampCreateData(moduleName,      "RAMP_SP",        &arg->ramp_SP,    0);
+
+    status += INTD_API_createDataNode(moduleName, "RAMP_SP_TGT_I",     (void *)(arg -> ramp_SPTargetI),              (void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_WFO, INTD_PASSIVE);  /* w */
+    status += INTD_API_createDataNode(moduleName, "RAMP_SP_TGT_Q",     (void *)(arg -> ramp_SPTargetQ),              (void *)arg, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_WFO, INTD_PASSIVE);  /* w */
+
+    /*-----------------------------------
+     * Regions of interest of the DAQ readout
+     *-----------------------------------*/
+    status += RFCFW_func_roiCreateData(moduleName, &arg->roi, &arg->config_ioScan);
+
+    /*-----------------------------------
+     * Wake-up of the pulse thread
+     *-----------------------------------*/
+    status += RFCFW_func_wakeCreateData(moduleName, &arg->wake, &arg->config_ioScan);
+
+    /*-----------------------------------
+     * Staged commit of the parameters
+     *-----------------------------------*/
+    status += INTD_API_createDataNode(moduleName, "B_STAGED_COMMIT",   (void *)(&arg -> stage_enable),               (void *)arg, 1, &arg -> config_ioScan, INTD_USHORT, NULL, NULL, NULL, NULL, INTD_BO, INTD_IOINT);
+    status += RFCFW_func_timeStatsCreateData(moduleName, "STAGE_COMMIT_TIME", &arg->stage_commitTime);
+
+    /*-----------------------------------
+     * Cached snapshot of the status registers
+     *-----------------------------------*/
+    status += INTD_API_createDataNode(moduleName, "STAT_MAX_AGE",  (void *)(&arg -> stat_maxAge_ms),            (void *)arg, 1, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AO, INTD_PASSIVE);
+    status += INTD_API_createDataNode(moduleName, "STAT_READ_CNT", (void *)(&arg -> stat_readCnt),              (void *)arg, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);      /* r */
+    status += INTD_API_createDataNode(moduleName, "STAT_HIT_CNT",  (void *)(&arg -> stat_hitCnt),               (void *)arg, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);      /* r */
+
+    /*-----------------------------------
+     * Queue of the readouts to the EPICS publishing, the published readout is processed with the I/O interrupt
+     *-----------------------------------*/
+    status += INTD_API_createDataNode(moduleName, "PUB_SEQ",       (void *)(&arg -> pub_frame.seq),            (void *)arg, 1, &arg -> pub_queue.ioScan, INTD_LONG, NULL, NULL, NULL, NULL, INTD_LI, INTD_IOINT);    /* r */
+    status += INTD_API_createDataNode(moduleName, "PUB_PNO",       (void *)(&arg -> pub_frame.pno),            (void *)arg, 1, &arg -> pub_queue.ioScan, INTD_LONG, NULL, NULL, NULL, NULL, INTD_LI, INTD_IOINT);    /* r */
+    status += INTD_API_createDataNode(moduleName, "PUB_BANK",      (void *)(&arg -> pub_frame.bank),           (void *)arg, 1, &arg -> pub_queue.ioScan, INTD_LONG, NULL, NULL, NULL, NULL, INTD_LI, INTD_IOINT);    /* r */
+    status += INTD_API_createDataNode(moduleName, "PUB_SHARE_SEL", (void *)(&arg -> pub_frame.shareSel),       (void *)arg, 1, &arg -> pub_queue.ioScan, INTD_LONG, NULL, NULL, NULL, NULL, INTD_LI, INTD_IOINT);    /* r */
+    status += INTD_API_createDataNode(moduleName, "PUB_SEQ_SET0",  (void *)(&arg -> pub_frame.setSeq[0]),      (void *)arg, 1, &arg -> pub_queue.ioScan, INTD_LONG, NULL, NULL, NULL, NULL, INTD_LI, INTD_IOINT);    /* r, ref/fbk/tracked */
+    status += INTD_API_createDataNode(moduleName, "PUB_SEQ_SET1",  (void *)(&arg -> pub_frame.setSeq[1]),      (void *)arg, 1, &arg -> pub_queue.ioScan, INTD_LONG, NULL, NULL, NULL, NULL, INTD_LI, INTD_IOINT);    /* r, err/act/DAC output */
+    status += INTD_API_createDataNode(moduleName, "PUB_ROI_SEG_NUM", (void *)(&arg -> pub_frame.segNum),       (void *)arg, 1, &arg -> pub_queue.ioScan, INTD_LONG, NULL, NULL, NULL, NULL, INTD_LI, INTD_IOINT);    /* r */
+
+    for(i = 0; i < RFCFW_CONST_ROI_NUM; i ++) {
+        snprintf(var_dataName, sizeof(var_dataName), "PUB_ROI_SEG%d_START", i);
+        status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&arg -> pub_frame.segStart[i]),     (void *)arg, 1, &arg -> pub_queue.ioScan, INTD_LONG, NULL, NULL, NULL, NULL, INTD_LI, INTD_IOINT);    /* r */
+
+        snprintf(var_dataName, sizeof(var_dataName), "PUB_ROI_SEG%d_PNO", i);
+        status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&arg -> pub_frame.segPno[i]),       (void *)arg, 1, &arg -> pub_queue.ioScan, INTD_LONG, NULL, NULL, NULL, NULL, INTD_LI, INTD_IOINT);    /* r */
+    }
+
+    status += RFCFW_func_pubQueueCreateData(moduleName, &arg->pub_queue);
+
     return status;
 }
 
@@ -661,23 +773,208 @@ int FWC_sis8300_eicsys_iqfb_func_deleteEpicsData(void *module, const char *modul
     return 0;
 }
 
+/*======================================
+ * Configuration snapshot and restore
+ *======================================*/
+/* Settings saved in the configuration snapshot, the readings, the intermediate data, the command bits (e.g. reset) and
+ *   the usage status are not included, a restore must not reset the board or claim it */
+static const RFCFW_struc_configItem FWC_sis8300_eicsys_iqfb_gvar_configItems[] = {
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_clkDiv2),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_ADCClockSel),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_triggerSource),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_refTrackEnabled),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_DACOutputEnabled),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_DACConOutputEnabled),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_IRQEnabled),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_DACOutSel),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_edgeSelAcc),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_edgeSelStdby),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_edgeSelSpare),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_DAQShareSel),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_DAQShareAlt),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_DAQShareAltPulses),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_fbEnable),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_refChSel),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_fbkChSel),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_triggerModeSel),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_extTriggerRateDivRatio),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_DACOffsetI),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_DACOffsetQ),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_ampLimitHi),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_ampLimitLo),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_ADCSamplePno),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_ADCAutoPno),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_ADCTailMargin_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_DAQPingPong),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_coefIdOffset),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_corrLimitI),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_corrLimitQ),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_sampleFreq_MHz),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_extTriggerDelayAcc_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_extTriggerDelayStdby_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_extTriggerDelaySpare_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_intTriggerPeriod_ms),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_RFPulseLength_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_DAQTriggerDelay_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_refPhaseSP_deg),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_fbkRotationGain),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_fbkRotationAngle_deg),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_actRotationGain),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_actRotationAngle_deg),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_ampScale),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_feedforwardI_MV),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_feedforwardQ_MV),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_voltageFactor_perMV),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_gainI),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_gainQ),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_intgStart_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_intgEnd_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_applyStart_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_applyEnd_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_imbalanceMatrixA11),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_imbalanceMatrixA12),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_imbalanceMatrixA21),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_imbalanceMatrixA22),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_setPointTable_I),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_setPointTable_Q),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_drvRotScaleTable),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, board_drvRotAngleTable),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, feat_winStart_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, feat_winEnd_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, feat_chSel),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, pfb_srcCh),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, pfb_budget_us),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, stage_enable),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, roi.enable),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, roi.start_ns),
+    RFCFW_CONFIG_ITEM(FWC_sis8300_eicsys_iqfb_struc_data, roi.end_ns),
+};
+
+#define FWC_SIS8300_EICSYS_IQFB_CONST_CONFIG_ITEM_NUM   (long)(sizeof(FWC_sis8300_eicsys_iqfb_gvar_configItems) / sizeof(RFCFW_struc_configItem))
 
+/**
+ * Program all settings to the board in one ordered pass: platform settings and trigger, timing, channel selection and
+ *   limits, loop parameters, tables (each uploaded once), and finally the control bits which enable the outputs
+ */
+static void FWC_sis8300_eicsys_iqfb_func_applyConfig(FWC_sis8300_eicsys_iqfb_struc_data *arg)
+{
+    /* stop the ramps, they would move the settings away from the restored values */
+    arg -> ramp_gainI.abort = 1;
+    arg -> ramp_gainQ.abort = 1;
+    arg -> ramp_FFI.abort   = 1;
+    arg -> ramp_FFQ.abort   = 1;
+    arg -> ramp_SP.abort    = 1;
+
+    /* regions of interest, applied at next pulse */
+    arg -> roi.pending      = 1;
+
+    /* output records of the settings read back the restored values */
+    if(arg -> config_ioScan) scanIoRequest(arg -> config_ioScan);
+
+    if(!arg -> board_handle) return;
+
+    /* platform and trigger */
+    FWC_sis8300_eicsys_iqfb_func_setADCClockSource(arg -> board_handle, (unsigned int)arg -> board_ADCClockSel);
+    FWC_sis8300_eicsys_iqfb_func_selectTrigMode(arg -> board_handle, (unsigned int)arg -> board_triggerModeSel);
+    FWC_sis8300_eicsys_iqfb_func_setTrigRateDiv(arg -> board_handle, (unsigned int)arg -> board_extTriggerRateDivRatio);
+
+    /* timing, the time axis is built once */
+    FWC_sis8300_eicsys_iqfb_func_writeTiming(arg);                      /* the DAQ size is written at the next pulse, see roi.pending */
+
+    /* channel selection, offsets and limits */
+    FWC_sis8300_eicsys_iqfb_func_selectRefFbkChannel(arg -> board_handle, (unsigned int)arg -> board_refChSel, (unsigned int)arg -> board_fbkChSel);
+    FWC_sis8300_eicsys_iqfb_func_setNonIQCoefOffset(arg -> board_handle, (unsigned int)arg -> board_coefIdOffset);
+    FWC_sis8300_eicsys_iqfb_func_setFeedbackCorrLimits(arg -> board_handle, (unsigned int)arg -> board_corrLimitI, (unsigned int)arg -> board_corrLimitQ);
+    FWC_sis8300_eicsys_iqfb_func_setDACOffset_I(arg -> board_handle, (unsigned int)arg -> board_DACOffsetI);
+    FWC_sis8300_eicsys_iqfb_func_setDACOffset_Q(arg -> board_handle, (unsigned int)arg -> board_DACOffsetQ);
+    FWC_sis8300_eicsys_iqfb_func_setAmpLimitHi(arg -> board_handle, (unsigned int)arg -> board_ampLimitHi);
+    FWC_sis8300_eicsys_iqfb_func_setAmpLimitLo(arg -> board_handle, (unsigned int)arg -> board_ampLimitLo);
+    FWC_sis8300_eicsys_iqfb_func_setRefPhaSP(arg -> board_handle, arg -> board_refPhaseSP_deg);
+
+    /* loop parameters, written together (staged to the next pulse boundary if the staged commit is enabled) */
+    FWC_sis8300_eicsys_iqfb_func_writeParam(arg, FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_GAIN | FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_FF | FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_IQ_CORR | FWC_SIS8300_EICSYS_IQFB_CONST_PARAM_ROT);
+
+    /* tables */
+    if(arg -> board_tabMutex) epicsMutexMustLock(arg -> board_tabMutex);
+    FWC_sis8300_eicsys_iqfb_func_setIQSPTable(arg -> board_handle, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH, arg -> board_setPointTable_I, arg -> board_setPointTable_Q);
+    FWC_sis8300_eicsys_iqfb_func_setDrvRotationTable(arg -> board_handle, FWC_SIS8300_EICSYS_IQFB_CONST_DRV_TAB_BUF_DEPTH, arg -> board_drvRotScaleTable, arg -> board_drvRotAngleTable);
+    if(arg -> board_tabMutex) epicsMutexUnlock(arg -> board_tabMutex);
+    RFCFW_func_ilcSetBase(&arg -> ilc, arg -> board_setPointTable_I, arg -> board_setPointTable_Q, FWC_SIS8300_EICSYS_IQFB_CONST_SP_TAB_BUF_DEPTH, 1);       /* applied by the pulse thread or while no pulse comes */
+
+    /* control bits, the reset bit is not restored and keeps its current value */
+    FWC_sis8300_eicsys_iqfb_func_writeBits(arg);
+}
 
+/**
+ * Save the settings of the module to a binary file
+ * Input:
+ *   module         : Data structure of the module
+ *   fileName       : Name of the file
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int FWC_sis8300_eicsys_iqfb_func_saveConfig(void *module, const char *fileName)
+{
+    FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)module;
 
+    if(!arg) return -1;
 
+    return RFCFW_func_configSave(fileName, "SIS8300:EICSYS:IQFB", (const void *)arg, FWC_sis8300_eicsys_iqfb_gvar_configItems, FWC_SIS8300_EICSYS_IQFB_CONST_CONFIG_ITEM_NUM);
+}
 
+/**
+ * Restore the settings of the module from a binary file and program them to the board. This replaces the replay of the
+ *   PVs one by one, each write callback (e.g. the timing) is executed only once. The settings are applied by the pulse
+ *   thread right after the interrupt, so that no pulse sees them half-restored; if no pulse comes within the timeout
+ *   (e.g. no trigger), they are applied here. The output records of the settings are processed afterwards with the
+ *   restored values
+ * Input:
+ *   module         : Data structure of the module
+ *   fileName       : Name of the file
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed, the settings are not changed
+ */
+int FWC_sis8300_eicsys_iqfb_func_restoreConfig(void *module, const char *fileName)
+{
+    int   status;
+    char *var_buf;
+    FWC_sis8300_eicsys_iqfb_struc_data *arg = (FWC_sis8300_eicsys_iqfb_struc_data *)module;
 
+    if(!arg) return -1;
 
+    var_buf = RFCFW_func_configRead(fileName, "SIS8300:EICSYS:IQFB", FWC_sis8300_eicsys_iqfb_gvar_configItems, FWC_SIS8300_EICSYS_IQFB_CONST_CONFIG_ITEM_NUM);
+    if(!var_buf) return -1;
 
+    status = RFCFW_func_configPost(&arg -> config_pending, var_buf, RFCFW_CONST_CONFIG_POST_TIMEOUT);
 
+    if(status == 1) {
+        RFCFW_func_configCopy((void *)arg, var_buf, FWC_sis8300_eicsys_iqfb_gvar_configItems, FWC_SIS8300_EICSYS_IQFB_CONST_CONFIG_ITEM_NUM);
+        FWC_sis8300_eicsys_iqfb_func_applyConfig(arg);
+    }
 
+    free(var_buf);
 
+    return status < 0 ? -1 : 0;
+}
 
+/**
+ * Apply the configuration handed over by the restore, called by the pulse thread right after the interrupt
+ * Input:
+ *   arg            : Data structure of the module
+ */
+void FWC_sis8300_eicsys_iqfb_func_commitConfig(FWC_sis8300_eicsys_iqfb_struc_data *arg)
+{
+    char *var_buf;
 
+    if(!arg) return;
 
+    var_buf = RFCFW_func_configTake(&arg -> config_pending);
+    if(!var_buf) return;
 
+    RFCFW_func_configCopy((void *)arg, var_buf, FWC_sis8300_eicsys_iqfb_gvar_configItems, FWC_SIS8300_EICSYS_IQFB_CONST_CONFIG_ITEM_NUM);
+    FWC_sis8300_eicsys_iqfb_func_applyConfig(arg);
 
-
-
-
-
+    RFCFW_func_configDone(&arg -> config_pending);
+}
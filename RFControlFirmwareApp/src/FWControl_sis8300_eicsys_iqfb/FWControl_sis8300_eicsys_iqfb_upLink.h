@@ -26,6 +26,13 @@ extern "C" {
 int FWC_sis8300_eicsys_iqfb_func_createEpicsData(void *module, const char *moduleName);
 int FWC_sis8300_eicsys_iqfb_func_deleteEpicsData(void *module, const char *moduleName);
 
+/**
+ * Snapshot and restore of the configuration (virtual function implementation)
+ */
+int  FWC_sis8300_eicsys_iqfb_func_saveConfig(void *module, const char *fileName);
+int  FWC_sis8300_eicsys_iqfb_func_restoreConfig(void *module, const char *fileName);
+void FWC_sis8300_eicsys_iqfb_func_commitConfig(FWC_sis8300_eicsys_iqfb_struc_data *arg);     /* called by the pulse thread */
+
 #ifdef __cplusplus
 }
 #endif
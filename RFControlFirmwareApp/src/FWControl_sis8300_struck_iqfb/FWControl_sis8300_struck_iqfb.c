@@ -18,8 +18,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
 #include "FWControl_sis8300_struck_iqfb.h"
+#include "FWControl_sis8300_struck_iqfb_upLink.h"
 
 /*======================================
  * Private Data and Routines 
@@ -90,6 +92,554 @@ static int FWC_sis8300_struck_iqfb_func_getDAQDoubleChannel(unsigned int *DAQDat
 
     return status;
 }
+
+/**
+ * Get all channels of the DAQ system in a single pass of the DAQ buffer. The 4 channels of a buffer are unpacked in the
+ *   same loop, the loop has no data dependent branches and constant strides, so that it is vectorized by the compiler.
+ * Input:
+ *   DAQData    : Raw data read from the hardware
+ *   data       : Destination of the channels 0 - 4 * FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_NUM - 1, NULL for the
+ *                channels not needed (the buffer of which is skipped if all of its 4 channels are not needed)
+ *   pno        : Number of points of each channel, not larger than FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed
+ */
+static int FWC_sis8300_struck_iqfb_func_getDAQAllChannels(unsigned int *DAQData, short **data, int pno)
+{
+    int i, j;
+    short *dataStart_short;                                     /* 4 channels of a buffer, from channel 3 to 0 */
+    short *ptr_ch0, *ptr_ch1, *ptr_ch2, *ptr_ch3;
+
+    /* check the input */
+    if(!DAQData || !data || pno < 0 || pno > FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH) return -1;
+
+    for(i = 0; i < FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_NUM; i ++) {
+        ptr_ch0 = data[4 * i];
+        ptr_ch1 = data[4 * i + 1];
+        ptr_ch2 = data[4 * i + 2];
+        ptr_ch3 = data[4 * i + 3];
+
+        if(!ptr_ch0 && !ptr_ch1 && !ptr_ch2 && !ptr_ch3) continue;
+
+        dataStart_short = (short *)(DAQData + i * 2 * FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH);
+
+        if(ptr_ch0 && ptr_ch1 && ptr_ch2 && ptr_ch3) {
+            for(j = 0; j < pno; j ++) {
+                ptr_ch3[j] = dataStart_short[4 * j];
+                ptr_ch2[j] = dataStart_short[4 * j + 1];
+                ptr_ch1[j] = dataStart_short[4 * j + 2];
+                ptr_ch0[j] = dataStart_short[4 * j + 3];
+            }
+        } else {
+            for(j = 0; j < pno; j ++) {
+                if(ptr_ch3) ptr_ch3[j] = dataStart_short[4 * j];
+                if(ptr_ch2) ptr_ch2[j] = dataStart_short[4 * j + 1];
+                if(ptr_ch1) ptr_ch1[j] = dataStart_short[4 * j + 2];
+                if(ptr_ch0) ptr_ch0[j] = dataStart_short[4 * j + 3];
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Get the I/Q waveforms of the DAQ system in a single pass, the I is the channel chId and the Q is the channel chId + 1
+ *   (the same as FWC_sis8300_struck_iqfb_func_getDAQDoubleChannel). If several waveforms use the same channels, they
+ *   are copied from the first one
+ * Input:
+ *   DAQData    : Raw data read from the hardware
+ *   wf         : Waveforms to be filled
+ *   wfNum      : Number of waveforms
+ * Return:
+ *   0          : Successful
+ *  <=-1        : Failed
+ */
+static int FWC_sis8300_struck_iqfb_func_getDAQWaveforms(unsigned int *DAQData, RFLIB_struc_RFWaveform **wf, int wfNum)
+{
+    int i;
+    int status = 0;
+    int var_chId;
+    short *var_data[4 * FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_NUM] = {NULL};
+
+    /* check the input */
+    if(!DAQData || !wf) return -1;
+
+    /* map the channels to the waveforms */
+    for(i = 0; i < wfNum; i ++) {
+        var_chId = (int)wf[i] -> chId;
+
+        if(var_chId < 0 || var_chId + 1 >= 4 * FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_NUM) {
+            status --;
+            continue;
+        }
+
+        if(!var_data[var_chId])     var_data[var_chId]     = wf[i] -> wfI;
+        if(!var_data[var_chId + 1]) var_data[var_chId + 1] = wf[i] -> wfQ;
+    }
+
+    /* unpack all channels */
+    if(FWC_sis8300_struck_iqfb_func_getDAQAllChannels(DAQData, var_data, FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH) != 0) return -1;
+
+    /* waveforms sharing the channels with another one */
+    for(i = 0; i < wfNum; i ++) {
+        var_chId = (int)wf[i] -> chId;
+
+        if(var_chId < 0 || var_chId + 1 >= 4 * FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_NUM) continue;
+
+        if(var_data[var_chId] != wf[i] -> wfI)
+            memcpy((void *)wf[i] -> wfI, (void *)var_data[var_chId],     sizeof(short) * FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH);
+        if(var_data[var_chId + 1] != wf[i] -> wfQ)
+            memcpy((void *)wf[i] -> wfQ, (void *)var_data[var_chId + 1], sizeof(short) * FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH);
+    }
+
+    return status;
+}
+
+/**
+ * Get the features of an RF waveform, the id is in the order of RFCFW_CONST_FEAT_CH_*
+ */
+static RFCFW_struc_pulseFeature *FWC_sis8300_struck_iqfb_func_getFeature(FWC_sis8300_struck_iqfb_struc_data *arg, long id)
+{
+    switch(id) {
+        case 0:  return &arg -> feat_refCh;
+        case 1:  return &arg -> feat_fbkCh;
+        case 2:  return &arg -> feat_tracked;
+        case 3:  return &arg -> feat_err;
+        case 4:  return &arg -> feat_act;
+        case 5:  return &arg -> feat_DACOut;
+        default: return NULL;
+    }
+}
+
+/**
+ * Get the mask bit of an RF waveform, 0 for illegal id
+ */
+static long FWC_sis8300_struck_iqfb_func_getFeatureMask(long id)
+{
+    return (id >= 0 && id < 6) ? (1 << id) : 0;
+}
+
+/**
+ * Calculate the per-pulse scalar features for the selected RF waveforms, return the mask of the waveforms with valid features
+ */
+static long FWC_sis8300_struck_iqfb_func_calcFeatures(FWC_sis8300_struck_iqfb_struc_data *arg, long pno, long chMask)
+{
+    int  i;
+    long var_validMask = 0;
+
+    RFLIB_struc_RFWaveform *wf[6] = {&arg -> rfData_refCh,  &arg -> rfData_fbkCh,
+                                     &arg -> rfData_tracked, &arg -> rfData_err,
+                                     &arg -> rfData_act,     &arg -> rfData_DACOut};
+
+    for(i = 0; i < 6; i ++) {
+        if((chMask & (1 << i)) && 
+           RFCFW_func_calcPulseFeature(wf[i] -> wfI, wf[i] -> wfQ, pno, wf[i] -> sampleFreq_MHz, wf[i] -> sampleDelay_ns,
+                                       arg -> feat_winStart_ns, arg -> feat_winEnd_ns, FWC_sis8300_struck_iqfb_func_getFeature(arg, i)) == 0)
+            var_validMask |= (1 << i);
+    }
+
+    return var_validMask;
+}
+
+/**
+ * Write the parameters to the firmware
+ * Input:
+ *   arg        : Data of the module
+ *   mask       : Parameters to write, see the _CONST_PARAM_*
+ */
+static void FWC_sis8300_struck_iqfb_func_writeParamToFw(FWC_sis8300_struck_iqfb_struc_data *arg, unsigned long mask)
+{
+    if(!arg -> board_handle) return;
+
+    if(mask & FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_GAIN) {
+        FWC_sis8300_struck_iqfb_func_setGain_I(arg -> board_handle, arg -> board_gainI * arg -> board_fbEnable);
+        FWC_sis8300_struck_iqfb_func_setGain_Q(arg -> board_handle, arg -> board_gainQ * arg -> board_fbEnable);
+    }
+
+    if(mask & FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_FF) {
+        FWC_sis8300_struck_iqfb_func_setFeedforward_I(arg -> board_handle, arg -> board_feedforwardI_MV, arg -> board_voltageFactor_perMV);
+        FWC_sis8300_struck_iqfb_func_setFeedforward_Q(arg -> board_handle, arg -> board_feedforwardQ_MV, arg -> board_voltageFactor_perMV);
+    }
+
+    if(mask & FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_IQ_CORR) {
+        FWC_sis8300_struck_iqfb_func_setImbalanceCorrMatrix(arg -> board_handle, arg -> board_imbalanceMatrixA11, 
+                                                            arg -> board_imbalanceMatrixA12, 
+                                                            arg -> board_imbalanceMatrixA21, 
+                                                            arg -> board_imbalanceMatrixA22);
+    }
+
+    if(mask & FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_ROT) {
+        FWC_sis8300_struck_iqfb_func_setFbkVectorRotation(arg -> board_handle, arg -> board_fbkRotationGain, arg -> board_fbkRotationAngle_deg);
+        FWC_sis8300_struck_iqfb_func_setActVectorRotation(arg -> board_handle, arg -> board_actRotationGain, arg -> board_actRotationAngle_deg);
+    }
+}
+
+/**
+ * Write the parameters to the firmware immediately, or mark them as pending if the staged commit is enabled, so that
+ *   the parameters belong together (e.g. the gains of I/Q) can not be seen half-updated by a pulse
+ * Input:
+ *   arg        : Data of the module
+ *   mask       : Parameters to write, see the _CONST_PARAM_*
+ */
+void FWC_sis8300_struck_iqfb_func_writeParam(FWC_sis8300_struck_iqfb_struc_data *arg, unsigned long mask)
+{
+    if(!arg) return;
+
+    if(arg -> stage_enable && arg -> stage_mutex) {
+        epicsMutexLock(arg -> stage_mutex);
+        arg -> stage_pending |= mask;
+        epicsMutexUnlock(arg -> stage_mutex);
+    } else {
+        FWC_sis8300_struck_iqfb_func_writeParamToFw(arg, mask);
+    }
+}
+
+/**
+ * Commit all staged parameters, called right after the interrupt so that they are written together in the gap 
+ *   between two pulses
+ * Input:
+ *   arg        : Data of the module
+ */
+static void FWC_sis8300_struck_iqfb_func_commitParam(FWC_sis8300_struck_iqfb_struc_data *arg)
+{
+    unsigned long var_mask;
+    double var_startTime_us;
+
+    if(!arg -> stage_mutex) return;
+
+    epicsMutexLock(arg -> stage_mutex);
+    var_mask             = arg -> stage_pending;
+    arg -> stage_pending = 0;
+    epicsMutexUnlock(arg -> stage_mutex);
+
+    if(!var_mask) return;
+
+    var_startTime_us = RFCFW_func_getTime_us();
+
+    FWC_sis8300_struck_iqfb_func_writeParamToFw(arg, var_mask);
+
+    RFCFW_func_timeStatsUpdate(&arg -> stage_commitTime, RFCFW_func_getTime_us() - var_startTime_us, arg -> pfb_budget_us);
+}
+
+/**
+ * Apply the phase and amplitude adjustment to: 1). measurement chain rotation; 2). driving chain rotation. 
+ *   Only the settings are changed, the caller writes both rotations to the firmware together (PARAM_ROT)
+ * Input:
+ *   arg        : Data of the module
+ *   pha_deg    : Phase change in degree
+ *   ampRatio   : Relative change of the amplitude (1.0 for no change)
+ */
+static void FWC_sis8300_struck_iqfb_func_applyRotation(FWC_sis8300_struck_iqfb_struc_data *arg, double pha_deg, double ampRatio)
+{
+    double var_scale = arg -> board_ampScale * ampRatio;
+
+    if(var_scale < RFCFW_CONST_AMP_SCALE_MIN) var_scale = RFCFW_CONST_AMP_SCALE_MIN;
+    if(var_scale > RFCFW_CONST_AMP_SCALE_MAX) var_scale = RFCFW_CONST_AMP_SCALE_MAX;
+
+    arg -> board_fbkRotationAngle_deg -= pha_deg;
+    arg -> board_actRotationAngle_deg += pha_deg;
+
+    arg -> board_fbkRotationGain      = 1.0 / var_scale;     /* these rotations are only used for fast phase/amplitude adjustment! */
+    arg -> board_actRotationGain      = var_scale;
+    arg -> board_ampScale             = var_scale;
+}
+
+/**
+ * Run the pulse-to-pulse feedback with the features of this pulse, the corrections are applied with the vector rotations
+ * Input:
+ *   arg        : Data of the module
+ *   validMask  : Mask of the waveforms with valid features of this pulse
+ *   startTime  : Time (us) when the processing of this pulse started
+ */
+static void FWC_sis8300_struck_iqfb_func_runPulseFeedback(FWC_sis8300_struck_iqfb_struc_data *arg, long validMask, double startTime_us)
+{
+    double var_err;
+    double var_corrAmp;
+    double var_corrPha;
+    double var_time_us;
+
+    RFCFW_struc_pulseFeature *feat = FWC_sis8300_struck_iqfb_func_getFeature(arg, arg -> pfb_srcCh);
+
+    /* the measurement must be updated in this pulse */
+    if(!feat || !(validMask & FWC_sis8300_struck_iqfb_func_getFeatureMask(arg -> pfb_srcCh))) return;
+
+    /* amplitude error normalized to the set point */
+    var_err     = arg -> pfb_ampCtrl.sp > 0.0 ? (arg -> pfb_ampCtrl.sp - feat -> amp) / arg -> pfb_ampCtrl.sp : 0.0;
+    var_corrAmp = RFCFW_func_piCtrlUpdate(&arg -> pfb_ampCtrl, var_err);
+
+    /* phase error wrapped to [-180, 180) */
+    var_err     = arg -> pfb_phaCtrl.sp - feat -> pha_deg;
+    var_err    -= 360.0 * floor((var_err + 180.0) / 360.0);
+    var_corrPha = RFCFW_func_piCtrlUpdate(&arg -> pfb_phaCtrl, var_err);
+
+    /* apply the corrections */
+    if(!arg -> pfb_ampCtrl.enable && !arg -> pfb_phaCtrl.enable) return;
+
+    FWC_sis8300_struck_iqfb_func_applyRotation(arg, var_corrPha, 1.0 + var_corrAmp);
+    FWC_sis8300_struck_iqfb_func_writeParamToFw(arg, FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_ROT);                   /* already in the gap between pulses, no need to stage */
+
+    /* timing */
+    var_time_us = RFCFW_func_getTime_us();
+
+    RFCFW_func_timeStatsUpdate(&arg -> pfb_procTime, var_time_us - startTime_us, arg -> pfb_budget_us);
+
+    if(arg -> pfb_intrTime_us > 0.0)
+        RFCFW_func_timeStatsUpdate(&arg -> pfb_loopTime, var_time_us - arg -> pfb_intrTime_us, arg -> pfb_budget_us);
+}
+
+/**
+ * Run the iterative learning of the set point table with the error waveform of this pulse, and upload the changed
+ *   region of the table
+ * Input:
+ *   arg        : Data of the module
+ *   pno        : Point number of the error waveform
+ */
+static void FWC_sis8300_struck_iqfb_func_runILC(FWC_sis8300_struck_iqfb_struc_data *arg, long pno)
+{
+    long var_updStart;
+    long var_updPno;
+    double var_startTime_us;
+
+    if(RFCFW_func_ilcUpdate(&arg -> ilc, arg -> rfData_err.wfI, arg -> rfData_err.wfQ, pno, &var_updStart, &var_updPno) != 0 || var_updPno <= 0) return;
+
+    var_startTime_us = RFCFW_func_getTime_us();
+
+    if(arg -> board_tabMutex) epicsMutexMustLock(arg -> board_tabMutex);
+    FWC_sis8300_struck_iqfb_func_setIQSPTableRange(arg -> board_handle, (unsigned int)var_updStart, (unsigned int)var_updPno, arg -> ilc.tabUpI, arg -> ilc.tabUpQ);
+    if(arg -> board_tabMutex) epicsMutexUnlock(arg -> board_tabMutex);
+
+    RFCFW_func_timeStatsUpdate(&arg -> ilc.uploadTime, RFCFW_func_getTime_us() - var_startTime_us, arg -> pfb_budget_us);
+}
+
+/**
+ * Point number of the DAQ for the next arm, the setpoint or the automatic one derived from the RF pulse length, the DAQ
+ *   trigger delay and the tail margin (rounded up to 16 points, granularity of the firmware). Checked every pulse, so
+ *   that a change of the timing is applied at the pulse boundary. The setpoint is not changed
+ * Input:
+ *   arg        : Data of the module
+ * Return:
+ *   Point number
+ */
+static long FWC_sis8300_struck_iqfb_func_getSamplePno(FWC_sis8300_struck_iqfb_struc_data *arg)
+{
+    if(!arg -> board_ADCAutoPno) return arg -> board_ADCSamplePno;
+
+    return RFCFW_func_roiWindowPno(arg -> board_RFPulseLength_ns, arg -> board_DAQTriggerDelay_ns, arg -> board_ADCTailMargin_ns,
+                                   arg -> board_sampleFreq_MHz, 16, FWC_SIS8300_STRUCK_IQFB_CONST_ADC_SAMPLE_MAX);
+}
+
+/* Wait for the interrupt of the board, for the wake-up */
+static int FWC_sis8300_struck_iqfb_func_pullIntr(void *boardHandle)
+{
+    return FWC_sis8300_struck_iqfb_func_pullInterrupt(boardHandle);
+}
+
+/**
+ * Time from the trigger to the end of the DAQ window (DAQ trigger delay plus the points captured), used by the wake-up
+ *   with the pulse counter to wait until the data is complete.
+ * Input:
+ *   arg        : Data of the module
+ * Return:
+ *   Time in us
+ */
+static double FWC_sis8300_struck_iqfb_func_getDAQWindow_us(FWC_sis8300_struck_iqfb_struc_data *arg)
+{
+    double var_window_us = 0.0;
+
+    if(arg -> board_DAQTriggerDelay_ns > 0.0) var_window_us += arg -> board_DAQTriggerDelay_ns / 1000.0;
+    if(arg -> board_sampleFreq_MHz > 0.0)     var_window_us += (double)arg -> board_ADCSamplePnoEff / arg -> board_sampleFreq_MHz;
+
+    return var_window_us;
+}
+
+/**
+ * Execute the ramps of the settings for one pulse. The new values of all ramps are calculated first, then each changed 
+ *   setting is written to the firmware once (the scalar settings go through the staged commit if enabled)
+ * Input:
+ *   arg        : Data of the module
+ */
+static void FWC_sis8300_struck_iqfb_func_runRamp(FWC_sis8300_struck_iqfb_struc_data *arg)
+{
+    int i;
+    int var_gainChanged = 0;
+    int var_FFChanged   = 0;
+    int var_SPStatus;
+    double var_frac;
+
+    /* scalar settings */
+    if(RFCFW_func_rampScalar(&arg -> ramp_gainI, &arg -> board_gainI) == 0)           var_gainChanged = 1;
+    if(RFCFW_func_rampScalar(&arg -> ramp_gainQ, &arg -> board_gainQ) == 0)           var_gainChanged = 1;
+    if(RFCFW_func_rampScalar(&arg -> ramp_FFI,   &arg -> board_feedforwardI_MV) == 0) var_FFChanged   = 1;
+    if(RFCFW_func_rampScalar(&arg -> ramp_FFQ,   &arg -> board_feedforwardQ_MV) == 0) var_FFChanged   = 1;
+
+    /* set point table */
+    var_SPStatus = RFCFW_func_rampStep(&arg -> ramp_SP, &var_frac);
+
+    if(var_SPStatus > 0) {
+        memcpy((void *)arg -> ramp_SPFromI, (void *)arg -> board_setPointTable_I, sizeof(arg -> ramp_SPFromI));
+        memcpy((void *)arg -> ramp_SPFromQ, (void *)arg -> board_setPointTable_Q, sizeof(arg -> ramp_SPFromQ));
+    }
+
+    if(var_SPStatus >= 0) {
+        for(i = 0; i < FWC_SIS8300_STRUCK_IQFB_CONST_SP_TAB_BUF_DEPTH; i ++) {
+            arg -> board_setPointTable_I[i] = arg -> ramp_SPFromI[i] + (arg -> ramp_SPTargetI[i] - arg -> ramp_SPFromI[i]) * var_frac;
+            arg -> board_setPointTable_Q[i] = arg -> ramp_SPFromQ[i] + (arg -> ramp_SPTargetQ[i] - arg -> ramp_SPFromQ[i]) * var_frac;
+        }
+    }
+
+    /* write to the firmware */
+    if(!arg -> board_handle) return;
+
+    if(var_gainChanged || var_FFChanged)
+        FWC_sis8300_struck_iqfb_func_writeParam(arg, (var_gainChanged ? FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_GAIN : 0) | (var_FFChanged ? FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_FF : 0));
+
+    if(var_SPStatus >= 0) {
+        if(arg -> board_tabMutex) epicsMutexMustLock(arg -> board_tabMutex);
+        FWC_sis8300_struck_iqfb_func_setIQSPTable(arg -> board_handle, FWC_SIS8300_STRUCK_IQFB_CONST_SP_TAB_BUF_DEPTH, arg -> board_setPointTable_I, arg -> board_setPointTable_Q);
+        if(arg -> board_tabMutex) epicsMutexUnlock(arg -> board_tabMutex);
+        RFCFW_func_ilcSetBase(&arg -> ilc, arg -> board_setPointTable_I, arg -> board_setPointTable_Q, FWC_SIS8300_STRUCK_IQFB_CONST_SP_TAB_BUF_DEPTH, 1);
+    }
+}
+
+/**
+ * Queue the waveforms of this pulse for the EPICS publishing, never waits for the publishing
+ * Input:
+ *   arg        : Data of the module
+ *   pno        : Point number of the waveforms
+ */
+static void FWC_sis8300_struck_iqfb_func_pubPush(FWC_sis8300_struck_iqfb_struc_data *arg, long pno)
+{
+    int i;
+    FWC_sis8300_struck_iqfb_struc_pubFrame *ptr_frame;
+
+    RFLIB_struc_RFWaveform *wf[FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM] = {&arg -> rfData_refCh,  &arg -> rfData_fbkCh,
+                                                                            &arg -> rfData_tracked, &arg -> rfData_err,
+                                                                            &arg -> rfData_act,     &arg -> rfData_DACOut};
+
+    arg -> pub_seq ++;
+
+    ptr_frame = (FWC_sis8300_struck_iqfb_struc_pubFrame *)RFCFW_func_pubQueuePutBegin(&arg -> pub_queue);
+    if(!ptr_frame) return;                                                  /* dropped, the queue is full */
+
+    if(pno < 0)                                           pno = 0;
+    if(pno > FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH) pno = FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH;
+
+    ptr_frame -> seq  = arg -> pub_seq;
+    ptr_frame -> pno  = pno;
+    ptr_frame -> bank = arg -> board_ADCBank;
+
+    for(i = 0; i < FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM; i ++) {
+        memcpy((void *)ptr_frame -> wfI[i], (void *)wf[i] -> wfI, sizeof(short) * pno);
+        memcpy((void *)ptr_frame -> wfQ[i], (void *)wf[i] -> wfQ, sizeof(short) * pno);
+
+        ptr_frame -> feat[i] = *FWC_sis8300_struck_iqfb_func_getFeature(arg, i);
+    }
+
+    RFCFW_func_pubQueuePutCommit(&arg -> pub_queue);
+}
+
+/**
+ * Worker thread of the burst, read back all pulses when signaled so that the bulk readout does not block the pulse
+ *   thread. The buffers are not reallocated during the readout, the burst is in progress until the status is DONE
+ */
+static void FWC_sis8300_struck_iqfb_func_burstWorker(void *ptr)
+{
+    FWC_sis8300_struck_iqfb_struc_data *arg = (FWC_sis8300_struck_iqfb_struc_data *)ptr;
+    double var_startTime_us;
+    double var_readTime_us;
+
+    while(!arg -> burst_stop) {
+        epicsEventMustWait(arg -> burst_event);
+
+        if(arg -> burst_stop) break;
+        if(arg -> burst_status != FWC_SIS8300_STRUCK_IQFB_CONST_BURST_READOUT) continue;
+
+        var_startTime_us = RFCFW_func_getTime_us();
+
+        FWC_sis8300_struck_iqfb_func_getBurstADCData(arg -> board_handle, arg -> burst_pno, (unsigned int)arg -> burst_num, arg -> burst_frame[0].ADCData);
+
+        var_readTime_us  = RFCFW_func_getTime_us() - var_startTime_us;
+
+        epicsMutexMustLock(arg -> burst_mutex);
+        arg -> burst_readTime_us = var_readTime_us;
+        arg -> burst_status      = FWC_SIS8300_STRUCK_IQFB_CONST_BURST_READ_DONE;
+        epicsMutexUnlock(arg -> burst_mutex);
+    }
+
+    epicsEventSignal(arg -> burst_exit);
+}
+
+/**
+ * Run the burst capture at the pulse boundary. The pulse k of the burst is captured in the slot k (k * pno points from
+ *   the start of the DRAM region of each channel), so the CPU only re-arms the next slot for each pulse. All pulses are
+ *   read back by the worker thread after the last one and the normal capture is armed again at the pulse after the
+ *   readout. The lock is not taken when no burst is in progress
+ * Input:
+ *   arg        : Data of the module
+ *   coefId     : Non-IQ coefficient Id of the pulse, tag of the frame
+ */
+static void FWC_sis8300_struck_iqfb_func_runBurst(FWC_sis8300_struck_iqfb_struc_data *arg, unsigned int coefId)
+{
+    FWC_sis8300_struck_iqfb_struc_burstFrame *ptr_frame;
+
+    if(arg -> burst_status == FWC_SIS8300_STRUCK_IQFB_CONST_BURST_IDLE || arg -> burst_status == FWC_SIS8300_STRUCK_IQFB_CONST_BURST_DONE) return;
+
+    epicsMutexMustLock(arg -> burst_mutex);
+
+    switch(arg -> burst_status) {
+        case FWC_SIS8300_STRUCK_IQFB_CONST_BURST_PENDING:
+            /* the normal readout of this pulse is done, capture the next pulse in the first slot */
+            arg -> burst_cnt    = 0;
+            arg -> burst_status = FWC_SIS8300_STRUCK_IQFB_CONST_BURST_CAPTURE;
+
+            FWC_sis8300_struck_iqfb_func_armADC(arg -> board_handle, arg -> burst_pno, 0);
+            break;
+
+        case FWC_SIS8300_STRUCK_IQFB_CONST_BURST_CAPTURE:
+            /* tag the frame of the pulse just captured */
+            ptr_frame = &arg -> burst_frame[arg -> burst_cnt];
+
+            ptr_frame -> seq     = arg -> burst_cnt;
+            ptr_frame -> pno     = (long)arg -> burst_pno;
+            ptr_frame -> coefId  = (long)coefId;
+            ptr_frame -> time_us = RFCFW_func_getTime_us();
+
+            arg -> burst_cnt ++;
+
+            if(arg -> burst_cnt < arg -> burst_num) {
+                FWC_sis8300_struck_iqfb_func_armADC(arg -> board_handle, arg -> burst_pno, (unsigned int)arg -> burst_cnt * (arg -> burst_pno >> 4));
+                break;
+            }
+
+            /* all captured, read them back in the worker thread */
+            arg -> burst_status = FWC_SIS8300_STRUCK_IQFB_CONST_BURST_READOUT;
+            epicsEventSignal(arg -> burst_event);
+            break;
+
+        case FWC_SIS8300_STRUCK_IQFB_CONST_BURST_READ_DONE:
+            /* back to the normal capture */
+            arg -> burst_status = FWC_SIS8300_STRUCK_IQFB_CONST_BURST_DONE;
+
+            arg -> board_ADCBankCapture  = 0;
+            arg -> board_ADCSamplePnoEff = FWC_sis8300_struck_iqfb_func_getSamplePno(arg);
+            FWC_sis8300_struck_iqfb_func_armADC(arg -> board_handle, (unsigned int)arg -> board_ADCSamplePnoEff, 0);
+            break;
+
+        case FWC_SIS8300_STRUCK_IQFB_CONST_BURST_ABORT:
+            arg -> burst_status = FWC_SIS8300_STRUCK_IQFB_CONST_BURST_IDLE;
+
+            arg -> board_ADCBankCapture  = 0;
+            arg -> board_ADCSamplePnoEff = FWC_sis8300_struck_iqfb_func_getSamplePno(arg);
+            FWC_sis8300_struck_iqfb_func_armADC(arg -> board_handle, (unsigned int)arg -> board_ADCSamplePnoEff, 0);
+            break;
+
+        default: break;
+    }
+
+    epicsMutexUnlock(arg -> burst_mutex);
+}
                    
 /*======================================
  * Public Routines (virtual function implementation)
@@ -126,6 +676,37 @@ int FWC_sis8300_struck_iqfb_func_init(void *module)
     arg -> rfData_act.chId             = 8;
     arg -> rfData_DACOut.chId          = 10;
 
+    /* Init the vector rotations and the pulse-to-pulse feedback */
+    arg -> board_ampScale = 1.0;
+    arg -> pfb_srcCh      = 1;                                              /* feedback channel */
+    arg -> pfb_budget_us  = RFCFW_CONST_PULSE_BUDGET_US;
+
+    /* Init the staged commit, the parameters are written immediately by default */
+    arg -> stage_mutex    = epicsMutexCreate();
+
+    /* Init the restore of the configuration at the pulse boundary */
+    RFCFW_func_configPendingInit(&arg -> config_pending);
+
+    /* Init the lock of the table uploads */
+    arg -> board_tabMutex = epicsMutexCreate();
+
+    /* Init the status snapshot */
+    arg -> stat_maxAge_ms = FWC_SIS8300_STRUCK_IQFB_CONST_STAT_MAX_AGE_MS;
+
+    /* Init the burst capture, the buffer is allocated when started */
+    arg -> burst_mutex    = epicsMutexCreate();
+
+    /* Init the wake-up, the interrupt is used by default */
+    RFCFW_func_wakeInit(&arg -> wake);
+
+    /* Init the iterative learning control, learn the whole table with the error waveform sampled point by point */
+    arg -> ilc.filterLen  = 1;
+    arg -> ilc.errStep    = 1.0;
+    arg -> ilc.tabEnd     = FWC_SIS8300_STRUCK_IQFB_CONST_SP_TAB_BUF_DEPTH;
+
+    RFCFW_func_ilcInit(&arg -> ilc);
+    RFCFW_func_ilcSetBase(&arg -> ilc, arg -> board_setPointTable_I, arg -> board_setPointTable_Q, FWC_SIS8300_STRUCK_IQFB_CONST_SP_TAB_BUF_DEPTH, 0);
+
     /* Init others */
     arg -> board_ADC_data[0] = arg -> board_ADC0_raw;
     arg -> board_ADC_data[1] = arg -> board_ADC1_raw;
@@ -141,6 +722,81 @@ int FWC_sis8300_struck_iqfb_func_init(void *module)
     return 0;       
 }
 
+/**
+ * Release the resources of the firmware data, called before the module is freed
+ */
+int FWC_sis8300_struck_iqfb_func_deinit(void *module)
+{
+    FWC_sis8300_struck_iqfb_struc_data *arg = (FWC_sis8300_struck_iqfb_struc_data *)module;
+
+    if(!arg) return -1;
+
+    /* Queue of the readouts to the EPICS publishing */
+    RFCFW_func_pubQueueDeinit(&arg -> pub_queue);
+
+    /* Staged commit */
+    if(arg -> stage_mutex) {
+        epicsMutexDestroy(arg -> stage_mutex);
+        arg -> stage_mutex = NULL;
+    }
+
+    /* Restore of the configuration */
+    RFCFW_func_configPendingDeinit(&arg -> config_pending);
+
+    /* Table uploads */
+    if(arg -> board_tabMutex) {
+        epicsMutexDestroy(arg -> board_tabMutex);
+        arg -> board_tabMutex = NULL;
+    }
+
+    /* Iterative learning control */
+    RFCFW_func_ilcDeinit(&arg -> ilc);
+
+    /* Burst capture, the buffers are kept if the worker thread does not exit */
+    if(arg -> burst_thread) {
+        arg -> burst_stop = 1;
+        epicsEventSignal(arg -> burst_event);
+
+        if(epicsEventWaitWithTimeout(arg -> burst_exit, FWC_SIS8300_STRUCK_IQFB_CONST_BURST_EXIT_TIMEOUT) != epicsEventWaitOK) {
+            EPICSLIB_func_errlogPrintf("FWC_sis8300_struck_iqfb_func_deinit: The worker thread of the burst does not exit\n");
+            return -1;
+        }
+
+        arg -> burst_thread = NULL;
+    }
+
+    if(arg -> burst_event) epicsEventDestroy(arg -> burst_event);
+    if(arg -> burst_exit)  epicsEventDestroy(arg -> burst_exit);
+    if(arg -> burst_mutex) epicsMutexDestroy(arg -> burst_mutex);
+
+    free(arg -> burst_buf);
+    free(arg -> burst_frame);
+
+    arg -> burst_event    = NULL;
+    arg -> burst_exit     = NULL;
+    arg -> burst_mutex    = NULL;
+    arg -> burst_buf      = NULL;
+    arg -> burst_bufSize  = 0;
+    arg -> burst_frame    = NULL;
+    arg -> burst_frameNum = 0;
+
+    return 0;
+}
+
+/**
+ * Share the lock of the control writes of the RFControlFirmware module, called after the init
+ */
+int FWC_sis8300_struck_iqfb_func_setLock(void *module, epicsMutexId lock)
+{
+    FWC_sis8300_struck_iqfb_struc_data *arg = (FWC_sis8300_struck_iqfb_struc_data *)module;
+
+    if(!arg) return -1;
+
+    arg -> fw_mutex = lock;
+
+    return 0;
+}
+
 /**
  * Get the board module handle for this firmware module
  */ 
@@ -151,6 +807,7 @@ int FWC_sis8300_struck_iqfb_func_getBoard(void *module, const char *boardModuleN
     if(!arg) return -1;
 
     arg -> board_handle = FWC_sis8300_struck_iqfb_func_getBoardHandle(boardModuleName);
+    arg -> info_valid   = 0;                                                /* read the firmware information of the new board */
 
     if(arg -> board_handle) return 0;
     else return -1;
@@ -163,25 +820,67 @@ int FWC_sis8300_struck_iqfb_func_getDAQData(void *module)
 {
     FWC_sis8300_struck_iqfb_struc_data *arg = (FWC_sis8300_struck_iqfb_struc_data *)module;
 
+    int i;
     unsigned int coefId;
+    unsigned int var_bank;
+    unsigned int var_bankNext;
+    long var_pno;
+    long var_pnoNext;
 
     if(!arg) return -1;
 
     if(arg -> board_handle) {
+        RFCFW_LAT_BEGIN();
+
         /* get the BRAM data (RF Controller internal) */
         FWC_sis8300_struck_iqfb_func_getAllDAQData(arg -> board_handle, arg -> board_bufDAQ);
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_READ_BRAM);
+
+        /* get the DRAM data (ADC raw), the bank captured is read and the other bank is armed if ping-pong is enabled. 
+           Skipped during a burst, the data stays in the DRAM until it is read back and the normal capture is armed again */
+        if(arg -> burst_status != FWC_SIS8300_STRUCK_IQFB_CONST_BURST_CAPTURE &&
+           arg -> burst_status != FWC_SIS8300_STRUCK_IQFB_CONST_BURST_READOUT &&
+           arg -> burst_status != FWC_SIS8300_STRUCK_IQFB_CONST_BURST_READ_DONE) {
+            var_bank     = arg -> board_ADCBankCapture;
+            var_bankNext = arg -> board_ADCPingPong ? (var_bank ^ 0x1) : 0;
+
+            /* the bank captured is read with the point number it was armed with, a new point number (setpoint or
+               automatic from the timing) is applied at the next arm */
+            var_pno     = arg -> board_ADCSamplePnoEff;
+            var_pnoNext = FWC_sis8300_struck_iqfb_func_getSamplePno(arg);
+
+            /* regions of interest, applied at the pulse boundary. When the segments change, the points out of the segments
+               are cleared once, so that the waveforms do not show the data of the former segments */
+            if(RFCFW_func_roiCheck(&arg -> roi, arg -> board_sampleFreq_MHz, var_pno, 2) && arg -> roi.segNum > 0) {
+                for(i = 0; i < 10; i ++)
+                    memset((void *)arg -> board_ADC_data[i], 0, sizeof(arg -> board_ADC0_raw));
+            }
+
+            FWC_sis8300_struck_iqfb_func_getAllADCData(arg -> board_handle, (unsigned int)var_pno, (unsigned int)var_pnoNext, var_bank, var_bankNext,
+                                                       arg -> roi.seg, (int)arg -> roi.segNum,
+                                                       arg -> board_ADC0_raw, arg -> board_ADC1_raw,
+                                                       arg -> board_ADC2_raw, arg -> board_ADC3_raw,
+                                                       arg -> board_ADC4_raw, arg -> board_ADC5_raw,
+                                                       arg -> board_ADC6_raw, arg -> board_ADC7_raw,
+                                                       arg -> board_ADC8_raw, arg -> board_ADC9_raw); 
+            RFCFW_LAT_MARK(RFCFW_CONST_LAT_READ_DAQ);
+
+            arg -> board_ADCBank         = (long)var_bank;
+            arg -> board_ADCBankCapture  = var_bankNext;
+            arg -> board_ADCSamplePnoEff = var_pnoNext;
+        }
 
-        /* get the DRAM data (ADC raw) */
-        FWC_sis8300_struck_iqfb_func_getAllADCData(arg -> board_handle, (unsigned int)arg -> board_ADCSamplePno, 
-                                                   arg -> board_ADC0_raw, arg -> board_ADC1_raw,
-                                                   arg -> board_ADC2_raw, arg -> board_ADC3_raw,
-                                                   arg -> board_ADC4_raw, arg -> board_ADC5_raw,
-                                                   arg -> board_ADC6_raw, arg -> board_ADC7_raw,
-                                                   arg -> board_ADC8_raw, arg -> board_ADC9_raw); 
+        /* ramps of the settings, at the pulse boundary */
+        FWC_sis8300_struck_iqfb_func_runRamp(arg);
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_CONTROL);
 
         /* get the current coefficient id for demod in CPU */
         FWC_sis8300_struck_iqfb_func_getNonIQCoefCur(arg -> board_handle, &coefId);
         arg -> board_coefIdCur = (long)coefId;
+
+        /* burst capture of the ADC data */
+        FWC_sis8300_struck_iqfb_func_runBurst(arg, coefId);
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_BURST);
     }
 
     /*int i;
@@ -229,29 +928,51 @@ int FWC_sis8300_struck_iqfb_func_getADCData(void *module, unsigned long channel,
 int FWC_sis8300_struck_iqfb_func_getIntData(void *module)
 {
     int status = 0;
+    long var_validMask;
+    double var_startTime_us = RFCFW_func_getTime_us();
 
     FWC_sis8300_struck_iqfb_struc_data *arg = (FWC_sis8300_struck_iqfb_struc_data *)module;
 
+    RFLIB_struc_RFWaveform *var_wf[FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM];
+
     /* check the input */
     if(!arg) return -1;
 
-    /* fill all waveforms */
+    var_wf[0] = &arg -> rfData_refCh;
+    var_wf[1] = &arg -> rfData_fbkCh;
+    var_wf[2] = &arg -> rfData_tracked;
+    var_wf[3] = &arg -> rfData_err;
+    var_wf[4] = &arg -> rfData_act;
+    var_wf[5] = &arg -> rfData_DACOut;
+
+    /* fill all waveforms in a single pass of the DAQ buffer */
     if(arg -> board_handle) {    
-        status += FWC_sis8300_struck_iqfb_func_getDAQDoubleChannel(arg -> board_bufDAQ, (int)arg -> rfData_refCh.chId,         arg -> rfData_refCh.wfI,         arg -> rfData_refCh.wfQ);
-        status += FWC_sis8300_struck_iqfb_func_getDAQDoubleChannel(arg -> board_bufDAQ, (int)arg -> rfData_fbkCh.chId,         arg -> rfData_fbkCh.wfI,         arg -> rfData_fbkCh.wfQ);
+        RFCFW_LAT_BEGIN();
+
+        status += FWC_sis8300_struck_iqfb_func_getDAQWaveforms(arg -> board_bufDAQ, var_wf, FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM);
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_DEINTLV);
+
+        /* scalar features of the waveforms, the one used by the pulse-to-pulse feedback is always calculated */
+        var_validMask = FWC_sis8300_struck_iqfb_func_calcFeatures(arg, FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH, arg -> feat_chSel | FWC_sis8300_struck_iqfb_func_getFeatureMask(arg -> pfb_srcCh));
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_FEATURE);
 
-        status += FWC_sis8300_struck_iqfb_func_getDAQDoubleChannel(arg -> board_bufDAQ, (int)arg -> rfData_tracked.chId,       arg -> rfData_tracked.wfI,       arg -> rfData_tracked.wfQ);
-        status += FWC_sis8300_struck_iqfb_func_getDAQDoubleChannel(arg -> board_bufDAQ, (int)arg -> rfData_err.chId,           arg -> rfData_err.wfI,           arg -> rfData_err.wfQ);
+        /* pulse-to-pulse feedback */
+        FWC_sis8300_struck_iqfb_func_runPulseFeedback(arg, var_validMask, var_startTime_us);
 
-        status += FWC_sis8300_struck_iqfb_func_getDAQDoubleChannel(arg -> board_bufDAQ, (int)arg -> rfData_act.chId,           arg -> rfData_act.wfI,           arg -> rfData_act.wfQ);
-        status += FWC_sis8300_struck_iqfb_func_getDAQDoubleChannel(arg -> board_bufDAQ, (int)arg -> rfData_DACOut.chId,        arg -> rfData_DACOut.wfI,        arg -> rfData_DACOut.wfQ);
+        /* iterative learning of the set point table */
+        FWC_sis8300_struck_iqfb_func_runILC(arg, FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH);
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_CONTROL);
+
+        /* queue the waveforms for the EPICS publishing */
+        FWC_sis8300_struck_iqfb_func_pubPush(arg, FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH);
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_PUBLISH);
     }
 
     return status;
 }
 
 /**
- * Set the phase adjustment
+ * Set the phase adjustment, the input is the phase change respect to the current setting
  */
 int FWC_sis8300_struck_iqfb_func_setPha_deg(void *module, double pha_deg)
 {
@@ -260,26 +981,25 @@ int FWC_sis8300_struck_iqfb_func_setPha_deg(void *module, double pha_deg)
     /* check the input */
     if(!arg) return -1;
 
-    /* Apply the adjustement to: 1). measurement chain rotation; 2). driving chain rotation */
-    arg -> board_fbkRotationAngle_deg -= pha_deg;
-    arg -> board_actRotationAngle_deg += pha_deg;
-             
-    arg -> board_fbkRotationGain = 1.0;   /* these rotations are only used for fast phase rotation! */
-    arg -> board_actRotationGain = 1.0;
-
-    if(arg -> board_handle) {
-        FWC_sis8300_struck_iqfb_func_setFbkVectorRotation(arg -> board_handle, arg -> board_fbkRotationGain, arg -> board_fbkRotationAngle_deg);
-        FWC_sis8300_struck_iqfb_func_setActVectorRotation(arg -> board_handle, arg -> board_actRotationGain, arg -> board_actRotationAngle_deg);
-    }
+    FWC_sis8300_struck_iqfb_func_applyRotation(arg, pha_deg, 1.0);
+    FWC_sis8300_struck_iqfb_func_writeParam(arg, FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_ROT);
 
     return 0;
 }
 
 /**
- * Set amplitude (not supported now)
+ * Set the amplitude adjustment, the input is the ratio of the amplitude respect to the current setting (e.g. 1.01 to increase 1%)
  */
 int FWC_sis8300_struck_iqfb_func_setAmp(void *module, double amp)
 {
+    FWC_sis8300_struck_iqfb_struc_data *arg = (FWC_sis8300_struck_iqfb_struc_data *)module;
+
+    /* check the input */
+    if(!arg || amp <= 0.0) return -1;
+
+    FWC_sis8300_struck_iqfb_func_applyRotation(arg, 0.0, amp);
+    FWC_sis8300_struck_iqfb_func_writeParam(arg, FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_ROT);
+
     return 0;
 }
 
@@ -295,9 +1015,22 @@ int FWC_sis8300_struck_iqfb_func_waitIntr(void *module)
     /* check the input */
     if(!arg) return -1;
 
-    /* wait the interrupt */
+    /* wait the interrupt (or spin on the pulse counter before the predicted trigger in the hybrid mode) */
     if(arg -> board_handle)
-        status = FWC_sis8300_struck_iqfb_func_pullInterrupt(arg -> board_handle);
+        status = RFCFW_func_wakeWait(&arg -> wake, arg -> board_handle, arg -> board_meaTriggerPeriod_ms, FWC_sis8300_struck_iqfb_func_getDAQWindow_us(arg),
+                                     FWC_sis8300_struck_iqfb_func_pullIntr, FWC_sis8300_struck_iqfb_func_getPulseCounter);
+
+    arg -> pfb_intrTime_us = RFCFW_func_getTime_us();
+
+    /* start the latency breakdown of the pulse */
+    RFCFW_LAT_START();
+
+    /* restore the configuration if requested, before the commit so that its staged parameters are written with it */
+    FWC_sis8300_struck_iqfb_func_commitConfig(arg);
+
+    /* commit the staged parameters at the beginning of the gap between pulses */
+    FWC_sis8300_struck_iqfb_func_commitParam(arg);
+    RFCFW_LAT_MARK(RFCFW_CONST_LAT_COMMIT);
 
     /* disable the interrupt */
     data += arg -> board_reset                  << 0;
@@ -313,6 +1046,7 @@ int FWC_sis8300_struck_iqfb_func_waitIntr(void *module)
     data += arg -> board_edgeSelSpare           << 18;   
 
     FWC_sis8300_struck_iqfb_func_setBits(arg -> board_handle, data);
+    RFCFW_LAT_MARK(RFCFW_CONST_LAT_INTR_DIS);
 
     return status;
 }
@@ -326,6 +1060,7 @@ int FWC_sis8300_struck_iqfb_func_meaIntrLatency(void *module, long *latencyCnt,
     unsigned int data       = 0;
     unsigned int dataRead   = 0;
     unsigned int dataRead2  = 0;
+    double       var_stopTime_us;
 
     FWC_sis8300_struck_iqfb_struc_data *arg = (FWC_sis8300_struck_iqfb_struc_data *)module;
 
@@ -345,31 +1080,445 @@ int FWC_sis8300_struck_iqfb_func_meaIntrLatency(void *module, long *latencyCnt,
     data += arg -> board_edgeSelSpare           << 18; 
 
     if(arg -> board_handle) {
+        RFCFW_LAT_BEGIN();
+
         FWC_sis8300_struck_iqfb_func_setBits(arg->board_handle, data);    
+        var_stopTime_us = RFCFW_func_getTime_us();
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_CNT_STOP);
 
         /* read the register */            
-        RFCB_API_readRegister((RFCB_struc_moduleData *)arg->board_handle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_IRQ_DELAY_CNT, &dataRead, RFCB_DEV_SYS);
-        RFCB_API_readRegister((RFCB_struc_moduleData *)arg->board_handle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_PUL_CNT,       &dataRead2, RFCB_DEV_SYS);
+        FWC_SIS8300_STRUCK_IQFB_REG_READ(arg->board_handle, IRQ_DELAY_CNT, &dataRead);
+        FWC_SIS8300_STRUCK_IQFB_REG_READ(arg->board_handle, PUL_CNT,       &dataRead2);
 
         *(latencyCnt) = (long)dataRead;
         *(pulseCnt)   = (long)dataRead2;
 
+        /* wake-up latency for the breakdown and for the source of the wake-up, the counter runs with the sampling clock
+           from the interrupt to the stop above */
+        if(arg -> board_sampleFreq_MHz > 0.0) {
+            RFCFW_LAT_SET_WAKE((double)dataRead / arg -> board_sampleFreq_MHz);
+            RFCFW_func_wakeLatency(&arg -> wake, (double)dataRead / arg -> board_sampleFreq_MHz - (var_stopTime_us - arg -> wake.wakeTime_us));
+        }
+
         /* enable the counter */                    
         data |= 0x00000040; 
         FWC_sis8300_struck_iqfb_func_setBits(arg->board_handle, data);  
+        RFCFW_LAT_MARK(RFCFW_CONST_LAT_CNT_ARM);
     }
 
     return 0;
 }
 
+/**
+ * Read the information of the firmware and the board (firmware name, versions, device status...). The firmware
+ *   information does not change while the board is opened, it is read from the registers only once
+ * Input:
+ *   arg        : Data of the module
+ */
+void FWC_sis8300_struck_iqfb_func_readFwInfo(FWC_sis8300_struck_iqfb_struc_data *arg)
+{
+    unsigned int platformFwId;
+    unsigned int boardSno;
+
+    unsigned int firmwareName;
+    unsigned int majorVer;
+    unsigned int minorVer;
+    unsigned int buildNum;
+
+    int deviceOpened;
 
+    if(!arg) return;
 
+    if(arg -> board_handle) {
+        FWC_sis8300_struck_iqfb_func_getBoardInfo(arg -> board_handle, arg -> board_deviceName, &deviceOpened);
+
+        arg -> board_deviceOpened   = (long)deviceOpened;
 
+        if(deviceOpened && !arg -> info_valid) {
+            FWC_sis8300_struck_iqfb_func_getPlatformInfo(arg -> board_handle, &platformFwId, &boardSno);
+            FWC_sis8300_struck_iqfb_func_getAppFwInfo(arg -> board_handle, &firmwareName, &majorVer, &minorVer, &buildNum);
 
+            arg -> board_platformFwId   = (long)platformFwId;
+            arg -> board_sno            = (long)boardSno;
 
+            arg -> board_firmwareName   = (long)firmwareName;
+            arg -> board_majorVer       = (long)majorVer;
+            arg -> board_minorVer       = (long)minorVer;
+            arg -> board_buildNum       = (long)buildNum;
 
+            arg -> info_valid           = 1;
+        }
+    }
+}
+
+/**
+ * Update the status of the firmware from the snapshot of the status registers. The snapshot is read from the board
+ *   only if it is older than the maximum age, so that all status records of a scan share one reading
+ * Input:
+ *   arg        : Data of the module
+ */
+void FWC_sis8300_struck_iqfb_func_readStatus(FWC_sis8300_struck_iqfb_struc_data *arg)
+{
+    double var_time_us;
+
+    if(!arg || !arg -> board_handle) return;
+
+    var_time_us = RFCFW_func_getTime_us();
+
+    if(arg -> stat_readCnt > 0 && var_time_us - arg -> stat_time_us < arg -> stat_maxAge_ms * 1000.0) {
+        arg -> stat_hitCnt ++;
+        return;
+    }
 
+    FWC_sis8300_struck_iqfb_func_getStatusSnapshot(arg -> board_handle, &arg -> stat_snapshot);
+
+    arg -> stat_time_us = var_time_us;
+    arg -> stat_readCnt ++;
+
+    arg -> board_pulseCnt                 = (long)arg -> stat_snapshot.pulseCnt;
+    arg -> board_ADCClkWdCnt              = (long)arg -> stat_snapshot.WDCnt;
+    arg -> board_platformStatus           = (long)arg -> stat_snapshot.platformStatus;
+    arg -> board_usageStatus              = (long)arg -> stat_snapshot.useStatus;
+    arg -> board_RFCtrlStatus             = (long)arg -> stat_snapshot.RFCtrlStatus;
+
+    arg -> board_raceConditionFlags_acc   = (long)arg -> stat_snapshot.RCFlagsAcc;
+    arg -> board_raceConditionFlags_stdby = (long)arg -> stat_snapshot.RCFlagsStdby;
+    arg -> board_raceConditionFlags_spare = (long)arg -> stat_snapshot.RCFlagsSpare;
+
+    arg -> board_harlinkIn                = (long)arg -> stat_snapshot.harlinkIn;
+    arg -> board_amcLVDSIn                = (long)arg -> stat_snapshot.amcLVDSIn;
+
+    arg -> board_meaTriggerPeriod_ms      = (double)arg -> stat_snapshot.trigPeriod / arg -> board_sampleFreq_MHz / 1000.0;
+}
+
+/**
+ * Bring up the board at the IOC start: setup the SPI (clock divider, ADC chips and DAC chips) and read the firmware
+ *   information. Only the board of this module is accessed, so that the bring-up of different modules can run in parallel
+ * Input:
+ *   module     : Data of the module
+ *   setupSPI   : 1 to setup the SPI with the current settings
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed
+ */
+int FWC_sis8300_struck_iqfb_func_bringUp(void *module, int setupSPI)
+{
+    int status = 0;
+    double var_startTime_us;
+
+    FWC_sis8300_struck_iqfb_struc_data *arg = (FWC_sis8300_struck_iqfb_struc_data *)module;
+
+    if(!arg || !arg -> board_handle) return -1;
+
+    if(setupSPI) {
+        var_startTime_us        = RFCFW_func_getTime_us();
+        arg -> board_SPIStatus  = FWC_sis8300_struck_iqfb_func_setSPI(arg -> board_handle, (unsigned int)arg -> board_clkDiv2, (unsigned int)arg -> board_SPIVerify, (long *)&arg -> board_SPIFallbackCnt);
+        arg -> board_SPITime_us = RFCFW_func_getTime_us() - var_startTime_us;
+        status                  = (int)arg -> board_SPIStatus;
+    }
+
+    arg -> info_valid = 0;
+    FWC_sis8300_struck_iqfb_func_readFwInfo(arg);
+
+    if(!arg -> board_deviceOpened) status = -1;
+
+    return status;
+}
+
+/**
+ * Create the worker thread of the burst, which reads back the pulses after the last one
+ * Input:
+ *   arg            : Data of the module
+ *   moduleName     : Name of the module, used for the thread name
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int FWC_sis8300_struck_iqfb_func_burstInit(FWC_sis8300_struck_iqfb_struc_data *arg, const char *moduleName)
+{
+    char var_threadName[64];
 
+    if(!arg || !moduleName || !arg -> burst_mutex) return -1;
 
+    if(arg -> burst_thread) return 0;
 
+    arg -> burst_stop  = 0;
+    arg -> burst_event = epicsEventCreate(epicsEventEmpty);
+    arg -> burst_exit  = epicsEventCreate(epicsEventEmpty);
 
+    if(!arg -> burst_event || !arg -> burst_exit) {
+        EPICSLIB_func_errlogPrintf("FWC_sis8300_struck_iqfb_func_burstInit: Failed to create the events for %s\n", moduleName);
+        return -1;
+    }
+
+    snprintf(var_threadName, sizeof(var_threadName), "%s_BURST", moduleName);
+
+    arg -> burst_thread = epicsThreadCreate(var_threadName, epicsThreadPriorityMedium, epicsThreadGetStackSize(epicsThreadStackMedium), FWC_sis8300_struck_iqfb_func_burstWorker, (void *)arg);
+
+    if(!arg -> burst_thread) {
+        EPICSLIB_func_errlogPrintf("FWC_sis8300_struck_iqfb_func_burstInit: Failed to create the thread %s\n", var_threadName);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Start a burst capture of the ADC data, it starts at the next pulse. The buffer is allocated for all pulses here (10
+ *   channels, num * pno points each), the point number is the one armed for the normal capture (board_ADCSamplePnoEff)
+ * Input:
+ *   module         : Data of the module
+ *   num            : Number of pulses, the burst in capture is aborted if <= 0 (the readout can not be aborted)
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int FWC_sis8300_struck_iqfb_func_burstStart(void *module, long num)
+{
+    FWC_sis8300_struck_iqfb_struc_data *arg = (FWC_sis8300_struck_iqfb_struc_data *)module;
+
+    int  i;
+    long k;
+    unsigned int pno_f;
+
+    if(!arg || !arg -> burst_mutex || !arg -> burst_thread) return -1;
+
+    epicsMutexLock(arg -> burst_mutex);
+
+    /* abort */
+    if(num <= 0) {
+        if(arg -> burst_status == FWC_SIS8300_STRUCK_IQFB_CONST_BURST_PENDING)
+            arg -> burst_status = FWC_SIS8300_STRUCK_IQFB_CONST_BURST_IDLE;
+        else if(arg -> burst_status == FWC_SIS8300_STRUCK_IQFB_CONST_BURST_CAPTURE)
+            arg -> burst_status = FWC_SIS8300_STRUCK_IQFB_CONST_BURST_ABORT;
+
+        epicsMutexUnlock(arg -> burst_mutex);
+        return 0;
+    }
+
+    if(arg -> burst_status != FWC_SIS8300_STRUCK_IQFB_CONST_BURST_IDLE && arg -> burst_status != FWC_SIS8300_STRUCK_IQFB_CONST_BURST_DONE) {
+        epicsMutexUnlock(arg -> burst_mutex);
+        EPICSLIB_func_errlogPrintf("FWC_sis8300_struck_iqfb_func_burstStart: A burst is in progress\n");
+        return -1;
+    }
+
+    /* all pulses should fit in the DRAM region of a channel */
+    pno_f = (unsigned int)(arg -> board_ADCSamplePnoEff / 16) * 16;
+    if(pno_f < 16) pno_f = 16;
+
+    if(num > FWC_SIS8300_STRUCK_IQFB_CONST_ADC_REGION_BLOCKS / (pno_f >> 4)) {
+        epicsMutexUnlock(arg -> burst_mutex);
+        EPICSLIB_func_errlogPrintf("FWC_sis8300_struck_iqfb_func_burstStart: Max. %u pulses of %u points\n", FWC_SIS8300_STRUCK_IQFB_CONST_ADC_REGION_BLOCKS / (pno_f >> 4), pno_f);
+        return -1;
+    }
+
+    /* buffers, reused if large enough */
+    if(arg -> burst_bufSize < num * (long)pno_f) {
+        free(arg -> burst_buf);
+        arg -> burst_buf     = (short *)malloc(sizeof(short) * 10 * num * pno_f);
+        arg -> burst_bufSize = arg -> burst_buf ? num * (long)pno_f : 0;
+    }
+
+    if(arg -> burst_frameNum < num) {
+        free(arg -> burst_frame);
+        arg -> burst_frame    = (FWC_sis8300_struck_iqfb_struc_burstFrame *)calloc(num, sizeof(FWC_sis8300_struck_iqfb_struc_burstFrame));
+        arg -> burst_frameNum = arg -> burst_frame ? num : 0;
+    }
+
+    if(!arg -> burst_buf || !arg -> burst_frame) {
+        epicsMutexUnlock(arg -> burst_mutex);
+        EPICSLIB_func_errlogPrintf("FWC_sis8300_struck_iqfb_func_burstStart: Failed to allocate the buffer for %ld pulses\n", num);
+        return -1;
+    }
+
+    /* the data of a channel is continuous for all pulses, same as in the DRAM */
+    for(k = 0; k < num; k ++) {
+        for(i = 0; i < 10; i ++)
+            arg -> burst_frame[k].ADCData[i] = arg -> burst_buf + (i * num + k) * pno_f;
+    }
+
+    arg -> burst_pno         = pno_f;
+    arg -> burst_num         = num;
+    arg -> burst_cnt         = 0;
+    arg -> burst_readTime_us = 0.0;
+    arg -> burst_status      = FWC_SIS8300_STRUCK_IQFB_CONST_BURST_PENDING;
+
+    epicsMutexUnlock(arg -> burst_mutex);
+
+    return 0;
+}
+
+/**
+ * Get the frames of the latest burst
+ * Input:
+ *   arg            : Data of the module
+ * Output:
+ *   frames         : Frames of the pulses, valid until the next burst is started
+ *   num            : Number of frames
+ * Return:
+ *   0              : Successful
+ *  -1              : No burst is done
+ */
+int FWC_sis8300_struck_iqfb_func_getBurstFrames(FWC_sis8300_struck_iqfb_struc_data *arg, FWC_sis8300_struck_iqfb_struc_burstFrame **frames, long *num)
+{
+    int status = -1;
+
+    if(!arg || !frames || !num || !arg -> burst_mutex) return -1;
+
+    epicsMutexLock(arg -> burst_mutex);
+
+    if(arg -> burst_status == FWC_SIS8300_STRUCK_IQFB_CONST_BURST_DONE) {
+        *frames = arg -> burst_frame;
+        *num    = arg -> burst_num;
+        status  = 0;
+    }
+
+    epicsMutexUnlock(arg -> burst_mutex);
+
+    return status;
+}
+
+/**
+ * Print the frames of the latest burst, each frame has a header line with the tags followed by the points of 10 channels
+ * Input:
+ *   module         : Data of the module
+ *   fileName       : File to write, print to the console if NULL or empty
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int FWC_sis8300_struck_iqfb_func_burstDump(void *module, const char *fileName)
+{
+    FWC_sis8300_struck_iqfb_struc_data *arg = (FWC_sis8300_struck_iqfb_struc_data *)module;
+
+    int   i;
+    long  k, j;
+    FILE *ptr_file = stdout;
+    FWC_sis8300_struck_iqfb_struc_burstFrame *ptr_frame;
+
+    if(!arg || !arg -> burst_mutex) return -1;
+
+    epicsMutexLock(arg -> burst_mutex);
+
+    if(arg -> burst_status != FWC_SIS8300_STRUCK_IQFB_CONST_BURST_DONE) {
+        epicsMutexUnlock(arg -> burst_mutex);
+        EPICSLIB_func_errlogPrintf("FWC_sis8300_struck_iqfb_func_burstDump: No burst is done (status = %ld)\n", arg -> burst_status);
+        return -1;
+    }
+
+    if(fileName && fileName[0]) {
+        ptr_file = fopen(fileName, "w");
+
+        if(!ptr_file) {
+            epicsMutexUnlock(arg -> burst_mutex);
+            EPICSLIB_func_errlogPrintf("FWC_sis8300_struck_iqfb_func_burstDump: Failed to open the file %s\n", fileName);
+            return -1;
+        }
+    }
+
+    fprintf(ptr_file, "# burst of %ld pulses, %u points, read back in %.1f us\n", arg -> burst_num, arg -> burst_pno, arg -> burst_readTime_us);
+
+    for(k = 0; k < arg -> burst_num; k ++) {
+        ptr_frame = &arg -> burst_frame[k];
+
+        fprintf(ptr_file, "# frame %ld, time %.3f us, coefId %ld, pno %ld\n", ptr_frame -> seq, ptr_frame -> time_us - arg -> burst_frame[0].time_us,
+                ptr_frame -> coefId, ptr_frame -> pno);
+
+        for(j = 0; j < ptr_frame -> pno; j ++) {
+            for(i = 0; i < 10; i ++) fprintf(ptr_file, "%7d", ptr_frame -> ADCData[i][j]);
+            fprintf(ptr_file, "\n");
+        }
+    }
+
+    if(ptr_file != stdout) fclose(ptr_file);
+
+    epicsMutexUnlock(arg -> burst_mutex);
+
+    return 0;
+}
+
+/**
+ * Measure the time to get the internal waveforms from the DAQ buffer, with the separated passes of each channel
+ *   (FWC_sis8300_struck_iqfb_func_getDAQDoubleChannel) and with the single pass of all channels. A test pattern is used
+ *   so that no board is needed, and the results of the two ways are compared
+ * Input:
+ *   loops          : Number of pulses to average
+ * Output:
+ *   sepTime_us     : Time of a pulse with the separated passes
+ *   fusedTime_us   : Time of a pulse with the single pass
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ *  -2              : The results are different
+ */
+int FWC_sis8300_struck_iqfb_func_benchDeinterleave(long loops, double *sepTime_us, double *fusedTime_us)
+{
+    int  i;
+    long j;
+    int  status = 0;
+    double var_startTime_us;
+
+    unsigned int           *var_buf;
+    RFLIB_struc_RFWaveform *var_wfSep;
+    RFLIB_struc_RFWaveform *var_wfFused;
+    RFLIB_struc_RFWaveform *var_wf[FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM];
+
+    /* check the input */
+    if(loops <= 0 || !sepTime_us || !fusedTime_us) return -1;
+
+    var_buf     = (unsigned int *)malloc(sizeof(unsigned int) * FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH * FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_NUM * 2);
+    var_wfSep   = (RFLIB_struc_RFWaveform *)calloc(FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM, sizeof(RFLIB_struc_RFWaveform));
+    var_wfFused = (RFLIB_struc_RFWaveform *)calloc(FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM, sizeof(RFLIB_struc_RFWaveform));
+
+    if(!var_buf || !var_wfSep || !var_wfFused) {
+        free(var_buf);
+        free(var_wfSep);
+        free(var_wfFused);
+        return -1;
+    }
+
+    /* test pattern, each 16 bit data is different */
+    for(i = 0; i < FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH * FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_NUM * 2; i ++)
+        var_buf[i] = (unsigned int)(i * 2) | ((unsigned int)(i * 2 + 1) << 16);
+
+    /* the same channels as the internal waveforms, initialized as in FWC_sis8300_struck_iqfb_func_init */
+    for(i = 0; i < FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM; i ++) {
+        RFLIB_initRFWaveform(&var_wfSep[i],   FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH);
+        RFLIB_initRFWaveform(&var_wfFused[i], FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH);
+
+        var_wfSep[i].chId   = 2 * i;
+        var_wfFused[i].chId = 2 * i;
+        var_wf[i]           = &var_wfFused[i];
+    }
+
+    /* separated passes */
+    var_startTime_us = RFCFW_func_getTime_us();
+
+    for(j = 0; j < loops; j ++) {
+        for(i = 0; i < FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM; i ++)
+            FWC_sis8300_struck_iqfb_func_getDAQDoubleChannel(var_buf, (int)var_wfSep[i].chId, var_wfSep[i].wfI, var_wfSep[i].wfQ);
+    }
+
+    *sepTime_us = (RFCFW_func_getTime_us() - var_startTime_us) / (double)loops;
+
+    /* single pass */
+    var_startTime_us = RFCFW_func_getTime_us();
+
+    for(j = 0; j < loops; j ++)
+        FWC_sis8300_struck_iqfb_func_getDAQWaveforms(var_buf, var_wf, FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM);
+
+    *fusedTime_us = (RFCFW_func_getTime_us() - var_startTime_us) / (double)loops;
+
+    /* compare the results */
+    for(i = 0; i < FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM; i ++) {
+        if(memcmp((void *)var_wfSep[i].wfI, (void *)var_wfFused[i].wfI, sizeof(short) * FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH) != 0 ||
+           memcmp((void *)var_wfSep[i].wfQ, (void *)var_wfFused[i].wfQ, sizeof(short) * FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH) != 0)
+            status = -2;
+    }
+
+    free(var_buf);
+    free(var_wfSep);
+    free(var_wfFused);
+
+    return status;
+}
@@ -23,6 +23,18 @@
 #include "RFLib_signalProcess.h"                            /* use the library data definitions and routines */
 #include "MathLib_dataProcess.h"
 #include "EPICSLib_wrapper.h"
+#include "epicsMutex.h"
+
+#include "RFControlFirmware_pulseFeature.h"                   /* per-pulse scalar features of the RF waveforms */
+#include "RFControlFirmware_pulseCtrl.h"                      /* pulse-to-pulse feedback controller */
+#include "RFControlFirmware_timeStats.h"                      /* timing statistics of the real-time processing */
+#include "RFControlFirmware_ilc.h"                            /* iterative learning control of the set point table */
+#include "RFControlFirmware_ramp.h"                           /* ramps of the settings */
+#include "RFControlFirmware_pubQueue.h"                       /* queue of the readouts to the EPICS publishing */
+#include "RFControlFirmware_roi.h"                            /* regions of interest of the DAQ readout */
+#include "RFControlFirmware_wake.h"                           /* wake-up of the pulse thread */
+#include "RFControlFirmware_latency.h"                        /* latency breakdown of the pulse pipeline */
+#include "RFControlFirmware_config.h"                         /* restore of the configuration at the pulse boundary */
 
 #include "FWControl_sis8300_struck_iqfb_board.h"
 
@@ -30,6 +42,55 @@
 extern "C" {
 #endif
 
+/**
+ * Default maximum age of the status snapshot
+ */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_STAT_MAX_AGE_MS 500.0
+
+/**
+ * Parameters written to the firmware together, used as the bit mask of the staged commit
+ */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_GAIN       0x01                 /* feedback gain of I/Q */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_FF         0x02                 /* feedforward of I/Q */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_IQ_CORR    0x04                 /* imbalance correction matrix */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_PARAM_ROT        0x08                 /* feedback and actuation vector rotations */
+
+/**
+ * Readout of a pulse published to EPICS, the waveforms and their features are in the order of RFCFW_CONST_FEAT_CH_*
+ */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM          6                    /* RF waveforms published */
+
+typedef struct {
+    long  seq;                                              /* sequence number of the readout */
+    long  pno;                                              /* valid points of the waveforms */
+    long  bank;                                             /* DRAM bank of the ADC data of the same pulse */
+    short wfI[FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM][FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH];
+    short wfQ[FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM][FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH];
+    RFCFW_struc_pulseFeature feat[FWC_SIS8300_STRUCK_IQFB_CONST_PUB_WF_NUM];    /* features of the waveforms of the same pulse */
+} FWC_sis8300_struck_iqfb_struc_pubFrame;
+
+/**
+ * Burst capture of the ADC data, the pulses are captured one after another in the DRAM and read back in bulk by the
+ *   worker thread of the burst
+ */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_BURST_IDLE        0                    /* status of the burst */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_BURST_PENDING     1                    /* started, the capture is armed at the next pulse */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_BURST_CAPTURE     2                    /* capturing the pulses */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_BURST_DONE        3                    /* all pulses are read back, the frames are valid */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_BURST_ABORT       4                    /* aborted, the normal capture is armed at the next pulse */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_BURST_READOUT     5                    /* all pulses are captured, read back by the worker thread */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_BURST_READ_DONE   6                    /* read back, the normal capture is armed at the next pulse */
+
+#define FWC_SIS8300_STRUCK_IQFB_CONST_BURST_EXIT_TIMEOUT 5.0                 /* time to wait for the exit of the worker thread (s) */
+
+typedef struct {
+    long   seq;                                             /* index of the pulse in the burst */
+    long   pno;                                             /* points of the waveforms */
+    long   coefId;                                          /* non-IQ coefficient Id of the first point */
+    double time_us;                                         /* time when the pulse was received */
+    short *ADCData[10];                                     /* ADC waveforms, in the buffer of the burst */
+} FWC_sis8300_struck_iqfb_struc_burstFrame;
+
 /**
  * Define the data structure for the firmware
  * some EPICS data types:
@@ -50,6 +111,11 @@ typedef struct {
      */
     volatile unsigned short board_setupSPI;                 /* write 1 to setup the clock divider, ADC chips and DAC chips */
     volatile unsigned short board_clkDiv2;                  /* 1 to divide the ADC clock by 2,, this is to use the OSC clock (250MHz) for testing */
+    volatile unsigned short board_SPIVerify;                /* 1 to read back the settings of the ADC chips after setting the SPI */
+
+    volatile long   board_SPIStatus;                        /* result of the latest SPI setting (0 - successful; -1 - verification failed) */
+    volatile long   board_SPIFallbackCnt;                   /* number of SPI commands fell back to sleep as the busy status was not available */
+    volatile double board_SPITime_us;                       /* elapsed time of the latest SPI setting */
 
     volatile unsigned long  board_ADCClockSel;              /* ADC clock selection */
 
@@ -105,6 +171,13 @@ typedef struct {
     volatile long board_ampLimitLo;                         /* Limit of the DAC output low */
     
     volatile long board_ADCSamplePno;                       /* ADC sample point number */
+    volatile unsigned short board_ADCAutoPno;               /* 1 to derive the point number from the RF pulse length and the DAQ trigger delay */
+    volatile double board_ADCTailMargin_ns;                 /* margin after the RF pulse end for the automatic point number (decay tail) */
+    volatile long board_ADCSamplePnoEff;                    /* point number armed for the next pulse (setpoint or automatic), readback */
+
+    volatile unsigned short board_ADCPingPong;              /* 1 to alternate the DRAM capture bank every pulse, the readout overlaps the next capture */
+    volatile long board_ADCBank;                            /* bank of the ADC data read (tag of the latest ADC waveforms) */
+    unsigned int  board_ADCBankCapture;                     /* bank armed for the next pulse */
 
     volatile long board_coefIdOffset;                       /* the non-IQ coefficient ID offset, this is to compensate the sampling start point uncertainty after power cycle */
     volatile long board_coefIdCur;                          /* current coefficient Id for the first point of the DAQ buffer (ADC) */
@@ -128,6 +201,8 @@ typedef struct {
     
     volatile double  board_actRotationGain;                 /* rotation gain of the actuation signal */
     volatile double  board_actRotationAngle_deg;            /* rotation angle of the actuation signal */
+
+    volatile double  board_ampScale;                        /* amplitude scale applied with the vector rotations, changed by setAmp (1.0 by default) */
     
     volatile double  board_feedforwardI_MV;                 /* feed forward value I component, MV */
     volatile double  board_feedforwardQ_MV;                 /* feed forward value Q component, MV */
@@ -183,12 +258,112 @@ typedef struct {
     double DAQTimeAxis_ns[FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_DEPTH];        /* time axis in ns for internal DAQ*/
     double ADCTimeAxis_ns[FWC_SIS8300_STRUCK_IQFB_CONST_ADC_SAMPLE_MAX];       /* time axis in ns for ADC waveform */
 
+    /* --- per-pulse scalar features of the RF waveforms --- */
+    volatile double  feat_winStart_ns;                      /* start time of the flat-top window in ns (same time base as the waveform time axis) */
+    volatile double  feat_winEnd_ns;                        /* end time of the flat-top window in ns */
+    volatile long    feat_chSel;                            /* bit mask to select the waveforms for the calculation, see RFCFW_CONST_FEAT_CH_* */
+
+    RFCFW_struc_pulseFeature feat_refCh;                    /* features of the waveforms above */
+    RFCFW_struc_pulseFeature feat_fbkCh;
+    RFCFW_struc_pulseFeature feat_tracked;
+    RFCFW_struc_pulseFeature feat_err;
+    RFCFW_struc_pulseFeature feat_act;
+    RFCFW_struc_pulseFeature feat_DACOut;
+
+    /* --- pulse-to-pulse amplitude/phase feedback with the vector rotations --- */
+    volatile long    pfb_srcCh;                             /* waveform (0 - 5, in the order of RFCFW_CONST_FEAT_CH_*) whose features are used as the measurement */
+    volatile double  pfb_budget_us;                         /* time budget of the loop, from the interrupt to the correction applied */
+    double           pfb_intrTime_us;                       /* time when the latest interrupt was received */
+
+    RFCFW_struc_piCtrl    pfb_ampCtrl;                      /* amplitude controller, the error is normalized to the set point */
+    RFCFW_struc_piCtrl    pfb_phaCtrl;                      /* phase controller, in degree */
+
+    RFCFW_struc_timeStats pfb_procTime;                     /* time from the data ready to the correction applied */
+    RFCFW_struc_timeStats pfb_loopTime;                     /* time from the interrupt to the correction applied */
+
+    /* --- iterative learning control of the set point table --- */
+    RFCFW_struc_ilc ilc;                                    /* learns from the error waveform, the base table is board_setPointTable_I/Q */
+
+    /* --- ramps of the settings, one step is applied per pulse --- */
+    RFCFW_struc_ramp ramp_gainI;                            /* ramps of board_gainI/Q */
+    RFCFW_struc_ramp ramp_gainQ;
+    RFCFW_struc_ramp ramp_FFI;                              /* ramps of board_feedforwardI/Q_MV */
+    RFCFW_struc_ramp ramp_FFQ;
+    RFCFW_struc_ramp ramp_SP;                               /* ramp of the set point table, the target is ramp_SPTargetI/Q */
+
+    double ramp_SPTargetI[FWC_SIS8300_STRUCK_IQFB_CONST_SP_TAB_BUF_DEPTH];     /* target of the set point table */
+    double ramp_SPTargetQ[FWC_SIS8300_STRUCK_IQFB_CONST_SP_TAB_BUF_DEPTH];
+    double ramp_SPFromI[FWC_SIS8300_STRUCK_IQFB_CONST_SP_TAB_BUF_DEPTH];       /* set point table when the ramp started */
+    double ramp_SPFromQ[FWC_SIS8300_STRUCK_IQFB_CONST_SP_TAB_BUF_DEPTH];
+
+    /* --- regions of interest of the ADC readout from the DRAM, applied at the pulse boundary --- */
+    RFCFW_struc_roi roi;                                    /* only the segments are read if enabled */
+
+    /* --- lock of the control writes of the RFControlFirmware module (fwMutex), taken by the record callbacks writing the
+           loop parameters, which are also written by the pulse feedback of the asynchronous readout, NULL if not set --- */
+    epicsMutexId    fw_mutex;
+
+    /* --- the tables are uploaded through the shared pair of BUF_WR_ADDR/BUF_WR_DATA by the EPICS threads (table records,
+           restore) and by the pulse thread (ILC, ramp), each upload holds this lock for its whole address/data sequence --- */
+    epicsMutexId    board_tabMutex;
+
+    /* --- staged commit of the parameters, all pending parameters are written right after the interrupt --- */
+    volatile unsigned short stage_enable;                   /* 1 to stage the writes of the parameters, 0 to write them immediately */
+    unsigned long   stage_pending;                          /* mask of the parameters waiting for the commit, see the _CONST_PARAM_* */
+    epicsMutexId    stage_mutex;                            /* protect the pending mask */
+
+    RFCFW_struc_timeStats stage_commitTime;                 /* time to write all pending parameters */
+
+    /* --- restore of the configuration, handed to the pulse thread and applied right after the interrupt --- */
+    RFCFW_struc_configPending config_pending;
+    IOSCANPVT       config_ioScan;                          /* I/O interrupt scan of the records of the settings, requested after a restore */
+
+    /* --- queue of the readouts from the pulse thread to the EPICS publishing, the waveform nodes point to pub_frame --- */
+    RFCFW_struc_pubQueue pub_queue;
+    volatile long   pub_seq;                                /* sequence number of the latest readout queued */
+
+    FWC_sis8300_struck_iqfb_struc_pubFrame pub_frame;       /* published readout */
+
+    /* --- cached snapshot of the status registers, all status records are served from it --- */
+    FWC_sis8300_struck_iqfb_struc_status stat_snapshot;
+    double          stat_time_us;                           /* time when the snapshot was read */
+    volatile double stat_maxAge_ms;                         /* the snapshot is reused if it is younger than this */
+    volatile long   stat_readCnt;                           /* number of snapshots read from the board */
+    volatile long   stat_hitCnt;                            /* number of status readings served from the snapshot */
+
+    volatile unsigned short info_valid;                     /* 1 if the static firmware information (name, version) has been read */
+
+    /* --- burst capture of the ADC data, the DRAM readout is skipped during the burst --- */
+    volatile long   burst_numSet;                           /* number of pulses for the burst started by the record, 0 to abort */
+    volatile unsigned short burst_start;                    /* write 1 to start the burst */
+    volatile long   burst_status;                           /* FWC_SIS8300_STRUCK_IQFB_CONST_BURST_* */
+    volatile long   burst_num;                              /* number of pulses of the burst */
+    volatile long   burst_cnt;                              /* number of pulses captured */
+    volatile double burst_readTime_us;                      /* time of the bulk readout */
+    unsigned int    burst_pno;                              /* points of each pulse, integer times of 16 */
+
+    short          *burst_buf;                              /* data of all pulses, channel after channel */
+    long            burst_bufSize;                          /* size of the buffer in points per channel */
+    FWC_sis8300_struck_iqfb_struc_burstFrame *burst_frame;  /* frames of the pulses */
+    long            burst_frameNum;                         /* number of frames allocated */
+    epicsMutexId    burst_mutex;                            /* protect the status and the buffer, taken by the pulse thread out of IDLE and DONE */
+
+    epicsThreadId   burst_thread;                           /* worker thread of the bulk readout */
+    epicsEventId    burst_event;                            /* signaled to read back the burst */
+    epicsEventId    burst_exit;                             /* signaled when the worker thread exits */
+    volatile int    burst_stop;                             /* set to stop the worker thread */
+
+    /* --- wake-up of the pulse thread, interrupt or sleep and spin on the pulse counter before the predicted trigger --- */
+    RFCFW_struc_wake wake;
+
 } FWC_sis8300_struck_iqfb_struc_data;
 
 /**
  * Implementation of the virtual functions
  */
 int FWC_sis8300_struck_iqfb_func_init(void *module);
+int FWC_sis8300_struck_iqfb_func_deinit(void *module);
+int FWC_sis8300_struck_iqfb_func_setLock(void *module, epicsMutexId lock);
 
 int FWC_sis8300_struck_iqfb_func_getBoard(void *module, const char *boardModuleName);
 
@@ -203,6 +378,22 @@ int FWC_sis8300_struck_iqfb_func_waitIntr(void *module);
 
 int FWC_sis8300_struck_iqfb_func_meaIntrLatency(void *module, long *latencyCnt, long *pulseCnt);
 
+int FWC_sis8300_struck_iqfb_func_bringUp(void *module, int setupSPI);
+
+/**
+ * Other routines
+ */
+void FWC_sis8300_struck_iqfb_func_writeParam(FWC_sis8300_struck_iqfb_struc_data *arg, unsigned long mask);                 /* write the parameters, or stage them if enabled */
+void FWC_sis8300_struck_iqfb_func_readFwInfo(FWC_sis8300_struck_iqfb_struc_data *arg);                                       /* read the firmware and board information */
+void FWC_sis8300_struck_iqfb_func_readStatus(FWC_sis8300_struck_iqfb_struc_data *arg);                                       /* update the status from the snapshot */
+
+int  FWC_sis8300_struck_iqfb_func_burstInit(FWC_sis8300_struck_iqfb_struc_data *arg, const char *moduleName);               /* create the worker thread of the burst */
+int  FWC_sis8300_struck_iqfb_func_burstStart(void *module, long num);                                                        /* start a burst of num pulses, abort if num <= 0 */
+int  FWC_sis8300_struck_iqfb_func_getBurstFrames(FWC_sis8300_struck_iqfb_struc_data *arg, FWC_sis8300_struck_iqfb_struc_burstFrame **frames, long *num);
+int  FWC_sis8300_struck_iqfb_func_burstDump(void *module, const char *fileName);                                            /* print the frames of the burst */
+
+int  FWC_sis8300_struck_iqfb_func_benchDeinterleave(long loops, double *sepTime_us, double *fusedTime_us);                   /* time of getting the internal waveforms from the DAQ buffer */
+
 #ifdef __cplusplus
 }
 #endif
@@ -66,16 +66,87 @@ void FWC_sis8300_struck_iqfb_func_getBoardInfo(void *boardHandle, char *deviceNa
  *      -- Out 6    (ADC4-CLK, ch6/7)           : LVDS 3.5 mA
  *      -- Out 7    (Frontpanel Clk, Harlink)   : LVDS 3.5 mA
  */
-#define SLEEP_TIME 10
+#define SLEEP_TIME 10                                       /* fall back sleep time (us) if the SPI busy status can not be polled */
 
-void FWC_sis8300_struck_iqfb_func_setSPI(void *boardHandle, unsigned int clkDiv2)
+#define FWC_SIS8300_STRUCK_IQFB_CONST_SPI_BUSY      0x80000000      /* busy bit when reading the SPI registers */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_ADC_SPI_READ  0x00800000      /* read command of the ADC SPI */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_SPI_POLL_MAX  1000            /* maximum times of polling the busy status for a command */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_SPI_SEQ_MAX   80              /* maximum commands of the sequence */
+
+/**
+ * One command of the SPI sequence
+ */
+typedef struct {
+    unsigned int reg;                                       /* register address, SIS8300_ADC_SPI_REG or SIS8300_AD9510_SPI_REG */
+    unsigned int data;                                      /* data to write */
+} FWC_sis8300_struck_iqfb_struc_SPICmd;
+
+/**
+ * Add a command to the SPI sequence
+ */
+static void FWC_sis8300_struck_iqfb_func_addSPICmd(FWC_sis8300_struck_iqfb_struc_SPICmd *seq, unsigned int *cnt, unsigned int reg, unsigned int data)
 {
-    RFCB_struc_moduleData *board = (RFCB_struc_moduleData *)boardHandle;
-    
-    /* address and data for register writing */
-    unsigned int addr_offset;
+    if(*cnt >= FWC_SIS8300_STRUCK_IQFB_CONST_SPI_SEQ_MAX) return;
+
+    seq[*cnt].reg  = reg;
+    seq[*cnt].data = data;
+    (*cnt) ++;
+}
+
+/**
+ * Wait until the SPI transaction of the register finished. The busy status is polled, only if it can not be
+ *   read or does not clear in the polling times, sleep for a fixed time
+ * Return:
+ *   0              : The SPI is idle
+ *   1              : Fall back to sleep
+ */
+static int FWC_sis8300_struck_iqfb_func_waitSPIIdle(RFCB_struc_moduleData *board, unsigned int reg)
+{
+    unsigned int i;
     unsigned int data;
 
+    for(i = 0; i < FWC_SIS8300_STRUCK_IQFB_CONST_SPI_POLL_MAX; i ++) {
+        if(RFCFW_func_regRead(board, reg, &data, RFCB_DEV_SYS) != 0) break;
+        if(!(data & FWC_SIS8300_STRUCK_IQFB_CONST_SPI_BUSY)) return 0;
+    }
+
+    usleep(SLEEP_TIME);
+    return 1;
+}
+
+/**
+ * Read a register of an ADC chip via SPI
+ */
+static int FWC_sis8300_struck_iqfb_func_readADCReg(RFCB_struc_moduleData *board, unsigned int adc, unsigned int addr, unsigned int *value)
+{
+    unsigned int data = (adc << 24) + FWC_SIS8300_STRUCK_IQFB_CONST_ADC_SPI_READ + ((addr & 0xffff) << 8);
+
+    RFCFW_func_regWrite(board, SIS8300_ADC_SPI_REG, data, RFCB_DEV_SYS);
+    FWC_sis8300_struck_iqfb_func_waitSPIIdle(board, SIS8300_ADC_SPI_REG);
+
+    if(RFCFW_func_regRead(board, SIS8300_ADC_SPI_REG, &data, RFCB_DEV_SYS) != 0) return -1;
+
+    *value = data & 0xff;
+    return 0;
+}
+
+/**
+ * Set the SPI. The commands are built into a table first and then written back to back, each command only waits
+ *   for the busy status of the SPI to clear
+ * Input:
+ *   boardHandle        : Address of the data structure of the board moudle
+ *   clkDiv2            : 1 to divide the ADC clock by 2
+ *   verify             : 1 to read back the settings of the ADC chips after the sequence
+ * Output:
+ *   fallbackCnt        : Number of commands fell back to sleep because the busy status was not available (can be NULL)
+ * Return:
+ *   0                  : Successful
+ *  -1                  : Verification failed
+ */
+int FWC_sis8300_struck_iqfb_func_setSPI(void *boardHandle, unsigned int clkDiv2, unsigned int verify, long *fallbackCnt)
+{
+    RFCB_struc_moduleData *board = (RFCB_struc_moduleData *)boardHandle;
+    
     /* data for AD9510 (clock divider) setting, for each array data
      *	bits <3:0>:   Divider High
      *	bits <7:4>:   Divider Low
@@ -129,12 +200,21 @@ void FWC_sis8300_struck_iqfb_func_setSPI(void *boardHandle, unsigned int clkDiv2
     unsigned int ad9510_divider_configuration_array[8];
     unsigned int div_bypass;    
     unsigned int divide_cmd;
-    
-    /* data for ADC setting */
-    unsigned int i;
-    unsigned int uint_adc_mux_select;
-    unsigned int adc_addr;
-    unsigned int adc_data;
+
+    /* settings of the ADC chips: output type LVDS, and the registers 0x16/0x17 cleared */
+    static const unsigned int adc_settings[3][2] = {{0x14, 0x40}, {0x16, 0x00}, {0x17, 0x00}};
+
+    /* divider configuration used by the Out 4/5/6/7 of the two AD9510 chips */
+    static const unsigned int ad9510_out_div_id[2][4] = {{6, 2, 1, 0}, {7, 4, 3, 5}};
+
+    FWC_sis8300_struck_iqfb_struc_SPICmd var_seq[FWC_SIS8300_STRUCK_IQFB_CONST_SPI_SEQ_MAX];
+    unsigned int var_cnt = 0;
+    unsigned int var_select;
+    unsigned int var_value;
+    long         var_fallbackCnt = 0;
+    int          status = 0;
+
+    unsigned int i, j;
     
     /* set the divider */
     if(clkDiv2 == 1) {
@@ -156,311 +236,79 @@ void FWC_sis8300_struck_iqfb_func_setSPI(void *boardHandle, unsigned int clkDiv2
     ad9510_divider_configuration_array[7] = 0xC000 + 0x00;             /* (FPGA DIV-CLK69) used for sychn. of AD910 ISc and Bypass */
 
     /*----------------------------------------
-     * Set ADC chip
+     * Build the sequence - ADC chips
      *----------------------------------------*/
-    /* get the address of the register for ADC */
-    addr_offset = SIS8300_ADC_SPI_REG;
-
     for(i = 0; i < 5; i ++) {
-        uint_adc_mux_select = i << 24;
-
-        /* output type LVDS */
-        adc_addr = (0x14 & 0xffff) << 8 ;
-        adc_data = (0x40 & 0xff)  ;
-        data = uint_adc_mux_select + adc_addr + adc_data;
-        RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);        
-        usleep(SLEEP_TIME) ;
-        
-        adc_addr = (0x16 & 0xffff) << 8 ;
-        adc_data = (0x00 & 0xff)  ;
-        data = uint_adc_mux_select + adc_addr + adc_data;
-        RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-        usleep(SLEEP_TIME) ;
-
-        adc_addr = (0x17 & 0xffff) << 8 ;
-        adc_data = (0x00 & 0xff)  ;
-        data = uint_adc_mux_select + adc_addr + adc_data;
-        RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-        usleep(SLEEP_TIME) ;
-
-        /* register update cmd */
-        adc_addr = (0xff & 0xffff) << 8 ;
-        adc_data = (0x01 & 0xff)  ;
-        data = uint_adc_mux_select + adc_addr + adc_data;
-        RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-        usleep(SLEEP_TIME) ;
+        for(j = 0; j < 3; j ++)
+            FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_ADC_SPI_REG, (i << 24) + ((adc_settings[j][0] & 0xffff) << 8) + (adc_settings[j][1] & 0xff));
+
+        FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_ADC_SPI_REG, (i << 24) + ((0xff & 0xffff) << 8) + (0x01 & 0xff));      /* register update cmd */
     }
 
     /*----------------------------------------
-     * Set ADC clock
+     * Build the sequence - ADC clock (AD9510 No1 and No2)
      *----------------------------------------*/
-    /* get the address of the register for AD9510 */
-    addr_offset = SIS8300_AD9510_SPI_REG;
+    for(i = 0; i < 2; i ++) {
+        var_select = AD9510_GENERATE_SPI_RW_CMD + (i == 0 ? 0 : AD9510_SPI_SELECT_NO2);
 
-    /* === AD9510 No1 === */
-    /* set AD9510 to Bidirectional Mode and Soft Reset */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x00B0;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME);
+        FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, var_select + 0x00B0);     /* bidirectional mode and soft reset */
+        FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, var_select + 0x0090);     /* bidirectional mode */
+        FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, var_select + 0x0A01);     /* asychrnon power down, no prescaler */
 
-    /* set AD9510 to Bidirectional Mode  */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x0090;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME);
+        for(j = 0; j < 4; j ++)
+            FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, var_select + ((0x3C + j) << 8) + 0x0B);    /* Out 0-3 (not used) : total power down */
 
-    /* default: Asychrnon PowerDown, no Prescaler  */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x0A01;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME);
+        for(j = 0; j < 4; j ++)
+            FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, var_select + ((0x40 + j) << 8) + 0x02);    /* Out 4-7 : LVDS 3.5 mA */
 
-    /* Out 0 (not used) : total Power-Down  */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x3C0B;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME);
+        /* power down RefIn (0x10), shut down clk to PLL prescaler (0x08), power down CLK2 (0x04), CLK1 drives distribution section (0x01) */
+        FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, var_select + 0x4500 + 0x10 + 0x08 + 0x04 + 0x01);
 
-    /* Out 1 (not used) : total Power-Down  */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x3D0B;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME);
+        /* Out 4-7 : divider low/high, and bypass diver (7), no sychn (6), force individual start (5), start high (4), phase offset (3:0) */
+        for(j = 0; j < 4; j ++) {
+            FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, var_select + ((0x50 + 2 * j) << 8) + ( ad9510_divider_configuration_array[ad9510_out_div_id[i][j]]       & 0xff));
+            FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, var_select + ((0x51 + 2 * j) << 8) + ((ad9510_divider_configuration_array[ad9510_out_div_id[i][j]] >> 8) & 0xff));
+        }
 
-    /* Out 2 (not used) : total Power-Down  */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x3E0B;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME);
+        FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, var_select + 0x5A01);     /* update command */
+    }
 
-    /* Out 3 (not used) : total Power-Down  */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x3F0B;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME);
+    /*----------------------------------------
+     * Build the sequence - synch Cmd
+     *----------------------------------------*/
+    for(i = 0; i < 2; i ++) {
+        var_select = AD9510_GENERATE_SPI_RW_CMD + (i == 0 ? 0 : AD9510_SPI_SELECT_NO2);
 
-    /* Out 4  (FPGA DIV-CLK05) : LVDS 3.5 mA  */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x4002;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME);
+        FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, var_select + 0x5822);     /* set function of "function pin" to SYNCB (default reset) */
+        FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, var_select + 0x5A01);     /* update command */
+    }
 
-    /* Out 5  (ADC3-CLK, ch4/5) : LVDS 3.5 mA  */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x4102;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME);
+    FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, AD9510_SPI_SET_FUNCTION_SYNCH_FPGA_CLK69);                                          /* use "FPGA DIV-CLK69" for sychn pulse */
+    FWC_sis8300_struck_iqfb_func_addSPICmd(var_seq, &var_cnt, SIS8300_AD9510_SPI_REG, AD9510_GENERATE_FUNCTION_PULSE_CMD + AD9510_SPI_SET_FUNCTION_SYNCH_FPGA_CLK69);     /* generate sych pulse and hold FPGA_CLK69 */
 
-    /* Out 6  (ADC2-CLK, ch3/4) : LVDS 3.5 mA  */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x4202;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME);
+    /*----------------------------------------
+     * Execute the sequence
+     *----------------------------------------*/
+    for(i = 0; i < var_cnt; i ++) {
+        RFCFW_func_regWrite(board, var_seq[i].reg, var_seq[i].data, RFCB_DEV_SYS);
+        var_fallbackCnt += FWC_sis8300_struck_iqfb_func_waitSPIIdle(board, var_seq[i].reg);
+    }
 
-    /* Out 7  (ADC1-CLK, ch1/2) : LVDS 3.5 mA  */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x4302;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME);
+    /*----------------------------------------
+     * Verify the settings of the ADC chips
+     *----------------------------------------*/
+    if(verify) {
+        for(i = 0; i < 5; i ++) {
+            for(j = 0; j < 3; j ++) {
+                if(FWC_sis8300_struck_iqfb_func_readADCReg(board, i, adc_settings[j][0], &var_value) != 0 || var_value != adc_settings[j][1])
+                    status = -1;
+            }
+        }
+    }
 
-    /* set the first chip */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x4500;
-    data += 0x10 ; /* Power-Down RefIn */
-    data += 0x08 ; /* Shut Down Clk to PLL Prescaler */
-    data += 0x04 ; /* Power-Down CLK2 */
-    data += 0x01 ; /* CLK1 Drives Distribution Section */
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME);
+    if(fallbackCnt) *fallbackCnt = var_fallbackCnt;
 
-    /* Out 4  (FPGA DIV-CLK05) : Divider Low/High */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x5000;                     /* addr */
-    data = data + (ad9510_divider_configuration_array[6] & 0xff) ;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 4  (FPGA DIV-CLK05) : Bypasse Diver (7), No Sychn (6), Force Individual Start (5), Start High (4), Phase Offset (3:0) */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x5100;                             /* addr */
-    data = data + ((ad9510_divider_configuration_array[6] >> 8) & 0xff) ;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 5  (ADC3-CLK, ch4/5) : Divider Low/High */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x5200;                     /* addr */
-    data = data + (ad9510_divider_configuration_array[2] & 0xff) ;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 5  (ADC3-CLK, ch4/5) : Bypasse Diver (7), No Sychn (6), Force Individual Start (5), Start High (4), Phase Offset (3:0) */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x5300;                             /* addr */
-    data = data + ((ad9510_divider_configuration_array[2] >> 8) & 0xff);
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 6  (ADC2-CLK, ch2/3) : Divider Low/High */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x5400;                     /* addr */
-    data = data + (ad9510_divider_configuration_array[1] & 0xff) ;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 6  (ADC2-CLK, ch2/3) : Bypasse Diver (7), No Sychn (6), Force Individual Start (5), Start High (4), Phase Offset (3:0) */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x5500;                             /* addr */
-    data = data + ((ad9510_divider_configuration_array[1] >> 8) & 0xff);
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 7  (ADC1-CLK, ch1/2) : Divider Low/High */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x5600;                     /* addr */
-    data = data + (ad9510_divider_configuration_array[0] & 0xff) ;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-     /* Out 7  (ADC1-CLK, ch1/2) : Bypasse Diver (7), No Sychn (6), Force Individual Start (5), Start High (4), Phase Offset (3:0) */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x5700;                             /* addr */
-    data = data + ((ad9510_divider_configuration_array[0] >> 8) & 0xff);
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* update command */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x5A01;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* === AD9510 No2 (ADC channels 7 to 10) === */
-    /* set AD9510 to Bidirectional Mode and Soft Reset */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x00B0;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* set AD9510 to Bidirectional Mode  */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x0090;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x0A01;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 0 (not used) : total Power-Down */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x3C0B;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 1 (not used) : total Power-Down */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x3D0B;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 2 (not used) : total Power-Down */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x3E0B;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 3 (not used) : total Power-Down */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x3F0B;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 4  (FPGA DIV-CLK69) : LVDS 3.5 mA */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x4002;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 5  (ADC5-CLK, ch8/9) : LVDS 3.5 mA */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x4102;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 6  (ADC4-CLK, ch6/7) : LVDS 3.5 mA */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x4202;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 7  (Frontpanel Clk, Harlink) : LVDS 3.5 mA */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x4302; /* on  */
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x4500; /* addr */
-    data = data + 0x10 ; /* Power-Down RefIn */
-    data = data + 0x08 ; /* Shut Down Clk to PLL Prescaler */
-    data = data + 0x04 ; /* Power-Down CLK2 */
-    data = data + 0x01 ; /* CLK1 Drives Distribution Section */
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 4  (FPGA DIV-CLK69) : Divider Low/High */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x5000; /* addr */
-    data = data + (ad9510_divider_configuration_array[7] & 0xff) ;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 4  (FPGA DIV-CLK69) : Bypasse Diver (7), No Sychn (6), Force Individual Start (5), Start High (4), Phase Offset (3:0) */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x5100; /* addr */
-    data = data + ((ad9510_divider_configuration_array[7] >> 8) & 0xff);
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 5  (ADC5-CLK, ch8/9) : Divider Low/High */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x5200; /* addr */
-    data = data + (ad9510_divider_configuration_array[4] & 0xff) ;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 5  (ADC5-CLK, ch8/9) : Bypasse Diver (7), No Sychn (6), Force Individual Start (5), Start High (4), Phase Offset (3:0) */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x5300; /* addr */
-    data = data + ((ad9510_divider_configuration_array[4] >> 8) & 0xff);
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 6  (ADC4-CLK, ch6/7) : Divider Low/High */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x5400; /* addr */
-    data = data + (ad9510_divider_configuration_array[3] & 0xff) ;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 6  (ADC4-CLK, ch6/7) : Bypasse Diver (7), No Sychn (6), Force Individual Start (5), Start High (4), Phase Offset (3:0) */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x5500; /* addr */
-    data = data + ((ad9510_divider_configuration_array[3] >> 8) & 0xff);
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 7  (Frontpanel Clk, Harlink) : Divider Low/High */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x5600; /* addr */
-    data = data + (ad9510_divider_configuration_array[5] & 0xff) ;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* Out 7  (Frontpanel Clk, Harlink) : Bypasse Diver (7), No Sychn (6), Force Individual Start (5), Start High (4), Phase Offset (3:0) */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x5700;/* addr */
-    data = data + ((ad9510_divider_configuration_array[5] >> 8) & 0xff);
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* update command */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x5A01;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* === synch Cmd === */
-    /* set Function of "Function pin" to SYNCB (Default Reset) */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x5822;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* update command */
-    data = AD9510_GENERATE_SPI_RW_CMD + 0x5A01;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* set Function of "Function pin" to SYNCB (Default Reset) */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x5822;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* update command */
-    data = AD9510_GENERATE_SPI_RW_CMD + AD9510_SPI_SELECT_NO2 + 0x5A01;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* set use "FPGA DIV-CLK69" for Sychn Pulse  - Logic (VIRTEX5) */
-    data = AD9510_SPI_SET_FUNCTION_SYNCH_FPGA_CLK69;                    /* set clock */
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
-
-    /* generate sych Pulse   (pulse Function pins) and hold FPGA_CLK69 to sycnh pulse */
-    data = AD9510_GENERATE_FUNCTION_PULSE_CMD + AD9510_SPI_SET_FUNCTION_SYNCH_FPGA_CLK69;
-    RFCB_API_writeRegister(board, addr_offset, data, RFCB_DEV_SYS);
-    usleep(SLEEP_TIME) ;
+    return status;
 }
 
 /**
@@ -468,7 +316,7 @@ void FWC_sis8300_struck_iqfb_func_setSPI(void *boardHandle, unsigned int clkDiv2
  */
 void FWC_sis8300_struck_iqfb_func_setHarlink(void *boardHandle, unsigned int data)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_HARLINK_IN_OUT_CONTROL_REG, data, RFCB_DEV_SYS);       
+    RFCFW_func_regWrite(boardHandle, SIS8300_HARLINK_IN_OUT_CONTROL_REG, data, RFCB_DEV_SYS);       
 }
 
 /**
@@ -476,7 +324,7 @@ void FWC_sis8300_struck_iqfb_func_setHarlink(void *boardHandle, unsigned int dat
  */
 void FWC_sis8300_struck_iqfb_func_setAMCLVDS(void *boardHandle, unsigned int data)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_MLVDS_IO_CONTROL_REG, data, RFCB_DEV_SYS);
+    RFCFW_func_regWrite(boardHandle, SIS8300_MLVDS_IO_CONTROL_REG, data, RFCB_DEV_SYS);
 }
 
 /**
@@ -484,7 +332,7 @@ void FWC_sis8300_struck_iqfb_func_setAMCLVDS(void *boardHandle, unsigned int dat
  */
 void FWC_sis8300_struck_iqfb_func_getHarlink(void *boardHandle, unsigned int *data)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_HARLINK_IN_OUT_CONTROL_REG, data, RFCB_DEV_SYS); 
+    RFCFW_func_regRead(boardHandle, SIS8300_HARLINK_IN_OUT_CONTROL_REG, data, RFCB_DEV_SYS); 
 }
 
 /**
@@ -492,7 +340,7 @@ void FWC_sis8300_struck_iqfb_func_getHarlink(void *boardHandle, unsigned int *da
  */
 void FWC_sis8300_struck_iqfb_func_getAMCLVDS(void *boardHandle, unsigned int *data)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_MLVDS_IO_CONTROL_REG, data, RFCB_DEV_SYS);
+    RFCFW_func_regRead(boardHandle, SIS8300_MLVDS_IO_CONTROL_REG, data, RFCB_DEV_SYS);
 }
 
 /**
@@ -519,7 +367,7 @@ void FWC_sis8300_struck_iqfb_func_setADCClockSource(void *boardHandle, unsigned
         default: data = 0;    
     }
 
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_CLOCK_DISTRIBUTION_MUX_REG, data, RFCB_DEV_SYS);
+    RFCFW_func_regWrite(boardHandle, SIS8300_CLOCK_DISTRIBUTION_MUX_REG, data, RFCB_DEV_SYS);
 }
 
 /**
@@ -527,8 +375,8 @@ void FWC_sis8300_struck_iqfb_func_setADCClockSource(void *boardHandle, unsigned
  */
 void FWC_sis8300_struck_iqfb_func_getPlatformInfo(void *boardHandle, unsigned int *id, unsigned int *sno)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_INDENTIFIER_VERSION_REG, id, RFCB_DEV_SYS);
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SERIAL_NUMBER_REG, sno, RFCB_DEV_SYS);
+    RFCFW_func_regRead(boardHandle, SIS8300_INDENTIFIER_VERSION_REG, id, RFCB_DEV_SYS);
+    RFCFW_func_regRead(boardHandle, SIS8300_SERIAL_NUMBER_REG, sno, RFCB_DEV_SYS);
 }
 
 /*-------------------------------------------------------------
@@ -539,7 +387,7 @@ void FWC_sis8300_struck_iqfb_func_getPlatformInfo(void *boardHandle, unsigned in
  */
 void  FWC_sis8300_struck_iqfb_func_setBits(void *boardHandle, unsigned int data)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_SWITCH_CTRL, data, RFCB_DEV_SYS);   /* Write to the register */
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, SWITCH_CTRL, data);   /* Write to the register */
 }
 
 /**
@@ -552,19 +400,19 @@ void  FWC_sis8300_struck_iqfb_func_setBits(void *boardHandle, unsigned int data)
 void  FWC_sis8300_struck_iqfb_func_setExtTrigDelayAcc(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_DELAY_ACC, data, RFCB_DEV_SYS);    
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, DELAY_ACC, data);    
 }
 
 void  FWC_sis8300_struck_iqfb_func_setExtTrigDelayStdby(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_DELAY_STDBY, data, RFCB_DEV_SYS);    
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, DELAY_STDBY, data);    
 }
 
 void  FWC_sis8300_struck_iqfb_func_setExtTrigDelaySpare(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_DELAY_SPARE, data, RFCB_DEV_SYS);    
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, DELAY_SPARE, data);    
 }
 
 /**
@@ -577,7 +425,7 @@ void  FWC_sis8300_struck_iqfb_func_setExtTrigDelaySpare(void *boardHandle, doubl
 void  FWC_sis8300_struck_iqfb_func_setIntTrigPeriod(void *boardHandle, double value_ms, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ms * freq_MHz * 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_TRIG_INT_PERIOD, data, RFCB_DEV_SYS);        
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, TRIG_INT_PERIOD, data);        
 }
 
 /**
@@ -590,7 +438,7 @@ void  FWC_sis8300_struck_iqfb_func_setIntTrigPeriod(void *boardHandle, double va
 void  FWC_sis8300_struck_iqfb_func_setRFPulseLength(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_RF_PULSE_LENGTH, data, RFCB_DEV_SYS);     
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, RF_PULSE_LENGTH, data);     
 }
 
 /**
@@ -603,7 +451,7 @@ void  FWC_sis8300_struck_iqfb_func_setRFPulseLength(void *boardHandle, double va
 void  FWC_sis8300_struck_iqfb_func_setDAQTrigDelay(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_DAQ_TRIG_DELAY, data, RFCB_DEV_SYS);     
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, DAQ_TRIG_DELAY, data);     
 }
 
 /**
@@ -616,7 +464,7 @@ void  FWC_sis8300_struck_iqfb_func_setDAQTrigDelay(void *boardHandle, double val
 void  FWC_sis8300_struck_iqfb_func_selectRefFbkChannel(void *boardHandle, unsigned int refCh, unsigned int fbkCh)
 {
     unsigned int data = (refCh << 16) + (fbkCh & 0x0000FFFF);       
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_REF_FBK_SEL, data, RFCB_DEV_SYS);    
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, REF_FBK_SEL, data);    
 }
 
 /**
@@ -624,7 +472,7 @@ void  FWC_sis8300_struck_iqfb_func_selectRefFbkChannel(void *boardHandle, unsign
  */
 void  FWC_sis8300_struck_iqfb_func_selectTrigMode(void *boardHandle, unsigned int trigMode)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_TRIG_MODE_SEL, trigMode, RFCB_DEV_SYS);    
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, TRIG_MODE_SEL, trigMode);    
 }
 
 /**
@@ -632,7 +480,7 @@ void  FWC_sis8300_struck_iqfb_func_selectTrigMode(void *boardHandle, unsigned in
  */
 void  FWC_sis8300_struck_iqfb_func_setUsageStatus(void *boardHandle, unsigned int useStatus)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_USE_STATUS, useStatus, RFCB_DEV_SYS);    
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, USE_STATUS, useStatus);    
 }
 
 /**
@@ -640,7 +488,7 @@ void  FWC_sis8300_struck_iqfb_func_setUsageStatus(void *boardHandle, unsigned in
  */
 void  FWC_sis8300_struck_iqfb_func_setTrigRateDiv(void *boardHandle, unsigned int trigRateDiv)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_DIV_RATIO, trigRateDiv, RFCB_DEV_SYS);    
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, DIV_RATIO, trigRateDiv);    
 }
 
 /**
@@ -650,7 +498,7 @@ void  FWC_sis8300_struck_iqfb_func_setTrigRateDiv(void *boardHandle, unsigned in
 void  FWC_sis8300_struck_iqfb_func_setRefPhaSP(void *boardHandle, double phaSP_deg)
 {
     unsigned int pha = (unsigned int)(RFLIB_degToRad(phaSP_deg) * pow(2, FWC_SIS8300_STRUCK_IQFB_CONST_PHS_FRACTION));
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_REF_PHAS_SP, pha, RFCB_DEV_SYS);      
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, REF_PHAS_SP, pha);      
 }
 
 /**
@@ -666,7 +514,7 @@ void  FWC_sis8300_struck_iqfb_func_setFbkVectorRotation(void *boardHandle, doubl
     unsigned int cs   = (unsigned int)(scale * cos(RFLIB_degToRad(rotAngle_deg)) * pow(2, FWC_SIS8300_STRUCK_IQFB_CONST_ROT_COEF_FRACTION));
     unsigned int sn   = (unsigned int)(scale * sin(RFLIB_degToRad(rotAngle_deg)) * pow(2, FWC_SIS8300_STRUCK_IQFB_CONST_ROT_COEF_FRACTION));    
     unsigned int data = (cs << 16) + (sn & 0x0000FFFF);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_ROT_COEF_FBK, data, RFCB_DEV_SYS);      
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, ROT_COEF_FBK, data);      
 }
 
 /**
@@ -682,7 +530,7 @@ void  FWC_sis8300_struck_iqfb_func_setActVectorRotation(void *boardHandle, doubl
     unsigned int cs   = (unsigned int)(scale * cos(RFLIB_degToRad(rotAngle_deg)) * pow(2, FWC_SIS8300_STRUCK_IQFB_CONST_ROT_COEF_FRACTION));
     unsigned int sn   = (unsigned int)(scale * sin(RFLIB_degToRad(rotAngle_deg)) * pow(2, FWC_SIS8300_STRUCK_IQFB_CONST_ROT_COEF_FRACTION));    
     unsigned int data = (cs << 16) + (sn & 0x0000FFFF);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_ROT_COEF_ACT, data, RFCB_DEV_SYS);     
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, ROT_COEF_ACT, data);     
 }
 
 /**
@@ -695,13 +543,13 @@ void  FWC_sis8300_struck_iqfb_func_setActVectorRotation(void *boardHandle, doubl
 void  FWC_sis8300_struck_iqfb_func_setFeedforward_I(void *boardHandle, double value_MV, double factor)
 {
     unsigned int data = (unsigned int)(value_MV * factor);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_FEEDFORWARD_I, data, RFCB_DEV_SYS);     
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, FEEDFORWARD_I, data);     
 }
 
 void  FWC_sis8300_struck_iqfb_func_setFeedforward_Q(void *boardHandle, double value_MV, double factor)
 {
     unsigned int data = (unsigned int)(value_MV * factor);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_FEEDFORWARD_Q, data, RFCB_DEV_SYS);     
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, FEEDFORWARD_Q, data);     
 }
 
 /**
@@ -713,13 +561,13 @@ void  FWC_sis8300_struck_iqfb_func_setFeedforward_Q(void *boardHandle, double va
 void  FWC_sis8300_struck_iqfb_func_setGain_I(void *boardHandle, double value)
 {
     unsigned int data = (unsigned int)(value * pow(2, FWC_SIS8300_STRUCK_IQFB_CONST_GAIN_FRACTION));
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_GAIN_I, data, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, GAIN_I, data);
 }
 
 void  FWC_sis8300_struck_iqfb_func_setGain_Q(void *boardHandle, double value)
 {
     unsigned int data = (unsigned int)(value * pow(2, FWC_SIS8300_STRUCK_IQFB_CONST_GAIN_FRACTION));
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_GAIN_Q, data, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, GAIN_Q, data);
 }
 
 /**
@@ -727,8 +575,8 @@ void  FWC_sis8300_struck_iqfb_func_setGain_Q(void *boardHandle, double value)
  */
 void  FWC_sis8300_struck_iqfb_func_setFeedbackCorrLimits(void *boardHandle, unsigned int limit_i, unsigned int limit_q)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_CORR_LIMIT_I, limit_i, RFCB_DEV_SYS);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_CORR_LIMIT_Q, limit_q, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, CORR_LIMIT_I, limit_i);
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, CORR_LIMIT_Q, limit_q);
 }
 
 /**
@@ -741,13 +589,13 @@ void  FWC_sis8300_struck_iqfb_func_setFeedbackCorrLimits(void *boardHandle, unsi
 void  FWC_sis8300_struck_iqfb_func_setIntgStart(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_INTG_START, data, RFCB_DEV_SYS);       
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, INTG_START, data);       
 }
 
 void  FWC_sis8300_struck_iqfb_func_setIntgEnd(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_INTG_END, data, RFCB_DEV_SYS);       
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, INTG_END, data);       
 }            
 
 /**
@@ -760,13 +608,13 @@ void  FWC_sis8300_struck_iqfb_func_setIntgEnd(void *boardHandle, double value_ns
 void  FWC_sis8300_struck_iqfb_func_setApplStart(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_APPL_START, data, RFCB_DEV_SYS);       
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, APPL_START, data);       
 }    
 
 void  FWC_sis8300_struck_iqfb_func_setApplEnd(void *boardHandle, double value_ns, double freq_MHz)
 {
     unsigned int data = (unsigned int)(value_ns * freq_MHz / 1000.0);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_APPL_END, data, RFCB_DEV_SYS);         
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, APPL_END, data);         
 }
 
 /**
@@ -777,12 +625,12 @@ void  FWC_sis8300_struck_iqfb_func_setApplEnd(void *boardHandle, double value_ns
  */
 void  FWC_sis8300_struck_iqfb_func_setDACOffset_I(void *boardHandle, unsigned int offset)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_OFFSET_I, offset, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, OFFSET_I, offset);
 }
 
 void  FWC_sis8300_struck_iqfb_func_setDACOffset_Q(void *boardHandle, unsigned int offset)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_OFFSET_Q, offset, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, OFFSET_Q, offset);
 }
 
 /**
@@ -792,12 +640,12 @@ void  FWC_sis8300_struck_iqfb_func_setDACOffset_Q(void *boardHandle, unsigned in
  */
 void  FWC_sis8300_struck_iqfb_func_setAmpLimitHi(void *boardHandle, unsigned int limit)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_AMP_LIMIT_HI , limit, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, AMP_LIMIT_HI, limit);
 }
 
 void  FWC_sis8300_struck_iqfb_func_setAmpLimitLo(void *boardHandle, unsigned int limit)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_AMP_LIMIT_LO , limit, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, AMP_LIMIT_LO, limit);
 }
 
 /**
@@ -809,24 +657,39 @@ void  FWC_sis8300_struck_iqfb_func_setAmpLimitLo(void *boardHandle, unsigned int
  *   QSPTable           : set point table for Q
  */
 void  FWC_sis8300_struck_iqfb_func_setIQSPTable(void *boardHandle, unsigned int pno, double *ISPTable, double *QSPTable)
+{
+    FWC_sis8300_struck_iqfb_func_setIQSPTableRange(boardHandle, 0, pno, ISPTable, QSPTable);
+}
+
+/**
+ * Set a region of the I/Q set point table, the other entries in the firmware are not touched. The caller holds the
+ *   lock of the table uploads (board_tabMutex), the address/data registers are shared by all tables
+ * Input:
+ *   boardHandle        : Address of the data structure of the board moudle
+ *   start              : First entry of the region
+ *   pno                : Number of the points of the region
+ *   ISPTable           : set point table for I (the whole table, only the entries in the region are used)
+ *   QSPTable           : set point table for Q
+ */
+void  FWC_sis8300_struck_iqfb_func_setIQSPTableRange(void *boardHandle, unsigned int start, unsigned int pno, double *ISPTable, double *QSPTable)
 {
     unsigned int i;
     unsigned int Idata;
     unsigned int Qdata;
     unsigned int data;
       
-    for(i = 0; i < pno; i ++) {
+    for(i = start; i < start + pno; i ++) {
         /* Make up the data */
         Idata = (unsigned int)(*(ISPTable + i));
         Qdata = (unsigned int)(*(QSPTable + i)); 
         data = (Idata << 16) + (Qdata & 0x0000FFFF);
 
         /* Write to the firmware via two registers */
-        RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_BUF_WR_ADDR, CON_SIS8300_STRUCK_IQFB_IQ_SP_TABLE_OFFSET + i, RFCB_DEV_SYS);         /* address */
-        RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_BUF_WR_DATA, data, RFCB_DEV_SYS);                                                   /* data */        
+        FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, BUF_WR_ADDR, CON_SIS8300_STRUCK_IQFB_IQ_SP_TABLE_OFFSET + i);         /* address */
+        FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, BUF_WR_DATA, data);                                                   /* data */        
     }
     
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_BUF_WR_ADDR, 0, RFCB_DEV_SYS);      /* disable the writing */    
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, BUF_WR_ADDR, 0);      /* disable the writing */    
 }
 
 /**
@@ -852,11 +715,11 @@ void  FWC_sis8300_struck_iqfb_func_setDrvRotationTable(void *boardHandle, unsign
         data = (cs << 16) + (sn & 0x0000FFFF);
 
         /* Write to the firmware via two registers */
-        RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_BUF_WR_ADDR, CON_SIS8300_STRUCK_IQFB_DRV_ROT_TABLE_OFFSET + i, RFCB_DEV_SYS);       /* address */
-        RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_BUF_WR_DATA, data, RFCB_DEV_SYS);                                                   /* data */        
+        FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, BUF_WR_ADDR, CON_SIS8300_STRUCK_IQFB_DRV_ROT_TABLE_OFFSET + i);       /* address */
+        FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, BUF_WR_DATA, data);                                                   /* data */        
     }
     
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_BUF_WR_ADDR, 0, RFCB_DEV_SYS);      /* disable the writing */    
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, BUF_WR_ADDR, 0);      /* disable the writing */    
 }
 
 /** 
@@ -864,7 +727,7 @@ void  FWC_sis8300_struck_iqfb_func_setDrvRotationTable(void *boardHandle, unsign
  */
 void  FWC_sis8300_struck_iqfb_func_setNonIQCoefOffset(void *boardHandle, unsigned int offset)
 {
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_COEF_ID_OFF, offset, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, COEF_ID_OFF, offset);
 }
 
 /**
@@ -887,8 +750,8 @@ void  FWC_sis8300_struck_iqfb_func_setImbalanceCorrMatrix(void *boardHandle, dou
     a1x   = (hw1x << 16) + (lw1x & 0x0000FFFF);
     a2x   = (hw2x << 16) + (lw2x & 0x0000FFFF);
 
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_IMBALANCE_MATRIX_A1X, a1x, RFCB_DEV_SYS);
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_IMBALANCE_MATRIX_A2X, a2x, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, IMBALANCE_MATRIX_A1X, a1x);
+    FWC_SIS8300_STRUCK_IQFB_REG_WRITE(boardHandle, IMBALANCE_MATRIX_A2X, a2x);
 }
 
 /*-------------------------------------------------------------
@@ -902,8 +765,8 @@ void FWC_sis8300_struck_iqfb_func_getAppFwInfo(void *boardHandle, unsigned int *
     unsigned int var_version;
     
     /* read the registers */    
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_FRIMWARE_NAME,     firmwareName, RFCB_DEV_SYS);
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_FIRMWARE_VERSION,  &var_version, RFCB_DEV_SYS);    
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, FRIMWARE_NAME,     firmwareName);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, FIRMWARE_VERSION,  &var_version);    
     
     /* build up the data */   
     *majorVer   = (var_version >> 24) & 0xFF;
@@ -916,7 +779,7 @@ void FWC_sis8300_struck_iqfb_func_getAppFwInfo(void *boardHandle, unsigned int *
  */
 void  FWC_sis8300_struck_iqfb_func_getUsageStatus(void *boardHandle, unsigned int *useStatus)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_USE_STATUS, useStatus, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, USE_STATUS, useStatus);
 }
 
 /**
@@ -924,9 +787,9 @@ void  FWC_sis8300_struck_iqfb_func_getUsageStatus(void *boardHandle, unsigned in
  */
 void  FWC_sis8300_struck_iqfb_func_getRaceConditionFlags(void *boardHandle, unsigned int *accFlags, unsigned int *stdbyFlags, unsigned int *spareFlags)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_RCFLAGS_ACC,   accFlags, RFCB_DEV_SYS);
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_RCFLAGS_STDBY, stdbyFlags, RFCB_DEV_SYS);
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_RCFLAGS_SPARE, spareFlags, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, RCFLAGS_ACC,   accFlags);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, RCFLAGS_STDBY, stdbyFlags);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, RCFLAGS_SPARE, spareFlags);
 }
 
 /**
@@ -934,7 +797,7 @@ void  FWC_sis8300_struck_iqfb_func_getRaceConditionFlags(void *boardHandle, unsi
  */
 void FWC_sis8300_struck_iqfb_func_getPulseCounter(void *boardHandle, unsigned int *pulseCnt)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_PUL_CNT, pulseCnt, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, PUL_CNT, pulseCnt);
 }
 
 /**
@@ -943,7 +806,7 @@ void FWC_sis8300_struck_iqfb_func_getPulseCounter(void *boardHandle, unsigned in
 void  FWC_sis8300_struck_iqfb_func_getMeaTrigPeriod(void *boardHandle, double *value_ms, double freq_MHz)
 {
     unsigned int data;
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_DIAG_TRIG_PERIOD, &data, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, DIAG_TRIG_PERIOD, &data);
     *value_ms = (double)data / freq_MHz / 1000.0;
 }
 
@@ -952,7 +815,7 @@ void  FWC_sis8300_struck_iqfb_func_getMeaTrigPeriod(void *boardHandle, double *v
  */
 void  FWC_sis8300_struck_iqfb_func_getNonIQCoefCur(void *boardHandle, unsigned int *cur)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_COEF_ID_TRIG, cur, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, COEF_ID_TRIG, cur);
 }
 
 /**
@@ -960,7 +823,7 @@ void  FWC_sis8300_struck_iqfb_func_getNonIQCoefCur(void *boardHandle, unsigned i
  */
 void  FWC_sis8300_struck_iqfb_func_getWatchDogCnt(void *boardHandle, unsigned int *cnt)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_WD_CNT, cnt, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, WD_CNT, cnt);
 }
 
 /**
@@ -968,8 +831,50 @@ void  FWC_sis8300_struck_iqfb_func_getWatchDogCnt(void *boardHandle, unsigned in
  */
 void  FWC_sis8300_struck_iqfb_func_getFwStatus(void *boardHandle, unsigned int *platformStatus, unsigned int *RFCtrlStatus)
 {
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_PLATFORM_STATUS, platformStatus, RFCB_DEV_SYS);
-    RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_REG_ADDR_RFCTRL_STATUS,   RFCtrlStatus, RFCB_DEV_SYS);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, PLATFORM_STATUS, platformStatus);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, RFCTRL_STATUS,   RFCtrlStatus);
+}
+
+/**
+ * Read all status registers, the neighbouring registers are read with one block read (the global block and two parts
+ *   of the trigger block), the others one by one
+ * Input:
+ *   boardHandle        : Address of the data structure of the board moudle
+ * Output:
+ *   status             : Snapshot of the status registers
+ */
+void FWC_sis8300_struck_iqfb_func_getStatusSnapshot(void *boardHandle, FWC_sis8300_struck_iqfb_struc_status *status)
+{
+    unsigned int var_global[3];                             /* WD_CNT, PLATFORM_STATUS, USE_STATUS */
+    unsigned int var_RCFlags[3];                            /* RCFLAGS_ACC, RCFLAGS_STDBY, RCFLAGS_SPARE */
+    unsigned int var_trig[2];                               /* DIAG_TRIG_PERIOD, PUL_CNT */
+
+    if(!status) return;
+
+    memset(var_global,  0, sizeof(var_global));
+    memset(var_RCFlags, 0, sizeof(var_RCFlags));
+    memset(var_trig,    0, sizeof(var_trig));
+
+    FWC_SIS8300_STRUCK_IQFB_REG_READ_BLOCK(boardHandle, WD_CNT,           3, var_global);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ_BLOCK(boardHandle, RCFLAGS_ACC,      3, var_RCFlags);
+    FWC_SIS8300_STRUCK_IQFB_REG_READ_BLOCK(boardHandle, DIAG_TRIG_PERIOD, 2, var_trig);
+
+    status -> WDCnt          = var_global[(CON_SIS8300_STRUCK_IQFB_REG_ADDR_WD_CNT          - CON_SIS8300_STRUCK_IQFB_REG_ADDR_WD_CNT) / FWC_SIS8300_STRUCK_IQFB_CONST_REG_STRIDE];
+    status -> platformStatus = var_global[(CON_SIS8300_STRUCK_IQFB_REG_ADDR_PLATFORM_STATUS - CON_SIS8300_STRUCK_IQFB_REG_ADDR_WD_CNT) / FWC_SIS8300_STRUCK_IQFB_CONST_REG_STRIDE];
+    status -> useStatus      = var_global[(CON_SIS8300_STRUCK_IQFB_REG_ADDR_USE_STATUS      - CON_SIS8300_STRUCK_IQFB_REG_ADDR_WD_CNT) / FWC_SIS8300_STRUCK_IQFB_CONST_REG_STRIDE];
+
+    status -> RCFlagsAcc     = var_RCFlags[(CON_SIS8300_STRUCK_IQFB_REG_ADDR_RCFLAGS_ACC   - CON_SIS8300_STRUCK_IQFB_REG_ADDR_RCFLAGS_ACC) / FWC_SIS8300_STRUCK_IQFB_CONST_REG_STRIDE];
+    status -> RCFlagsStdby   = var_RCFlags[(CON_SIS8300_STRUCK_IQFB_REG_ADDR_RCFLAGS_STDBY - CON_SIS8300_STRUCK_IQFB_REG_ADDR_RCFLAGS_ACC) / FWC_SIS8300_STRUCK_IQFB_CONST_REG_STRIDE];
+    status -> RCFlagsSpare   = var_RCFlags[(CON_SIS8300_STRUCK_IQFB_REG_ADDR_RCFLAGS_SPARE - CON_SIS8300_STRUCK_IQFB_REG_ADDR_RCFLAGS_ACC) / FWC_SIS8300_STRUCK_IQFB_CONST_REG_STRIDE];
+
+    status -> trigPeriod     = var_trig[(CON_SIS8300_STRUCK_IQFB_REG_ADDR_DIAG_TRIG_PERIOD - CON_SIS8300_STRUCK_IQFB_REG_ADDR_DIAG_TRIG_PERIOD) / FWC_SIS8300_STRUCK_IQFB_CONST_REG_STRIDE];
+    status -> pulseCnt       = var_trig[(CON_SIS8300_STRUCK_IQFB_REG_ADDR_PUL_CNT          - CON_SIS8300_STRUCK_IQFB_REG_ADDR_DIAG_TRIG_PERIOD) / FWC_SIS8300_STRUCK_IQFB_CONST_REG_STRIDE];
+
+    FWC_SIS8300_STRUCK_IQFB_REG_READ(boardHandle, RFCTRL_STATUS, &status -> RFCtrlStatus);
+
+    /* digital input of the platform */
+    FWC_sis8300_struck_iqfb_func_getHarlink(boardHandle, &status -> harlinkIn);
+    FWC_sis8300_struck_iqfb_func_getAMCLVDS(boardHandle, &status -> amcLVDSIn);
 }
 
 /**
@@ -985,8 +890,8 @@ void  FWC_sis8300_struck_iqfb_func_getAllDAQData(void *boardHandle, unsigned int
 
     unsigned int data;*/
 
-    RFCB_API_readBuffer((RFCB_struc_moduleData *)boardHandle, CON_SIS8300_STRUCK_IQFB_BRAM_DMA_OFFSET, 
-                         CON_SIS8300_STRUCK_IQFB_DAQ_BUF_DEPTH * CON_SIS8300_STRUCK_IQFB_DAQ_BUF_NUM * 2, buf, RFCB_DEV_SYS);  
+    RFCFW_func_bufRead(boardHandle, CON_SIS8300_STRUCK_IQFB_BRAM_DMA_OFFSET, 
+                        CON_SIS8300_STRUCK_IQFB_DAQ_BUF_DEPTH * CON_SIS8300_STRUCK_IQFB_DAQ_BUF_NUM * 2, buf, RFCB_DEV_SYS);  
 
     /* Print the data */
     /*printf("-----------------------------------------------\n");
@@ -1016,6 +921,46 @@ void  FWC_sis8300_struck_iqfb_func_getAllDAQData(void *boardHandle, unsigned int
   
 }
 
+/**
+ * Set up the ADC sampling to the DRAM and arm it for the next trigger
+ * Input:
+ *   boardHandle    : Handle of the RFControlBoard module
+ *   pno            : Point number, rounded down to integer times of 16
+ *   startBlock     : Start block in the region of each channel, the data of channel n is written from the block n * 1M + startBlock
+ *                    (bank * 512k for the ping-pong, or the slot of the pulse in a burst)
+ */
+void  FWC_sis8300_struck_iqfb_func_armADC(void *boardHandle, unsigned int pno, unsigned int startBlock)
+{
+    unsigned int pno_f;
+
+    pno_f = (unsigned int)(pno / 16) * 16;
+    if(pno_f < 16) pno_f = 16;
+
+    if(!boardHandle) return;
+
+    /* set up the ADC sampling */    
+    RFCFW_func_regWrite(boardHandle, DDR2_ACCESS_CONTROL, 0, RFCB_DEV_SYS);                   /* disable ddr2 test write interface */
+    RFCFW_func_regWrite(boardHandle, SIS8300_PRETRIGGER_DELAY_REG, 0, RFCB_DEV_SYS);          /* disable the delay */
+    RFCFW_func_regWrite(boardHandle, SIS8300_SAMPLE_LENGTH_REG, pno_f >> 4, RFCB_DEV_SYS);    /* each block has 16 point, here is the block number */
+    RFCFW_func_regWrite(boardHandle, SIS8300_SAMPLE_CONTROL_REG, 0x1000, RFCB_DEV_SYS);       /* enable all ADCs, use the RF pulse trigger */
+
+    RFCFW_func_regWrite(boardHandle, SIS8300_ACQUISITION_CONTROL_STATUS_REG, 0x00004, RFCB_DEV_SYS);  /* reset the sampling logic */
+
+    RFCFW_func_regWrite(boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH1_REG,  0x000000 + startBlock, RFCB_DEV_SYS);    /* 1. 1M-Block 16 Msamples */
+    RFCFW_func_regWrite(boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH2_REG,  0x100000 + startBlock, RFCB_DEV_SYS);    /* 2. 1M-Block 16 Msamples */
+    RFCFW_func_regWrite(boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH3_REG,  0x200000 + startBlock, RFCB_DEV_SYS);    /* 3. 1M-Block 16 Msamples */
+    RFCFW_func_regWrite(boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH4_REG,  0x300000 + startBlock, RFCB_DEV_SYS);    /* 4. 1M-Block 16 Msamples */
+    RFCFW_func_regWrite(boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH5_REG,  0x400000 + startBlock, RFCB_DEV_SYS);    /* 5. 1M-Block 16 Msamples */
+    RFCFW_func_regWrite(boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH6_REG,  0x500000 + startBlock, RFCB_DEV_SYS);    /* 6. 1M-Block 16 Msamples */
+    RFCFW_func_regWrite(boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH7_REG,  0x600000 + startBlock, RFCB_DEV_SYS);    /* 7. 1M-Block 16 Msamples */
+    RFCFW_func_regWrite(boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH8_REG,  0x700000 + startBlock, RFCB_DEV_SYS);    /* 8. 1M-Block 16 Msamples */
+    RFCFW_func_regWrite(boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH9_REG,  0x800000 + startBlock, RFCB_DEV_SYS);    /* 9. 1M-Block 16 Msamples */
+    RFCFW_func_regWrite(boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH10_REG, 0x900000 + startBlock, RFCB_DEV_SYS);    /* 10.1M-Block 16 Msamples */
+    
+    /* re-arm the sampling, waiting for next trigger */
+    RFCFW_func_regWrite(boardHandle, SIS8300_ACQUISITION_CONTROL_STATUS_REG, 0x00002, RFCB_DEV_SYS);  /* armed, wait for trigger */
+}
+
 /**
  * Get the ADC data from the DRAM
  * Note: now, all the ADC raw data will be read from the DRAM while the RF controller internal data will be read from the BRAM
@@ -1024,16 +969,34 @@ void  FWC_sis8300_struck_iqfb_func_getAllDAQData(void *boardHandle, unsigned int
  *       - Address of the registers are defined in the RFCB module
  *
  *       The ADCxData is a temp buffer to convert the data format
+ *
+ *       The DRAM region of each channel is split in 2 banks (ping-pong). If the next bank differs from the bank to read,
+ *       the sampling is re-armed to the next bank before the readout, so that the next pulse can be captured while the
+ *       bank is read. Otherwise the bank is read first and then re-armed (the readout must finish before next trigger)
+ *
+ *       If the segments (regions of interest) are given, only the points of the segments are read and converted, they
+ *       are placed at the same position of the buffers as the full readout. The other points are not touched
+ * Input:
+ *   pno            : Point number the bank to read was armed with
+ *   pnoNext        : Point number for the next pulse
+ *   bank           : Bank holding the pulse captured, to be read
+ *   bankNext       : Bank for the next pulse
+ *   seg            : Segments to read, the start and point number must be even (32-bit words)
+ *   segNum         : Number of segments, 0 to read all points
  */
-void  FWC_sis8300_struck_iqfb_func_getAllADCData(void *boardHandle, unsigned int pno,
+void  FWC_sis8300_struck_iqfb_func_getAllADCData(void *boardHandle, unsigned int pno, unsigned int pnoNext, unsigned int bank, unsigned int bankNext,
+                                                            const RFCFW_struc_roiSeg *seg, int segNum,
                                                             short *ADC0Data, short *ADC1Data,            
                                                             short *ADC2Data, short *ADC3Data,
                                                             short *ADC4Data, short *ADC5Data,
                                                             short *ADC6Data, short *ADC7Data,
                                                             short *ADC8Data, short *ADC9Data)
 {
-    int i;
+    int i, j, ch;
     unsigned int pno_f;
+    unsigned int var_bankStart;
+    unsigned int var_start, var_end;
+    short       *ptr_data[10];
 
     /* check the input */
     pno_f = (unsigned int)(pno / 16) * 16;
@@ -1041,58 +1004,90 @@ void  FWC_sis8300_struck_iqfb_func_getAllADCData(void *boardHandle, unsigned int
 
     if(!boardHandle || !ADC0Data || !ADC1Data || !ADC2Data || !ADC3Data || !ADC4Data || !ADC5Data || !ADC6Data || !ADC7Data || !ADC8Data || !ADC9Data) return;
 
+    if(!seg) segNum = 0;
+
+    ptr_data[0] = ADC0Data; ptr_data[1] = ADC1Data; ptr_data[2] = ADC2Data; ptr_data[3] = ADC3Data; ptr_data[4] = ADC4Data;
+    ptr_data[5] = ADC5Data; ptr_data[6] = ADC6Data; ptr_data[7] = ADC7Data; ptr_data[8] = ADC8Data; ptr_data[9] = ADC9Data;
+
+    bank     &= 0x1;
+    bankNext &= 0x1;
+
     /* wait if BUSY or arm (risky) */
     /*do {
         RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_ACQUISITION_CONTROL_STATUS_REG, &data, RFCB_DEV_SYS);       
     } while((data & 0x3) != 0); */ /* assume time is enough for finishing the sampling */
 
-    /* read the buffers (address and pno are for 32 bit data) */
-    RFCB_API_readBuffer((RFCB_struc_moduleData *)boardHandle, 0 * (0x100000 * 16 * 2 / 4), pno_f >> 1, (unsigned int *)ADC0Data, RFCB_DEV_SYS);    /* Blocklength * 16 Samples/Block * 2Byte/Sample / 4 for 32 bits data */
-    RFCB_API_readBuffer((RFCB_struc_moduleData *)boardHandle, 1 * (0x100000 * 16 * 2 / 4), pno_f >> 1, (unsigned int *)ADC1Data, RFCB_DEV_SYS);    /* Blocklength * 16 Samples/Block * 2Byte/Sample / 4 for 32 bits data */
-    RFCB_API_readBuffer((RFCB_struc_moduleData *)boardHandle, 2 * (0x100000 * 16 * 2 / 4), pno_f >> 1, (unsigned int *)ADC2Data, RFCB_DEV_SYS);    /* Blocklength * 16 Samples/Block * 2Byte/Sample / 4 for 32 bits data */
-    RFCB_API_readBuffer((RFCB_struc_moduleData *)boardHandle, 3 * (0x100000 * 16 * 2 / 4), pno_f >> 1, (unsigned int *)ADC3Data, RFCB_DEV_SYS);    /* Blocklength * 16 Samples/Block * 2Byte/Sample / 4 for 32 bits data */
-    RFCB_API_readBuffer((RFCB_struc_moduleData *)boardHandle, 4 * (0x100000 * 16 * 2 / 4), pno_f >> 1, (unsigned int *)ADC4Data, RFCB_DEV_SYS);    /* Blocklength * 16 Samples/Block * 2Byte/Sample / 4 for 32 bits data */
-    RFCB_API_readBuffer((RFCB_struc_moduleData *)boardHandle, 5 * (0x100000 * 16 * 2 / 4), pno_f >> 1, (unsigned int *)ADC5Data, RFCB_DEV_SYS);    /* Blocklength * 16 Samples/Block * 2Byte/Sample / 4 for 32 bits data */
-    RFCB_API_readBuffer((RFCB_struc_moduleData *)boardHandle, 6 * (0x100000 * 16 * 2 / 4), pno_f >> 1, (unsigned int *)ADC6Data, RFCB_DEV_SYS);    /* Blocklength * 16 Samples/Block * 2Byte/Sample / 4 for 32 bits data */
-    RFCB_API_readBuffer((RFCB_struc_moduleData *)boardHandle, 7 * (0x100000 * 16 * 2 / 4), pno_f >> 1, (unsigned int *)ADC7Data, RFCB_DEV_SYS);    /* Blocklength * 16 Samples/Block * 2Byte/Sample / 4 for 32 bits data */
-    RFCB_API_readBuffer((RFCB_struc_moduleData *)boardHandle, 8 * (0x100000 * 16 * 2 / 4), pno_f >> 1, (unsigned int *)ADC8Data, RFCB_DEV_SYS);    /* Blocklength * 16 Samples/Block * 2Byte/Sample / 4 for 32 bits data */
-    RFCB_API_readBuffer((RFCB_struc_moduleData *)boardHandle, 9 * (0x100000 * 16 * 2 / 4), pno_f >> 1, (unsigned int *)ADC9Data, RFCB_DEV_SYS);    /* Blocklength * 16 Samples/Block * 2Byte/Sample / 4 for 32 bits data */
-
-    /* convert the data to 2's complement from binary offset */
-    for(i = 0; i < pno_f; i ++) {
-        *(ADC0Data + i) ^= 0x8000;
-        *(ADC1Data + i) ^= 0x8000;
-        *(ADC2Data + i) ^= 0x8000;
-        *(ADC3Data + i) ^= 0x8000;
-        *(ADC4Data + i) ^= 0x8000;
-        *(ADC5Data + i) ^= 0x8000;
-        *(ADC6Data + i) ^= 0x8000;
-        *(ADC7Data + i) ^= 0x8000;
-        *(ADC8Data + i) ^= 0x8000;
-        *(ADC9Data + i) ^= 0x8000;
+    /* arm the other bank first, the next pulse is captured there during the readout */
+    if(bankNext != bank) FWC_sis8300_struck_iqfb_func_armADC(boardHandle, pnoNext, bankNext * FWC_SIS8300_STRUCK_IQFB_CONST_ADC_BANK_BLOCKS);
+
+    /* read the buffers (address and pno are for 32 bit data), the full readout is a single segment */
+    var_bankStart = bank * (FWC_SIS8300_STRUCK_IQFB_CONST_ADC_BANK_BLOCKS * 16 * 2 / 4);
+
+    for(j = 0; j < (segNum > 0 ? segNum : 1); j ++) {
+        if(segNum > 0) {
+            var_start = (unsigned int)seg[j].start & ~0x1u;
+            var_end   = (unsigned int)(seg[j].start + seg[j].pno + 1) & ~0x1u;
+            if(var_end > pno_f) var_end = pno_f;
+            if(var_end <= var_start) continue;
+        } else {
+            var_start = 0;
+            var_end   = pno_f;
+        }
+
+        for(ch = 0; ch < 10; ch ++) {
+            RFCFW_func_bufRead(boardHandle, var_bankStart + ch * (0x100000 * 16 * 2 / 4) + (var_start >> 1), (var_end - var_start) >> 1,
+                               (unsigned int *)(ptr_data[ch] + var_start), RFCB_DEV_SYS);    /* Blocklength * 16 Samples/Block * 2Byte/Sample / 4 for 32 bits data */
+
+            /* convert the data to 2's complement from binary offset */
+            for(i = (int)var_start; i < (int)var_end; i ++)
+                *(ptr_data[ch] + i) ^= 0x8000;
+        }
     }
 
-    /* set up the ADC sampling (later put to a commmon function) */    
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, DDR2_ACCESS_CONTROL, 0, RFCB_DEV_SYS);                   /* disable ddr2 test write interface */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_PRETRIGGER_DELAY_REG, 0, RFCB_DEV_SYS);          /* disable the delay */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SAMPLE_LENGTH_REG, pno_f >> 4, RFCB_DEV_SYS);    /* each block has 16 point, here is the block number */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SAMPLE_CONTROL_REG, 0x1000, RFCB_DEV_SYS);       /* enable all ADCs, use the RF pulse trigger */
-
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_ACQUISITION_CONTROL_STATUS_REG, 0x00004, RFCB_DEV_SYS);  /* reset the sampling logic */
-
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH1_REG,  0x000000, RFCB_DEV_SYS);  /* 1. 1M-Block 16 Msamples */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH2_REG,  0x100000, RFCB_DEV_SYS);  /* 2. 1M-Block 16 Msamples */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH3_REG,  0x200000, RFCB_DEV_SYS);  /* 3. 1M-Block 16 Msamples */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH4_REG,  0x300000, RFCB_DEV_SYS);  /* 4. 1M-Block 16 Msamples */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH5_REG,  0x400000, RFCB_DEV_SYS);  /* 5. 1M-Block 16 Msamples */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH6_REG,  0x500000, RFCB_DEV_SYS);  /* 6. 1M-Block 16 Msamples */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH7_REG,  0x600000, RFCB_DEV_SYS);  /* 7. 1M-Block 16 Msamples */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH8_REG,  0x700000, RFCB_DEV_SYS);  /* 8. 1M-Block 16 Msamples */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH9_REG,  0x800000, RFCB_DEV_SYS);  /* 9. 1M-Block 16 Msamples */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_SAMPLE_START_ADDRESS_CH10_REG, 0x900000, RFCB_DEV_SYS);  /* 10.1M-Block 16 Msamples */
-    
-    /* re-arm the sampling, waiting for next trigger */
-    RFCB_API_writeRegister((RFCB_struc_moduleData *)boardHandle, SIS8300_ACQUISITION_CONTROL_STATUS_REG, 0x00002, RFCB_DEV_SYS);  /* armed, wait for trigger */
+    /* single bank, re-arm after the readout */
+    if(bankNext == bank) FWC_sis8300_struck_iqfb_func_armADC(boardHandle, pnoNext, bankNext * FWC_SIS8300_STRUCK_IQFB_CONST_ADC_BANK_BLOCKS);
+}
+
+/**
+ * Get the ADC data of a burst from the DRAM. The pulses of the burst were captured one after another from the start of
+ *   the region of each channel, so the data of a channel is read with large transfers and converted in one pass
+ * Input:
+ *   boardHandle    : Handle of the RFControlBoard module
+ *   pno            : Point number of each pulse, integer times of 16
+ *   num            : Number of pulses
+ *   ADCData        : Buffers of the 10 channels, each for num * pno points (pulse after pulse)
+ */
+void  FWC_sis8300_struck_iqfb_func_getBurstADCData(void *boardHandle, unsigned int pno, unsigned int num, short **ADCData)
+{
+    unsigned int i;
+    unsigned int ch;
+    unsigned int var_words, var_offset, var_size;
+    unsigned int var_total;
+    short       *ptr_data;
+
+    if(!boardHandle || !ADCData || pno < 16 || num < 1) return;
+
+    var_total = pno * num;                          /* points per channel */
+
+    for(ch = 0; ch < 10; ch ++) {
+        ptr_data = ADCData[ch];
+        if(!ptr_data) continue;
+
+        /* read the buffer (address and size are for 32 bit data), limit the size of each transfer */
+        var_words = var_total >> 1;
+
+        for(var_offset = 0; var_offset < var_words; var_offset += var_size) {
+            var_size = var_words - var_offset;
+            if(var_size > FWC_SIS8300_STRUCK_IQFB_CONST_BURST_READ_WORDS) var_size = FWC_SIS8300_STRUCK_IQFB_CONST_BURST_READ_WORDS;
+
+            RFCFW_func_bufRead(boardHandle, ch * (0x100000 * 16 * 2 / 4) + var_offset, var_size, (unsigned int *)ptr_data + var_offset, RFCB_DEV_SYS);
+        }
+
+        /* convert the data to 2's complement from binary offset */
+        for(i = 0; i < var_total; i ++) {
+            *(ptr_data + i) ^= 0x8000;
+        }
+    }
 }
 
 
@@ -25,6 +25,8 @@
 #include "RFControlBoard_availableInterface.h"                                          /* only point to interact with the RFControlBoard module */                     
 #include "addrMap_sis8300_struck_iqfb.h"                                                /* use the address map here */
 #include "RFLib_signalProcess.h"
+#include "RFControlFirmware_regAccess.h"                                               /* register accessors generated from the address map */
+#include "RFControlFirmware_roi.h"                                                     /* segments of the readout */
 
 /**
  * Constants for board access 
@@ -41,11 +43,49 @@
 #define FWC_SIS8300_STRUCK_IQFB_CONST_DAQ_BUF_NUM       CON_SIS8300_STRUCK_IQFB_DAQ_BUF_NUM                 /* DAQ buffer number */
 
 #define FWC_SIS8300_STRUCK_IQFB_CONST_ADC_SAMPLE_MAX    65536                                               /* 64k points (65536) */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_ADC_BANK_BLOCKS   0x80000                                             /* DRAM blocks (16 points) of a capture bank, half of the 1M-block region of a channel */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_ADC_REGION_BLOCKS 0x100000                                            /* DRAM blocks (16 points) of the region of a channel (16 Msamples) */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_BURST_READ_WORDS  0x100000                                            /* max. 32-bit words of a buffer read of the burst data (4 MBytes) */
+
+#define FWC_SIS8300_STRUCK_IQFB_CONST_REG_DEVICE     RFCB_DEV_SYS                                        /* device of the application firmware registers */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_REG_STRIDE     1                                                   /* address step between two neighbouring registers */
+
+#define FWC_SIS8300_STRUCK_IQFB_CONST_FW_NAME_ID     0x00000000                                          /* detection: firmware name of the application firmware, not fixed by the address map, */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_FW_NAME_MASK   0x00000000                                          /*   set with RFCFW_setBackendFwId for the deployed firmware */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_PLATFORM_REG   SIS8300_INDENTIFIER_VERSION_REG                     /* detection: identifier register of the Struck platform firmware */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_PLATFORM_ID    0x83000000                                          /* module id 0x8300 in the upper 16 bits, the lower 16 bits are the version */
+#define FWC_SIS8300_STRUCK_IQFB_CONST_PLATFORM_MASK  0xFFFF0000
+
+/**
+ * Register accessors, the register is given by the name in the address map without the prefix, e.g. SWITCH_CTRL
+ */
+#define FWC_SIS8300_STRUCK_IQFB_REG_WRITE(handle, reg, data)  RFCFW_REG_WRITE(SIS8300_STRUCK_IQFB, FWC_SIS8300_STRUCK_IQFB_CONST_REG_DEVICE, handle, reg, data)
+#define FWC_SIS8300_STRUCK_IQFB_REG_READ(handle, reg, ptr)    RFCFW_REG_READ(SIS8300_STRUCK_IQFB, FWC_SIS8300_STRUCK_IQFB_CONST_REG_DEVICE, handle, reg, ptr)
+#define FWC_SIS8300_STRUCK_IQFB_REG_READ_BLOCK(handle, reg, num, ptr)  RFCFW_REG_READ_BLOCK(SIS8300_STRUCK_IQFB, FWC_SIS8300_STRUCK_IQFB_CONST_REG_DEVICE, FWC_SIS8300_STRUCK_IQFB_CONST_REG_STRIDE, handle, reg, num, ptr)
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Snapshot of the status registers, read together with block reads of the neighbouring registers
+ */
+typedef struct {
+    unsigned int WDCnt;                                     /* global block */
+    unsigned int platformStatus;
+    unsigned int useStatus;
+
+    unsigned int RCFlagsAcc;                                /* trigger block */
+    unsigned int RCFlagsStdby;
+    unsigned int RCFlagsSpare;
+    unsigned int trigPeriod;                                /* measured trigger period in sampling clocks */
+    unsigned int pulseCnt;
+
+    unsigned int RFCtrlStatus;                              /* RF control block */
+    unsigned int harlinkIn;                                 /* digital input of the platform */
+    unsigned int amcLVDSIn;
+} FWC_sis8300_struck_iqfb_struc_status;
+
 /**
  * Interface functions
  */
@@ -60,7 +100,7 @@ void FWC_sis8300_struck_iqfb_func_getBoardInfo(void *boardHandle, char *deviceNa
 /*--------------------------
  * platform firmware 
  *-------------------------- */                    
-void FWC_sis8300_struck_iqfb_func_setSPI(void *boardHandle, unsigned int clkDiv2);                                          /* set the clock divider, ADC chips and DAC chips (with fixed value,later can make it changable) */
+int  FWC_sis8300_struck_iqfb_func_setSPI(void *boardHandle, unsigned int clkDiv2, unsigned int verify, long *fallbackCnt);  /* set the clock divider, ADC chips and DAC chips (with fixed value,later can make it changable) */
 
 void FWC_sis8300_struck_iqfb_func_setHarlink(void *boardHandle, unsigned int data);
 void FWC_sis8300_struck_iqfb_func_setAMCLVDS(void *boardHandle, unsigned int data);
@@ -118,6 +158,7 @@ __inline__ void  FWC_sis8300_struck_iqfb_func_setAmpLimitHi(void *boardHandle,
 __inline__ void  FWC_sis8300_struck_iqfb_func_setAmpLimitLo(void *boardHandle,  unsigned int limit);
 
 __inline__ void  FWC_sis8300_struck_iqfb_func_setIQSPTable(void *boardHandle, unsigned int pno, double *ISPTable, double *QSPTable);                        /* set the set point table */
+__inline__ void  FWC_sis8300_struck_iqfb_func_setIQSPTableRange(void *boardHandle, unsigned int start, unsigned int pno, double *ISPTable, double *QSPTable);  /* set a region of the set point table */
 __inline__ void  FWC_sis8300_struck_iqfb_func_setDrvRotationTable(void *boardHandle, unsigned int pno, double *scaleTable, double *rotAngleTable_deg);      /* set the driving chain rotation table */
 
 __inline__ void  FWC_sis8300_struck_iqfb_func_setNonIQCoefOffset(void *boardHandle, unsigned int offset);
@@ -140,14 +181,21 @@ __inline__ void  FWC_sis8300_struck_iqfb_func_getNonIQCoefCur(void *boardHandle,
 __inline__ void  FWC_sis8300_struck_iqfb_func_getWatchDogCnt(void *boardHandle, unsigned int *cnt);
 __inline__ void  FWC_sis8300_struck_iqfb_func_getFwStatus(void *boardHandle, unsigned int *platformStatus, unsigned int *RFCtrlStatus);
 
+void FWC_sis8300_struck_iqfb_func_getStatusSnapshot(void *boardHandle, FWC_sis8300_struck_iqfb_struc_status *status);                     /* read all status registers */
+
 __inline__ void  FWC_sis8300_struck_iqfb_func_getAllDAQData(void *boardHandle, unsigned int *buf);                          /* data from BRAM */
-__inline__ void  FWC_sis8300_struck_iqfb_func_getAllADCData(void *boardHandle, unsigned int pno,                            /* data from DRAM */
+__inline__ void  FWC_sis8300_struck_iqfb_func_getAllADCData(void *boardHandle, unsigned int pno, unsigned int pnoNext,      /* data from DRAM */
+                                                            unsigned int bank, unsigned int bankNext,
+                                                            const RFCFW_struc_roiSeg *seg, int segNum,
                                                             short *ADC0Data, short *ADC1Data,            
                                                             short *ADC2Data, short *ADC3Data,
                                                             short *ADC4Data, short *ADC5Data,
                                                             short *ADC6Data, short *ADC7Data,
                                                             short *ADC8Data, short *ADC9Data);
 
+void  FWC_sis8300_struck_iqfb_func_armADC(void *boardHandle, unsigned int pno, unsigned int startBlock);                   /* arm the DRAM capture from the start block */
+void  FWC_sis8300_struck_iqfb_func_getBurstADCData(void *boardHandle, unsigned int pno, unsigned int num, short **ADCData); /* data of a burst from DRAM */
+
 #ifdef __cplusplus
 }
 #endif
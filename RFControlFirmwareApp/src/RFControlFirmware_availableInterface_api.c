@@ -8,8 +8,12 @@
  * Description: Initial creation
  ****************************************************/
 #include <stdlib.h>             
+#include <stdio.h>
 #include <string.h>
 #include <errlog.h>
+#include <epicsThread.h>
+#include <epicsEvent.h>
+#include <epicsMutex.h>
 
 #include "RFControlFirmware_availableInterface_api.h"
 
@@ -22,6 +26,49 @@ static int RFCFW_gvar_moduleInstanceListInitalized = 0;
 
 /* A mutex is required for this list (to be done later) */
 
+/* Jobs of the parallel bring-up, the workers take the modules one by one from the list */
+#define RFCFW_CONST_BRING_UP_THREAD_MAX     16
+
+typedef struct {
+    RFCFW_struc_moduleData **modules;                       /* modules to bring up */
+    long          moduleNum;
+    long          nextId;                                   /* index of the next module to take */
+    int           setupSPI;                                 /* 1 to setup the SPI of the boards */
+
+    long          workerDone;                               /* number of workers finished */
+    epicsMutexId  mutex;                                    /* protect the nextId and workerDone */
+    epicsEventId  doneEvent;                                /* signaled by each worker when finished */
+} RFCFW_struc_bringUpJob;
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * Worker of the parallel bring-up, takes the modules from the job until all are done
+ */
+static void RFCFW_func_bringUpWorker(void *ptr)
+{
+    RFCFW_struc_bringUpJob *job = (RFCFW_struc_bringUpJob *)ptr;
+    RFCFW_struc_moduleData *ptr_moduleData;
+
+    for(;;) {
+        epicsMutexLock(job -> mutex);
+        ptr_moduleData = job -> nextId < job -> moduleNum ? job -> modules[job -> nextId ++] : NULL;
+        epicsMutexUnlock(job -> mutex);
+
+        if(!ptr_moduleData) break;
+
+        RFCFW_func_bringUp(ptr_moduleData, job -> setupSPI);
+    }
+
+    /* signal with the mutex held: the joiner checks the count with the mutex, so it cannot destroy the mutex and the
+       event (and leave the job on its stack) before this worker has released the mutex */
+    epicsMutexLock(job -> mutex);
+    job -> workerDone ++;
+    epicsEventSignal(job -> doneEvent);
+    epicsMutexUnlock(job -> mutex);
+}
+
 /*======================================
  * Common API Routines for module management
  *======================================*/
@@ -29,16 +76,15 @@ static int RFCFW_gvar_moduleInstanceListInitalized = 0;
  * Create an instance of the module
  * Input: 
  *     moduleName : An unique name of the module instance
- *     firmwareType : one of the pre-defined firmware type supported by the software
+ *     firmwareType : one of the pre-defined firmware type supported by the software (registered backends)
  * Return:
  *     0          : Successful
  *    -1          : Failed
  */
 int RFCFW_API_createModule(const char *moduleName, const char *firmwareType)
 {
-    RFCFW_struc_moduleData              *ptr_dataInstance    = NULL;
-    FWC_sis8300_struck_iqfb_struc_data  *ptr_fwDataInstance  = NULL;                         /* firmware specific data: sis8300 board, struck platform fw, i/q feedback app fw */
-    FWC_sis8300_eicsys_iqfb_struc_data  *ptr_fwDataInstance2 = NULL;                         /* firmware specific data: sis8300 board, eicsys platform fw, i/q feedback app fw */
+    RFCFW_struc_moduleData    *ptr_dataInstance = NULL;
+    const RFCFW_struc_backend *ptr_backend      = NULL;                                      /* descriptor of the firmware backend */
 
     /* Check the input parameters */
     if(!moduleName || !moduleName[0]) {
@@ -46,6 +92,15 @@ int RFCFW_API_createModule(const char *moduleName, const char *firmwareType)
         return -1;
     }
 
+    /* Find the backend of the firmware */
+    ptr_backend = RFCFW_func_findBackend(firmwareType);
+
+    if(ptr_backend == NULL) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_createModule: Firmware type %s is not supported for %s, the supported types are:\n", firmwareType ? firmwareType : "(null)", moduleName);
+        RFCFW_func_printBackends();
+        return -1;
+    }
+
     /* Check if the list initialized */
     if(!RFCFW_gvar_moduleInstanceListInitalized) {
         EPICSLIB_func_LinkedListInit(RFCFW_gvar_moduleInstanceList);
@@ -68,66 +123,18 @@ int RFCFW_API_createModule(const char *moduleName, const char *firmwareType)
     }
 
     /* --- initalize the firmware specific things --- */
-    if(strcmp("SIS8300:STRUCK:IQFB", firmwareType) == 0) {
-            
-        /* 1. connect the virtual functions */
-        ptr_dataInstance -> fwFunc.FWC_func_init            = FWC_sis8300_struck_iqfb_func_init;
+    /* 1. connect the virtual functions */
+    ptr_dataInstance -> backend = ptr_backend;
+    ptr_dataInstance -> fwFunc  = ptr_backend -> fwFunc;
 
-        ptr_dataInstance -> fwFunc.FWC_func_createEpicsData = FWC_sis8300_struck_iqfb_func_createEpicsData;
-        ptr_dataInstance -> fwFunc.FWC_func_deleteEpicsData = FWC_sis8300_struck_iqfb_func_deleteEpicsData;
+    /* 2. create data instance for the firmware */
+    ptr_dataInstance -> fwModule = calloc(1, ptr_backend -> dataSize);
 
-        ptr_dataInstance -> fwFunc.FWC_func_getBoardHandle  = FWC_sis8300_struck_iqfb_func_getBoard;
-
-        ptr_dataInstance -> fwFunc.FWC_func_getDAQData      = FWC_sis8300_struck_iqfb_func_getDAQData;
-        ptr_dataInstance -> fwFunc.FWC_func_getADCData      = FWC_sis8300_struck_iqfb_func_getADCData;
-        ptr_dataInstance -> fwFunc.FWC_func_getIntData      = FWC_sis8300_struck_iqfb_func_getIntData;
-
-        ptr_dataInstance -> fwFunc.FWC_func_setPha_deg      = FWC_sis8300_struck_iqfb_func_setPha_deg;
-        ptr_dataInstance -> fwFunc.FWC_func_setAmp          = FWC_sis8300_struck_iqfb_func_setAmp;
-            
-        ptr_dataInstance -> fwFunc.FWC_func_waitIntr        = FWC_sis8300_struck_iqfb_func_waitIntr;
-        ptr_dataInstance -> fwFunc.FWC_func_meaIntrLatency  = FWC_sis8300_struck_iqfb_func_meaIntrLatency;
-
-        /* 2. create data instance for the firmware */
-        ptr_fwDataInstance = (FWC_sis8300_struck_iqfb_struc_data *)calloc(1, sizeof(FWC_sis8300_struck_iqfb_struc_data));
-
-        if(ptr_fwDataInstance == NULL) {
-            EPICSLIB_func_errlogPrintf("RFCFW_API_createModule: Failed to create the data structure for the firmware SIS8300:STRUCK:IQFB for %s\n", moduleName);
-            return -1;
-        } else {
-            ptr_dataInstance -> fwModule = (void *)ptr_fwDataInstance;
-        }
-   
-    } else if(strcmp("SIS8300:EICSYS:IQFB", firmwareType) == 0) {
-            
-        /* 1. connect the virtual functions */
-        ptr_dataInstance -> fwFunc.FWC_func_init            = FWC_sis8300_eicsys_iqfb_func_init;
-
-        ptr_dataInstance -> fwFunc.FWC_func_createEpicsData = FWC_sis8300_eicsys_iqfb_func_createEpicsData;
-        ptr_dataInstance -> fwFunc.FWC_func_deleteEpicsData = FWC_sis8300_eicsys_iqfb_func_deleteEpicsData;
-
-        ptr_dataInstance -> fwFunc.FWC_func_getBoardHandle  = FWC_sis8300_eicsys_iqfb_func_getBoard;
-
-        ptr_dataInstance -> fwFunc.FWC_func_getDAQData      = FWC_sis8300_eicsys_iqfb_func_getDAQData;
-        ptr_dataInstance -> fwFunc.FWC_func_getADCData      = FWC_sis8300_eicsys_iqfb_func_getADCData;
-        ptr_dataInstance -> fwFunc.FWC_func_getIntData      = FWC_sis8300_eicsys_iqfb_func_getIntData;
-
-        ptr_dataInstance -> fwFunc.FWC_func_setPha_deg      = FWC_sis8300_eicsys_iqfb_func_setPha_deg;
-        ptr_dataInstance -> fwFunc.FWC_func_setAmp          = FWC_sis8300_eicsys_iqfb_func_setAmp;
-            
-        ptr_dataInstance -> fwFunc.FWC_func_waitIntr        = FWC_sis8300_eicsys_iqfb_func_waitIntr;
-        ptr_dataInstance -> fwFunc.FWC_func_meaIntrLatency  = FWC_sis8300_eicsys_iqfb_func_meaIntrLatency;
-
-        /* 2. create data instance for the firmware */
-        ptr_fwDataInstance2 = (FWC_sis8300_eicsys_iqfb_struc_data *)calloc(1, sizeof(FWC_sis8300_eicsys_iqfb_struc_data));
-
-        if(ptr_fwDataInstance2 == NULL) {
-            EPICSLIB_func_errlogPrintf("RFCFW_API_createModule: Failed to create the data structure for the firmware SIS8300:EICSYS:IQFB for %s\n", moduleName);
-            return -1;
-        } else {
-            ptr_dataInstance -> fwModule = (void *)ptr_fwDataInstance2;
-        }
-   
+    if(ptr_dataInstance -> fwModule == NULL) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_createModule: Failed to create the data structure for the firmware %s for %s\n", ptr_backend -> fwType, moduleName);
+        RFCFW_func_destroyModule(ptr_dataInstance);
+        free(ptr_dataInstance);
+        return -1;
     }
 
     /* init the system */
@@ -148,6 +155,29 @@ int RFCFW_API_createModule(const char *moduleName, const char *firmwareType)
     return 0;
 }
 
+/**
+ * Create an instance of the module with the firmware type detected from the board, and associate the board with it
+ * Input: 
+ *     moduleName      : An unique name of the module instance
+ *     boardModuleName : Name of the module of the RFControlBoard
+ * Return:
+ *     0          : Successful
+ *    -1          : Failed
+ */
+int RFCFW_API_createModuleAuto(const char *moduleName, const char *boardModuleName)
+{
+    const char *var_fwType = RFCFW_API_detectFirmware(boardModuleName);
+
+    if(var_fwType == NULL) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_createModuleAuto: Failed to detect the firmware type of the board %s for %s\n", boardModuleName ? boardModuleName : "(null)", moduleName ? moduleName : "(null)");
+        return -1;
+    }
+
+    if(RFCFW_API_createModule(moduleName, var_fwType) != 0) return -1;
+
+    return RFCFW_API_setupModule(moduleName, "RFCB_NAME", boardModuleName);
+}
+
 /**
  * Delete the module instance
  * Input: 
@@ -278,5 +308,501 @@ RFCFW_struc_moduleData *RFCFW_API_getModule(const char *moduleName)
     else return NULL;
 }
 
+/**
+ * Detect the firmware type of the board
+ * Input: 
+ *     boardModuleName : Name of the module of the RFControlBoard
+ * Return:
+ *     NULL            : No or more than one backend matches the board
+ *     firmware type   : Successful
+ */
+const char *RFCFW_API_detectFirmware(const char *boardModuleName)
+{
+    void        *var_boardHandle;
+    unsigned int var_fwName;
+    unsigned int var_fwVersion;
+
+    const RFCFW_struc_backend *ptr_backend = NULL;
 
+    /* Check the input parameters */
+    if(!boardModuleName || !boardModuleName[0]) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_detectFirmware: Illegal board module name\n");
+        return NULL;
+    }
+
+    var_boardHandle = (void *)RFCB_API_getModule(boardModuleName);
+
+    if(var_boardHandle == NULL) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_detectFirmware: Failed to find the board module of %s\n", boardModuleName);
+        return NULL;
+    }
+
+    ptr_backend = RFCFW_func_detectBackend(var_boardHandle, &var_fwName, &var_fwVersion);
+
+    if(ptr_backend == NULL) return NULL;
+
+    printf("RFCFW_API_detectFirmware: Board %s has firmware %s (name = 0x%08X, version = %u.%u.%u)\n", boardModuleName, ptr_backend -> fwType,
+           var_fwName, (var_fwVersion >> 24) & 0xFF, (var_fwVersion >> 16) & 0xFF, var_fwVersion & 0xFFFF);
+
+    return ptr_backend -> fwType;
+}
+
+/**
+ * Bring up the boards of all modules in parallel (setup SPI, read firmware info), should be called after all modules are
+ *   created and associated with the RFControlBoard modules, and before the iocInit. The call returns after all boards are
+ *   done, and the elapsed time of each board and the total time are printed
+ * Input:
+ *     threadNum   : Number of the worker threads, the boards are brought up one by one if <= 1
+ *     setupSPI    : 1 to setup the SPI of the boards with the default settings (only the backends with RFCFW_CAP_SPI_SETUP)
+ * Return:
+ *     0          : Successful
+ *    -1          : Failed for some boards
+ */
+int RFCFW_API_bringUpAll(int threadNum, int setupSPI)
+{
+    int    i;
+    int    status = 0;
+    long   var_moduleNum = 0;
+    long   var_workerNum;
+    long   var_workerDone;
+    double var_startTime_us;
+    double var_totalTime_us;
+    char   var_threadName[32];
+
+    RFCFW_struc_moduleData *ptr_moduleData = NULL;
+    RFCFW_struc_bringUpJob  var_job;
+
+    if(!RFCFW_gvar_moduleInstanceListInitalized) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_bringUpAll: No module created\n");
+        return -1;
+    }
+
+    /* collect the modules */
+    for(ptr_moduleData = (RFCFW_struc_moduleData *)EPICSLIB_func_LinkedListFindFirst(RFCFW_gvar_moduleInstanceList);
+        ptr_moduleData;
+        ptr_moduleData = (RFCFW_struc_moduleData *)EPICSLIB_func_LinkedListFindNext(ptr_moduleData -> node)) {
+        var_moduleNum ++;
+    }
+
+    if(var_moduleNum <= 0) return 0;
+
+    memset(&var_job, 0, sizeof(var_job));
+
+    var_job.modules   = (RFCFW_struc_moduleData **)calloc(var_moduleNum, sizeof(RFCFW_struc_moduleData *));
+    var_job.moduleNum = var_moduleNum;
+    var_job.setupSPI  = setupSPI;
+
+    if(!var_job.modules) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_bringUpAll: Failed to allocate the job\n");
+        return -1;
+    }
+
+    for(i = 0, ptr_moduleData = (RFCFW_struc_moduleData *)EPICSLIB_func_LinkedListFindFirst(RFCFW_gvar_moduleInstanceList);
+        ptr_moduleData && i < var_moduleNum;
+        i ++, ptr_moduleData = (RFCFW_struc_moduleData *)EPICSLIB_func_LinkedListFindNext(ptr_moduleData -> node)) {
+        ptr_moduleData -> bringUpStatus  = -1;
+        ptr_moduleData -> bringUpTime_us = 0.0;
+        var_job.modules[i] = ptr_moduleData;
+    }
+
+    /* limit the number of threads */
+    if(threadNum > var_moduleNum)                       threadNum = (int)var_moduleNum;
+    if(threadNum > RFCFW_CONST_BRING_UP_THREAD_MAX)     threadNum = RFCFW_CONST_BRING_UP_THREAD_MAX;
+
+    var_startTime_us = RFCFW_func_getTime_us();
+
+    if(threadNum <= 1) {
+
+        /* --- sequential bring-up in the caller thread --- */
+        for(i = 0; i < var_moduleNum; i ++) RFCFW_func_bringUp(var_job.modules[i], setupSPI);
+
+    } else {
+
+        /* --- parallel bring-up with the worker threads, wait until all workers finished --- */
+        var_job.mutex     = epicsMutexCreate();
+        var_job.doneEvent = epicsEventCreate(epicsEventEmpty);
+
+        if(!var_job.mutex || !var_job.doneEvent) {
+            EPICSLIB_func_errlogPrintf("RFCFW_API_bringUpAll: Failed to create the mutex or event\n");
+            if(var_job.mutex)     epicsMutexDestroy(var_job.mutex);
+            if(var_job.doneEvent) epicsEventDestroy(var_job.doneEvent);
+            free(var_job.modules);
+            return -1;
+        }
+
+        for(i = 0; i < threadNum; i ++) {
+            sprintf(var_threadName, "RFCFW_bringUp%d", i);
+
+            if(!epicsThreadCreate(var_threadName, epicsThreadPriorityMedium, epicsThreadGetStackSize(epicsThreadStackMedium), RFCFW_func_bringUpWorker, (void *)&var_job)) {
+                EPICSLIB_func_errlogPrintf("RFCFW_API_bringUpAll: Failed to create the worker thread %d\n", i);
+                break;
+            }
+        }
+
+        /* if no worker is created, do the job in the caller thread */
+        var_workerNum = i;
+
+        if(var_workerNum == 0) {
+            RFCFW_func_bringUpWorker((void *)&var_job);
+            var_workerNum = 1;
+        }
+
+        /* join the workers */
+        for(;;) {
+            epicsMutexLock(var_job.mutex);
+            var_workerDone = var_job.workerDone;
+            epicsMutexUnlock(var_job.mutex);
+
+            if(var_workerDone >= var_workerNum) break;
+            epicsEventWait(var_job.doneEvent);
+        }
+
+        threadNum = (int)var_workerNum;
+
+        epicsMutexDestroy(var_job.mutex);
+        epicsEventDestroy(var_job.doneEvent);
+    }
+
+    var_totalTime_us = RFCFW_func_getTime_us() - var_startTime_us;
+
+    /* report */
+    for(i = 0; i < var_moduleNum; i ++) {
+        printf("RFCFW_API_bringUpAll: %-32s %s %10.1f ms\n", var_job.modules[i] -> moduleName, 
+               var_job.modules[i] -> bringUpStatus == 0 ? "OK    " : "FAILED", var_job.modules[i] -> bringUpTime_us / 1000.0);
+
+        if(var_job.modules[i] -> bringUpStatus != 0) status = -1;
+    }
+
+    printf("RFCFW_API_bringUpAll: %ld modules with %d threads, total %.1f ms\n", var_moduleNum, threadNum > 1 ? threadNum : 1, var_totalTime_us / 1000.0);
+
+    free(var_job.modules);
+
+    return status;
+}
+
+/**
+ * Save the settings of the module to a binary file
+ * Input:
+ *     moduleName  : Name of the module instance
+ *     fileName    : Name of the file
+ * Return:
+ *     0          : Successful
+ *    -1          : Failed
+ */
+int RFCFW_API_saveConfig(const char *moduleName, const char *fileName)
+{
+    RFCFW_struc_moduleData *ptr_dataInstance = RFCFW_API_getModule(moduleName);
+
+    if(ptr_dataInstance == NULL) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_saveConfig: Failed to find the module\n");
+        return -1;
+    }
+
+    if(RFCFW_func_saveConfig(ptr_dataInstance, fileName) != 0) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_saveConfig: Failed to save the settings of %s\n", moduleName);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Restore the settings of the module from a binary file and program the board in one pass. Can be called before iocInit
+ *   (after the board is associated) to replace the restore of the PVs one by one
+ * Input:
+ *     moduleName  : Name of the module instance
+ *     fileName    : Name of the file
+ * Return:
+ *     0          : Successful
+ *    -1          : Failed
+ */
+int RFCFW_API_restoreConfig(const char *moduleName, const char *fileName)
+{
+    double var_startTime_us;
+    RFCFW_struc_moduleData *ptr_dataInstance = RFCFW_API_getModule(moduleName);
+
+    if(ptr_dataInstance == NULL) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_restoreConfig: Failed to find the module\n");
+        return -1;
+    }
+
+    var_startTime_us = RFCFW_func_getTime_us();
+
+    if(RFCFW_func_restoreConfig(ptr_dataInstance, fileName) != 0) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_restoreConfig: Failed to restore the settings of %s\n", moduleName);
+        return -1;
+    }
+
+    printf("RFCFW_API_restoreConfig: %s restored from %s in %.1f ms\n", moduleName, fileName, (RFCFW_func_getTime_us() - var_startTime_us) / 1000.0);
+
+    return 0;
+}
+
+/**
+ * Enable or disable the fast path of the register access of the module (memory mapped registers). The register space
+ *   is mapped at the first enabling, if the mapping is not possible, the driver calls are used as before
+ * Input:
+ *     moduleName : Name of the module instance, the board should have been associated
+ *     enable     : 1 to enable, 0 to disable
+ * Return:
+ *     0          : Successful
+ *    -1          : Failed
+ */
+int RFCFW_API_mapRegisters(const char *moduleName, int enable)
+{
+    void        *var_boardHandle;
+    unsigned int var_bytesPerAddr;
+    RFCFW_struc_moduleData *ptr_dataInstance = RFCFW_API_getModule(moduleName);
+
+    if(ptr_dataInstance == NULL || ptr_dataInstance -> backend == NULL) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_mapRegisters: Failed to find the module\n");
+        return -1;
+    }
+
+    var_boardHandle = (void *)RFCB_API_getModule(ptr_dataInstance -> boardModuleName);
+
+    if(var_boardHandle == NULL) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_mapRegisters: No board is associated with %s\n", moduleName);
+        return -1;
+    }
+
+    if(!enable) return RFCFW_func_regWindowEnable(var_boardHandle, ptr_dataInstance -> backend -> regDevice, 0);
+
+    /* word addressed register space (stride 1) has 4 bytes per address */
+    var_bytesPerAddr = (ptr_dataInstance -> backend -> regStride > 0 && ptr_dataInstance -> backend -> regStride < 4) ? 4 / ptr_dataInstance -> backend -> regStride : 1;
+
+    if(RFCFW_func_regWindowOpen(var_boardHandle, ptr_dataInstance -> backend -> regDevice, RFCFW_CONST_REG_WINDOW_SIZE, var_bytesPerAddr, ptr_dataInstance -> backend -> regMap.fwName) != 0) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_mapRegisters: Failed to map the registers of %s, use the driver calls\n", moduleName);
+        return -1;
+    }
+
+    printf("RFCFW_API_mapRegisters: Registers of %s are memory mapped\n", moduleName);
+
+    return 0;
+}
+
+/**
+ * Measure the register access time of the module with the driver calls and with the mapping. The reading is measured
+ *   with the firmware name register. The writing is measured only if a scratch register is given (its value is written
+ *   back), the address maps of the backends do not have a register safe to write
+ * Input:
+ *     moduleName : Name of the module instance, the board should have been associated
+ *     loops      : Number of accesses to average
+ *     scratchAddr: Address of a register without side effect of writing on the device of the backend, <0 to skip the
+ *                  writing
+ * Return:
+ *     0          : Successful
+ *    -1          : Failed
+ */
+int RFCFW_API_benchRegAccess(const char *moduleName, long loops, long scratchAddr)
+{
+    void  *var_boardHandle;
+    double var_apiRead_ns, var_apiWrite_ns, var_mapRead_ns, var_mapWrite_ns;
+    RFCFW_struc_moduleData *ptr_dataInstance = RFCFW_API_getModule(moduleName);
+
+    if(ptr_dataInstance == NULL || ptr_dataInstance -> backend == NULL) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_benchRegAccess: Failed to find the module\n");
+        return -1;
+    }
+
+    var_boardHandle = (void *)RFCB_API_getModule(ptr_dataInstance -> boardModuleName);
+
+    if(var_boardHandle == NULL) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_benchRegAccess: No board is associated with %s\n", moduleName);
+        return -1;
+    }
+
+    if(loops <= 0) loops = 10000;
+
+    if(RFCFW_func_regBenchmark(var_boardHandle, ptr_dataInstance -> backend -> regDevice, ptr_dataInstance -> backend -> regMap.fwName, scratchAddr, loops,
+                               &var_apiRead_ns, &var_apiWrite_ns, &var_mapRead_ns, &var_mapWrite_ns) != 0) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_benchRegAccess: Failed to measure the register access of %s\n", moduleName);
+        return -1;
+    }
+
+    printf("RFCFW_API_benchRegAccess: %s, %ld accesses\n", moduleName, loops);
+    printf("    driver call : read %10.1f ns", var_apiRead_ns);
+
+    if(var_apiWrite_ns < 0) printf(", write not measured (no scratch register given)\n");
+    else                    printf(", write %10.1f ns\n", var_apiWrite_ns);
+
+    if(var_mapRead_ns < 0)       printf("    mapping     : not mapped (see RFCFW_mapRegisters)\n");
+    else if(var_mapWrite_ns < 0) printf("    mapping     : read %10.1f ns\n", var_mapRead_ns);
+    else                         printf("    mapping     : read %10.1f ns, write %10.1f ns\n", var_mapRead_ns, var_mapWrite_ns);
+
+    return 0;
+}
+
+/**
+ * Measure the time to get the internal waveforms from the DAQ buffer, with the separated passes of each channel and the
+ *   single pass of all channels, for each registered backend implementing the benchmark. No board is needed
+ * Input:
+ *     loops      : Number of pulses to average
+ * Return:
+ *     0          : Successful
+ *    -1          : Failed
+ */
+int RFCFW_API_benchDeinterleave(long loops)
+{
+    int    status;
+    int    var_ret   = 0;
+    long   var_found = 0;
+    long   i;
+    double var_sepTime_us, var_fusedTime_us;
+    const RFCFW_struc_backend *ptr_backend;
+
+    if(loops <= 0) loops = 10000;
+
+    for(i = 0; (ptr_backend = RFCFW_func_getBackend(i)) != NULL; i ++) {
+        if(!ptr_backend -> fwFunc.FWC_func_benchDeinterleave) continue;
+
+        var_found ++;
+        status = ptr_backend -> fwFunc.FWC_func_benchDeinterleave(loops, &var_sepTime_us, &var_fusedTime_us);
+
+        if(status == -1) {
+            EPICSLIB_func_errlogPrintf("RFCFW_API_benchDeinterleave: Failed to measure the time of %s\n", ptr_backend -> fwType);
+            var_ret = -1;
+            continue;
+        }
+
+        printf("RFCFW_API_benchDeinterleave: %s, %ld pulses\n", ptr_backend -> fwType, loops);
+        printf("    separated passes : %10.3f us\n", var_sepTime_us);
+        printf("    single pass      : %10.3f us\n", var_fusedTime_us);
+
+        if(status == -2) {
+            printf("    results are different!\n");
+            var_ret = -1;
+        }
+    }
+
+    if(!var_found) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_benchDeinterleave: No backend supports the benchmark\n");
+        return -1;
+    }
+
+    return var_ret;
+}
+
+/**
+ * Get the module supporting the burst capture (the backend implements the virtual functions of the burst)
+ */
+static RFCFW_struc_moduleData *RFCFW_func_getBurstModule(const char *moduleName, const char *funcName)
+{
+    RFCFW_struc_moduleData *ptr_dataInstance = RFCFW_API_getModule(moduleName);
+
+    if(ptr_dataInstance == NULL || ptr_dataInstance -> backend == NULL || ptr_dataInstance -> fwModule == NULL) {
+        EPICSLIB_func_errlogPrintf("%s: Failed to find the module\n", funcName);
+        return NULL;
+    }
+
+    if(!ptr_dataInstance -> fwFunc.FWC_func_burstStart || !ptr_dataInstance -> fwFunc.FWC_func_burstDump) {
+        EPICSLIB_func_errlogPrintf("%s: The burst capture is not supported by %s (%s)\n", funcName, moduleName, ptr_dataInstance -> backend -> fwType);
+        return NULL;
+    }
+
+    return ptr_dataInstance;
+}
+
+/**
+ * Start a burst capture of the ADC data, the pulses are captured in the board memory without readout and read back in
+ *   bulk after the last pulse. The point number of each pulse is the current ADC sample point number
+ * Input:
+ *     moduleName : Name of the module instance
+ *     num        : Number of pulses, abort the burst in progress if <= 0
+ * Return:
+ *     0          : Successful
+ *    -1          : Failed
+ */
+int RFCFW_API_burstStart(const char *moduleName, long num)
+{
+    RFCFW_struc_moduleData *ptr_dataInstance = RFCFW_func_getBurstModule(moduleName, "RFCFW_API_burstStart");
+
+    if(ptr_dataInstance == NULL) return -1;
+
+    return ptr_dataInstance -> fwFunc.FWC_func_burstStart(ptr_dataInstance -> fwModule, num);
+}
+
+/**
+ * Print the frames of the latest burst
+ * Input:
+ *     moduleName : Name of the module instance
+ *     fileName   : File to write, print to the console if empty
+ * Return:
+ *     0          : Successful
+ *    -1          : Failed
+ */
+int RFCFW_API_burstDump(const char *moduleName, const char *fileName)
+{
+    RFCFW_struc_moduleData *ptr_dataInstance = RFCFW_func_getBurstModule(moduleName, "RFCFW_API_burstDump");
+
+    if(ptr_dataInstance == NULL) return -1;
+
+    return ptr_dataInstance -> fwFunc.FWC_func_burstDump(ptr_dataInstance -> fwModule, fileName);
+}
+
+/**
+ * Enable or disable the profiling of the virtual functions of the module (only if compiled with RFCFW_ENABLE_PROFILING)
+ * Input:
+ *     moduleName : Name of the module instance
+ *     enable     : 1 to enable, 0 to disable
+ * Return:
+ *     0          : Successful
+ *    -1          : Failed
+ */
+int RFCFW_API_profileEnable(const char *moduleName, int enable)
+{
+#ifdef RFCFW_ENABLE_PROFILING
+    RFCFW_struc_moduleData *ptr_dataInstance = RFCFW_API_getModule(moduleName);
+
+    if(ptr_dataInstance == NULL) {
+        EPICSLIB_func_errlogPrintf("RFCFW_API_profileEnable: Failed to find the module\n");
+        return -1;
+    }
+
+    ptr_dataInstance -> prof.enable = enable ? 1 : 0;
+
+    return 0;
+#else
+    EPICSLIB_func_errlogPrintf("RFCFW_API_profileEnable: The profiling is not compiled (define RFCFW_ENABLE_PROFILING)\n");
+    return -1;
+#endif
+}
+
+/**
+ * Print the profiles of the virtual functions (only if compiled with RFCFW_ENABLE_PROFILING)
+ * Input:
+ *     moduleName : Name of the module instance, all modules if NULL or empty
+ * Return:
+ *     0          : Successful
+ *    -1          : Failed
+ */
+int RFCFW_API_profileReport(const char *moduleName)
+{
+#ifdef RFCFW_ENABLE_PROFILING
+    RFCFW_struc_moduleData *ptr_dataInstance;
+
+    if(moduleName && moduleName[0]) {
+        ptr_dataInstance = RFCFW_API_getModule(moduleName);
+
+        if(ptr_dataInstance == NULL) {
+            EPICSLIB_func_errlogPrintf("RFCFW_API_profileReport: Failed to find the module\n");
+            return -1;
+        }
+
+        RFCFW_func_profReport(&ptr_dataInstance -> prof, ptr_dataInstance -> moduleName);
+        return 0;
+    }
+
+    for(ptr_dataInstance = (RFCFW_struc_moduleData *)EPICSLIB_func_LinkedListFindFirst(RFCFW_gvar_moduleInstanceList);
+        ptr_dataInstance;
+        ptr_dataInstance = (RFCFW_struc_moduleData *)EPICSLIB_func_LinkedListFindNext(ptr_dataInstance -> node)) {
+        RFCFW_func_profReport(&ptr_dataInstance -> prof, ptr_dataInstance -> moduleName);
+    }
+
+    return 0;
+#else
+    EPICSLIB_func_errlogPrintf("RFCFW_API_profileReport: The profiling is not compiled (define RFCFW_ENABLE_PROFILING)\n");
+    return -1;
+#endif
+}
 
@@ -21,13 +21,42 @@ extern "C" {
  */
 /* Management of the modules (NOT REAL-TIME) */
 int RFCFW_API_createModule(const char *moduleName, const char *firmwareType);            
+int RFCFW_API_createModuleAuto(const char *moduleName, const char *boardModuleName);     /* detect the firmware type from the board, create the module and associate the board */
 int RFCFW_API_deleteModule(const char *moduleName);
 int RFCFW_API_setupModule(const char *moduleName, const char *cmd, const char *dataStr);
 
 RFCFW_struc_moduleData *RFCFW_API_getModule(const char *moduleName);
 
+/* Backends of the firmware (NOT REAL-TIME, call before creating the modules) */
+const char *RFCFW_API_detectFirmware(const char *boardModuleName);                      /* firmware type of the backend matching the board, NULL if not detected */
+
+#define RFCFW_API_registerBackend   RFCFW_func_registerBackend                          /* register the backend of other libraries */
+#define RFCFW_API_setBackendFwId    RFCFW_func_setBackendFwId
+#define RFCFW_API_printBackends     RFCFW_func_printBackends
+
+int RFCFW_API_bringUpAll(int threadNum, int setupSPI);                                  /* bring up the boards of all modules in parallel, call before iocInit */
+
+int RFCFW_API_saveConfig(const char *moduleName, const char *fileName);                 /* save the settings to a binary file */
+int RFCFW_API_restoreConfig(const char *moduleName, const char *fileName);              /* restore the settings from a binary file and program the board */
+
+int RFCFW_API_mapRegisters(const char *moduleName, int enable);                         /* enable/disable the memory mapped register access */
+int RFCFW_API_benchRegAccess(const char *moduleName, long loops, long scratchAddr);     /* measure the register access time with driver calls and mapping */
+int RFCFW_API_benchDeinterleave(long loops);                                            /* measure the time to get the internal waveforms from the DAQ buffer */
+
+int RFCFW_API_burstStart(const char *moduleName, long num);                             /* capture num pulses of ADC data in the board memory, abort if num <= 0 */
+int RFCFW_API_burstDump(const char *moduleName, const char *fileName);                  /* print the frames of the latest burst */
+
+int RFCFW_API_profileEnable(const char *moduleName, int enable);                        /* enable/disable the profiling of the virtual functions */
+int RFCFW_API_profileReport(const char *moduleName);                                    /* print the profiles, all modules if moduleName is empty */
+
+#define RFCFW_API_regTraceArm       RFCFW_func_regTraceArm                              /* start the trace of the register accesses */
+#define RFCFW_API_regTraceFreeze    RFCFW_func_regTraceFreeze                           /* stop the trace, keep it for the dump */
+#define RFCFW_API_regTraceDump      RFCFW_func_regTraceDump                             /* print the trace and the counters per function */
+
 /* wrappers for the virtual functions */
 #define RFCFW_API_getDAQData      RFCFW_func_getDAQData
+#define RFCFW_API_getDAQDataAsync RFCFW_func_getDAQDataAsync
+#define RFCFW_API_waitDAQData     RFCFW_func_waitDAQData
 #define RFCFW_API_getADCData      RFCFW_func_getADCData
 #define RFCFW_API_getIntData      RFCFW_func_getIntData
 
@@ -0,0 +1,369 @@
+/****************************************************
+ * RFControlFirmware_backend.c
+ *
+ * Descriptors and registry of the firmware backends
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "EPICSLib_wrapper.h"
+#include "RFControlBoard_availableInterface.h"
+
+#include "RFControlFirmware_backend.h"
+
+/*======================================
+ * Descriptors of the backends
+ *======================================*/
+/* sis8300 board, struck platform fw, i/q feedback app fw */
+static const RFCFW_struc_backend RFCFW_gvar_backendSis8300StruckIqfb = {
+    "SIS8300:STRUCK:IQFB",
+    "SIS8300 board with Struck platform firmware and I/Q feedback application firmware",
+
+    FWC_SIS8300_STRUCK_IQFB_CONST_REG_DEVICE,
+    CON_SIS8300_STRUCK_IQFB_REG_ADDR_START,
+    FWC_SIS8300_STRUCK_IQFB_CONST_REG_STRIDE,
+    {
+        CON_SIS8300_STRUCK_IQFB_REG_ADDR_FRIMWARE_NAME,
+        CON_SIS8300_STRUCK_IQFB_REG_ADDR_FIRMWARE_VERSION,
+        CON_SIS8300_STRUCK_IQFB_REG_ADDR_SWITCH_CTRL,
+        CON_SIS8300_STRUCK_IQFB_REG_ADDR_PUL_CNT,
+        CON_SIS8300_STRUCK_IQFB_REG_ADDR_IRQ_DELAY_CNT
+    },
+
+    RFCFW_CAP_SPI_SETUP | RFCFW_CAP_DIGITAL_OUT | RFCFW_CAP_ADC_CAPTURE | RFCFW_CAP_BURST_CAPTURE,
+    FWC_SIS8300_STRUCK_IQFB_CONST_FW_NAME_ID,
+    FWC_SIS8300_STRUCK_IQFB_CONST_FW_NAME_MASK,
+    0, 0,                                                   /* any firmware version */
+    RFCB_DEV_SYS,
+    FWC_SIS8300_STRUCK_IQFB_CONST_PLATFORM_REG,
+    FWC_SIS8300_STRUCK_IQFB_CONST_PLATFORM_ID,
+    FWC_SIS8300_STRUCK_IQFB_CONST_PLATFORM_MASK,
+
+    sizeof(FWC_sis8300_struck_iqfb_struc_data),
+    {
+        FWC_sis8300_struck_iqfb_func_init,
+        FWC_sis8300_struck_iqfb_func_deinit,
+
+        FWC_sis8300_struck_iqfb_func_createEpicsData,
+        FWC_sis8300_struck_iqfb_func_deleteEpicsData,
+
+        FWC_sis8300_struck_iqfb_func_getBoard,
+
+        FWC_sis8300_struck_iqfb_func_getDAQData,
+        FWC_sis8300_struck_iqfb_func_getADCData,
+        FWC_sis8300_struck_iqfb_func_getIntData,
+
+        FWC_sis8300_struck_iqfb_func_setPha_deg,
+        FWC_sis8300_struck_iqfb_func_setAmp,
+
+        FWC_sis8300_struck_iqfb_func_waitIntr,
+        FWC_sis8300_struck_iqfb_func_meaIntrLatency,
+
+        FWC_sis8300_struck_iqfb_func_bringUp,
+
+        FWC_sis8300_struck_iqfb_func_saveConfig,
+        FWC_sis8300_struck_iqfb_func_restoreConfig,
+
+        FWC_sis8300_struck_iqfb_func_burstStart,
+        FWC_sis8300_struck_iqfb_func_burstDump,
+
+        FWC_sis8300_struck_iqfb_func_setLock,
+
+        FWC_sis8300_struck_iqfb_func_benchDeinterleave
+    }
+};
+
+/* sis8300 board, eicsys platform fw, i/q feedback app fw */
+static const RFCFW_struc_backend RFCFW_gvar_backendSis8300EicsysIqfb = {
+    "SIS8300:EICSYS:IQFB",
+    "SIS8300 board with EICSYS platform firmware and I/Q feedback application firmware",
+
+    FWC_SIS8300_EICSYS_IQFB_CONST_REG_DEVICE,
+    CON_SIS8300_EICSYS_IQFB_REG_ADDR_START,
+    FWC_SIS8300_EICSYS_IQFB_CONST_REG_STRIDE,
+    {
+        CON_SIS8300_EICSYS_IQFB_REG_ADDR_FRIMWARE_NAME,
+        CON_SIS8300_EICSYS_IQFB_REG_ADDR_FIRMWARE_VERSION,
+        CON_SIS8300_EICSYS_IQFB_REG_ADDR_SWITCH_CTRL,
+        CON_SIS8300_EICSYS_IQFB_REG_ADDR_PUL_CNT,
+        CON_SIS8300_EICSYS_IQFB_REG_ADDR_IRQ_DELAY_CNT
+    },
+
+    RFCFW_CAP_DAQ_WINDOW,
+    FWC_SIS8300_EICSYS_IQFB_CONST_FW_NAME_ID,
+    FWC_SIS8300_EICSYS_IQFB_CONST_FW_NAME_MASK,
+    0, 0,                                                   /* any firmware version */
+    RFCB_DEV_SYS, 0, 0, 0,                                  /* no identifier of the platform firmware */
+
+    sizeof(FWC_sis8300_eicsys_iqfb_struc_data),
+    {
+        FWC_sis8300_eicsys_iqfb_func_init,
+        FWC_sis8300_eicsys_iqfb_func_deinit,
+
+        FWC_sis8300_eicsys_iqfb_func_createEpicsData,
+        FWC_sis8300_eicsys_iqfb_func_deleteEpicsData,
+
+        FWC_sis8300_eicsys_iqfb_func_getBoard,
+
+        FWC_sis8300_eicsys_iqfb_func_getDAQData,
+        FWC_sis8300_eicsys_iqfb_func_getADCData,
+        FWC_sis8300_eicsys_iqfb_func_getIntData,
+
+        FWC_sis8300_eicsys_iqfb_func_setPha_deg,
+        FWC_sis8300_eicsys_iqfb_func_setAmp,
+
+        FWC_sis8300_eicsys_iqfb_func_waitIntr,
+        FWC_sis8300_eicsys_iqfb_func_meaIntrLatency,
+
+        FWC_sis8300_eicsys_iqfb_func_bringUp,
+
+        FWC_sis8300_eicsys_iqfb_func_saveConfig,
+        FWC_sis8300_eicsys_iqfb_func_restoreConfig,
+
+        NULL,                                               /* no burst capture */
+        NULL,
+
+        FWC_sis8300_eicsys_iqfb_func_setLock,
+
+        NULL                                                /* no benchmark of the deinterleave */
+    }
+};
+
+/*======================================
+ * Registry of the backends
+ *======================================*/
+/* The backends are copied into the registry, the built-in ones are registered at the first access. The registry is
+ *   modified only at the IOC start (before the modules are created), so no lock is used */
+static RFCFW_struc_backend RFCFW_gvar_backendList[RFCFW_CONST_BACKEND_MAX];
+static long RFCFW_gvar_backendNum          = 0;
+static int  RFCFW_gvar_backendInitialized  = 0;
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * Register the built-in backends
+ */
+static void RFCFW_func_initBackends(void)
+{
+    if(RFCFW_gvar_backendInitialized) return;
+
+    RFCFW_gvar_backendInitialized = 1;
+
+    RFCFW_func_registerBackend(&RFCFW_gvar_backendSis8300StruckIqfb);
+    RFCFW_func_registerBackend(&RFCFW_gvar_backendSis8300EicsysIqfb);
+}
+
+/**
+ * Check if the firmware name and version read from the board match the backend
+ * Return:
+ *   0          : Not matched
+ *   1          : Matched, the backend accepts any valid firmware name and has no platform identifier
+ *   2          : Matched by the firmware name or the platform identifier
+ */
+static int RFCFW_func_matchBackend(void *boardHandle, const RFCFW_struc_backend *backend, unsigned int fwName, unsigned int fwVersion)
+{
+    unsigned int var_platformId;
+
+    /* nothing is there (registers not implemented or device not mapped) */
+    if(fwName == 0 || fwName == 0xFFFFFFFF) return 0;
+
+    if((fwName & backend -> fwNameMask) != backend -> fwNameId) return 0;
+
+    if(fwVersion < backend -> fwVersionMin) return 0;
+    if(backend -> fwVersionMax && fwVersion > backend -> fwVersionMax) return 0;
+
+    if(backend -> platformMask) {
+        if(RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, backend -> platformReg, &var_platformId, backend -> platformDevice) != 0) return 0;
+        if((var_platformId & backend -> platformMask) != backend -> platformId) return 0;
+    }
+
+    return (backend -> fwNameMask || backend -> platformMask) ? 2 : 1;
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Register a backend, the descriptor is copied into the registry (the strings are not copied and should be kept valid)
+ * Input:
+ *   backend    : Descriptor of the backend
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed
+ */
+int RFCFW_func_registerBackend(const RFCFW_struc_backend *backend)
+{
+    RFCFW_func_initBackends();
+
+    if(!backend || !backend -> fwType || !backend -> fwType[0] || backend -> dataSize == 0 || !backend -> fwFunc.FWC_func_init) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_registerBackend: Illegal descriptor of the backend\n");
+        return -1;
+    }
+
+    if(RFCFW_func_findBackend(backend -> fwType)) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_registerBackend: Backend %s has been registered\n", backend -> fwType);
+        return -1;
+    }
+
+    if(RFCFW_gvar_backendNum >= RFCFW_CONST_BACKEND_MAX) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_registerBackend: No space for backend %s\n", backend -> fwType);
+        return -1;
+    }
+
+    RFCFW_gvar_backendList[RFCFW_gvar_backendNum] = *backend;
+    RFCFW_gvar_backendList[RFCFW_gvar_backendNum].fwNameId &= backend -> fwNameMask;
+    RFCFW_gvar_backendList[RFCFW_gvar_backendNum].platformId &= backend -> platformMask;
+    RFCFW_gvar_backendNum ++;
+
+    return 0;
+}
+
+/**
+ * Set the expected firmware name of a backend for the detection
+ * Input:
+ *   fwType     : Firmware type of the backend
+ *   fwNameId   : Expected value of the firmware name register (after masking)
+ *   fwNameMask : Mask applied to the firmware name register, 0 to accept any valid value
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed
+ */
+int RFCFW_func_setBackendFwId(const char *fwType, unsigned int fwNameId, unsigned int fwNameMask)
+{
+    RFCFW_struc_backend *ptr_backend = (RFCFW_struc_backend *)RFCFW_func_findBackend(fwType);
+
+    if(!ptr_backend) return -1;
+
+    ptr_backend -> fwNameId   = fwNameId & fwNameMask;
+    ptr_backend -> fwNameMask = fwNameMask;
+
+    return 0;
+}
+
+/**
+ * Find the backend for the firmware type
+ * Input:
+ *   fwType     : Firmware type, e.g. "SIS8300:STRUCK:IQFB"
+ * Return:
+ *   Descriptor of the backend, NULL if the firmware type is not supported
+ */
+const RFCFW_struc_backend *RFCFW_func_findBackend(const char *fwType)
+{
+    long i;
+
+    RFCFW_func_initBackends();
+
+    if(!fwType || !fwType[0]) return NULL;
+
+    for(i = 0; i < RFCFW_gvar_backendNum; i ++) {
+        if(strcmp(RFCFW_gvar_backendList[i].fwType, fwType) == 0)
+            return &RFCFW_gvar_backendList[i];
+    }
+
+    return NULL;
+}
+
+/**
+ * Get the backend by index, can be used to go through all supported backends
+ * Input:
+ *   id         : Index of the backend, starts from 0
+ * Return:
+ *   Descriptor of the backend, NULL if out of range
+ */
+const RFCFW_struc_backend *RFCFW_func_getBackend(long id)
+{
+    RFCFW_func_initBackends();
+
+    if(id < 0 || id >= RFCFW_gvar_backendNum) return NULL;
+
+    return &RFCFW_gvar_backendList[id];
+}
+
+/**
+ * Detect the backend from the board. Each backend is probed with its own device and addresses of the firmware name
+ *   and version registers (and the platform identifier if known). The backends matching by the identifiers are
+ *   preferred to the ones accepting any valid firmware name, the detection is successful only if exactly one backend
+ *   matches at the best level
+ * Input:
+ *   boardHandle    : Handle of the RFControlBoard module
+ * Output:
+ *   fwName         : Firmware name read by the matched backend (can be NULL)
+ *   fwVersion      : Firmware version read by the matched backend (can be NULL)
+ * Return:
+ *   Descriptor of the backend, NULL if no or more than one backend matches
+ */
+const RFCFW_struc_backend *RFCFW_func_detectBackend(void *boardHandle, unsigned int *fwName, unsigned int *fwVersion)
+{
+    long i;
+    int  var_level;
+    int  var_bestLevel = 0;
+    long var_matchNum  = 0;
+    unsigned int var_name;
+    unsigned int var_version;
+    int  var_matchLevel[RFCFW_CONST_BACKEND_MAX];
+
+    const RFCFW_struc_backend *ptr_backend = NULL;
+
+    RFCFW_func_initBackends();
+
+    if(!boardHandle) return NULL;
+
+    for(i = 0; i < RFCFW_gvar_backendNum; i ++) {
+        var_matchLevel[i] = 0;
+
+        if(RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, RFCFW_gvar_backendList[i].regMap.fwName,    &var_name,    RFCFW_gvar_backendList[i].regDevice) != 0) continue;
+        if(RFCB_API_readRegister((RFCB_struc_moduleData *)boardHandle, RFCFW_gvar_backendList[i].regMap.fwVersion, &var_version, RFCFW_gvar_backendList[i].regDevice) != 0) continue;
+
+        var_level         = RFCFW_func_matchBackend(boardHandle, &RFCFW_gvar_backendList[i], var_name, var_version);
+        var_matchLevel[i] = var_level;
+
+        if(var_level == 0 || var_level < var_bestLevel) continue;
+
+        if(var_level > var_bestLevel) {
+            var_bestLevel = var_level;
+            var_matchNum  = 0;
+        }
+
+        var_matchNum ++;
+        ptr_backend = &RFCFW_gvar_backendList[i];
+
+        if(fwName)    *fwName    = var_name;
+        if(fwVersion) *fwVersion = var_version;
+    }
+
+    if(var_matchNum > 1) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_detectBackend: %ld backends match the board, set the firmware name with RFCFW_setBackendFwId or give the firmware type\n", var_matchNum);
+
+        for(i = 0; i < RFCFW_gvar_backendNum; i ++) {
+            if(var_matchLevel[i] == var_bestLevel)
+                EPICSLIB_func_errlogPrintf("RFCFW_func_detectBackend:   %s\n", RFCFW_gvar_backendList[i].fwType);
+        }
+
+        return NULL;
+    }
+
+    return ptr_backend;
+}
+
+/**
+ * Print the registered backends
+ */
+void RFCFW_func_printBackends(void)
+{
+    long i;
+
+    RFCFW_func_initBackends();
+
+    for(i = 0; i < RFCFW_gvar_backendNum; i ++) {
+        printf("%-24s : %s\n", RFCFW_gvar_backendList[i].fwType, RFCFW_gvar_backendList[i].description ? RFCFW_gvar_backendList[i].description : "");
+        printf("%-24s   device = %d, start = 0x%X, stride = %u, caps = 0x%04X, name id = 0x%08X (mask 0x%08X)\n", "",
+               RFCFW_gvar_backendList[i].regDevice, RFCFW_gvar_backendList[i].regStart, RFCFW_gvar_backendList[i].regStride,
+               RFCFW_gvar_backendList[i].caps, RFCFW_gvar_backendList[i].fwNameId, RFCFW_gvar_backendList[i].fwNameMask);
+        printf("%-24s   platform id = 0x%08X (mask 0x%08X, device %d, address 0x%X)\n", "",
+               RFCFW_gvar_backendList[i].platformId, RFCFW_gvar_backendList[i].platformMask,
+               RFCFW_gvar_backendList[i].platformDevice, RFCFW_gvar_backendList[i].platformReg);
+    }
+}
+
@@ -0,0 +1,94 @@
+/****************************************************
+ * RFControlFirmware_backend.h
+ *
+ * Descriptors of the firmware backends. A backend is described by a const descriptor holding the firmware type string,
+ *   the device and the address stride of the registers, the addresses of the common registers, the capabilities and the
+ *   virtual functions. The descriptors are collected in a registry, the module is created by looking up the firmware
+ *   type in the registry, so that a new firmware variant is supported by adding a descriptor instead of new code paths
+ *
+ * Other libraries can register their own backends with RFCFW_API_registerBackend before the modules are created. The
+ *   backend can also be detected from the board, each registered backend is probed by reading its firmware name and
+ *   version registers with its own device and register layout (and the identifier of the platform firmware if known). A
+ *   backend matching by the identifiers is preferred to the ones accepting any valid firmware name, the detection fails
+ *   if more than one backend match at the same level
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_BACKEND_H
+#define RF_CONTROL_FIRMWARE_BACKEND_H
+
+#include <stddef.h>
+
+#include "RFControlFirmware_requiredInterface_fwCtrlVirtual.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Capabilities of the backend
+ */
+#define RFCFW_CAP_SPI_SETUP         0x0001                  /* the clock and ADC chips are setup by software via SPI */
+#define RFCFW_CAP_DIGITAL_OUT       0x0002                  /* Harlink and AMC LVDS digital outputs */
+#define RFCFW_CAP_DAQ_WINDOW        0x0004                  /* DAQ window (address and size) in the shared memory is configurable */
+#define RFCFW_CAP_ADC_CAPTURE       0x0008                  /* raw ADC data can be captured via the platform firmware */
+#define RFCFW_CAP_BURST_CAPTURE     0x0010                  /* consecutive pulses of raw ADC data can be captured in the board memory */
+
+/**
+ * Constants of the registry
+ */
+#define RFCFW_CONST_BACKEND_MAX     16                      /* maximum number of backends in the registry */
+
+/**
+ * Addresses of the registers common to all backends
+ */
+typedef struct {
+    unsigned int fwName;                                    /* firmware name */
+    unsigned int fwVersion;                                 /* firmware version */
+    unsigned int switchCtrl;                                /* control bits */
+    unsigned int pulseCnt;                                  /* pulse counter */
+    unsigned int irqDelayCnt;                               /* delay of the interrupt in clock cycles */
+} RFCFW_struc_regMap;
+
+/**
+ * Descriptor of a backend
+ */
+typedef struct {
+    const char   *fwType;                                   /* firmware type, e.g. "SIS8300:STRUCK:IQFB" */
+    const char   *description;
+
+    int           regDevice;                                /* device of the application registers (RFCB_DEV_SYS or RFCB_DEV_USR) */
+    unsigned int  regStart;                                 /* start address of the application registers */
+    unsigned int  regStride;                                /* address step between two neighbouring registers */
+    RFCFW_struc_regMap regMap;                              /* addresses of the common registers */
+
+    unsigned int  caps;                                     /* capabilities, RFCFW_CAP_XXX */
+
+    unsigned int  fwNameId;                                 /* detection: (firmware name & fwNameMask) should be fwNameId */
+    unsigned int  fwNameMask;                               /* detection: 0 to accept any valid firmware name */
+    unsigned int  fwVersionMin;                             /* detection: range of the firmware version register, */
+    unsigned int  fwVersionMax;                             /*   no upper limit if fwVersionMax is 0 */
+    int           platformDevice;                           /* detection: device of the identifier register of the platform firmware */
+    unsigned int  platformReg;                              /* detection: address of the identifier register of the platform firmware */
+    unsigned int  platformId;                               /* detection: (identifier & platformMask) should be platformId */
+    unsigned int  platformMask;                             /* detection: 0 if the platform firmware is not identified */
+
+    size_t        dataSize;                                 /* size of the data structure of the firmware control */
+    RFCFW_struc_fwAccessFunc fwFunc;                        /* virtual functions */
+} RFCFW_struc_backend;
+
+/**
+ * Routines
+ */
+const RFCFW_struc_backend *RFCFW_func_findBackend(const char *fwType);
+const RFCFW_struc_backend *RFCFW_func_getBackend(long id);                  /* get the backend by index, NULL if out of range */
+const RFCFW_struc_backend *RFCFW_func_detectBackend(void *boardHandle, unsigned int *fwName, unsigned int *fwVersion);
+
+int  RFCFW_func_registerBackend(const RFCFW_struc_backend *backend);
+int  RFCFW_func_setBackendFwId(const char *fwType, unsigned int fwNameId, unsigned int fwNameMask);
+void RFCFW_func_printBackends(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,350 @@
+/****************************************************
+ * RFControlFirmware_config.c
+ *
+ * Snapshot of the configuration of the firmware control to a binary file and restore from it
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "EPICSLib_wrapper.h"
+#include "RFControlFirmware_config.h"
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * FNV-1a hash, used for the layout signature and the checksum
+ */
+static unsigned int RFCFW_func_configHash(unsigned int hash, const void *buf, size_t size)
+{
+    const unsigned char *ptr = (const unsigned char *)buf;
+
+    while(size --) {
+        hash ^= *ptr ++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * Get the signature and the total size of the item table
+ */
+static unsigned int RFCFW_func_configLayout(const RFCFW_struc_configItem *items, long itemNum, size_t *dataSize)
+{
+    long         i;
+    unsigned int var_size;
+    unsigned int var_sig  = 2166136261u;
+
+    *dataSize = 0;
+
+    for(i = 0; i < itemNum; i ++) {
+        var_size   = (unsigned int)items[i].size;
+        var_sig    = RFCFW_func_configHash(var_sig, items[i].name, strlen(items[i].name));
+        var_sig    = RFCFW_func_configHash(var_sig, &var_size, sizeof(var_size));
+        *dataSize += items[i].size;
+    }
+
+    return var_sig;
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Save the configuration items of the data structure to a file
+ * Input:
+ *   fileName   : Name of the file
+ *   fwType     : Firmware type, saved in the header and checked when loading
+ *   data       : Data structure of the firmware control
+ *   items      : Table of the items to save
+ *   itemNum    : Number of items
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed
+ */
+int RFCFW_func_configSave(const char *fileName, const char *fwType, const void *data, const RFCFW_struc_configItem *items, long itemNum)
+{
+    long   i;
+    size_t var_dataSize;
+    size_t var_pos = 0;
+    char  *var_buf;
+    FILE  *var_file;
+
+    RFCFW_struc_configHeader var_header;
+
+    if(!fileName || !fileName[0] || !fwType || !data || !items || itemNum <= 0) return -1;
+
+    /* collect all items into one buffer, so that the file is written with one call */
+    memset(&var_header, 0, sizeof(var_header));
+
+    var_header.magic     = RFCFW_CONST_CONFIG_MAGIC;
+    var_header.version   = RFCFW_CONST_CONFIG_VERSION;
+    var_header.itemNum   = (unsigned int)itemNum;
+    var_header.layoutSig = RFCFW_func_configLayout(items, itemNum, &var_dataSize);
+    var_header.dataSize  = (unsigned int)var_dataSize;
+    strncpy(var_header.fwType, fwType, RFCFW_CONST_CONFIG_TYPE_LEN - 1);
+
+    var_buf = (char *)malloc(var_dataSize);
+
+    if(!var_buf) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_configSave: Failed to allocate the buffer\n");
+        return -1;
+    }
+
+    for(i = 0; i < itemNum; i ++) {
+        memcpy(var_buf + var_pos, (const char *)data + items[i].offset, items[i].size);
+        var_pos += items[i].size;
+    }
+
+    var_header.checksum  = RFCFW_func_configHash(2166136261u, var_buf, var_dataSize);
+
+    /* write the file */
+    var_file = fopen(fileName, "wb");
+
+    if(!var_file) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_configSave: Failed to open the file %s\n", fileName);
+        free(var_buf);
+        return -1;
+    }
+
+    if(fwrite(&var_header, sizeof(var_header), 1, var_file) != 1 || fwrite(var_buf, var_dataSize, 1, var_file) != 1) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_configSave: Failed to write the file %s\n", fileName);
+        fclose(var_file);
+        free(var_buf);
+        return -1;
+    }
+
+    fclose(var_file);
+    free(var_buf);
+
+    return 0;
+}
+
+/**
+ * Read the configuration items from a file to a buffer. The file is read and checked completely, so the data structure
+ *   is either fully updated by RFCFW_func_configCopy or not touched
+ * Input:
+ *   fileName   : Name of the file
+ *   fwType     : Firmware type, should be the same as saved in the file
+ *   items      : Table of the items to load, should be the same as used for saving
+ *   itemNum    : Number of items
+ * Return:
+ *   Buffer of the data (free it after use), NULL if failed
+ */
+char *RFCFW_func_configRead(const char *fileName, const char *fwType, const RFCFW_struc_configItem *items, long itemNum)
+{
+    size_t var_dataSize;
+    char  *var_buf;
+    FILE  *var_file;
+
+    RFCFW_struc_configHeader var_header;
+
+    if(!fileName || !fileName[0] || !fwType || !items || itemNum <= 0) return NULL;
+
+    /* read the header and check it */
+    var_file = fopen(fileName, "rb");
+
+    if(!var_file) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_configRead: Failed to open the file %s\n", fileName);
+        return NULL;
+    }
+
+    if(fread(&var_header, sizeof(var_header), 1, var_file) != 1) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_configRead: Failed to read the header of %s\n", fileName);
+        fclose(var_file);
+        return NULL;
+    }
+
+    var_header.fwType[RFCFW_CONST_CONFIG_TYPE_LEN - 1] = 0;
+
+    if(var_header.magic != RFCFW_CONST_CONFIG_MAGIC || var_header.version != RFCFW_CONST_CONFIG_VERSION) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_configRead: %s is not a configuration file of this version\n", fileName);
+        fclose(var_file);
+        return NULL;
+    }
+
+    if(strcmp(var_header.fwType, fwType) != 0) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_configRead: %s is saved for %s, not %s\n", fileName, var_header.fwType, fwType);
+        fclose(var_file);
+        return NULL;
+    }
+
+    if(var_header.layoutSig != RFCFW_func_configLayout(items, itemNum, &var_dataSize) ||
+       var_header.itemNum   != (unsigned int)itemNum ||
+       var_header.dataSize  != (unsigned int)var_dataSize) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_configRead: %s is saved with a different layout\n", fileName);
+        fclose(var_file);
+        return NULL;
+    }
+
+    /* read the data and check it */
+    var_buf = (char *)malloc(var_dataSize);
+
+    if(!var_buf) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_configRead: Failed to allocate the buffer\n");
+        fclose(var_file);
+        return NULL;
+    }
+
+    if(fread(var_buf, var_dataSize, 1, var_file) != 1 || var_header.checksum != RFCFW_func_configHash(2166136261u, var_buf, var_dataSize)) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_configRead: The data in %s is incomplete or corrupted\n", fileName);
+        fclose(var_file);
+        free(var_buf);
+        return NULL;
+    }
+
+    fclose(var_file);
+
+    return var_buf;
+}
+
+/**
+ * Copy the configuration items read by RFCFW_func_configRead to the data structure
+ * Input:
+ *   buf        : Buffer of the data
+ *   items      : Table of the items, the same as used for reading
+ *   itemNum    : Number of items
+ * Output:
+ *   data       : Data structure of the firmware control
+ */
+void RFCFW_func_configCopy(void *data, const char *buf, const RFCFW_struc_configItem *items, long itemNum)
+{
+    long   i;
+    size_t var_pos = 0;
+
+    if(!data || !buf || !items) return;
+
+    for(i = 0; i < itemNum; i ++) {
+        memcpy((char *)data + items[i].offset, buf + var_pos, items[i].size);
+        var_pos += items[i].size;
+    }
+}
+
+/**
+ * Init the hand-off of the configuration to the pulse thread
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed
+ */
+int RFCFW_func_configPendingInit(RFCFW_struc_configPending *pending)
+{
+    if(!pending) return -1;
+
+    pending -> lock      = epicsMutexCreate();
+    pending -> doneEvent = epicsEventCreate(epicsEventEmpty);
+    pending -> buf       = NULL;
+    pending -> taken     = 0;
+
+    if(!pending -> lock || !pending -> doneEvent) {
+        RFCFW_func_configPendingDeinit(pending);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Release the hand-off of the configuration
+ */
+void RFCFW_func_configPendingDeinit(RFCFW_struc_configPending *pending)
+{
+    if(!pending) return;
+
+    if(pending -> lock)      epicsMutexDestroy(pending -> lock);
+    if(pending -> doneEvent) epicsEventDestroy(pending -> doneEvent);
+
+    pending -> lock      = NULL;
+    pending -> doneEvent = NULL;
+}
+
+/**
+ * Hand the configuration read by RFCFW_func_configRead to the pulse thread and wait until it is applied. If the pulse
+ *   thread does not take it within the timeout (e.g. no trigger), it is withdrawn and the caller applies it. The buffer
+ *   is owned by the caller in all cases
+ * Input:
+ *   pending    : Hand-off of the configuration
+ *   buf        : Buffer of the data
+ *   timeout_s  : Time to wait for the pulse thread to take the configuration
+ * Return:
+ *   0          : Applied by the pulse thread
+ *   1          : Not taken by the pulse thread, the caller should apply it
+ *  -1          : Failed (e.g. another restore is pending)
+ */
+int RFCFW_func_configPost(RFCFW_struc_configPending *pending, char *buf, double timeout_s)
+{
+    if(!pending || !pending -> lock || !pending -> doneEvent || !buf) return -1;
+
+    epicsMutexMustLock(pending -> lock);
+
+    if(pending -> buf) {
+        epicsMutexUnlock(pending -> lock);
+        EPICSLIB_func_errlogPrintf("RFCFW_func_configPost: Another configuration is waiting for the pulse thread\n");
+        return -1;
+    }
+
+    while(epicsEventTryWait(pending -> doneEvent) == epicsEventWaitOK);    /* no signal left from a former restore */
+
+    pending -> buf   = buf;
+    pending -> taken = 0;
+
+    epicsMutexUnlock(pending -> lock);
+
+    if(epicsEventWaitWithTimeout(pending -> doneEvent, timeout_s) == epicsEventWaitOK) return 0;
+
+    /* withdraw it if it is not taken yet, otherwise wait until the pulse thread finishes it */
+    epicsMutexMustLock(pending -> lock);
+
+    if(!pending -> taken) {
+        pending -> buf = NULL;
+        epicsMutexUnlock(pending -> lock);
+        return 1;
+    }
+
+    epicsMutexUnlock(pending -> lock);
+
+    epicsEventMustWait(pending -> doneEvent);
+
+    return 0;
+}
+
+/**
+ * Take the configuration waiting for the pulse boundary, called by the pulse thread right after the interrupt. Call
+ *   RFCFW_func_configDone after it is applied
+ * Return:
+ *   Buffer of the data, NULL if there is no configuration waiting
+ */
+char *RFCFW_func_configTake(RFCFW_struc_configPending *pending)
+{
+    char *var_buf = NULL;
+
+    if(!pending || !pending -> lock) return NULL;
+
+    epicsMutexMustLock(pending -> lock);
+
+    if(pending -> buf && !pending -> taken) {
+        pending -> taken = 1;
+        var_buf          = pending -> buf;
+    }
+
+    epicsMutexUnlock(pending -> lock);
+
+    return var_buf;
+}
+
+/**
+ * Tell the restore that the configuration taken by RFCFW_func_configTake has been applied
+ */
+void RFCFW_func_configDone(RFCFW_struc_configPending *pending)
+{
+    if(!pending || !pending -> lock) return;
+
+    epicsMutexMustLock(pending -> lock);
+    pending -> buf   = NULL;
+    pending -> taken = 0;
+    epicsMutexUnlock(pending -> lock);
+
+    epicsEventSignal(pending -> doneEvent);
+}
+
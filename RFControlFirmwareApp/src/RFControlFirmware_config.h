@@ -0,0 +1,85 @@
+/****************************************************
+ * RFControlFirmware_config.h
+ *
+ * Snapshot of the configuration of the firmware control to a binary file and restore from it. The settings to be saved
+ *   are described by a table of items (offset and size in the data structure of the firmware control), the file
+ *   contains a header and the raw bytes of all items in the order of the table. The layout signature of the table is
+ *   saved in the header, so that a file saved with a different layout is rejected as a whole instead of partially loaded
+ *
+ * The restore is handed to the pulse thread, which copies the items and programs the board right after the interrupt,
+ *   so that a pulse never sees the settings half-restored. If the pulse thread does not take it in time (e.g. no
+ *   trigger), the caller applies it by itself
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_CONFIG_H
+#define RF_CONTROL_FIRMWARE_CONFIG_H
+
+#include <stddef.h>
+
+#include <epicsEvent.h>
+#include <epicsMutex.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Constants
+ */
+#define RFCFW_CONST_CONFIG_MAGIC        0x47464352          /* "RCFG" */
+#define RFCFW_CONST_CONFIG_VERSION      1
+#define RFCFW_CONST_CONFIG_TYPE_LEN     32
+#define RFCFW_CONST_CONFIG_POST_TIMEOUT 1.0                 /* time to wait for the pulse thread to take the configuration (s) */
+
+/**
+ * Item of the configuration, use RFCFW_CONFIG_ITEM to define it
+ */
+typedef struct {
+    const char *name;                                       /* name of the field, used for the layout signature */
+    size_t      offset;                                     /* offset of the field in the data structure */
+    size_t      size;                                       /* size of the field in bytes */
+} RFCFW_struc_configItem;
+
+#define RFCFW_CONFIG_ITEM(strucType, field)     {#field, offsetof(strucType, field), sizeof(((strucType *)0) -> field)}
+
+/**
+ * Header of the configuration file
+ */
+typedef struct {
+    unsigned int magic;                                     /* RFCFW_CONST_CONFIG_MAGIC */
+    unsigned int version;                                   /* RFCFW_CONST_CONFIG_VERSION */
+    char         fwType[RFCFW_CONST_CONFIG_TYPE_LEN];       /* firmware type, e.g. "SIS8300:STRUCK:IQFB" */
+    unsigned int itemNum;                                   /* number of items */
+    unsigned int dataSize;                                  /* size of the data following the header in bytes */
+    unsigned int layoutSig;                                 /* signature of the item table (names and sizes) */
+    unsigned int checksum;                                  /* checksum of the data */
+} RFCFW_struc_configHeader;
+
+/**
+ * Hand-off of the loaded configuration to the pulse thread
+ */
+typedef struct {
+    epicsMutexId    lock;                                   /* protect buf and taken */
+    epicsEventId    doneEvent;                              /* signaled when the pulse thread has applied buf */
+    char           *buf;                                    /* loaded data waiting for the pulse boundary, NULL if none */
+    int             taken;                                  /* 1 when the pulse thread is applying buf */
+} RFCFW_struc_configPending;
+
+/**
+ * Routines
+ */
+int   RFCFW_func_configSave(const char *fileName, const char *fwType, const void *data, const RFCFW_struc_configItem *items, long itemNum);
+char *RFCFW_func_configRead(const char *fileName, const char *fwType, const RFCFW_struc_configItem *items, long itemNum);
+void  RFCFW_func_configCopy(void *data, const char *buf, const RFCFW_struc_configItem *items, long itemNum);
+
+int   RFCFW_func_configPendingInit(RFCFW_struc_configPending *pending);
+void  RFCFW_func_configPendingDeinit(RFCFW_struc_configPending *pending);
+int   RFCFW_func_configPost(RFCFW_struc_configPending *pending, char *buf, double timeout_s);     /* called by the restore */
+char *RFCFW_func_configTake(RFCFW_struc_configPending *pending);                                 /* called by the pulse thread */
+void  RFCFW_func_configDone(RFCFW_struc_configPending *pending);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
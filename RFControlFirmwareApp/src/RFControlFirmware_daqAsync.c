@@ -0,0 +1,258 @@
+/****************************************************
+ * RFControlFirmware_daqAsync.c
+ *
+ * Asynchronous readout of the DAQ data
+ ****************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include <epicsAtomic.h>
+
+#include "EPICSLib_wrapper.h"
+#include "InternalData.h"                                               /* to create EPICS data node */
+#include "RFControlFirmware_timeStats.h"
+#include "RFControlFirmware_daqAsync.h"
+#include "RFControlFirmware_regTrace.h"
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * Destroy the events of the asynchronous readout
+ */
+static void RFCFW_func_daqAsyncFree(RFCFW_struc_daqAsync *daq)
+{
+    if(daq -> startEvent) epicsEventDestroy(daq -> startEvent);
+    if(daq -> doneEvent)  epicsEventDestroy(daq -> doneEvent);
+    if(daq -> exitEvent)  epicsEventDestroy(daq -> exitEvent);
+
+    daq -> startEvent = NULL;
+    daq -> doneEvent  = NULL;
+    daq -> exitEvent  = NULL;
+}
+
+/**
+ * Worker thread, execute the readout when started, exit when stopped
+ */
+static void RFCFW_func_daqAsyncWorker(void *ptr)
+{
+    RFCFW_struc_daqAsync  *daq = (RFCFW_struc_daqAsync *)ptr;
+    RFCFW_FUNCPTR_DAQ_DONE var_callback;
+    void                  *var_userPvt;
+    double                 var_startTime_us;
+    int                    var_status;
+
+    while(!daq -> stop) {
+        epicsEventMustWait(daq -> startEvent);
+
+        if(daq -> stop) break;
+
+        /* readout, serialized with the control writes of the module */
+        var_startTime_us = RFCFW_func_getTime_us();
+        if(daq -> lock) epicsMutexMustLock(daq -> lock);
+        RFCFW_REG_TRACE_ENTER(RFCFW_CONST_PROF_GET_DAQ_DATA);
+        var_status       = daq -> getDAQData(daq -> fwModule);
+        RFCFW_REG_TRACE_LEAVE();
+        if(daq -> lock) epicsMutexUnlock(daq -> lock);
+
+        daq -> readTime_us = RFCFW_func_getTime_us() - var_startTime_us;
+        daq -> status      = var_status;
+
+        /* take the call back before releasing the busy flag, the caller may start the next readout in the call back */
+        var_callback = daq -> callback;
+        var_userPvt  = daq -> userPvt;
+
+        daq -> doneCnt ++;
+        epicsAtomicSetIntT(&daq -> busy, 0);
+
+        epicsEventSignal(daq -> doneEvent);
+
+        if(var_callback) var_callback(var_userPvt, var_status);
+    }
+
+    epicsEventSignal(daq -> exitEvent);
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Init the asynchronous readout and create the worker thread
+ * Input:
+ *   daq        : Data of the asynchronous readout
+ *   name       : Name of the module, used for the thread name
+ *   getDAQData : Synchronous readout of the firmware
+ *   fwModule   : Data structure of the firmware control
+ *   lock       : Lock of the module taken around the readout, NULL if the readout needs no serialization
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed
+ */
+int RFCFW_func_daqAsyncInit(RFCFW_struc_daqAsync *daq, const char *name, RFCFW_FUNCPTR_GET_DAQ_DATA getDAQData, void *fwModule, epicsMutexId lock)
+{
+    char var_threadName[64];
+
+    if(!daq || !name || !getDAQData || !fwModule) return -1;
+
+    if(daq -> thread) return 0;
+
+    daq -> getDAQData = getDAQData;
+    daq -> fwModule   = fwModule;
+    daq -> lock       = lock;
+    daq -> busy       = 0;
+    daq -> status     = 0;
+    daq -> stop       = 0;
+
+    daq -> startEvent = epicsEventCreate(epicsEventEmpty);
+    daq -> doneEvent  = epicsEventCreate(epicsEventEmpty);
+    daq -> exitEvent  = epicsEventCreate(epicsEventEmpty);
+
+    if(!daq -> startEvent || !daq -> doneEvent || !daq -> exitEvent) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_daqAsyncInit: Failed to create the events for %s\n", name);
+        RFCFW_func_daqAsyncFree(daq);
+        return -1;
+    }
+
+    strcpy(var_threadName, "RFCFW_DAQ_");
+    strncat(var_threadName, name, sizeof(var_threadName) - strlen(var_threadName) - 1);
+
+    daq -> thread = epicsThreadCreate(var_threadName, epicsThreadPriorityHigh, epicsThreadGetStackSize(epicsThreadStackMedium), RFCFW_func_daqAsyncWorker, (void *)daq);
+
+    if(!daq -> thread) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_daqAsyncInit: Failed to create the thread for %s\n", name);
+        RFCFW_func_daqAsyncFree(daq);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Wait for the readout in flight, stop the worker thread and destroy the events. Nothing is done if not initialized
+ * Input:
+ *   daq        : Data of the asynchronous readout
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed, the worker thread does not exit and the data should not be freed
+ */
+int RFCFW_func_daqAsyncDeinit(RFCFW_struc_daqAsync *daq)
+{
+    if(!daq || !daq -> thread) return 0;
+
+    if(RFCFW_func_daqAsyncWait(daq, RFCFW_CONST_DAQ_ASYNC_EXIT_TIMEOUT, NULL) != 0) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_daqAsyncDeinit: The readout in flight does not finish\n");
+        return -1;
+    }
+
+    daq -> stop = 1;
+    epicsEventSignal(daq -> startEvent);
+
+    if(epicsEventWaitWithTimeout(daq -> exitEvent, RFCFW_CONST_DAQ_ASYNC_EXIT_TIMEOUT) != epicsEventWaitOK) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_daqAsyncDeinit: The worker thread does not exit\n");
+        return -1;
+    }
+
+    daq -> thread = NULL;
+    RFCFW_func_daqAsyncFree(daq);
+
+    return 0;
+}
+
+/**
+ * Check if a readout is in flight
+ * Input:
+ *   daq        : Data of the asynchronous readout
+ * Return:
+ *   1 if a readout is in flight, otherwise 0
+ */
+int RFCFW_func_daqAsyncBusy(RFCFW_struc_daqAsync *daq)
+{
+    if(!daq) return 0;
+
+    return epicsAtomicGetIntT(&daq -> busy);
+}
+
+/**
+ * Start the readout and return immediately
+ * Input:
+ *   daq        : Data of the asynchronous readout
+ *   callback   : Called in the worker thread when the readout is finished (can be NULL)
+ *   userPvt    : User data passed to the call back
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed, a readout is in flight or not initialized
+ */
+int RFCFW_func_daqAsyncStart(RFCFW_struc_daqAsync *daq, RFCFW_FUNCPTR_DAQ_DONE callback, void *userPvt)
+{
+    if(!daq || !daq -> thread) return -1;
+
+    if(epicsAtomicCmpAndSwapIntT(&daq -> busy, 0, 1) != 0) {
+        daq -> rejectCnt ++;
+        return -1;
+    }
+
+    /* clear the completion of the previous readout if nobody waited for it */
+    epicsEventTryWait(daq -> doneEvent);
+
+    daq -> callback = callback;
+    daq -> userPvt  = userPvt;
+    daq -> startCnt ++;
+
+    epicsEventSignal(daq -> startEvent);
+
+    return 0;
+}
+
+/**
+ * Wait for the readout in flight
+ * Input:
+ *   daq        : Data of the asynchronous readout
+ *   timeout_s  : Timeout in seconds, <= 0 to wait forever
+ * Output:
+ *   status     : Status of the readout (can be NULL)
+ * Return:
+ *   0          : The readout is finished (or no readout in flight)
+ *   1          : Timeout
+ *  -1          : Failed
+ */
+int RFCFW_func_daqAsyncWait(RFCFW_struc_daqAsync *daq, double timeout_s, int *status)
+{
+    if(!daq || !daq -> thread) return -1;
+
+    while(epicsAtomicGetIntT(&daq -> busy)) {
+        if(timeout_s > 0) {
+            if(epicsEventWaitWithTimeout(daq -> doneEvent, timeout_s) == epicsEventWaitTimeout && epicsAtomicGetIntT(&daq -> busy)) return 1;
+        } else {
+            epicsEventMustWait(daq -> doneEvent);
+        }
+    }
+
+    if(status) *status = daq -> status;
+
+    return 0;
+}
+
+/**
+ * Create data nodes for the asynchronous readout
+ * Input:
+ *   moduleName     : Name of the high level module (RFControl)
+ *   daq            : Data of the asynchronous readout
+ * Return:
+ *   0              : Successful
+ *  <=-1            : Failed
+ */
+int RFCFW_func_daqAsyncCreateData(const char *moduleName, RFCFW_struc_daqAsync *daq)
+{
+    int status = 0;
+
+    /* check the input */
+    if(!moduleName || !moduleName[0] || !daq) return -1;
+
+    status += INTD_API_createDataNode(moduleName, "DAQ_ASYNC_START_CNT",  (void *)(&daq -> startCnt),    (void *)daq, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);  /* r */
+    status += INTD_API_createDataNode(moduleName, "DAQ_ASYNC_DONE_CNT",   (void *)(&daq -> doneCnt),     (void *)daq, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);  /* r */
+    status += INTD_API_createDataNode(moduleName, "DAQ_ASYNC_REJECT_CNT", (void *)(&daq -> rejectCnt),   (void *)daq, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);  /* r */
+    status += INTD_API_createDataNode(moduleName, "DAQ_ASYNC_READ_TIME",  (void *)(&daq -> readTime_us), (void *)daq, 1, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AI, INTD_1S);  /* r */
+
+    return status;
+}
+
@@ -0,0 +1,74 @@
+/****************************************************
+ * RFControlFirmware_daqAsync.h
+ *
+ * Asynchronous readout of the DAQ data. The readout (all BRAM and DRAM transfers of the firmware) is executed by a
+ *   worker thread of the module, the caller starts it and returns immediately, so that it can prepare the set points of
+ *   the next pulse or process the previous pulse while the transfers are in flight. The completion is notified by a
+ *   callback (called in the worker thread) and can also be waited for. Only one readout can be in flight per module
+ *
+ * The readout of the backends also writes the registers of the control (e.g. the PI, ILC and ramp of the pulse), so it
+ *   is executed under the lock of the module, which is also taken by the control writes (set phase and amplitude)
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_DAQ_ASYNC_H
+#define RF_CONTROL_FIRMWARE_DAQ_ASYNC_H
+
+#include <epicsThread.h>
+#include <epicsEvent.h>
+#include <epicsMutex.h>
+
+#include "RFControlFirmware_requiredInterface_fwCtrlVirtual.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RFCFW_CONST_DAQ_ASYNC_EXIT_TIMEOUT  5.0             /* time to wait for the readout in flight and the exit of the worker (s) */
+
+/**
+ * Call back when the readout is finished (user data, status of the readout), called in the worker thread, keep it short
+ */
+typedef void (*RFCFW_FUNCPTR_DAQ_DONE)(void *, int);
+
+/**
+ * Data of the asynchronous readout
+ */
+typedef struct {
+    epicsThreadId   thread;                                 /* worker thread, created at the first start */
+    epicsEventId    startEvent;                             /* signaled to start the readout */
+    epicsEventId    doneEvent;                              /* signaled when the readout is finished */
+    epicsEventId    exitEvent;                              /* signaled when the worker thread exits */
+    volatile int    stop;                                   /* set to stop the worker thread */
+
+    RFCFW_FUNCPTR_GET_DAQ_DATA getDAQData;                  /* synchronous readout of the firmware */
+    void           *fwModule;
+    epicsMutexId    lock;                                   /* lock of the module, taken around the readout (can be NULL) */
+
+    RFCFW_FUNCPTR_DAQ_DONE callback;                        /* call back of the readout in flight */
+    void           *userPvt;
+
+    int             busy;                                   /* 1 if a readout is in flight, accessed with epicsAtomic */
+    volatile int    status;                                 /* status of the latest readout */
+
+    volatile long   startCnt;                               /* number of readouts started */
+    volatile long   doneCnt;                                /* number of readouts finished */
+    volatile long   rejectCnt;                              /* number of starts rejected because a readout is in flight */
+    volatile double readTime_us;                            /* time of the latest readout */
+} RFCFW_struc_daqAsync;
+
+/**
+ * Routines
+ */
+int RFCFW_func_daqAsyncInit(RFCFW_struc_daqAsync *daq, const char *name, RFCFW_FUNCPTR_GET_DAQ_DATA getDAQData, void *fwModule, epicsMutexId lock);
+int RFCFW_func_daqAsyncDeinit(RFCFW_struc_daqAsync *daq);
+int RFCFW_func_daqAsyncBusy(RFCFW_struc_daqAsync *daq);
+int RFCFW_func_daqAsyncStart(RFCFW_struc_daqAsync *daq, RFCFW_FUNCPTR_DAQ_DONE callback, void *userPvt);
+int RFCFW_func_daqAsyncWait(RFCFW_struc_daqAsync *daq, double timeout_s, int *status);
+
+int RFCFW_func_daqAsyncCreateData(const char *moduleName, RFCFW_struc_daqAsync *daq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,378 @@
+/****************************************************
+ * RFControlFirmware_ilc.c
+ *
+ * Iterative learning control of the I/Q set point table
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "InternalData.h"                                               /* to create EPICS data node */
+#include "RFControlFirmware_ilc.h"
+
+/*======================================
+ * Private Data and Routines
+ *======================================*/
+/**
+ * Convert the table value to digits (same range as the 16 bits table entries of the firmware)
+ */
+static int RFCFW_func_ilcToDigits(double value)
+{
+    value = floor(value + 0.5);
+
+    if(value >  32767.0) value =  32767.0;
+    if(value < -32768.0) value = -32768.0;
+
+    return (int)value;
+}
+
+/**
+ * Sample the error waveform at the table entries [kStart, kEnd) with the moving average filter. The sum of the filter
+ *   window is stored (the division is merged into the learning coefficient), the window is truncated at the edges of
+ *   the waveform
+ */
+static void RFCFW_func_ilcFilter(RFCFW_struc_ilc *ilc, const short *errI, const short *errQ, long errPno, long kStart, long kEnd, long half)
+{
+    long k, m, j, jStart, jEnd;
+    int  var_sumI, var_sumQ;
+    long long var_stepFx = ilc -> errStep > 0.0 ? (long long)(ilc -> errStep * 65536.0 + 0.5) : 65536;     /* 16 bits fraction */
+
+    for(k = kStart; k < kEnd; k ++) {
+        j      = ilc -> errOffset + (long)(((long long)k * var_stepFx) >> 16);
+        jStart = j - half;
+        jEnd   = j + half + 1;
+
+        if(jStart < 0)      jStart = 0;
+        if(jEnd   > errPno) jEnd   = errPno;
+
+        var_sumI = 0;
+        var_sumQ = 0;
+
+        for(m = jStart; m < jEnd; m ++) {
+            var_sumI += errI[m];
+            var_sumQ += errQ[m];
+        }
+
+        ilc -> filtI[k] = var_sumI;
+        ilc -> filtQ[k] = var_sumQ;
+    }
+}
+
+/**
+ * Accumulate the filtered error into the correction for the entries [kStart, kEnd). No branches in the loop body
+ */
+static void RFCFW_func_ilcLearn(RFCFW_struc_ilc *ilc, long kStart, long kEnd, long long coef, int limit)
+{
+    long k;
+    int  var_corrI, var_corrQ;
+    long long var_dI, var_dQ;
+
+    for(k = kStart; k < kEnd; k ++) {
+        var_dI = (coef * ilc -> filtI[k]) >> (RFCFW_CONST_ILC_COEF_FRACTION - RFCFW_CONST_ILC_CORR_FRACTION);
+        var_dQ = (coef * ilc -> filtQ[k]) >> (RFCFW_CONST_ILC_COEF_FRACTION - RFCFW_CONST_ILC_CORR_FRACTION);
+
+        /* the step is limited before it is converted to int, the sum with the limited correction then fits in int */
+        var_dI = var_dI >  2 * (long long)limit ?  2 * (long long)limit : var_dI;
+        var_dI = var_dI < -2 * (long long)limit ? -2 * (long long)limit : var_dI;
+        var_dQ = var_dQ >  2 * (long long)limit ?  2 * (long long)limit : var_dQ;
+        var_dQ = var_dQ < -2 * (long long)limit ? -2 * (long long)limit : var_dQ;
+
+        var_corrI = ilc -> corrI[k] + (int)var_dI;
+        var_corrQ = ilc -> corrQ[k] + (int)var_dQ;
+
+        var_corrI = var_corrI >  limit ?  limit : var_corrI;
+        var_corrI = var_corrI < -limit ? -limit : var_corrI;
+        var_corrQ = var_corrQ >  limit ?  limit : var_corrQ;
+        var_corrQ = var_corrQ < -limit ? -limit : var_corrQ;
+
+        ilc -> corrI[k] = var_corrI;
+        ilc -> corrQ[k] = var_corrQ;
+    }
+}
+
+/*======================================
+ * Private Data and Routines - call backs
+ *======================================*/
+/* Write callback function, limit the filter length to the supported odd numbers */
+static void w_setFilterLen(void *ptr)
+{
+    INTD_struc_node *dataNode = (INTD_struc_node *)ptr;
+
+    if(!dataNode) return;
+    RFCFW_struc_ilc *ilc      = (RFCFW_struc_ilc *)dataNode->privateData;
+
+    if(ilc) {
+        if(ilc -> filterLen < 1)                          ilc -> filterLen = 1;
+        if(ilc -> filterLen > RFCFW_CONST_ILC_FILTER_MAX) ilc -> filterLen = RFCFW_CONST_ILC_FILTER_MAX;
+
+        ilc -> filterLen |= 1;
+    }
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Init the ILC, create the lock of the base table. The settings are kept
+ * Input:
+ *   ilc        : ILC data
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed
+ */
+int RFCFW_func_ilcInit(RFCFW_struc_ilc *ilc)
+{
+    if(!ilc) return -1;
+
+    if(!ilc -> lock) ilc -> lock = epicsMutexCreate();
+
+    return ilc -> lock ? 0 : -1;
+}
+
+/**
+ * Release the lock of the ILC
+ * Input:
+ *   ilc        : ILC data
+ */
+void RFCFW_func_ilcDeinit(RFCFW_struc_ilc *ilc)
+{
+    if(!ilc || !ilc -> lock) return;
+
+    epicsMutexDestroy(ilc -> lock);
+    ilc -> lock = NULL;
+}
+
+/**
+ * Set the base table (the table given by the operator, which has been uploaded to the firmware). The table is taken by
+ *   the next call of RFCFW_func_ilcUpdate at the pulse boundary, which clears the correction so that the learning
+ *   restarts from the new table. The whole table is uploaded again only if the learning is enabled and the caller may
+ *   have been interleaved with the partial uploads of the learning
+ * Input:
+ *   ilc        : ILC data
+ *   baseI/Q    : Base table
+ *   pno        : Length of the table (limited to RFCFW_CONST_ILC_TAB_MAX)
+ *   uploaded   : 1 if the table was uploaded by the pulse thread (or while no pulse comes), so the firmware already holds
+ *                exactly this table, 0 if uploaded by another thread
+ */
+void RFCFW_func_ilcSetBase(RFCFW_struc_ilc *ilc, const double *baseI, const double *baseQ, long pno, int uploaded)
+{
+    long i;
+
+    if(!ilc || !ilc -> lock || !baseI || !baseQ || pno <= 0) return;
+
+    if(pno > RFCFW_CONST_ILC_TAB_MAX) pno = RFCFW_CONST_ILC_TAB_MAX;
+
+    epicsMutexLock(ilc -> lock);
+
+    for(i = 0; i < pno; i ++) {
+        ilc -> pendI[i] = RFCFW_func_ilcToDigits(baseI[i]);
+        ilc -> pendQ[i] = RFCFW_func_ilcToDigits(baseQ[i]);
+    }
+
+    ilc -> pendPno      = pno;
+    ilc -> pendUploaded = uploaded;
+    ilc -> resync       = 1;
+
+    epicsMutexUnlock(ilc -> lock);
+}
+
+/**
+ * Execute the learning for one pulse and build the new table. The caller should upload the region of the table
+ *   given by updStart and updPno (taking the values from tabUpI/tabUpQ) and record the time to uploadTime. When a new
+ *   base table has been set, it is taken and the whole table is to be uploaded, no learning in this pulse
+ * Input:
+ *   ilc        : ILC data
+ *   errI/Q     : Error waveforms of this pulse (set point - measurement, digits)
+ *   errPno     : Point number of the error waveforms
+ * Output:
+ *   updStart   : First entry of the table to be uploaded
+ *   updPno     : Number of the entries to be uploaded, 0 if the table in the firmware is already up to date
+ * Return:
+ *   0          : Calculation executed
+ *  -1          : Nothing to do (disabled or invalid input)
+ */
+int RFCFW_func_ilcUpdate(RFCFW_struc_ilc *ilc, const short *errI, const short *errQ, long errPno, long *updStart, long *updPno)
+{
+    long i;
+    long var_kStart, var_kEnd, var_half, var_len;
+    long var_first = -1, var_last = -1;
+    int  var_limit, var_newI, var_newQ;
+    int  var_upload;
+    long long var_coef;
+    double var_gain;
+    double var_startTime_us = RFCFW_func_getTime_us();
+
+    /* check the input */
+    if(!ilc || !ilc -> lock || !updStart || !updPno) return -1;
+
+    *updStart = 0;
+    *updPno   = 0;
+
+    /* take the base table given by the operator, upload it again as a whole if the partial uploads of the learning may
+       have been interleaved with the upload of the operator */
+    if(ilc -> resync) {
+        epicsMutexLock(ilc -> lock);
+        memcpy(ilc -> baseI, ilc -> pendI, sizeof(ilc -> baseI));
+        memcpy(ilc -> baseQ, ilc -> pendQ, sizeof(ilc -> baseQ));
+        ilc -> tabPno = ilc -> pendPno;
+        ilc -> resync = 0;
+        var_upload    = ilc -> enable && !ilc -> pendUploaded;
+        epicsMutexUnlock(ilc -> lock);
+
+        memset(ilc -> corrI, 0, sizeof(ilc -> corrI));
+        memset(ilc -> corrQ, 0, sizeof(ilc -> corrQ));
+        memcpy(ilc -> tabI, ilc -> baseI, sizeof(ilc -> tabI));
+        memcpy(ilc -> tabQ, ilc -> baseQ, sizeof(ilc -> tabQ));
+
+        for(i = 0; i < ilc -> tabPno; i ++) {
+            ilc -> tabUpI[i] = (double)ilc -> tabI[i];
+            ilc -> tabUpQ[i] = (double)ilc -> tabQ[i];
+        }
+
+        ilc -> cnt      = 0;
+        ilc -> reset    = 0;
+        ilc -> updStart = *updStart = 0;
+        ilc -> updPno   = *updPno   = var_upload ? ilc -> tabPno : 0;
+        return 0;
+    }
+
+    if(ilc -> tabPno <= 0) return -1;
+
+    /* clear the correction, the base table will be uploaded below */
+    if(ilc -> reset) {
+        memset(ilc -> corrI, 0, sizeof(ilc -> corrI));
+        memset(ilc -> corrQ, 0, sizeof(ilc -> corrQ));
+
+        ilc -> cnt   = 0;
+        ilc -> reset = 0;
+    } else if(!ilc -> enable || !errI || !errQ || errPno <= 0) {
+        return -1;
+    }
+
+    /* learning */
+    if(ilc -> enable && errI && errQ && errPno > 0) {
+        var_kStart = ilc -> tabStart < 0 ? 0 : ilc -> tabStart;
+        var_kEnd   = ilc -> tabEnd > ilc -> tabPno ? ilc -> tabPno : ilc -> tabEnd;
+
+        var_len    = ilc -> filterLen < 1 ? 1 : (ilc -> filterLen > RFCFW_CONST_ILC_FILTER_MAX ? RFCFW_CONST_ILC_FILTER_MAX : ilc -> filterLen);
+        var_half   = var_len / 2;
+        var_len    = 2 * var_half + 1;
+
+        var_gain   = floor(ilc -> gain / var_len * (double)(1 << RFCFW_CONST_ILC_COEF_FRACTION) + 0.5);
+        var_gain   = var_gain >  (double)RFCFW_CONST_ILC_COEF_MAX ?  (double)RFCFW_CONST_ILC_COEF_MAX : var_gain;
+        var_gain   = var_gain < -(double)RFCFW_CONST_ILC_COEF_MAX ? -(double)RFCFW_CONST_ILC_COEF_MAX : var_gain;
+        var_coef   = (long long)var_gain;
+        var_limit  = ilc -> corrLimit > 0.0 && ilc -> corrLimit < 65535.0 ? (int)(ilc -> corrLimit * (1 << RFCFW_CONST_ILC_CORR_FRACTION)) : (65535 << RFCFW_CONST_ILC_CORR_FRACTION);
+
+        if(var_kStart < var_kEnd) {
+            RFCFW_func_ilcFilter(ilc, errI, errQ, errPno, var_kStart, var_kEnd, var_half);
+            RFCFW_func_ilcLearn(ilc, var_kStart, var_kEnd, var_coef, var_limit);
+        }
+
+        ilc -> cnt ++;
+    }
+
+    /* new table in digits (rounded and saturated), and the region changed */
+    for(i = 0; i < ilc -> tabPno; i ++) {
+        var_newI = ilc -> baseI[i] + ((ilc -> corrI[i] + (1 << (RFCFW_CONST_ILC_CORR_FRACTION - 1))) >> RFCFW_CONST_ILC_CORR_FRACTION);
+        var_newQ = ilc -> baseQ[i] + ((ilc -> corrQ[i] + (1 << (RFCFW_CONST_ILC_CORR_FRACTION - 1))) >> RFCFW_CONST_ILC_CORR_FRACTION);
+
+        var_newI = var_newI >  32767 ?  32767 : var_newI;
+        var_newI = var_newI < -32768 ? -32768 : var_newI;
+        var_newQ = var_newQ >  32767 ?  32767 : var_newQ;
+        var_newQ = var_newQ < -32768 ? -32768 : var_newQ;
+
+        if(var_newI != ilc -> tabI[i] || var_newQ != ilc -> tabQ[i]) {
+            if(var_first < 0) var_first = i;
+            var_last = i;
+
+            ilc -> tabI[i]   = var_newI;
+            ilc -> tabQ[i]   = var_newQ;
+            ilc -> tabUpI[i] = (double)var_newI;
+            ilc -> tabUpQ[i] = (double)var_newQ;
+        }
+    }
+
+    if(var_first >= 0) {
+        *updStart = var_first;
+        *updPno   = var_last - var_first + 1;
+    }
+
+    ilc -> updStart = *updStart;
+    ilc -> updPno   = *updPno;
+
+    RFCFW_func_timeStatsUpdate(&ilc -> calcTime, RFCFW_func_getTime_us() - var_startTime_us, RFCFW_CONST_PULSE_BUDGET_US);
+
+    return 0;
+}
+
+/**
+ * Create data nodes for the ILC
+ * Input:
+ *   moduleName     : Name of the high level module (RFControl)
+ *   ilcName        : Prefix of the data node names
+ *   ilc            : ILC data
+ * Return:
+ *   0              : Successful
+ *  <=-1            : Failed
+ */
+int RFCFW_func_ilcCreateData(const char *moduleName, const char *ilcName, RFCFW_struc_ilc *ilc)
+{
+    int  status = 0;
+    char var_dataName[64];
+
+    /* check the input */
+    if(!moduleName || !moduleName[0] || !ilcName || !ilcName[0] || !ilc) return -1;
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_ENA", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ilc -> enable),    (void *)ilc, 1, NULL, INTD_USHORT, NULL, NULL,           NULL, NULL, INTD_BO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_RST", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ilc -> reset),     (void *)ilc, 1, NULL, INTD_USHORT, NULL, NULL,           NULL, NULL, INTD_BO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_GAIN", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ilc -> gain),      (void *)ilc, 1, NULL, INTD_DOUBLE, NULL, NULL,           NULL, NULL, INTD_AO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_FILT_LEN", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ilc -> filterLen), (void *)ilc, 1, NULL, INTD_LONG,   NULL, w_setFilterLen, NULL, NULL, INTD_LO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_ERR_OFS", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ilc -> errOffset), (void *)ilc, 1, NULL, INTD_LONG,   NULL, NULL,           NULL, NULL, INTD_LO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_ERR_STEP", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ilc -> errStep),   (void *)ilc, 1, NULL, INTD_DOUBLE, NULL, NULL,           NULL, NULL, INTD_AO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_TAB_ST", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ilc -> tabStart),  (void *)ilc, 1, NULL, INTD_LONG,   NULL, NULL,           NULL, NULL, INTD_LO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_TAB_ET", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ilc -> tabEnd),    (void *)ilc, 1, NULL, INTD_LONG,   NULL, NULL,           NULL, NULL, INTD_LO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_CORR_LIMIT", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ilc -> corrLimit), (void *)ilc, 1, NULL, INTD_DOUBLE, NULL, NULL,           NULL, NULL, INTD_AO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_CNT", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ilc -> cnt),       (void *)ilc, 1, NULL, INTD_LONG,   NULL, NULL,           NULL, NULL, INTD_LI, INTD_1S);       /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_UPD_ST", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ilc -> updStart),  (void *)ilc, 1, NULL, INTD_LONG,   NULL, NULL,           NULL, NULL, INTD_LI, INTD_1S);       /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_UPD_PNO", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ilc -> updPno),    (void *)ilc, 1, NULL, INTD_LONG,   NULL, NULL,           NULL, NULL, INTD_LI, INTD_1S);       /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_TAB_I", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(ilc -> tabUpI),     (void *)ilc, RFCFW_CONST_ILC_TAB_MAX, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_WFI, INTD_1S);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_TAB_Q", ilcName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(ilc -> tabUpQ),     (void *)ilc, RFCFW_CONST_ILC_TAB_MAX, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_WFI, INTD_1S);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_CALC_TIME", ilcName);
+    status += RFCFW_func_timeStatsCreateData(moduleName, var_dataName, &ilc -> calcTime);
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_UPLOAD_TIME", ilcName);
+    status += RFCFW_func_timeStatsCreateData(moduleName, var_dataName, &ilc -> uploadTime);
+
+    return status;
+}
+
@@ -0,0 +1,95 @@
+/****************************************************
+ * RFControlFirmware_ilc.h
+ *
+ * Iterative learning control (ILC) of the I/Q set point table. Every pulse the error waveform of the firmware is
+ *   filtered, scaled with the learning gain and accumulated into a correction of the set point table, then only the
+ *   region of the table whose values in digits really changed is uploaded to the firmware. The calculation is in fixed
+ *   point with plain loops over integer arrays, so that the compiler can vectorize the update of the table
+ *
+ * The base table is given by the operator (CA thread) and used by the pulse thread. It is written to a pending copy under
+ *   the lock and taken by the pulse thread at the next pulse boundary. If the learning is enabled and the table was
+ *   uploaded by another thread, the whole table is uploaded again, so that the firmware does not keep a table mixed from
+ *   the upload of the operator and the partial uploads of the learning. A table uploaded by the pulse thread itself (e.g.
+ *   the ramp) is only taken, it is not uploaded twice
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_ILC_H
+#define RF_CONTROL_FIRMWARE_ILC_H
+
+#include <epicsMutex.h>
+
+#include "RFControlFirmware_timeStats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Constants
+ */
+#define RFCFW_CONST_ILC_TAB_MAX         1024                /* maximum length of the set point table */
+#define RFCFW_CONST_ILC_FILTER_MAX      63                  /* maximum points of the moving average filter */
+#define RFCFW_CONST_ILC_CORR_FRACTION   8                   /* fraction bits of the accumulated correction, so that small gains still learn */
+#define RFCFW_CONST_ILC_COEF_FRACTION   24                  /* fraction bits of the learning coefficient (gain / filter points) */
+#define RFCFW_CONST_ILC_COEF_MAX        (1LL << 40)         /* limit of the learning coefficient, the product with the filtered error fits in 64 bits */
+
+/**
+ * Data of the ILC of a set point table
+ */
+typedef struct {
+    /* settings */
+    volatile unsigned short enable;                         /* 1 to enable the learning, the correction is kept in the table when disabled */
+    volatile unsigned short reset;                          /* write 1 to clear the correction, the base table is restored at the next pulse */
+    volatile double gain;                                   /* learning gain (table digits per error digit), negative to invert the sign */
+    volatile long   filterLen;                              /* points of the moving average filter applied to the error (odd number, 1 for no filter) */
+    volatile long   errOffset;                              /* index of the error waveform corresponding to the first entry of the table */
+    volatile double errStep;                                /* error waveform points per table entry */
+    volatile long   tabStart;                               /* first entry of the table to learn */
+    volatile long   tabEnd;                                 /* last entry (exclusive) of the table to learn */
+    volatile double corrLimit;                              /* limit of the correction in digits, no limit if <= 0 */
+
+    /* status */
+    volatile long   cnt;                                    /* number of the learning iterations */
+    volatile long   updStart;                               /* region of the table uploaded for the latest pulse */
+    volatile long   updPno;
+    volatile unsigned short resync;                         /* set when the base table is changed, the correction is cleared at the next pulse */
+
+    epicsMutexId lock;                                      /* protect the pending base table */
+    long   pendPno;                                         /* pending base table given by the operator (digits) */
+    int    pendUploaded;                                    /* 1 if the pending table was uploaded where no partial upload can interleave */
+    int    pendI[RFCFW_CONST_ILC_TAB_MAX];
+    int    pendQ[RFCFW_CONST_ILC_TAB_MAX];
+
+    long   tabPno;                                          /* length of the table */
+
+    int    baseI[RFCFW_CONST_ILC_TAB_MAX];                  /* base table used by the learning (digits) */
+    int    baseQ[RFCFW_CONST_ILC_TAB_MAX];
+    int    corrI[RFCFW_CONST_ILC_TAB_MAX];                  /* accumulated correction (digits with RFCFW_CONST_ILC_CORR_FRACTION bits fraction) */
+    int    corrQ[RFCFW_CONST_ILC_TAB_MAX];
+    int    filtI[RFCFW_CONST_ILC_TAB_MAX];                  /* filtered error sampled at the table entries (sum of the filter window) */
+    int    filtQ[RFCFW_CONST_ILC_TAB_MAX];
+    int    tabI[RFCFW_CONST_ILC_TAB_MAX];                   /* table in the firmware (digits) */
+    int    tabQ[RFCFW_CONST_ILC_TAB_MAX];
+
+    double tabUpI[RFCFW_CONST_ILC_TAB_MAX];                 /* table in the format of the upload routine */
+    double tabUpQ[RFCFW_CONST_ILC_TAB_MAX];
+
+    RFCFW_struc_timeStats calcTime;                         /* time of the calculation */
+    RFCFW_struc_timeStats uploadTime;                       /* time of uploading the changed region */
+} RFCFW_struc_ilc;
+
+/**
+ * Routines
+ */
+int  RFCFW_func_ilcInit(RFCFW_struc_ilc *ilc);
+void RFCFW_func_ilcDeinit(RFCFW_struc_ilc *ilc);
+void RFCFW_func_ilcSetBase(RFCFW_struc_ilc *ilc, const double *baseI, const double *baseQ, long pno, int uploaded);
+int  RFCFW_func_ilcUpdate(RFCFW_struc_ilc *ilc, const short *errI, const short *errQ, long errPno, long *updStart, long *updPno);
+
+int  RFCFW_func_ilcCreateData(const char *moduleName, const char *ilcName, RFCFW_struc_ilc *ilc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
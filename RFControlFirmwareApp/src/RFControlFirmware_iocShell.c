@@ -7,6 +7,7 @@
  * Created on: 2/13/2013
  * Description: Initial creation
  ****************************************************/
+#include <stdlib.h>
 #include <epicsTypes.h>
 #include <epicsExport.h>
 #include <iocsh.h>
@@ -41,11 +42,139 @@ static const iocshArg *const RFCFW_setupModule_Args[3] = {&RFCFW_setupModule_Arg
 static const iocshFuncDef    RFCFW_setupModule_FuncDef = {"RFCFW_setupModule", 3, RFCFW_setupModule_Args};
 static void  RFCFW_setupModule_CallFunc(const iocshArgBuf *args) {RFCFW_API_setupModule(args[0].sval, args[1].sval, args[2].sval);}
 
+/* RFCFW_API_bringUpAll(int threadNum, int setupSPI) */
+static const iocshArg        RFCFW_bringUpAll_Arg0    = {"threadNum", iocshArgInt};
+static const iocshArg        RFCFW_bringUpAll_Arg1    = {"setupSPI",  iocshArgInt};
+static const iocshArg *const RFCFW_bringUpAll_Args[2] = {&RFCFW_bringUpAll_Arg0, &RFCFW_bringUpAll_Arg1};
+static const iocshFuncDef    RFCFW_bringUpAll_FuncDef = {"RFCFW_bringUpAll", 2, RFCFW_bringUpAll_Args};
+static void  RFCFW_bringUpAll_CallFunc(const iocshArgBuf *args) {RFCFW_API_bringUpAll(args[0].ival, args[1].ival);}
+
+/* RFCFW_API_saveConfig(const char *moduleName, const char *fileName) */
+static const iocshArg        RFCFW_saveConfig_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg        RFCFW_saveConfig_Arg1    = {"fileName",   iocshArgString};
+static const iocshArg *const RFCFW_saveConfig_Args[2] = {&RFCFW_saveConfig_Arg0, &RFCFW_saveConfig_Arg1};
+static const iocshFuncDef    RFCFW_saveConfig_FuncDef = {"RFCFW_saveConfig", 2, RFCFW_saveConfig_Args};
+static void  RFCFW_saveConfig_CallFunc(const iocshArgBuf *args) {RFCFW_API_saveConfig(args[0].sval, args[1].sval);}
+
+/* RFCFW_API_restoreConfig(const char *moduleName, const char *fileName) */
+static const iocshArg        RFCFW_restoreConfig_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg        RFCFW_restoreConfig_Arg1    = {"fileName",   iocshArgString};
+static const iocshArg *const RFCFW_restoreConfig_Args[2] = {&RFCFW_restoreConfig_Arg0, &RFCFW_restoreConfig_Arg1};
+static const iocshFuncDef    RFCFW_restoreConfig_FuncDef = {"RFCFW_restoreConfig", 2, RFCFW_restoreConfig_Args};
+static void  RFCFW_restoreConfig_CallFunc(const iocshArgBuf *args) {RFCFW_API_restoreConfig(args[0].sval, args[1].sval);}
+
+/* RFCFW_API_createModuleAuto(const char *moduleName, const char *boardModuleName) */
+static const iocshArg        RFCFW_createModuleAuto_Arg0    = {"moduleName",      iocshArgString};
+static const iocshArg        RFCFW_createModuleAuto_Arg1    = {"boardModuleName", iocshArgString};
+static const iocshArg *const RFCFW_createModuleAuto_Args[2] = {&RFCFW_createModuleAuto_Arg0, &RFCFW_createModuleAuto_Arg1};
+static const iocshFuncDef    RFCFW_createModuleAuto_FuncDef = {"RFCFW_createModuleAuto", 2, RFCFW_createModuleAuto_Args};
+static void  RFCFW_createModuleAuto_CallFunc(const iocshArgBuf *args) {RFCFW_API_createModuleAuto(args[0].sval, args[1].sval);}
+
+/* RFCFW_API_setBackendFwId(const char *fwType, unsigned int fwNameId, unsigned int fwNameMask), the id and mask are strings to allow hex numbers */
+static const iocshArg        RFCFW_setBackendFwId_Arg0    = {"firmwareType", iocshArgString};
+static const iocshArg        RFCFW_setBackendFwId_Arg1    = {"fwNameId",     iocshArgString};
+static const iocshArg        RFCFW_setBackendFwId_Arg2    = {"fwNameMask",   iocshArgString};
+static const iocshArg *const RFCFW_setBackendFwId_Args[3] = {&RFCFW_setBackendFwId_Arg0, &RFCFW_setBackendFwId_Arg1, &RFCFW_setBackendFwId_Arg2};
+static const iocshFuncDef    RFCFW_setBackendFwId_FuncDef = {"RFCFW_setBackendFwId", 3, RFCFW_setBackendFwId_Args};
+static void  RFCFW_setBackendFwId_CallFunc(const iocshArgBuf *args) 
+{
+    if(!args[1].sval || !args[2].sval) return;
+    RFCFW_API_setBackendFwId(args[0].sval, (unsigned int)strtoul(args[1].sval, NULL, 0), (unsigned int)strtoul(args[2].sval, NULL, 0));
+}
+
+/* RFCFW_API_printBackends(void) */
+static const iocshFuncDef    RFCFW_printBackends_FuncDef = {"RFCFW_printBackends", 0, NULL};
+static void  RFCFW_printBackends_CallFunc(const iocshArgBuf *args) {RFCFW_API_printBackends();}
+
+/* RFCFW_API_mapRegisters(const char *moduleName, int enable) */
+static const iocshArg        RFCFW_mapRegisters_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg        RFCFW_mapRegisters_Arg1    = {"enable",     iocshArgInt};
+static const iocshArg *const RFCFW_mapRegisters_Args[2] = {&RFCFW_mapRegisters_Arg0, &RFCFW_mapRegisters_Arg1};
+static const iocshFuncDef    RFCFW_mapRegisters_FuncDef = {"RFCFW_mapRegisters", 2, RFCFW_mapRegisters_Args};
+static void  RFCFW_mapRegisters_CallFunc(const iocshArgBuf *args) {RFCFW_API_mapRegisters(args[0].sval, args[1].ival);}
+
+/* RFCFW_API_benchRegAccess(const char *moduleName, long loops, long scratchAddr), the address is a string to allow hex numbers, empty to skip the writing */
+static const iocshArg        RFCFW_benchRegAccess_Arg0    = {"moduleName",  iocshArgString};
+static const iocshArg        RFCFW_benchRegAccess_Arg1    = {"loops",       iocshArgInt};
+static const iocshArg        RFCFW_benchRegAccess_Arg2    = {"scratchAddr", iocshArgString};
+static const iocshArg *const RFCFW_benchRegAccess_Args[3] = {&RFCFW_benchRegAccess_Arg0, &RFCFW_benchRegAccess_Arg1, &RFCFW_benchRegAccess_Arg2};
+static const iocshFuncDef    RFCFW_benchRegAccess_FuncDef = {"RFCFW_benchRegAccess", 3, RFCFW_benchRegAccess_Args};
+static void  RFCFW_benchRegAccess_CallFunc(const iocshArgBuf *args) 
+{
+    RFCFW_API_benchRegAccess(args[0].sval, (long)args[1].ival, (args[2].sval && args[2].sval[0]) ? (long)strtoul(args[2].sval, NULL, 0) : -1);
+}
+
+/* RFCFW_API_benchDeinterleave(long loops) */
+static const iocshArg        RFCFW_benchDeinterleave_Arg0    = {"loops", iocshArgInt};
+static const iocshArg *const RFCFW_benchDeinterleave_Args[1] = {&RFCFW_benchDeinterleave_Arg0};
+static const iocshFuncDef    RFCFW_benchDeinterleave_FuncDef = {"RFCFW_benchDeinterleave", 1, RFCFW_benchDeinterleave_Args};
+static void  RFCFW_benchDeinterleave_CallFunc(const iocshArgBuf *args) {RFCFW_API_benchDeinterleave((long)args[0].ival);}
+
+/* RFCFW_API_burstStart(const char *moduleName, long num) */
+static const iocshArg        RFCFW_burstStart_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg        RFCFW_burstStart_Arg1    = {"num",        iocshArgInt};
+static const iocshArg *const RFCFW_burstStart_Args[2] = {&RFCFW_burstStart_Arg0, &RFCFW_burstStart_Arg1};
+static const iocshFuncDef    RFCFW_burstStart_FuncDef = {"RFCFW_burstStart", 2, RFCFW_burstStart_Args};
+static void  RFCFW_burstStart_CallFunc(const iocshArgBuf *args) {RFCFW_API_burstStart(args[0].sval, (long)args[1].ival);}
+
+/* RFCFW_API_burstDump(const char *moduleName, const char *fileName) */
+static const iocshArg        RFCFW_burstDump_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg        RFCFW_burstDump_Arg1    = {"fileName",   iocshArgString};
+static const iocshArg *const RFCFW_burstDump_Args[2] = {&RFCFW_burstDump_Arg0, &RFCFW_burstDump_Arg1};
+static const iocshFuncDef    RFCFW_burstDump_FuncDef = {"RFCFW_burstDump", 2, RFCFW_burstDump_Args};
+static void  RFCFW_burstDump_CallFunc(const iocshArgBuf *args) {RFCFW_API_burstDump(args[0].sval, args[1].sval);}
+
+/* RFCFW_API_profileEnable(const char *moduleName, int enable) */
+static const iocshArg        RFCFW_profileEnable_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg        RFCFW_profileEnable_Arg1    = {"enable",     iocshArgInt};
+static const iocshArg *const RFCFW_profileEnable_Args[2] = {&RFCFW_profileEnable_Arg0, &RFCFW_profileEnable_Arg1};
+static const iocshFuncDef    RFCFW_profileEnable_FuncDef = {"RFCFW_profileEnable", 2, RFCFW_profileEnable_Args};
+static void  RFCFW_profileEnable_CallFunc(const iocshArgBuf *args) {RFCFW_API_profileEnable(args[0].sval, args[1].ival);}
+
+/* RFCFW_API_profileReport(const char *moduleName) */
+static const iocshArg        RFCFW_profileReport_Arg0    = {"moduleName", iocshArgString};
+static const iocshArg *const RFCFW_profileReport_Args[1] = {&RFCFW_profileReport_Arg0};
+static const iocshFuncDef    RFCFW_profileReport_FuncDef = {"RFCFW_profileReport", 1, RFCFW_profileReport_Args};
+static void  RFCFW_profileReport_CallFunc(const iocshArgBuf *args) {RFCFW_API_profileReport(args[0].sval);}
+
+/* RFCFW_API_regTraceArm(int clear) */
+static const iocshArg        RFCFW_regTraceArm_Arg0    = {"clear", iocshArgInt};
+static const iocshArg *const RFCFW_regTraceArm_Args[1] = {&RFCFW_regTraceArm_Arg0};
+static const iocshFuncDef    RFCFW_regTraceArm_FuncDef = {"RFCFW_regTraceArm", 1, RFCFW_regTraceArm_Args};
+static void  RFCFW_regTraceArm_CallFunc(const iocshArgBuf *args) {RFCFW_API_regTraceArm(args[0].ival);}
+
+/* RFCFW_API_regTraceFreeze(void) */
+static const iocshFuncDef    RFCFW_regTraceFreeze_FuncDef = {"RFCFW_regTraceFreeze", 0, NULL};
+static void  RFCFW_regTraceFreeze_CallFunc(const iocshArgBuf *args) {RFCFW_API_regTraceFreeze();}
+
+/* RFCFW_API_regTraceDump(const char *fileName, long num) */
+static const iocshArg        RFCFW_regTraceDump_Arg0    = {"fileName", iocshArgString};
+static const iocshArg        RFCFW_regTraceDump_Arg1    = {"num",      iocshArgInt};
+static const iocshArg *const RFCFW_regTraceDump_Args[2] = {&RFCFW_regTraceDump_Arg0, &RFCFW_regTraceDump_Arg1};
+static const iocshFuncDef    RFCFW_regTraceDump_FuncDef = {"RFCFW_regTraceDump", 2, RFCFW_regTraceDump_Args};
+static void  RFCFW_regTraceDump_CallFunc(const iocshArgBuf *args) {RFCFW_API_regTraceDump(args[0].sval, (long)args[1].ival);}
+
 void RFCFW_IOCShellRegister(void)
 {
     iocshRegister(&RFCFW_createModule_FuncDef,  RFCFW_createModule_CallFunc);
     iocshRegister(&RFCFW_deleteModule_FuncDef,  RFCFW_deleteModule_CallFunc);
     iocshRegister(&RFCFW_setupModule_FuncDef,   RFCFW_setupModule_CallFunc);
+    iocshRegister(&RFCFW_bringUpAll_FuncDef,    RFCFW_bringUpAll_CallFunc);
+    iocshRegister(&RFCFW_saveConfig_FuncDef,    RFCFW_saveConfig_CallFunc);
+    iocshRegister(&RFCFW_restoreConfig_FuncDef, RFCFW_restoreConfig_CallFunc);
+    iocshRegister(&RFCFW_createModuleAuto_FuncDef, RFCFW_createModuleAuto_CallFunc);
+    iocshRegister(&RFCFW_setBackendFwId_FuncDef,   RFCFW_setBackendFwId_CallFunc);
+    iocshRegister(&RFCFW_printBackends_FuncDef,    RFCFW_printBackends_CallFunc);
+    iocshRegister(&RFCFW_mapRegisters_FuncDef,     RFCFW_mapRegisters_CallFunc);
+    iocshRegister(&RFCFW_benchRegAccess_FuncDef,   RFCFW_benchRegAccess_CallFunc);
+    iocshRegister(&RFCFW_benchDeinterleave_FuncDef, RFCFW_benchDeinterleave_CallFunc);
+    iocshRegister(&RFCFW_burstStart_FuncDef,       RFCFW_burstStart_CallFunc);
+    iocshRegister(&RFCFW_burstDump_FuncDef,        RFCFW_burstDump_CallFunc);
+    iocshRegister(&RFCFW_profileEnable_FuncDef,    RFCFW_profileEnable_CallFunc);
+    iocshRegister(&RFCFW_profileReport_FuncDef,    RFCFW_profileReport_CallFunc);
+    iocshRegister(&RFCFW_regTraceArm_FuncDef,      RFCFW_regTraceArm_CallFunc);
+    iocshRegister(&RFCFW_regTraceFreeze_FuncDef,   RFCFW_regTraceFreeze_CallFunc);
+    iocshRegister(&RFCFW_regTraceDump_FuncDef,     RFCFW_regTraceDump_CallFunc);
 }
 
 epicsExportRegistrar(RFCFW_IOCShellRegister);
@@ -0,0 +1,192 @@
+/****************************************************
+ * RFControlFirmware_latency.c
+ *
+ * Latency breakdown of the pulse pipeline
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "InternalData.h"                                               /* to create EPICS data node */
+#include "RFControlFirmware_latency.h"
+
+/*======================================
+ * Global Data
+ *======================================*/
+const char *RFCFW_gvar_latStageName[RFCFW_CONST_LAT_STAGE_NUM] = {
+    "WAKE",
+    "COMMIT",
+    "INTR_DIS",
+    "RD_BRAM",
+    "RD_DAQ",
+    "DEINTLV",
+    "FEATURE",
+    "CONTROL",
+    "PUBLISH",
+    "BURST",
+    "CNT_STOP",
+    "CNT_ARM",
+    "TOTAL"
+};
+
+#ifdef RFCFW_ENABLE_PROFILING
+__thread RFCFW_struc_latency *RFCFW_gvar_latCur = NULL;                /* latency of the module of the pulse thread */
+#endif
+
+/*======================================
+ * Private Data and Routines - call backs
+ *======================================*/
+/* Read callback function, update the 99th percentile */
+static void r_getP99(void *ptr)
+{
+    INTD_struc_node      *dataNode = (INTD_struc_node *)ptr;
+    RFCFW_struc_profFunc *func;
+
+    if(!dataNode) return;
+    func = (RFCFW_struc_profFunc *)dataNode->privateData;
+
+    if(func) func -> p99_us = RFCFW_func_profPercentile(func, 0.99);
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Reset the statistics of all stages and the slowest pulse
+ */
+void RFCFW_func_latReset(RFCFW_struc_latency *lat)
+{
+    int i;
+
+    if(!lat) return;
+
+    for(i = 0; i < RFCFW_CONST_LAT_STAGE_NUM; i ++) {
+        RFCFW_func_timeStatsReset(&lat -> stage[i].stats);
+        memset((void *)lat -> stage[i].hist, 0, sizeof(lat -> stage[i].hist));
+        lat -> stage[i].p99_us = 0.0;
+        lat -> worst_us[i]     = 0.0;
+    }
+
+    lat -> pulseCnt   = 0;
+    lat -> worstPulse = 0;
+    lat -> reset      = 0;
+}
+
+/**
+ * Start a pulse at the wake-up from the interrupt. The former pulse is closed: the stage times are added to the
+ *   statistics and kept if it is the slowest pulse. The reset requested by the EPICS record is executed here, so that
+ *   the statistics are only changed by the pulse thread
+ * Input:
+ *   lat        : Latency of the module
+ */
+void RFCFW_func_latStart(RFCFW_struc_latency *lat)
+{
+    int i;
+
+    if(!lat) return;
+
+    /* close the former pulse */
+    if(lat -> active) {
+        lat -> cur_us[RFCFW_CONST_LAT_TOTAL] = lat -> lastTime_us - lat -> wakeTime_us;
+        lat -> curMask |= 1UL << RFCFW_CONST_LAT_TOTAL;
+
+        for(i = 0; i < RFCFW_CONST_LAT_STAGE_NUM; i ++) {
+            if(lat -> curMask & (1UL << i)) RFCFW_func_profFuncUpdate(&lat -> stage[i], lat -> cur_us[i]);
+        }
+
+        lat -> pulseCnt ++;
+
+        if(lat -> pulseCnt == 1 || lat -> cur_us[RFCFW_CONST_LAT_TOTAL] > lat -> worst_us[RFCFW_CONST_LAT_TOTAL]) {
+            for(i = 0; i < RFCFW_CONST_LAT_STAGE_NUM; i ++) lat -> worst_us[i] = lat -> cur_us[i];
+            lat -> worstPulse = lat -> pulseCnt;
+        }
+
+        lat -> active = 0;
+    }
+
+    if(lat -> reset) RFCFW_func_latReset(lat);
+
+    if(!lat -> enable) return;
+
+    /* start the new pulse */
+    lat -> wakeTime_us = RFCFW_func_getTime_us();
+    lat -> markTime_us = lat -> wakeTime_us;
+    lat -> lastTime_us = lat -> wakeTime_us;
+    lat -> curMask     = 0;
+    lat -> active      = 1;
+
+    memset((void *)lat -> cur_us, 0, sizeof(lat -> cur_us));
+}
+
+/**
+ * Mark the end of a stage, the time from the former mark (or begin) is added to the stage
+ * Input:
+ *   lat        : Latency of the module
+ *   stage      : Stage, RFCFW_CONST_LAT_*
+ */
+void RFCFW_func_latMark(RFCFW_struc_latency *lat, int stage)
+{
+    double var_time_us;
+
+    if(!lat || !lat -> active || stage < 0 || stage >= RFCFW_CONST_LAT_TOTAL) return;
+
+    var_time_us = RFCFW_func_getTime_us();
+
+    lat -> cur_us[stage] += var_time_us - lat -> markTime_us;
+    lat -> curMask       |= 1UL << stage;
+    lat -> markTime_us    = var_time_us;
+    lat -> lastTime_us    = var_time_us;
+}
+
+/**
+ * Set the time of a stage measured otherwise (e.g. the wake-up latency from the counter of the firmware)
+ * Input:
+ *   lat        : Latency of the module
+ *   stage      : Stage, RFCFW_CONST_LAT_*
+ *   time_us    : Time of the stage
+ */
+void RFCFW_func_latSet(RFCFW_struc_latency *lat, int stage, double time_us)
+{
+    if(!lat || !lat -> active || stage < 0 || stage >= RFCFW_CONST_LAT_TOTAL) return;
+
+    lat -> cur_us[stage]  = time_us;
+    lat -> curMask       |= 1UL << stage;
+}
+
+/**
+ * Create data nodes for the latency, the names are LAT_<stage>_CUR/MIN/MAX/AVG/CNT/OVR/RST/P99/WORST
+ * Input:
+ *   moduleName     : Name of the module
+ *   lat            : Latency of the module
+ * Return:
+ *   0              : Successful
+ *  <=-1            : Failed
+ */
+int RFCFW_func_latCreateData(const char *moduleName, RFCFW_struc_latency *lat)
+{
+    int  i;
+    int  status = 0;
+    char var_dataName[64];
+
+    /* check the input */
+    if(!moduleName || !moduleName[0] || !lat) return -1;
+
+    status += INTD_API_createDataNode(moduleName, "LAT_ENABLE",      (void *)(&lat -> enable),     (void *)lat, 1, NULL, INTD_USHORT, NULL, NULL, NULL, NULL, INTD_BO, INTD_PASSIVE);  /* w */
+    status += INTD_API_createDataNode(moduleName, "LAT_RST",         (void *)(&lat -> reset),      (void *)lat, 1, NULL, INTD_USHORT, NULL, NULL, NULL, NULL, INTD_BO, INTD_PASSIVE);  /* w, executed at next pulse */
+    status += INTD_API_createDataNode(moduleName, "LAT_PUL_CNT",     (void *)(&lat -> pulseCnt),   (void *)lat, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);       /* r */
+    status += INTD_API_createDataNode(moduleName, "LAT_WORST_PUL",   (void *)(&lat -> worstPulse), (void *)lat, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);       /* r */
+
+    for(i = 0; i < RFCFW_CONST_LAT_STAGE_NUM; i ++) {
+        snprintf(var_dataName, sizeof(var_dataName), "LAT_%s", RFCFW_gvar_latStageName[i]);
+        status += RFCFW_func_timeStatsCreateData(moduleName, var_dataName, &lat -> stage[i].stats);
+
+        snprintf(var_dataName, sizeof(var_dataName), "LAT_%s_P99", RFCFW_gvar_latStageName[i]);
+        status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&lat -> stage[i].p99_us), (void *)(&lat -> stage[i]), 1, NULL, INTD_DOUBLE, r_getP99, NULL, NULL, NULL, INTD_AI, INTD_1S);  /* r */
+
+        snprintf(var_dataName, sizeof(var_dataName), "LAT_%s_WORST", RFCFW_gvar_latStageName[i]);
+        status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&lat -> worst_us[i]),     (void *)lat,                1, NULL, INTD_DOUBLE, NULL,     NULL, NULL, NULL, INTD_AI, INTD_1S);  /* r */
+    }
+
+    return status;
+}
+
@@ -0,0 +1,106 @@
+/****************************************************
+ * RFControlFirmware_latency.h
+ *
+ * Latency breakdown of the pulse pipeline. Each stage of the processing of a pulse, from the wake-up after the interrupt
+ *   to the publishing, is timed with the monotonic clock. The statistics and the histogram (see the profiling) are kept
+ *   for each stage, together with the stage times of the slowest pulse since the reset.
+ *
+ * The latency of the module is attached to the pulse thread by the dispatch of the wait of the interrupt (RFCFW_LAT_ARM),
+ *   so that the backends mark the stages without knowing the module. The pulse is started at the wake-up from the
+ *   interrupt (RFCFW_LAT_START) and closed at the wake-up of the next pulse, so the order of the calls of the upper module
+ *   does not matter. A stage is the time from the former mark (or begin) to its mark, the stages marked several times in
+ *   a pulse are accumulated. The marks in other threads (e.g. the asynchronous readout) are ignored.
+ *
+ * The wake-up latency is derived from the IRQ delay counter of the firmware (interrupt to the stop of the counter) minus
+ *   the time from the wake-up to the former mark (the stop of the counter), RFCFW_LAT_SET_WAKE.
+ *
+ * The hooks are compiled only if RFCFW_ENABLE_PROFILING is defined (see the Makefile), and switchable at run time
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_LATENCY_H
+#define RF_CONTROL_FIRMWARE_LATENCY_H
+
+#include "RFControlFirmware_profile.h"                          /* statistics and histogram of the duration */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Stages of the pulse pipeline, the order is the same as the names in RFCFW_gvar_latStageName
+ */
+#define RFCFW_CONST_LAT_WAKE            0                       /* interrupt to the wake-up, from the IRQ delay counter of the firmware */
+#define RFCFW_CONST_LAT_COMMIT          1                       /* commit of the staged parameters */
+#define RFCFW_CONST_LAT_INTR_DIS        2                       /* interrupt disabled (Struck only, EICSYS does not disable it) */
+#define RFCFW_CONST_LAT_READ_BRAM       3                       /* readout of the internal data from the BRAM */
+#define RFCFW_CONST_LAT_READ_DAQ        4                       /* readout of the DRAM or set up of the DMA pool */
+#define RFCFW_CONST_LAT_DEINTLV         5                       /* deinterleave and format conversion of the data */
+#define RFCFW_CONST_LAT_FEATURE         6                       /* scalar features of the waveforms */
+#define RFCFW_CONST_LAT_CONTROL         7                       /* pulse-to-pulse feedback and iterative learning */
+#define RFCFW_CONST_LAT_PUBLISH         8                       /* queue of the readout to the EPICS publishing */
+#define RFCFW_CONST_LAT_BURST           9                       /* burst capture of the ADC data (Struck only) */
+#define RFCFW_CONST_LAT_CNT_STOP        10                      /* IRQ delay counter stopped (on Struck with the interrupt re-enabled) */
+#define RFCFW_CONST_LAT_CNT_ARM         11                      /* IRQ delay counter read and enabled for the next pulse */
+#define RFCFW_CONST_LAT_TOTAL           12                      /* wake-up to the end of the last stage */
+#define RFCFW_CONST_LAT_STAGE_NUM       13
+
+/**
+ * Latency of a module
+ */
+typedef struct {
+    volatile unsigned short enable;                         /* 1 to enable the measurement */
+    volatile unsigned short reset;                          /* write 1 to reset the statistics and the slowest pulse */
+
+    RFCFW_struc_profFunc stage[RFCFW_CONST_LAT_STAGE_NUM];  /* statistics and histogram of each stage */
+
+    /* pulse being measured */
+    int    active;                                          /* 1 if a pulse is started */
+    double wakeTime_us;                                     /* time of the wake-up */
+    double markTime_us;                                     /* time of the former mark */
+    double lastTime_us;                                     /* end of the last stage */
+    double cur_us[RFCFW_CONST_LAT_STAGE_NUM];               /* stage times */
+    unsigned long curMask;                                  /* stages marked */
+
+    /* slowest pulse since the reset */
+    volatile long   pulseCnt;                               /* pulses measured */
+    volatile long   worstPulse;                             /* pulse number of the slowest pulse */
+    volatile double worst_us[RFCFW_CONST_LAT_STAGE_NUM];    /* stage times of the slowest pulse */
+} RFCFW_struc_latency;
+
+/**
+ * Hooks in the pulse pipeline, empty if the profiling is not compiled
+ */
+#ifdef RFCFW_ENABLE_PROFILING
+extern __thread RFCFW_struc_latency *RFCFW_gvar_latCur;
+
+#define RFCFW_LAT_ARM(lat)              (RFCFW_gvar_latCur = (lat))
+#define RFCFW_LAT_START()               do { if(RFCFW_gvar_latCur) RFCFW_func_latStart(RFCFW_gvar_latCur); } while(0)
+#define RFCFW_LAT_BEGIN()               do { if(RFCFW_gvar_latCur && RFCFW_gvar_latCur -> active) RFCFW_gvar_latCur -> markTime_us = RFCFW_func_getTime_us(); } while(0)
+#define RFCFW_LAT_MARK(stage)           do { if(RFCFW_gvar_latCur) RFCFW_func_latMark(RFCFW_gvar_latCur, (stage)); } while(0)
+#define RFCFW_LAT_SET_WAKE(irq_us)      do { if(RFCFW_gvar_latCur) RFCFW_func_latSet(RFCFW_gvar_latCur, RFCFW_CONST_LAT_WAKE, \
+                                             (irq_us) - (RFCFW_gvar_latCur -> markTime_us - RFCFW_gvar_latCur -> wakeTime_us)); } while(0)
+#else
+#define RFCFW_LAT_ARM(lat)              ((void)0)
+#define RFCFW_LAT_START()               ((void)0)
+#define RFCFW_LAT_BEGIN()               ((void)0)
+#define RFCFW_LAT_MARK(stage)           ((void)0)
+#define RFCFW_LAT_SET_WAKE(irq_us)      ((void)0)
+#endif
+
+/**
+ * Routines
+ */
+extern const char *RFCFW_gvar_latStageName[RFCFW_CONST_LAT_STAGE_NUM];
+
+void RFCFW_func_latReset(RFCFW_struc_latency *lat);
+void RFCFW_func_latStart(RFCFW_struc_latency *lat);                                     /* close the former pulse and start a new one */
+void RFCFW_func_latMark(RFCFW_struc_latency *lat, int stage);                           /* end of a stage */
+void RFCFW_func_latSet(RFCFW_struc_latency *lat, int stage, double time_us);            /* stage time measured otherwise */
+
+int  RFCFW_func_latCreateData(const char *moduleName, RFCFW_struc_latency *lat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -24,6 +24,9 @@ int RFCFW_func_createModule(RFCFW_struc_moduleData *arg, const char *moduleName)
     /* Init the data structure */
     strcpy(arg -> moduleName, moduleName);
 
+    arg -> fwMutex = epicsMutexCreate();
+    if(!arg -> fwMutex) return -1;
+
     return 0;
 }
 
@@ -35,8 +38,20 @@ int RFCFW_func_destroyModule(RFCFW_struc_moduleData *arg)
     /* Check the input */
     if(!arg) return -1;
 
-    /* Delete the data structure for firmware */
-    if(arg -> fwModule) free(arg -> fwModule);
+    /* Stop the asynchronous readout, which uses the data structure for firmware */
+    if(RFCFW_func_daqAsyncDeinit(&arg -> daqAsync) != 0) return -1;
+
+    /* Delete the data structure for firmware, release its resources first */
+    if(arg -> fwModule) {
+        if(arg -> fwFunc.FWC_func_deinit) arg -> fwFunc.FWC_func_deinit(arg -> fwModule);
+        free(arg -> fwModule);
+        arg -> fwModule = NULL;
+    }
+
+    if(arg -> fwMutex) {
+        epicsMutexDestroy(arg -> fwMutex);
+        arg -> fwMutex = NULL;
+    }
 
     return 0;
 }
@@ -65,7 +80,12 @@ int RFCFW_func_associateBoardModule(RFCFW_struc_moduleData *arg, const char *boa
 int RFCFW_func_initModule(RFCFW_struc_moduleData *arg)
 {
     if(arg && arg -> fwFunc.FWC_func_init) {
-        return arg -> fwFunc.FWC_func_init(arg -> fwModule);
+        if(arg -> fwFunc.FWC_func_init(arg -> fwModule) != 0) return -1;
+
+        /* the record callbacks of the firmware control serialize with the asynchronous readout as well */
+        if(arg -> fwFunc.FWC_func_setLock) return arg -> fwFunc.FWC_func_setLock(arg -> fwModule, arg -> fwMutex);
+
+        return 0;
     }
 
     return -1;
@@ -77,7 +97,12 @@ int RFCFW_func_initModule(RFCFW_struc_moduleData *arg)
 int RFCFW_func_createEpicsData(RFCFW_struc_moduleData *arg)
 {
     if(arg && arg -> fwFunc.FWC_func_createEpicsData) {
-        return arg -> fwFunc.FWC_func_createEpicsData(arg -> fwModule, arg -> moduleName);
+#ifdef RFCFW_ENABLE_PROFILING
+        RFCFW_func_profCreateData(arg -> moduleName, &arg -> prof);
+        RFCFW_func_latCreateData(arg -> moduleName, &arg -> lat);
+#endif
+        return arg -> fwFunc.FWC_func_createEpicsData(arg -> fwModule, arg -> moduleName) +
+               RFCFW_func_daqAsyncCreateData(arg -> moduleName, &arg -> daqAsync);
     }
 
     return -1;
@@ -100,8 +125,46 @@ int RFCFW_func_deleteEpicsData(RFCFW_struc_moduleData *arg)
  */
 int RFCFW_func_getDAQData(RFCFW_struc_moduleData *arg)
 {
+    int    var_status;
+    double var_profStart_us;
+
     if(arg && arg -> fwFunc.FWC_func_getDAQData) {
-        return arg -> fwFunc.FWC_func_getDAQData(arg -> fwModule);
+        /* do not overlap with the asynchronous readout in flight */
+        if(RFCFW_func_daqAsyncBusy(&arg -> daqAsync)) RFCFW_func_daqAsyncWait(&arg -> daqAsync, 0, NULL);
+
+        RFCFW_PROF_START(&arg -> prof, var_profStart_us);
+        RFCFW_REG_TRACE_ENTER(RFCFW_CONST_PROF_GET_DAQ_DATA);
+        var_status = arg -> fwFunc.FWC_func_getDAQData(arg -> fwModule);
+        RFCFW_REG_TRACE_LEAVE();
+        RFCFW_PROF_STOP(&arg -> prof, RFCFW_CONST_PROF_GET_DAQ_DATA, var_profStart_us);
+        return var_status;
+    }
+
+    return -1;
+}
+
+/**
+ * Start the readout of the DAQ data and return immediately, the call back is called in the worker thread of the module
+ *   when the readout is finished. The worker thread is created at the first call
+ */
+int RFCFW_func_getDAQDataAsync(RFCFW_struc_moduleData *arg, RFCFW_FUNCPTR_DAQ_DONE callback, void *userPvt)
+{
+    if(arg && arg -> fwFunc.FWC_func_getDAQData) {
+        if(RFCFW_func_daqAsyncInit(&arg -> daqAsync, arg -> moduleName, arg -> fwFunc.FWC_func_getDAQData, arg -> fwModule, arg -> fwMutex) != 0) return -1;
+
+        return RFCFW_func_daqAsyncStart(&arg -> daqAsync, callback, userPvt);
+    }
+
+    return -1;
+}
+
+/**
+ * Wait for the asynchronous readout of the DAQ data. Return 0 when finished (status of the readout in status), 1 for timeout
+ */
+int RFCFW_func_waitDAQData(RFCFW_struc_moduleData *arg, double timeout_s, int *status)
+{
+    if(arg) {
+        return RFCFW_func_daqAsyncWait(&arg -> daqAsync, timeout_s, status);
     }
 
     return -1;
@@ -112,8 +175,19 @@ int RFCFW_func_getDAQData(RFCFW_struc_moduleData *arg)
  */
 int RFCFW_func_getADCData(RFCFW_struc_moduleData *arg, unsigned long channel, short *data, double *sampleFreq_MHz, double *sampleDelay_ns, long *pno, long *coefIdCur)
 {
+    int    var_status;
+    double var_profStart_us;
+
     if(arg && arg -> fwFunc.FWC_func_getADCData) {
-        return arg -> fwFunc.FWC_func_getADCData(arg -> fwModule, channel, data, sampleFreq_MHz, sampleDelay_ns, pno, coefIdCur);
+        /* do not read the buffers while the asynchronous readout in flight fills them */
+        if(RFCFW_func_daqAsyncBusy(&arg -> daqAsync)) RFCFW_func_daqAsyncWait(&arg -> daqAsync, 0, NULL);
+
+        RFCFW_PROF_START(&arg -> prof, var_profStart_us);
+        RFCFW_REG_TRACE_ENTER(RFCFW_CONST_PROF_GET_ADC_DATA);
+        var_status = arg -> fwFunc.FWC_func_getADCData(arg -> fwModule, channel, data, sampleFreq_MHz, sampleDelay_ns, pno, coefIdCur);
+        RFCFW_REG_TRACE_LEAVE();
+        RFCFW_PROF_STOP(&arg -> prof, RFCFW_CONST_PROF_GET_ADC_DATA, var_profStart_us);
+        return var_status;
     }
 
     return -1;
@@ -124,8 +198,19 @@ int RFCFW_func_getADCData(RFCFW_struc_moduleData *arg, unsigned long channel, sh
  */
 int RFCFW_func_getIntData(RFCFW_struc_moduleData *arg)
 {
+    int    var_status;
+    double var_profStart_us;
+
     if(arg && arg -> fwFunc.FWC_func_getIntData) {
-       return arg -> fwFunc.FWC_func_getIntData(arg -> fwModule);
+       /* do not read the buffers while the asynchronous readout in flight fills them */
+       if(RFCFW_func_daqAsyncBusy(&arg -> daqAsync)) RFCFW_func_daqAsyncWait(&arg -> daqAsync, 0, NULL);
+
+       RFCFW_PROF_START(&arg -> prof, var_profStart_us);
+       RFCFW_REG_TRACE_ENTER(RFCFW_CONST_PROF_GET_INT_DATA);
+       var_status = arg -> fwFunc.FWC_func_getIntData(arg -> fwModule);
+       RFCFW_REG_TRACE_LEAVE();
+       RFCFW_PROF_STOP(&arg -> prof, RFCFW_CONST_PROF_GET_INT_DATA, var_profStart_us);
+       return var_status;
     }
 
     return -1;
@@ -136,8 +221,18 @@ int RFCFW_func_getIntData(RFCFW_struc_moduleData *arg)
  */
 int RFCFW_func_setPha_deg(RFCFW_struc_moduleData *arg, double pha_deg)
 {
+    int    var_status;
+    double var_profStart_us;
+
     if(arg && arg -> fwFunc.FWC_func_setPha_deg) {
-       return arg -> fwFunc.FWC_func_setPha_deg(arg -> fwModule, pha_deg);
+       RFCFW_PROF_START(&arg -> prof, var_profStart_us);
+       RFCFW_REG_TRACE_ENTER(RFCFW_CONST_PROF_SET_PHA);
+       epicsMutexMustLock(arg -> fwMutex);                          /* not while the asynchronous readout writes the registers */
+       var_status = arg -> fwFunc.FWC_func_setPha_deg(arg -> fwModule, pha_deg);
+       epicsMutexUnlock(arg -> fwMutex);
+       RFCFW_REG_TRACE_LEAVE();
+       RFCFW_PROF_STOP(&arg -> prof, RFCFW_CONST_PROF_SET_PHA, var_profStart_us);
+       return var_status;
     }
 
     return -1;
@@ -148,8 +243,18 @@ int RFCFW_func_setPha_deg(RFCFW_struc_moduleData *arg, double pha_deg)
  */
 int RFCFW_func_setAmp(RFCFW_struc_moduleData *arg, double amp)
 {
+    int    var_status;
+    double var_profStart_us;
+
     if(arg && arg -> fwFunc.FWC_func_setAmp) {
-       return arg -> fwFunc.FWC_func_setAmp(arg -> fwModule, amp);
+       RFCFW_PROF_START(&arg -> prof, var_profStart_us);
+       RFCFW_REG_TRACE_ENTER(RFCFW_CONST_PROF_SET_AMP);
+       epicsMutexMustLock(arg -> fwMutex);                          /* not while the asynchronous readout writes the registers */
+       var_status = arg -> fwFunc.FWC_func_setAmp(arg -> fwModule, amp);
+       epicsMutexUnlock(arg -> fwMutex);
+       RFCFW_REG_TRACE_LEAVE();
+       RFCFW_PROF_STOP(&arg -> prof, RFCFW_CONST_PROF_SET_AMP, var_profStart_us);
+       return var_status;
     }
 
     return -1;
@@ -160,8 +265,17 @@ int RFCFW_func_setAmp(RFCFW_struc_moduleData *arg, double amp)
  */
 int RFCFW_func_waitIntr(RFCFW_struc_moduleData *arg)
 {
+    int    var_status;
+    double var_profStart_us;
+
     if(arg && arg -> fwFunc.FWC_func_waitIntr) {
-       return arg -> fwFunc.FWC_func_waitIntr(arg -> fwModule);
+       RFCFW_LAT_ARM(&arg -> lat);                                  /* the pulse is started by the backend at the wake-up */
+       RFCFW_PROF_START(&arg -> prof, var_profStart_us);
+       RFCFW_REG_TRACE_ENTER(RFCFW_CONST_PROF_WAIT_INTR);
+       var_status = arg -> fwFunc.FWC_func_waitIntr(arg -> fwModule);
+       RFCFW_REG_TRACE_LEAVE();
+       RFCFW_PROF_STOP(&arg -> prof, RFCFW_CONST_PROF_WAIT_INTR, var_profStart_us);
+       return var_status;
     }
 
     return -1;
@@ -172,20 +286,61 @@ int RFCFW_func_waitIntr(RFCFW_struc_moduleData *arg)
  */
 int RFCFW_func_meaIntrLatency(RFCFW_struc_moduleData *arg, long *latencyCnt, long *pulseCnt)
 {
+    int    var_status;
+    double var_profStart_us;
+
     if(arg && arg -> fwFunc.FWC_func_meaIntrLatency) {
-       return arg -> fwFunc.FWC_func_meaIntrLatency(arg -> fwModule, latencyCnt, pulseCnt);
+       RFCFW_PROF_START(&arg -> prof, var_profStart_us);
+       RFCFW_REG_TRACE_ENTER(RFCFW_CONST_PROF_MEA_INTR_LATENCY);
+       var_status = arg -> fwFunc.FWC_func_meaIntrLatency(arg -> fwModule, latencyCnt, pulseCnt);
+       RFCFW_REG_TRACE_LEAVE();
+       RFCFW_PROF_STOP(&arg -> prof, RFCFW_CONST_PROF_MEA_INTR_LATENCY, var_profStart_us);
+       return var_status;
     }
 
     return -1;
 }
 
+/**
+ * Bring up the board (setup SPI, read firmware info). Call the virtual function. The elapsed time is recorded in the module.
+ *   The SPI is only setup if the backend supports it (RFCFW_CAP_SPI_SETUP)
+ */
+int RFCFW_func_bringUp(RFCFW_struc_moduleData *arg, int setupSPI)
+{
+    double var_startTime_us;
 
+    if(arg && arg -> fwFunc.FWC_func_bringUp) {
+        if(!arg -> backend || !(arg -> backend -> caps & RFCFW_CAP_SPI_SETUP)) setupSPI = 0;
 
+        var_startTime_us      = RFCFW_func_getTime_us();
+        arg -> bringUpStatus  = arg -> fwFunc.FWC_func_bringUp(arg -> fwModule, setupSPI);
+        arg -> bringUpTime_us = RFCFW_func_getTime_us() - var_startTime_us;
+        return arg -> bringUpStatus;
+    }
 
+    return -1;
+}
 
+/**
+ * Save the settings to a file. Call the virtual function.
+ */
+int RFCFW_func_saveConfig(RFCFW_struc_moduleData *arg, const char *fileName)
+{
+    if(arg && arg -> fwFunc.FWC_func_saveConfig) {
+       return arg -> fwFunc.FWC_func_saveConfig(arg -> fwModule, fileName);
+    }
 
+    return -1;
+}
 
+/**
+ * Restore the settings from a file. Call the virtual function.
+ */
+int RFCFW_func_restoreConfig(RFCFW_struc_moduleData *arg, const char *fileName)
+{
+    if(arg && arg -> fwFunc.FWC_func_restoreConfig) {
+       return arg -> fwFunc.FWC_func_restoreConfig(arg -> fwModule, fileName);
+    }
 
-
-
-
+    return -1;
+}
@@ -16,6 +16,11 @@
 #include "EPICSLib_wrapper.h"
 
 #include "RFControlFirmware_requiredInterface_fwCtrlVirtual.h"
+#include "RFControlFirmware_backend.h"
+#include "RFControlFirmware_daqAsync.h"
+#include "RFControlFirmware_profile.h"
+#include "RFControlFirmware_regTrace.h"
+#include "RFControlFirmware_latency.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +38,18 @@ typedef struct {
 
     void *fwModule;                                         /* data structure of the firmware control, there maybe multitypes of the fw module, so use void pointer */    
     RFCFW_struc_fwAccessFunc fwFunc;                        /* virtual functions for firmware access */                    
+    const RFCFW_struc_backend *backend;                     /* descriptor of the firmware backend */
+
+    int    bringUpStatus;                                   /* result of the latest bring-up of the board (0 - successful) */
+    double bringUpTime_us;                                  /* elapsed time of the latest bring-up of the board */
+
+    epicsMutexId fwMutex;                                   /* serialize the asynchronous readout with the control writes */
+    RFCFW_struc_daqAsync daqAsync;                          /* asynchronous readout of the DAQ data */
+
+#ifdef RFCFW_ENABLE_PROFILING
+    RFCFW_struc_profile prof;                               /* profiles of the dispatch of the virtual functions */
+    RFCFW_struc_latency lat;                                /* latency breakdown of the pulse pipeline */
+#endif
 
 } RFCFW_struc_moduleData;
 
@@ -50,6 +67,8 @@ int RFCFW_func_deleteEpicsData(RFCFW_struc_moduleData *arg);
 
 /*--- functions to serve the external client (called by higher level module) ---*/ 
 int RFCFW_func_getDAQData(RFCFW_struc_moduleData *arg);
+int RFCFW_func_getDAQDataAsync(RFCFW_struc_moduleData *arg, RFCFW_FUNCPTR_DAQ_DONE callback, void *userPvt);   /* start the readout and return */
+int RFCFW_func_waitDAQData(RFCFW_struc_moduleData *arg, double timeout_s, int *status);                       /* wait for the readout started */
 int RFCFW_func_getADCData(RFCFW_struc_moduleData *arg, unsigned long channel, short *data, double *sampleFreq_MHz, double *sampleDelay_ns, long *pno, long *coefIdCur);
 int RFCFW_func_getIntData(RFCFW_struc_moduleData *arg);
 
@@ -59,6 +78,11 @@ int RFCFW_func_setAmp(RFCFW_struc_moduleData *arg, double amp);
 int RFCFW_func_waitIntr(RFCFW_struc_moduleData *arg);
 int RFCFW_func_meaIntrLatency(RFCFW_struc_moduleData *arg, long *latencyCnt, long *pulseCnt);
 
+int RFCFW_func_bringUp(RFCFW_struc_moduleData *arg, int setupSPI);
+
+int RFCFW_func_saveConfig(RFCFW_struc_moduleData *arg, const char *fileName);
+int RFCFW_func_restoreConfig(RFCFW_struc_moduleData *arg, const char *fileName);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,209 @@
+/****************************************************
+ * RFControlFirmware_profile.c
+ *
+ * Profiling of the dispatch of the virtual functions (RFCFW_func_*)
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "InternalData.h"                                               /* to create EPICS data node */
+#include "RFControlFirmware_profile.h"
+
+/*======================================
+ * Global Data
+ *======================================*/
+const char *RFCFW_gvar_profFuncName[RFCFW_CONST_PROF_FUNC_NUM] = {
+    "GET_DAQ",                                                          /* RFCFW_func_getDAQData */
+    "GET_ADC",                                                          /* RFCFW_func_getADCData */
+    "GET_INT",                                                          /* RFCFW_func_getIntData */
+    "SET_PHA",                                                          /* RFCFW_func_setPha_deg */
+    "SET_AMP",                                                          /* RFCFW_func_setAmp */
+    "WAIT_INTR",                                                        /* RFCFW_func_waitIntr */
+    "MEA_LAT"                                                           /* RFCFW_func_meaIntrLatency */
+};
+
+/*======================================
+ * Private Data and Routines - call backs
+ *======================================*/
+/* Write callback function, reset all profiles */
+static void w_resetProf(void *ptr)
+{
+    INTD_struc_node     *dataNode = (INTD_struc_node *)ptr;
+    RFCFW_struc_profile *prof;
+
+    if(!dataNode) return;
+    prof = (RFCFW_struc_profile *)dataNode->privateData;
+
+    if(prof && prof -> reset == 1) {
+        RFCFW_func_profReset(prof);
+    }
+}
+
+/* Read callback function, update the 99th percentile */
+static void r_getP99(void *ptr)
+{
+    INTD_struc_node      *dataNode = (INTD_struc_node *)ptr;
+    RFCFW_struc_profFunc *func;
+
+    if(!dataNode) return;
+    func = (RFCFW_struc_profFunc *)dataNode->privateData;
+
+    if(func) func -> p99_us = RFCFW_func_profPercentile(func, 0.99);
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Reset all profiles of the module
+ */
+void RFCFW_func_profReset(RFCFW_struc_profile *prof)
+{
+    int i;
+
+    if(!prof) return;
+
+    for(i = 0; i < RFCFW_CONST_PROF_FUNC_NUM; i ++) {
+        RFCFW_func_timeStatsReset(&prof -> func[i].stats);
+        memset((void *)prof -> func[i].hist, 0, sizeof(prof -> func[i].hist));
+        prof -> func[i].p99_us = 0.0;
+    }
+
+    prof -> reset = 0;
+}
+
+/**
+ * Add a call to the profile of a function
+ * Input:
+ *   prof       : Profiles of the module
+ *   funcId     : Function, RFCFW_CONST_PROF_*
+ *   time_us    : Duration of the call in us
+ */
+void RFCFW_func_profUpdate(RFCFW_struc_profile *prof, int funcId, double time_us)
+{
+    if(!prof || funcId < 0 || funcId >= RFCFW_CONST_PROF_FUNC_NUM) return;
+
+    RFCFW_func_profFuncUpdate(&prof -> func[funcId], time_us);
+}
+
+/**
+ * Add a duration to the statistics and the histogram of a function (or any other measured item)
+ * Input:
+ *   ptr_func   : Profile of the function
+ *   time_us    : Duration in us
+ */
+void RFCFW_func_profFuncUpdate(RFCFW_struc_profFunc *ptr_func, double time_us)
+{
+    int var_bin;
+
+    if(!ptr_func) return;
+
+    /* the statistics have been reset separately (e.g. via its data node), clear the histogram as well */
+    if(ptr_func -> stats.cnt <= 0) memset((void *)ptr_func -> hist, 0, sizeof(ptr_func -> hist));
+
+    RFCFW_func_timeStatsUpdate(&ptr_func -> stats, time_us, 0.0);
+
+    if(time_us <= RFCFW_CONST_PROF_BIN_START_US) var_bin = 0;
+    else var_bin = (int)(RFCFW_CONST_PROF_BIN_PER_OCT * log2(time_us / RFCFW_CONST_PROF_BIN_START_US));
+
+    if(var_bin >= RFCFW_CONST_PROF_BIN_NUM) var_bin = RFCFW_CONST_PROF_BIN_NUM - 1;
+
+    ptr_func -> hist[var_bin] ++;
+}
+
+/**
+ * Get the percentile of the duration from the histogram, the upper edge of the bin is returned so that the value is
+ *   not underestimated (max. 19% above the real value)
+ * Input:
+ *   func       : Profile of the function
+ *   ratio      : Ratio of the calls, e.g. 0.99 for the 99th percentile
+ * Return:
+ *   Duration in us, 0 if no calls
+ */
+double RFCFW_func_profPercentile(RFCFW_struc_profFunc *func, double ratio)
+{
+    int    i;
+    long   var_total = 0;
+    long   var_sum   = 0;
+    double var_edge_us;
+
+    if(!func) return 0.0;
+
+    for(i = 0; i < RFCFW_CONST_PROF_BIN_NUM; i ++) var_total += func -> hist[i];
+
+    if(var_total <= 0) return 0.0;
+
+    for(i = 0; i < RFCFW_CONST_PROF_BIN_NUM; i ++) {
+        var_sum += func -> hist[i];
+        if((double)var_sum >= ratio * (double)var_total) break;
+    }
+
+    /* the last bin has no upper edge */
+    if(i >= RFCFW_CONST_PROF_BIN_NUM - 1) return func -> stats.max_us;
+
+    var_edge_us = RFCFW_CONST_PROF_BIN_START_US * pow(2.0, (double)(i + 1) / RFCFW_CONST_PROF_BIN_PER_OCT);
+
+    /* the edge can be larger than the maximum */
+    return (var_edge_us < func -> stats.max_us) ? var_edge_us : func -> stats.max_us;
+}
+
+/**
+ * Print the profiles of the module
+ * Input:
+ *   prof       : Profiles of the module
+ *   moduleName : Name of the module, for the print only
+ */
+void RFCFW_func_profReport(RFCFW_struc_profile *prof, const char *moduleName)
+{
+    int i;
+    RFCFW_struc_profFunc *ptr_func;
+
+    if(!prof) return;
+
+    printf("Profile of %s (%s):\n", moduleName ? moduleName : "", prof -> enable ? "enabled" : "disabled");
+    printf("    %-10s %10s %12s %12s %12s %12s %12s\n", "function", "calls", "min(us)", "mean(us)", "max(us)", "p99(us)", "total(ms)");
+
+    for(i = 0; i < RFCFW_CONST_PROF_FUNC_NUM; i ++) {
+        ptr_func = &prof -> func[i];
+        ptr_func -> p99_us = RFCFW_func_profPercentile(ptr_func, 0.99);
+
+        printf("    %-10s %10ld %12.2f %12.2f %12.2f %12.2f %12.2f\n", RFCFW_gvar_profFuncName[i], ptr_func -> stats.cnt,
+               ptr_func -> stats.min_us, ptr_func -> stats.avg_us, ptr_func -> stats.max_us, ptr_func -> p99_us,
+               ptr_func -> stats.avg_us * ptr_func -> stats.cnt * 1.0e-3);
+    }
+}
+
+/**
+ * Create data nodes for the profiles, the names are PROF_<function>_CUR/MIN/MAX/AVG/CNT/OVR/RST/P99
+ * Input:
+ *   moduleName     : Name of the high level module (RFControl)
+ *   prof           : Profiles of the module
+ * Return:
+ *   0              : Successful
+ *  <=-1            : Failed
+ */
+int RFCFW_func_profCreateData(const char *moduleName, RFCFW_struc_profile *prof)
+{
+    int  i;
+    int  status = 0;
+    char var_dataName[64];
+
+    /* check the input */
+    if(!moduleName || !moduleName[0] || !prof) return -1;
+
+    status += INTD_API_createDataNode(moduleName, "PROF_ENABLE", (void *)(&prof -> enable), (void *)prof, 1, NULL, INTD_USHORT, NULL, NULL,        NULL, NULL, INTD_BO, INTD_PASSIVE);  /* w */
+    status += INTD_API_createDataNode(moduleName, "PROF_RST",    (void *)(&prof -> reset),  (void *)prof, 1, NULL, INTD_USHORT, NULL, w_resetProf, NULL, NULL, INTD_BO, INTD_PASSIVE);  /* w */
+
+    for(i = 0; i < RFCFW_CONST_PROF_FUNC_NUM; i ++) {
+        snprintf(var_dataName, sizeof(var_dataName), "PROF_%s", RFCFW_gvar_profFuncName[i]);
+        status += RFCFW_func_timeStatsCreateData(moduleName, var_dataName, &prof -> func[i].stats);
+
+        snprintf(var_dataName, sizeof(var_dataName), "PROF_%s_P99", RFCFW_gvar_profFuncName[i]);
+        status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&prof -> func[i].p99_us), (void *)(&prof -> func[i]), 1, NULL, INTD_DOUBLE, r_getP99, NULL, NULL, NULL, INTD_AI, INTD_1S);  /* r */
+    }
+
+    return status;
+}
+
@@ -0,0 +1,88 @@
+/****************************************************
+ * RFControlFirmware_profile.h
+ *
+ * Profiling of the dispatch of the virtual functions (RFCFW_func_*). The calls are timed with the monotonic clock, the
+ *   statistics (count, min/mean/max) and a histogram of the duration (for the 99th percentile) are kept for each
+ *   function of each module.
+ *
+ * The profiling is compiled only if RFCFW_ENABLE_PROFILING is defined (see the Makefile), otherwise the hooks in the
+ *   dispatch are empty and the module data has no profiling fields. When compiled, it is also switchable at run time
+ *   and costs only a check of the switch when disabled
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_PROFILE_H
+#define RF_CONTROL_FIRMWARE_PROFILE_H
+
+#include "RFControlFirmware_timeStats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Functions profiled, the order is the same as the names in RFCFW_gvar_profFuncName
+ */
+#define RFCFW_CONST_PROF_GET_DAQ_DATA       0
+#define RFCFW_CONST_PROF_GET_ADC_DATA       1
+#define RFCFW_CONST_PROF_GET_INT_DATA       2
+#define RFCFW_CONST_PROF_SET_PHA            3
+#define RFCFW_CONST_PROF_SET_AMP            4
+#define RFCFW_CONST_PROF_WAIT_INTR          5
+#define RFCFW_CONST_PROF_MEA_INTR_LATENCY   6
+#define RFCFW_CONST_PROF_FUNC_NUM           7
+
+/**
+ * Histogram of the duration, the bins are logarithmic with 4 bins per octave starting from 0.125 us, the last bin
+ *   collects all longer durations (> 2 s)
+ */
+#define RFCFW_CONST_PROF_BIN_NUM            96
+#define RFCFW_CONST_PROF_BIN_PER_OCT        4
+#define RFCFW_CONST_PROF_BIN_START_US       0.125
+
+/**
+ * Profile of a function
+ */
+typedef struct {
+    RFCFW_struc_timeStats stats;                            /* count, min/mean/max of the duration */
+    volatile long   hist[RFCFW_CONST_PROF_BIN_NUM];         /* histogram of the duration */
+    volatile double p99_us;                                 /* 99th percentile of the duration, updated when read */
+} RFCFW_struc_profFunc;
+
+/**
+ * Profiles of a module
+ */
+typedef struct {
+    volatile unsigned short enable;                         /* 1 to enable the profiling */
+    volatile unsigned short reset;                          /* write 1 to reset all profiles */
+    RFCFW_struc_profFunc func[RFCFW_CONST_PROF_FUNC_NUM];
+} RFCFW_struc_profile;
+
+/**
+ * Hooks in the dispatch, empty if the profiling is not compiled
+ */
+#ifdef RFCFW_ENABLE_PROFILING
+#define RFCFW_PROF_START(prof, startTime_us)        ((startTime_us) = (prof) -> enable ? RFCFW_func_getTime_us() : 0.0)
+#define RFCFW_PROF_STOP(prof, funcId, startTime_us) do { if((startTime_us) > 0.0) RFCFW_func_profUpdate((prof), (funcId), RFCFW_func_getTime_us() - (startTime_us)); } while(0)
+#else
+#define RFCFW_PROF_START(prof, startTime_us)        ((void)(startTime_us))
+#define RFCFW_PROF_STOP(prof, funcId, startTime_us) ((void)0)
+#endif
+
+/**
+ * Routines
+ */
+extern const char *RFCFW_gvar_profFuncName[RFCFW_CONST_PROF_FUNC_NUM];
+
+void   RFCFW_func_profReset(RFCFW_struc_profile *prof);
+void   RFCFW_func_profUpdate(RFCFW_struc_profile *prof, int funcId, double time_us);
+void   RFCFW_func_profFuncUpdate(RFCFW_struc_profFunc *ptr_func, double time_us);               /* update the statistics and the histogram */
+double RFCFW_func_profPercentile(RFCFW_struc_profFunc *func, double ratio);               /* duration below which the ratio of the calls are */
+void   RFCFW_func_profReport(RFCFW_struc_profile *prof, const char *moduleName);
+
+int    RFCFW_func_profCreateData(const char *moduleName, RFCFW_struc_profile *prof);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
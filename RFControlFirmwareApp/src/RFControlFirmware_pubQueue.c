@@ -0,0 +1,333 @@
+/****************************************************
+ * RFControlFirmware_pubQueue.c
+ *
+ * Lock-free single producer/single consumer queue of the readouts, from the pulse thread to the EPICS publishing
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "EPICSLib_wrapper.h"
+#include "InternalData.h"                                               /* to create EPICS data node */
+#include "RFControlFirmware_pubQueue.h"
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * Call back of the I/O interrupt scan, called when the records of one priority have been processed
+ */
+static void RFCFW_func_pubQueueScanDone(void *usr, IOSCANPVT scan, int prio)
+{
+    RFCFW_struc_pubQueue *q = (RFCFW_struc_pubQueue *)usr;
+
+    __sync_add_and_fetch(&q -> scanDoneCnt, 1);
+    epicsEventSignal(q -> scanDone);
+}
+
+/**
+ * Publishing thread, publish all readouts in the queue when signaled. Only every ioDiv-th readout is copied to the
+ *   published frame, the others are skipped. After the scan is requested, wait until the records of all priorities
+ *   requested have been processed, so that the frame is not overwritten while the records read it
+ */
+static void RFCFW_func_pubQueueWorker(void *ptr)
+{
+    RFCFW_struc_pubQueue *q = (RFCFW_struc_pubQueue *)ptr;
+
+    long         var_div;
+    unsigned int var_prioMask;
+    int          var_prioNum;
+
+    while(!q -> stop) {
+        epicsEventMustWait(q -> event);
+
+        while(!q -> stop) {
+            var_div = q -> ioDiv;
+            if(var_div < 1) var_div = 1;
+
+            /* skip the readouts not published */
+            if(q -> ioDivCnt + 1 < var_div) {
+                if(RFCFW_func_pubQueueSkip(q) != 0) break;
+
+                q -> ioDivCnt ++;
+                q -> skipCnt ++;
+                continue;
+            }
+
+            if(RFCFW_func_pubQueueGet(q, q -> pubFrame) != 0) break;
+
+            /* process the records of the published frame */
+            q -> ioDivCnt    = 0;
+            q -> scanDoneCnt = 0;
+            q -> ioReqCnt ++;
+
+            var_prioMask = scanIoRequest(q -> ioScan);
+
+            for(var_prioNum = 0; var_prioMask; var_prioMask >>= 1)
+                if(var_prioMask & 0x1) var_prioNum ++;
+
+            while(q -> scanDoneCnt < var_prioNum) {
+                if(epicsEventWaitWithTimeout(q -> scanDone, RFCFW_CONST_PUBQ_SCAN_TIMEOUT) != epicsEventWaitOK) {
+                    q -> scanTimeoutCnt ++;
+                    break;
+                }
+            }
+        }
+    }
+
+    epicsEventSignal(q -> exited);
+}
+
+/**
+ * Destroy the events and free the slots
+ */
+static void RFCFW_func_pubQueueFree(RFCFW_struc_pubQueue *q)
+{
+    if(q -> event)    epicsEventDestroy(q -> event);
+    if(q -> scanDone) epicsEventDestroy(q -> scanDone);
+    if(q -> exited)   epicsEventDestroy(q -> exited);
+    if(q -> slots)    free(q -> slots);
+
+    q -> event    = NULL;
+    q -> scanDone = NULL;
+    q -> exited   = NULL;
+    q -> slots    = NULL;
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Init the queue, allocate the slots and create the publishing thread, named <moduleName>_PUB
+ * Input:
+ *   q          : Data of the queue
+ *   moduleName : Name of the high level module (RFControl)
+ *   slotSize   : Size of a readout in bytes
+ *   slotNum    : Number of slots
+ *   pubFrame   : Published frame with the size of slotSize, the data nodes point to it
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed
+ */
+int RFCFW_func_pubQueueInit(RFCFW_struc_pubQueue *q, const char *moduleName, unsigned long slotSize, unsigned long slotNum, void *pubFrame)
+{
+    char var_threadName[64];
+
+    if(!q || !moduleName || !moduleName[0] || slotSize == 0 || slotNum == 0 || !pubFrame) return -1;
+
+    if(q -> thread) return 0;
+
+    snprintf(var_threadName, sizeof(var_threadName), "%s_PUB", moduleName);
+
+    q -> slots = (char *)calloc(slotNum, slotSize);
+
+    if(!q -> slots) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_pubQueueInit: Failed to allocate %lu slots of %lu bytes for %s\n", slotNum, slotSize, moduleName);
+        return -1;
+    }
+
+    q -> slotSize  = slotSize;
+    q -> slotNum   = slotNum;
+    q -> head      = 0;
+    q -> tail      = 0;
+    q -> putActive = 0;
+    q -> pubFrame  = pubFrame;
+    q -> ioDivCnt  = 0;
+    q -> stop      = 0;
+
+    scanIoInit(&q -> ioScan);
+    scanIoSetComplete(q -> ioScan, RFCFW_func_pubQueueScanDone, (void *)q);
+
+    q -> event    = epicsEventCreate(epicsEventEmpty);
+    q -> scanDone = epicsEventCreate(epicsEventEmpty);
+    q -> exited   = epicsEventCreate(epicsEventEmpty);
+
+    if(!q -> event || !q -> scanDone || !q -> exited) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_pubQueueInit: Failed to create the events for %s\n", moduleName);
+        RFCFW_func_pubQueueFree(q);
+        return -1;
+    }
+
+    q -> thread = epicsThreadCreate(var_threadName, epicsThreadPriorityMedium, epicsThreadGetStackSize(epicsThreadStackMedium), RFCFW_func_pubQueueWorker, (void *)q);
+
+    if(!q -> thread) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_pubQueueInit: Failed to create the thread %s\n", var_threadName);
+        RFCFW_func_pubQueueFree(q);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * Stop the publishing thread and free the slots, the producer should not use the queue any more
+ * Input:
+ *   q          : Data of the queue
+ */
+void RFCFW_func_pubQueueDeinit(RFCFW_struc_pubQueue *q)
+{
+    if(!q || !q -> thread) return;
+
+    q -> stop = 1;
+    epicsEventSignal(q -> event);
+
+    /* the thread may wait for the scan up to its timeout */
+    if(epicsEventWaitWithTimeout(q -> exited, 2.0 * RFCFW_CONST_PUBQ_SCAN_TIMEOUT + 1.0) != epicsEventWaitOK) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_pubQueueDeinit: The publishing thread does not exit, the queue is not freed\n");
+        return;
+    }
+
+    q -> thread = NULL;
+    RFCFW_func_pubQueueFree(q);
+}
+
+/**
+ * Get the slot to be filled by the producer, never waits. When the queue is full, the oldest readout is dropped or the
+ *   new readout is dropped (NULL returned), depending on the policy
+ * Input:
+ *   q          : Data of the queue
+ * Return:
+ *   Address of the slot, NULL if the new readout should be dropped or the queue is not initialized
+ */
+void *RFCFW_func_pubQueuePutBegin(RFCFW_struc_pubQueue *q)
+{
+    unsigned long var_head;
+    unsigned long var_tail;
+
+    if(!q || !q -> slots) return NULL;
+
+    var_head = q -> head;
+    var_tail = q -> tail;
+
+    if(var_head - var_tail >= q -> slotNum) {
+        if(q -> policy == RFCFW_CONST_PUBQ_DROP_NEWEST) {
+            q -> dropCnt ++;
+            return NULL;
+        }
+
+        /* drop the oldest, if it fails the consumer has just taken it, there is space anyway */
+        if(RFCFW_PUBQ_CAS(&q -> tail, var_tail, var_tail + 1)) q -> dropCnt ++;
+    }
+
+    q -> putActive = 1;
+
+    return (void *)(q -> slots + (var_head % q -> slotNum) * q -> slotSize);
+}
+
+/**
+ * Commit the slot filled by the producer and wake up the publishing thread
+ * Input:
+ *   q          : Data of the queue
+ */
+void RFCFW_func_pubQueuePutCommit(RFCFW_struc_pubQueue *q)
+{
+    unsigned long var_fill;
+
+    if(!q || !q -> putActive) return;
+
+    /* the slot must be completely written before it is visible to the consumer */
+    RFCFW_PUBQ_BARRIER();
+    q -> head ++;
+
+    q -> putActive = 0;
+    q -> putCnt ++;
+
+    var_fill = q -> head - q -> tail;
+    if((long)var_fill > q -> fillMax) q -> fillMax = (long)var_fill;
+
+    epicsEventSignal(q -> event);
+}
+
+/**
+ * Copy the oldest readout in the queue and remove it from the queue, called by the consumer
+ * Input:
+ *   q          : Data of the queue
+ * Output:
+ *   frame      : Buffer with the size of the slot
+ * Return:
+ *   0          : Successful
+ *   1          : The queue is empty
+ *  -1          : Failed
+ */
+int RFCFW_func_pubQueueGet(RFCFW_struc_pubQueue *q, void *frame)
+{
+    unsigned long var_tail;
+
+    if(!q || !q -> slots || !frame) return -1;
+
+    for(;;) {
+        var_tail = q -> tail;
+
+        if(var_tail == q -> head) return 1;
+
+        /* read the slot after the head is seen */
+        RFCFW_PUBQ_BARRIER();
+        memcpy(frame, (void *)(q -> slots + (var_tail % q -> slotNum) * q -> slotSize), q -> slotSize);
+        RFCFW_PUBQ_BARRIER();
+
+        /* the copy is valid only if the slot was not dropped by the producer meanwhile */
+        if(RFCFW_PUBQ_CAS(&q -> tail, var_tail, var_tail + 1)) break;
+
+        q -> retryCnt ++;
+    }
+
+    q -> getCnt ++;
+
+    return 0;
+}
+
+/**
+ * Remove the oldest readout in the queue without copying it, called by the consumer
+ * Input:
+ *   q          : Data of the queue
+ * Return:
+ *   0          : Successful
+ *   1          : The queue is empty
+ *  -1          : Failed
+ */
+int RFCFW_func_pubQueueSkip(RFCFW_struc_pubQueue *q)
+{
+    unsigned long var_tail;
+
+    if(!q || !q -> slots) return -1;
+
+    /* if the producer drops the oldest meanwhile, the next one is removed */
+    do {
+        var_tail = q -> tail;
+
+        if(var_tail == q -> head) return 1;
+    } while(!RFCFW_PUBQ_CAS(&q -> tail, var_tail, var_tail + 1));
+
+    return 0;
+}
+
+/**
+ * Create data nodes for the queue
+ * Input:
+ *   moduleName     : Name of the high level module (RFControl)
+ *   q              : Data of the queue
+ * Return:
+ *   0              : Successful
+ *  <=-1            : Failed
+ */
+int RFCFW_func_pubQueueCreateData(const char *moduleName, RFCFW_struc_pubQueue *q)
+{
+    int status = 0;
+
+    /* check the input */
+    if(!moduleName || !moduleName[0] || !q) return -1;
+
+    status += INTD_API_createDataNode(moduleName, "PUBQ_POLICY",     (void *)(&q -> policy),   (void *)q, 1, NULL, INTD_ULONG, NULL, NULL, NULL, NULL, INTD_MBBO, INTD_PASSIVE);  /* w */
+    status += INTD_API_createDataNode(moduleName, "PUBQ_PUT_CNT",    (void *)(&q -> putCnt),   (void *)q, 1, NULL, INTD_LONG,  NULL, NULL, NULL, NULL, INTD_LI,   INTD_1S);       /* r */
+    status += INTD_API_createDataNode(moduleName, "PUBQ_GET_CNT",    (void *)(&q -> getCnt),   (void *)q, 1, NULL, INTD_LONG,  NULL, NULL, NULL, NULL, INTD_LI,   INTD_1S);       /* r */
+    status += INTD_API_createDataNode(moduleName, "PUBQ_DROP_CNT",   (void *)(&q -> dropCnt),  (void *)q, 1, NULL, INTD_LONG,  NULL, NULL, NULL, NULL, INTD_LI,   INTD_1S);       /* r */
+    status += INTD_API_createDataNode(moduleName, "PUBQ_RETRY_CNT",  (void *)(&q -> retryCnt), (void *)q, 1, NULL, INTD_LONG,  NULL, NULL, NULL, NULL, INTD_LI,   INTD_1S);       /* r */
+    status += INTD_API_createDataNode(moduleName, "PUBQ_FILL_MAX",   (void *)(&q -> fillMax),  (void *)q, 1, NULL, INTD_LONG,  NULL, NULL, NULL, NULL, INTD_LI,   INTD_1S);       /* r */
+    status += INTD_API_createDataNode(moduleName, "PUBQ_IO_DIV",     (void *)(&q -> ioDiv),    (void *)q, 1, NULL, INTD_LONG,  NULL, NULL, NULL, NULL, INTD_LO,   INTD_PASSIVE);  /* w */
+    status += INTD_API_createDataNode(moduleName, "PUBQ_IO_REQ_CNT", (void *)(&q -> ioReqCnt), (void *)q, 1, NULL, INTD_LONG,  NULL, NULL, NULL, NULL, INTD_LI,   INTD_1S);       /* r */
+    status += INTD_API_createDataNode(moduleName, "PUBQ_SKIP_CNT",   (void *)(&q -> skipCnt),  (void *)q, 1, NULL, INTD_LONG,  NULL, NULL, NULL, NULL, INTD_LI,   INTD_1S);       /* r */
+    status += INTD_API_createDataNode(moduleName, "PUBQ_SCAN_TMO",   (void *)(&q -> scanTimeoutCnt), (void *)q, 1, NULL, INTD_LONG, NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);       /* r */
+
+    return status;
+}
+
@@ -0,0 +1,102 @@
+/****************************************************
+ * RFControlFirmware_pubQueue.h
+ *
+ * Lock-free single producer/single consumer queue of the readouts, from the pulse thread to the EPICS publishing.
+ *   The slots are allocated at the init. The pulse thread (producer) fills a slot with the readout of a pulse and
+ *   commits it, the publishing thread (consumer) copies the oldest readout to the published frame, where the data
+ *   nodes point to. The pulse thread never waits for the publishing: when the queue is full, either the oldest readout
+ *   in the queue or the new readout is dropped (selected by the policy)
+ *
+ * The producer owns the head index and the consumer owns the tail index, except that the producer may move the tail to
+ *   drop the oldest readout. The tail is moved with compare and swap by both sides, the consumer copies the slot first
+ *   and then moves the tail, if the tail has been moved by the producer meanwhile (the slot may be overwritten during
+ *   the copy), the copy is discarded and the next readout is taken
+ *
+ * The records of the published data can use the I/O interrupt scan (ioScan), the publishing thread requests the scan
+ *   after a readout is published, with a divider to publish only every N-th readout, so that the records are
+ *   processed once per new data without polling. The readouts skipped by the divider are removed from the queue without
+ *   being copied. The published frame is not overwritten before the records have been processed: the publishing thread
+ *   waits for the completion of the scan (on all priorities requested, with a timeout) before it copies the next readout
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_PUB_QUEUE_H
+#define RF_CONTROL_FIRMWARE_PUB_QUEUE_H
+
+#include <epicsThread.h>
+#include <epicsEvent.h>
+#include <dbScan.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Policies when the queue is full
+ */
+#define RFCFW_CONST_PUBQ_DROP_OLDEST    0                       /* drop the oldest readout in the queue (default, the published data is the latest) */
+#define RFCFW_CONST_PUBQ_DROP_NEWEST    1                       /* drop the new readout (all readouts published are consecutive) */
+
+#define RFCFW_CONST_PUBQ_SLOT_NUM       4                       /* default number of slots */
+#define RFCFW_CONST_PUBQ_SCAN_TIMEOUT   1.0                     /* maximum wait for the records to be processed in seconds */
+
+/**
+ * Memory barrier and atomic operation of the indexes
+ */
+#define RFCFW_PUBQ_BARRIER()            __sync_synchronize()
+#define RFCFW_PUBQ_CAS(ptr, old, new)   __sync_bool_compare_and_swap((ptr), (old), (new))
+
+/**
+ * Data of the queue
+ */
+typedef struct {
+    char           *slots;                                  /* slotNum x slotSize bytes */
+    unsigned long   slotSize;                               /* size of a readout in bytes */
+    unsigned long   slotNum;                                /* number of slots */
+
+    volatile unsigned long head;                            /* number of readouts committed (written by producer) */
+    volatile unsigned long tail;                            /* number of readouts removed (published or dropped) */
+    int             putActive;                              /* 1 between the begin and commit of the producer */
+
+    volatile unsigned long policy;                          /* see RFCFW_CONST_PUBQ_* */
+
+    void           *pubFrame;                               /* published frame, the data nodes point to it */
+
+    epicsThreadId   thread;                                 /* publishing thread */
+    epicsEventId    event;                                  /* signaled when a readout is committed */
+    epicsEventId    exited;                                 /* signaled when the publishing thread exits */
+    volatile int    stop;                                   /* 1 to stop the publishing thread */
+    epicsEventId    scanDone;                               /* signaled when the scan of a priority is completed */
+
+    IOSCANPVT       ioScan;                                 /* I/O interrupt scan of the records of the published frame */
+    volatile long   ioDiv;                                  /* request the scan every ioDiv readouts (<= 1 for every readout) */
+    long            ioDivCnt;
+    volatile int    scanDoneCnt;                            /* number of priorities completed for the latest scan */
+
+    volatile long   putCnt;                                 /* number of readouts committed */
+    volatile long   getCnt;                                 /* number of readouts published */
+    volatile long   dropCnt;                                /* number of readouts dropped because the queue is full */
+    volatile long   retryCnt;                               /* number of copies discarded because the slot was dropped during the copy */
+    volatile long   fillMax;                                /* maximum number of readouts waiting in the queue */
+    volatile long   ioReqCnt;                               /* number of I/O interrupt scans requested */
+    volatile long   skipCnt;                                /* number of readouts skipped by the divider */
+    volatile long   scanTimeoutCnt;                         /* number of scans not completed in RFCFW_CONST_PUBQ_SCAN_TIMEOUT */
+} RFCFW_struc_pubQueue;
+
+/**
+ * Routines
+ */
+int   RFCFW_func_pubQueueInit(RFCFW_struc_pubQueue *q, const char *moduleName, unsigned long slotSize, unsigned long slotNum, void *pubFrame);
+void  RFCFW_func_pubQueueDeinit(RFCFW_struc_pubQueue *q);                              /* stop the publishing thread and free the slots */
+
+void *RFCFW_func_pubQueuePutBegin(RFCFW_struc_pubQueue *q);                            /* producer, get the slot to fill */
+void  RFCFW_func_pubQueuePutCommit(RFCFW_struc_pubQueue *q);                           /* producer, commit the filled slot */
+int   RFCFW_func_pubQueueGet(RFCFW_struc_pubQueue *q, void *frame);                    /* consumer, copy the oldest readout */
+int   RFCFW_func_pubQueueSkip(RFCFW_struc_pubQueue *q);                                /* consumer, remove the oldest readout without copy */
+
+int   RFCFW_func_pubQueueCreateData(const char *moduleName, RFCFW_struc_pubQueue *q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
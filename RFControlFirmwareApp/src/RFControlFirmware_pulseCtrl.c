@@ -0,0 +1,119 @@
+/****************************************************
+ * RFControlFirmware_pulseCtrl.c
+ *
+ * PI controller for the pulse-to-pulse feedback
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "InternalData.h"                                               /* to create EPICS data node */
+#include "RFControlFirmware_pulseCtrl.h"
+
+/*======================================
+ * Private Data and Routines - call backs
+ *======================================*/
+/* Write callback function, restart the controller when enabled (bumpless) */
+static void w_setEnable(void *ptr)
+{
+    INTD_struc_node    *dataNode = (INTD_struc_node *)ptr;
+
+    if(!dataNode) return;
+    RFCFW_struc_piCtrl *ctrl     = (RFCFW_struc_piCtrl *)dataNode->privateData;
+
+    if(ctrl) {
+        ctrl -> started = 0;
+        ctrl -> out     = 0.0;
+    }
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Reset the states of the controller
+ */
+void RFCFW_func_piCtrlReset(RFCFW_struc_piCtrl *ctrl)
+{
+    if(!ctrl) return;
+
+    ctrl -> err     = 0.0;
+    ctrl -> out     = 0.0;
+    ctrl -> started = 0;
+}
+
+/**
+ * Execute the controller for one pulse
+ * Input:
+ *   ctrl       : Controller
+ *   err        : Error of this pulse (set point - measurement, calculated by the caller so that it can be normalized or wrapped)
+ * Return:
+ *   Increment of the actuator for this pulse (0 if the controller is disabled)
+ */
+double RFCFW_func_piCtrlUpdate(RFCFW_struc_piCtrl *ctrl, double err)
+{
+    double var_out;
+
+    if(!ctrl) return 0.0;
+
+    /* the first pulse after enabled only has the integral part */
+    if(ctrl -> started)
+        var_out = ctrl -> kp * (err - ctrl -> err) + ctrl -> ki * err;
+    else
+        var_out = ctrl -> ki * err;
+
+    if(ctrl -> outLimit > 0.0) {
+        if(var_out >  ctrl -> outLimit) var_out =  ctrl -> outLimit;
+        if(var_out < -ctrl -> outLimit) var_out = -ctrl -> outLimit;
+    }
+
+    /* remember the error even if disabled, so that the controller can be enabled without bump */
+    ctrl -> err     = err;
+    ctrl -> started = 1;
+    ctrl -> out     = ctrl -> enable ? var_out : 0.0;
+
+    return ctrl -> out;
+}
+
+/**
+ * Create data nodes for the controller
+ * Input:
+ *   moduleName     : Name of the high level module (RFControl)
+ *   ctrlName       : Prefix of the data node names
+ *   ctrl           : Controller
+ * Return:
+ *   0              : Successful
+ *  <=-1            : Failed
+ */
+int RFCFW_func_piCtrlCreateData(const char *moduleName, const char *ctrlName, RFCFW_struc_piCtrl *ctrl)
+{
+    int  status = 0;
+    char var_dataName[64];
+
+    /* check the input */
+    if(!moduleName || !moduleName[0] || !ctrlName || !ctrlName[0] || !ctrl) return -1;
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_ENA", ctrlName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ctrl -> enable),   (void *)ctrl, 1, NULL, INTD_USHORT, NULL, w_setEnable, NULL, NULL, INTD_BO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_SP", ctrlName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ctrl -> sp),       (void *)ctrl, 1, NULL, INTD_DOUBLE, NULL, NULL,        NULL, NULL, INTD_AO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_KP", ctrlName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ctrl -> kp),       (void *)ctrl, 1, NULL, INTD_DOUBLE, NULL, NULL,        NULL, NULL, INTD_AO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_KI", ctrlName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ctrl -> ki),       (void *)ctrl, 1, NULL, INTD_DOUBLE, NULL, NULL,        NULL, NULL, INTD_AO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_LIMIT", ctrlName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ctrl -> outLimit), (void *)ctrl, 1, NULL, INTD_DOUBLE, NULL, NULL,        NULL, NULL, INTD_AO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_ERR", ctrlName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ctrl -> err),      (void *)ctrl, 1, NULL, INTD_DOUBLE, NULL, NULL,        NULL, NULL, INTD_AI, INTD_1S);       /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_CORR", ctrlName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ctrl -> out),      (void *)ctrl, 1, NULL, INTD_DOUBLE, NULL, NULL,        NULL, NULL, INTD_AI, INTD_1S);       /* r */
+
+    return status;
+}
+
@@ -0,0 +1,49 @@
+/****************************************************
+ * RFControlFirmware_pulseCtrl.h
+ *
+ * PI controller for the pulse-to-pulse feedback running in the firmware control module. The controller is in the 
+ *   velocity form, it outputs the increment of the actuator every pulse, which fits the incremental actuators of 
+ *   setPha_deg/setAmp (vector rotation) and needs no anti-windup for the integrator
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_PULSE_CTRL_H
+#define RF_CONTROL_FIRMWARE_PULSE_CTRL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Limits of the amplitude scale applied by the actuation vector rotation (coefficients have 14 bits fraction in 16 bits)
+ */
+#define RFCFW_CONST_AMP_SCALE_MIN       0.01
+#define RFCFW_CONST_AMP_SCALE_MAX       1.99
+
+/**
+ * Data of a PI controller
+ */
+typedef struct {
+    volatile unsigned short enable;                         /* 1 to enable the controller */
+    volatile double sp;                                     /* set point */
+    volatile double kp;                                     /* proportional gain */
+    volatile double ki;                                     /* integral gain (per pulse) */
+    volatile double outLimit;                               /* limit of the output (increment per pulse), no limit if <= 0 */
+
+    volatile double err;                                    /* latest error */
+    volatile double out;                                    /* latest output */
+    volatile long   started;                                /* 1 if there is a valid error of last pulse */
+} RFCFW_struc_piCtrl;
+
+/**
+ * Routines
+ */
+void   RFCFW_func_piCtrlReset(RFCFW_struc_piCtrl *ctrl);
+double RFCFW_func_piCtrlUpdate(RFCFW_struc_piCtrl *ctrl, double err);
+
+int    RFCFW_func_piCtrlCreateData(const char *moduleName, const char *ctrlName, RFCFW_struc_piCtrl *ctrl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,119 @@
+/****************************************************
+ * RFControlFirmware_pulseFeature.c
+ *
+ * Calculate the per-pulse scalar features of the RF waveforms
+ ****************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "RFControlFirmware_pulseFeature.h"
+
+/**
+ * Convert the time in ns to the index of the waveform, limited in the range of [0, pno]
+ */
+static long RFCFW_func_timeToIndex(double time_ns, long pno, double sampleFreq_MHz, double sampleDelay_ns)
+{
+    long id = (long)floor((time_ns - sampleDelay_ns) * sampleFreq_MHz / 1000.0 + 0.5);
+
+    if(id < 0)   id = 0;
+    if(id > pno) id = pno;
+
+    return id;
+}
+
+/**
+ * Calculate the scalar features of an RF waveform. The flat-top window is visited by a single loop which accumulates
+ *   all statistics at the same time (the loop body has no data dependent branches except the max, so the compiler can
+ *   vectorize it), the points out of the window are visited once more to find the rise edge and the peak
+ * Input:
+ *   wfI, wfQ       : I/Q waveforms
+ *   pno            : point number of the waveforms
+ *   sampleFreq_MHz : sampling frequency of the waveforms
+ *   sampleDelay_ns : time of the first point of the waveforms
+ *   winStart_ns    : start time of the flat-top window
+ *   winEnd_ns      : end time of the flat-top window
+ * Output:
+ *   feature        : calculated features, the valid flag will be cleared if the window is not valid
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int RFCFW_func_calcPulseFeature(const short *wfI, const short *wfQ, long pno, double sampleFreq_MHz, double sampleDelay_ns,
+                                double winStart_ns, double winEnd_ns, RFCFW_struc_pulseFeature *feature)
+{
+    long  i;
+    long  var_idStart, var_idEnd, var_n;
+    long  var_id10 = -1, var_id90 = -1;
+    long  var_sumI  = 0;
+    long  var_sumQ  = 0;
+    unsigned int var_pow;                                   /* I^2 + Q^2 of two shorts may exceed the range of int */
+    unsigned int var_powPeak = 0;
+    double var_amp;
+    double var_sumA  = 0.0;
+    double var_sumKA = 0.0;                                 /* double is required, the slope is from difference of large sums */
+    double var_meanA, var_sumK, var_sumK2, var_slope;
+    double var_thr10, var_thr90;
+
+    /* check the input */
+    if(!wfI || !wfQ || !feature || pno <= 0 || sampleFreq_MHz <= 0.0) return -1;
+
+    feature -> valid = 0;
+
+    /* get the window in index */
+    var_idStart = RFCFW_func_timeToIndex(winStart_ns, pno, sampleFreq_MHz, sampleDelay_ns);
+    var_idEnd   = RFCFW_func_timeToIndex(winEnd_ns,   pno, sampleFreq_MHz, sampleDelay_ns);
+    var_n       = var_idEnd - var_idStart;
+
+    if(var_n < 2) return -1;
+
+    /* fused pass over the flat-top window */
+    for(i = var_idStart; i < var_idEnd; i ++) {
+        var_pow    = (unsigned int)(wfI[i] * wfI[i]) + (unsigned int)(wfQ[i] * wfQ[i]);
+        var_amp    = sqrt((double)var_pow);
+
+        var_sumI  += wfI[i];
+        var_sumQ  += wfQ[i];
+        var_sumA  += var_amp;
+        var_sumKA += (double)(i - var_idStart) * var_amp;
+
+        var_powPeak = var_pow > var_powPeak ? var_pow : var_powPeak;
+    }
+
+    var_meanA = var_sumA / var_n;
+
+    /* amplitude slope with linear fit, the sum of k and k^2 (k = 0...n-1) are known */
+    var_sumK  = (double)var_n * (var_n - 1) / 2.0;
+    var_sumK2 = (double)var_n * (var_n - 1) * (2 * var_n - 1) / 6.0;
+    var_slope = (var_n * var_sumKA - var_sumK * var_sumA) / (var_n * var_sumK2 - var_sumK * var_sumK);
+
+    /* rise edge before the window, thresholds are respect to the mean amplitude in the window */
+    var_thr10 = 0.01 * var_meanA * var_meanA;
+    var_thr90 = 0.81 * var_meanA * var_meanA;
+
+    for(i = 0; i < var_idStart; i ++) {
+        var_pow = (unsigned int)(wfI[i] * wfI[i]) + (unsigned int)(wfQ[i] * wfQ[i]);
+
+        if(var_id10 < 0 && var_pow >= var_thr10) var_id10 = i;
+        if(var_id90 < 0 && var_pow >= var_thr90) var_id90 = i;
+
+        var_powPeak = var_pow > var_powPeak ? var_pow : var_powPeak;
+    }
+
+    /* peak after the window */
+    for(i = var_idEnd; i < pno; i ++) {
+        var_pow     = (unsigned int)(wfI[i] * wfI[i]) + (unsigned int)(wfQ[i] * wfQ[i]);
+        var_powPeak = var_pow > var_powPeak ? var_pow : var_powPeak;
+    }
+
+    /* output */
+    feature -> amp         = var_meanA;
+    feature -> pha_deg     = atan2((double)var_sumQ, (double)var_sumI) * 180.0 / M_PI;
+    feature -> ampPeak     = sqrt((double)var_powPeak);
+    feature -> riseTime_ns = (var_id10 >= 0 && var_id90 >= var_id10) ? (var_id90 - var_id10) * 1000.0 / sampleFreq_MHz : 0.0;
+    feature -> droop_pct   = var_meanA > 0.0 ? -100.0 * var_slope * (var_n - 1) / var_meanA : 0.0;
+    feature -> valid       = 1;
+
+    return 0;
+}
+
@@ -0,0 +1,48 @@
+/****************************************************
+ * RFControlFirmware_pulseFeature.h
+ *
+ * Per-pulse scalar features of the RF waveforms (amplitude/phase in the flat-top window, peak, rise time and droop).
+ *   The features are calculated right after the DAQ data is read, so that the clients only interested in scalars
+ *   do not need to fetch the whole waveforms
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_PULSE_FEATURE_H
+#define RF_CONTROL_FIRMWARE_PULSE_FEATURE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Bit definition of the channel selection mask, in the order of the RF waveforms of the firmware modules
+ */
+#define RFCFW_CONST_FEAT_CH_REF         0x01
+#define RFCFW_CONST_FEAT_CH_FBK         0x02
+#define RFCFW_CONST_FEAT_CH_TRACKED     0x04
+#define RFCFW_CONST_FEAT_CH_ERR         0x08
+#define RFCFW_CONST_FEAT_CH_ACT         0x10
+#define RFCFW_CONST_FEAT_CH_DAC_OUT     0x20
+
+/**
+ * Scalar features of a single RF waveform
+ */
+typedef struct {
+    volatile double amp;                                    /* mean amplitude in the flat-top window (digits) */
+    volatile double pha_deg;                                /* phase of the mean vector in the flat-top window (degree) */
+    volatile double ampPeak;                                /* peak amplitude of the whole waveform (digits) */
+    volatile double riseTime_ns;                            /* 10% - 90% rise time before the window, respect to the mean amplitude (ns) */
+    volatile double droop_pct;                              /* amplitude drop across the window from the linear fit (percent of the mean amplitude) */
+    volatile long   valid;                                  /* 1 to indicate the features are calculated with the latest pulse */
+} RFCFW_struc_pulseFeature;
+
+/**
+ * Routines
+ */
+int RFCFW_func_calcPulseFeature(const short *wfI, const short *wfQ, long pno, double sampleFreq_MHz, double sampleDelay_ns,
+                                double winStart_ns, double winEnd_ns, RFCFW_struc_pulseFeature *feature);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
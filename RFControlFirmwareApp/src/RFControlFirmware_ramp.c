@@ -0,0 +1,148 @@
+/****************************************************
+ * RFControlFirmware_ramp.c
+ *
+ * Ramp scheduler for the settings of the firmware
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "InternalData.h"                                               /* to create EPICS data node */
+#include "RFControlFirmware_ramp.h"
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Execute the ramp for one pulse, should be called once per pulse
+ * Input:
+ *   ramp       : Ramp
+ * Output:
+ *   frac       : Position of the ramp for this pulse, 0 for the start value and 1 for the target
+ * Return:
+ *   1          : The ramp is started in this pulse, the caller should remember the start value before applying frac
+ *   0          : A step should be applied in this pulse
+ *  -1          : No step in this pulse
+ */
+int RFCFW_func_rampStep(RFCFW_struc_ramp *ramp, double *frac)
+{
+    int  status = 0;
+    long var_duration;
+
+    if(!ramp || !frac) return -1;
+
+    /* stop at the current value */
+    if(ramp -> abort) {
+        ramp -> abort  = 0;
+        ramp -> go     = 0;
+        ramp -> active = 0;
+        ramp -> remain = 0;
+        return -1;
+    }
+
+    /* start (or restart) the ramp */
+    if(ramp -> go) {
+        ramp -> go         = 0;
+        ramp -> active     = 1;
+        ramp -> pos        = 0.0;
+        ramp -> durApplied = ramp -> duration;
+        ramp -> remain     = ramp -> duration > 1 ? ramp -> duration : 1;
+        status             = 1;
+    }
+
+    if(!ramp -> active) return -1;
+
+    /* the duration may be changed during the ramp, the rest of the ramp is re-based from the position reached and
+       covered in the new duration, so that the position does not jump */
+    var_duration = ramp -> duration;
+
+    if(var_duration != ramp -> durApplied) {
+        ramp -> durApplied = var_duration;
+        ramp -> remain     = var_duration > 1 ? var_duration : 1;
+    }
+
+    /* equal steps to the target in the remained pulses */
+    ramp -> pos += (1.0 - ramp -> pos) / (double)ramp -> remain;
+    ramp -> remain --;
+    *frac = ramp -> pos;
+
+    if(ramp -> remain <= 0) {
+        ramp -> remain = 0;
+        ramp -> active = 0;
+        ramp -> pos    = 1.0;
+        *frac          = 1.0;
+    }
+
+    return status;
+}
+
+/**
+ * Execute the ramp of a scalar setting for one pulse
+ * Input:
+ *   ramp       : Ramp
+ *   value      : Current value of the setting
+ * Output:
+ *   value      : New value of the setting
+ * Return:
+ *   0          : The value is changed, the caller should write it to the firmware
+ *  -1          : No step in this pulse
+ */
+int RFCFW_func_rampScalar(RFCFW_struc_ramp *ramp, volatile double *value)
+{
+    int    status;
+    double var_frac;
+
+    if(!ramp || !value) return -1;
+
+    status = RFCFW_func_rampStep(ramp, &var_frac);
+
+    if(status < 0) return -1;
+    if(status > 0) ramp -> from = *value;
+
+    *value = ramp -> from + (ramp -> target - ramp -> from) * var_frac;
+
+    return 0;
+}
+
+/**
+ * Create data nodes for the ramp
+ * Input:
+ *   moduleName     : Name of the high level module (RFControl)
+ *   rampName       : Prefix of the data node names
+ *   ramp           : Ramp
+ *   scalar         : 1 to create the node for the target (the targets of table ramps are provided by the caller)
+ * Return:
+ *   0              : Successful
+ *  <=-1            : Failed
+ */
+int RFCFW_func_rampCreateData(const char *moduleName, const char *rampName, RFCFW_struc_ramp *ramp, int scalar)
+{
+    int  status = 0;
+    char var_dataName[64];
+
+    /* check the input */
+    if(!moduleName || !moduleName[0] || !rampName || !rampName[0] || !ramp) return -1;
+
+    if(scalar) {
+        snprintf(var_dataName, sizeof(var_dataName), "%s_TGT", rampName);
+        status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ramp -> target),   (void *)ramp, 1, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AO, INTD_PASSIVE);  /* w */
+    }
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_DUR", rampName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ramp -> duration), (void *)ramp, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_GO", rampName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ramp -> go),       (void *)ramp, 1, NULL, INTD_USHORT, NULL, NULL, NULL, NULL, INTD_BO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_ABORT", rampName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ramp -> abort),    (void *)ramp, 1, NULL, INTD_USHORT, NULL, NULL, NULL, NULL, INTD_BO, INTD_PASSIVE);  /* w */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_ACTIVE", rampName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ramp -> active),   (void *)ramp, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);       /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_REMAIN", rampName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&ramp -> remain),   (void *)ramp, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);       /* r */
+
+    return status;
+}
+
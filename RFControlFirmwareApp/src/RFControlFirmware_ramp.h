@@ -0,0 +1,45 @@
+/****************************************************
+ * RFControlFirmware_ramp.h
+ *
+ * Ramp scheduler for the settings of the firmware. A ramp moves a setting from its current value to the target
+ *   linearly in the given number of pulses, one step is applied per pulse at the pulse boundary, so that the
+ *   operators do not need to write ramping scripts with many puts and the settings do not change with big steps
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_RAMP_H
+#define RF_CONTROL_FIRMWARE_RAMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Data of a ramp
+ */
+typedef struct {
+    volatile unsigned short go;                             /* write 1 to start the ramp from the current value */
+    volatile unsigned short abort;                          /* write 1 to stop the ramp at the current value */
+    volatile long   duration;                               /* number of pulses of the ramp, the target is applied in one pulse if <= 1 */
+    volatile double target;                                 /* target of the ramp (only for scalar settings) */
+
+    volatile long   active;                                 /* 1 if the ramp is running */
+    volatile long   remain;                                 /* number of pulses remained */
+
+    double from;                                            /* value when the ramp started (only for scalar settings) */
+    double pos;                                             /* position reached, 0 for the start value and 1 for the target */
+    long   durApplied;                                      /* duration in use, the ramp is re-based from the position reached when the duration is changed */
+} RFCFW_struc_ramp;
+
+/**
+ * Routines
+ */
+int RFCFW_func_rampStep(RFCFW_struc_ramp *ramp, double *frac);
+int RFCFW_func_rampScalar(RFCFW_struc_ramp *ramp, volatile double *value);
+
+int RFCFW_func_rampCreateData(const char *moduleName, const char *rampName, RFCFW_struc_ramp *ramp, int scalar);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,298 @@
+/****************************************************
+ * RFControlFirmware_regAccess.c
+ *
+ * Memory mapped register spaces for the fast path of the register access
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "EPICSLib_wrapper.h"
+#include "RFControlFirmware_timeStats.h"
+#include "RFControlFirmware_regAccess.h"
+
+/*======================================
+ * Global data
+ *======================================*/
+RFCFW_struc_regWindow RFCFW_gvar_regWindowList[RFCFW_CONST_REG_WINDOW_MAX];
+volatile int          RFCFW_gvar_regWindowNum = 0;
+
+/*======================================
+ * Private Routines
+ *======================================*/
+/**
+ * Find the mapping of the board and device
+ */
+static RFCFW_struc_regWindow *RFCFW_func_regWindowFind(void *handle, int device)
+{
+    int i;
+
+    for(i = 0; i < RFCFW_gvar_regWindowNum; i ++) {
+        if(RFCFW_gvar_regWindowList[i].handle == handle && RFCFW_gvar_regWindowList[i].device == device)
+            return &RFCFW_gvar_regWindowList[i];
+    }
+
+    return NULL;
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Map the register space of the board, should be called at the IOC start before the registers are accessed by
+ *   other threads. The mapping is checked by reading a register with both the mapping and the driver
+ * Input:
+ *   handle         : Handle of the RFControlBoard module
+ *   device         : Device to be mapped (RFCB_DEV_SYS or RFCB_DEV_USR)
+ *   size           : Size of the mapping in bytes
+ *   bytesPerAddr   : Bytes of one step of the register address (4 for word addressed register space)
+ *   checkAddr      : Address of a register with constant value to check the mapping (e.g. firmware name)
+ * Return:
+ *   0              : Successful, the fast path is enabled
+ *  -1              : Failed, the driver calls will be used
+ */
+int RFCFW_func_regWindowOpen(void *handle, int device, unsigned long size, unsigned int bytesPerAddr, unsigned int checkAddr)
+{
+    int   var_opened = 0;
+    int   var_fd;
+    char  var_deviceName[EPICSLIB_CONST_NAME_LEN];
+    char  var_fileName[EPICSLIB_CONST_NAME_LEN + 8];
+    void *ptr_map;
+    unsigned int var_dataApi;
+    unsigned int var_dataMap;
+
+    RFCFW_struc_regWindow *ptr_window;
+
+    if(!handle || size < sizeof(unsigned int) || bytesPerAddr == 0) return -1;
+
+    /* already mapped */
+    ptr_window = RFCFW_func_regWindowFind(handle, device);
+
+    if(ptr_window) {
+        ptr_window -> enabled = 1;
+        return 0;
+    }
+
+    if(RFCFW_gvar_regWindowNum >= RFCFW_CONST_REG_WINDOW_MAX) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_regWindowOpen: No space for more mappings\n");
+        return -1;
+    }
+
+    /* get the device file of the board */
+    memset(var_deviceName, 0, sizeof(var_deviceName));
+    RFCB_API_getModuleStatus((RFCB_struc_moduleData *)handle, var_deviceName, &var_opened, device);
+
+    if(!var_opened || !var_deviceName[0]) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_regWindowOpen: The device is not opened\n");
+        return -1;
+    }
+
+    if(var_deviceName[0] == '/') strcpy(var_fileName, var_deviceName);
+    else                         sprintf(var_fileName, "/dev/%s", var_deviceName);
+
+    /* map the register space */
+    var_fd = open(var_fileName, O_RDWR | O_SYNC);
+
+    if(var_fd < 0) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_regWindowOpen: Failed to open %s\n", var_fileName);
+        return -1;
+    }
+
+    ptr_map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, var_fd, 0);
+    close(var_fd);                                                      /* the mapping stays valid after closing */
+
+    if(ptr_map == MAP_FAILED) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_regWindowOpen: %s does not support the mapping of the registers\n", var_fileName);
+        return -1;
+    }
+
+    /* check if the mapping is the register space */
+    if((unsigned long)checkAddr * bytesPerAddr + sizeof(unsigned int) > size ||
+       RFCB_API_readRegister((RFCB_struc_moduleData *)handle, checkAddr, &var_dataApi, device) != 0) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_regWindowOpen: Failed to check the mapping of %s\n", var_fileName);
+        munmap(ptr_map, size);
+        return -1;
+    }
+
+    RFCFW_REG_BARRIER();
+    var_dataMap = *(volatile unsigned int *)((volatile char *)ptr_map + (unsigned long)checkAddr * bytesPerAddr);
+
+    if(var_dataMap != var_dataApi) {
+        EPICSLIB_func_errlogPrintf("RFCFW_func_regWindowOpen: The mapping of %s is not the register space (0x%08X read, 0x%08X expected)\n", var_fileName, var_dataMap, var_dataApi);
+        munmap(ptr_map, size);
+        return -1;
+    }
+
+    /* fill the entry completely before making it visible to the accessors */
+    ptr_window = &RFCFW_gvar_regWindowList[RFCFW_gvar_regWindowNum];
+
+    ptr_window -> handle       = handle;
+    ptr_window -> device       = device;
+    ptr_window -> base         = (volatile unsigned int *)ptr_map;
+    ptr_window -> size         = size;
+    ptr_window -> bytesPerAddr = bytesPerAddr;
+    ptr_window -> enabled      = 1;
+
+    RFCFW_REG_BARRIER();
+    RFCFW_gvar_regWindowNum ++;
+
+    return 0;
+}
+
+/**
+ * Enable or disable the fast path of the board (the mapping is kept)
+ * Input:
+ *   handle         : Handle of the RFControlBoard module
+ *   device         : Device mapped
+ *   enable         : 1 to use the mapping, 0 to use the driver calls
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed, the register space is not mapped
+ */
+int RFCFW_func_regWindowEnable(void *handle, int device, int enable)
+{
+    RFCFW_struc_regWindow *ptr_window = RFCFW_func_regWindowFind(handle, device);
+
+    if(!ptr_window) return -1;
+
+    ptr_window -> enabled = enable ? 1 : 0;
+
+    return 0;
+}
+
+/**
+ * Read a block of neighbouring registers in one pass. With the mapping, the registers are read with back-to-back loads
+ *   between two barriers, otherwise with the driver calls
+ * Input:
+ *   handle         : Handle of the RFControlBoard module
+ *   addr           : Address of the first register
+ *   stride         : Address step between two neighbouring registers
+ *   num            : Number of registers
+ *   device         : Device of the registers
+ * Output:
+ *   data           : Values of the registers
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int RFCFW_func_regReadBlock(void *handle, unsigned int addr, unsigned int stride, unsigned int num, unsigned int *data, int device)
+{
+    int status = 0;
+    unsigned int i;
+    unsigned long var_offset;
+    volatile unsigned int *ptr_reg;
+
+    RFCFW_struc_regWindow *ptr_window;
+
+    if(!handle || !data || num == 0) return -1;
+
+    /* mapping, the whole block must be in the mapping */
+    ptr_window = RFCFW_func_regWindowFind(handle, device);
+
+    if(ptr_window && ptr_window -> enabled) {
+        var_offset = (unsigned long)addr * ptr_window -> bytesPerAddr;
+
+        if(var_offset + (unsigned long)(num - 1) * stride * ptr_window -> bytesPerAddr + sizeof(unsigned int) <= ptr_window -> size) {
+            ptr_reg = (volatile unsigned int *)((volatile char *)ptr_window -> base + var_offset);
+
+            RFCFW_REG_BARRIER();
+            for(i = 0; i < num; i ++) data[i] = *(volatile unsigned int *)((volatile char *)ptr_reg + (unsigned long)i * stride * ptr_window -> bytesPerAddr);
+            RFCFW_REG_BARRIER();
+
+            for(i = 0; i < num; i ++) RFCFW_REG_TRACE(handle, RFCFW_CONST_REG_TRACE_READ, addr + i * stride, data[i], 1, device);
+
+            return 0;
+        }
+    }
+
+    /* driver calls */
+    for(i = 0; i < num; i ++) {
+        if(RFCB_API_readRegister((RFCB_struc_moduleData *)handle, addr + i * stride, &data[i], device) != 0) status = -1;
+        RFCFW_REG_TRACE(handle, RFCFW_CONST_REG_TRACE_READ, addr + i * stride, data[i], 1, device);
+    }
+
+    return status;
+}
+
+/**
+ * Measure the time of the register access with the driver calls and with the mapping. The reading is measured with a
+ *   register without side effect of reading (e.g. firmware name). The writing is measured only with a scratch register,
+ *   its value is read and the same value is written back
+ * Input:
+ *   handle         : Handle of the RFControlBoard module
+ *   device         : Device of the registers
+ *   readAddr       : Address of the register to read
+ *   writeAddr      : Address of the scratch register to write, <0 to skip the writing
+ *   loops          : Number of accesses to average
+ * Output:
+ *   apiRead_ns     : Time of one read with the driver call
+ *   apiWrite_ns    : Time of one write with the driver call (-1 if not measured)
+ *   mapRead_ns     : Time of one read with the mapping (-1 if not mapped)
+ *   mapWrite_ns    : Time of one write with the mapping (-1 if not mapped or not measured)
+ * Return:
+ *   0              : Successful
+ *  -1              : Failed
+ */
+int RFCFW_func_regBenchmark(void *handle, int device, unsigned int readAddr, long writeAddr, long loops,
+                            double *apiRead_ns, double *apiWrite_ns, double *mapRead_ns, double *mapWrite_ns)
+{
+    long   i;
+    double var_startTime_us;
+    unsigned int var_data    = 0;
+    unsigned int var_scratch = 0;
+    volatile unsigned int *ptr_reg;
+
+    RFCFW_struc_regWindow *ptr_window;
+
+    if(!handle || loops <= 0 || !apiRead_ns || !apiWrite_ns || !mapRead_ns || !mapWrite_ns) return -1;
+
+    *apiWrite_ns = -1;
+    *mapRead_ns  = -1;
+    *mapWrite_ns = -1;
+
+    /* driver calls */
+    var_startTime_us = RFCFW_func_getTime_us();
+    for(i = 0; i < loops; i ++) RFCB_API_readRegister((RFCB_struc_moduleData *)handle, readAddr, &var_data, device);
+    *apiRead_ns = (RFCFW_func_getTime_us() - var_startTime_us) * 1000.0 / loops;
+
+    if(writeAddr >= 0) {
+        if(RFCB_API_readRegister((RFCB_struc_moduleData *)handle, (unsigned int)writeAddr, &var_scratch, device) != 0) return -1;
+
+        var_startTime_us = RFCFW_func_getTime_us();
+        for(i = 0; i < loops; i ++) RFCB_API_writeRegister((RFCB_struc_moduleData *)handle, (unsigned int)writeAddr, var_scratch, device);
+        *apiWrite_ns = (RFCFW_func_getTime_us() - var_startTime_us) * 1000.0 / loops;
+    }
+
+    /* mapping (also when disabled, to show the gain) */
+    ptr_window = RFCFW_func_regWindowFind(handle, device);
+
+    if(!ptr_window || (unsigned long)readAddr * ptr_window -> bytesPerAddr + sizeof(unsigned int) > ptr_window -> size) return 0;
+
+    ptr_reg = (volatile unsigned int *)((volatile char *)ptr_window -> base + (unsigned long)readAddr * ptr_window -> bytesPerAddr);
+
+    var_startTime_us = RFCFW_func_getTime_us();
+    for(i = 0; i < loops; i ++) {
+        RFCFW_REG_BARRIER();
+        var_data = *ptr_reg;
+        RFCFW_REG_BARRIER();
+    }
+    *mapRead_ns = (RFCFW_func_getTime_us() - var_startTime_us) * 1000.0 / loops;
+
+    if(writeAddr < 0 || (unsigned long)writeAddr * ptr_window -> bytesPerAddr + sizeof(unsigned int) > ptr_window -> size) return 0;
+
+    ptr_reg = (volatile unsigned int *)((volatile char *)ptr_window -> base + (unsigned long)writeAddr * ptr_window -> bytesPerAddr);
+
+    var_startTime_us = RFCFW_func_getTime_us();
+    for(i = 0; i < loops; i ++) {
+        RFCFW_REG_BARRIER();
+        *ptr_reg = var_scratch;
+        RFCFW_REG_BARRIER();
+    }
+    *mapWrite_ns = (RFCFW_func_getTime_us() - var_startTime_us) * 1000.0 / loops;
+
+    return 0;
+}
+
@@ -0,0 +1,155 @@
+/****************************************************
+ * RFControlFirmware_regAccess.h
+ *
+ * Macros to generate the register accessors of the firmware backends. Each backend defines its device and the
+ *   register map with compile-time constants, the accessors are specialized with them so that every register access
+ *   compiles to a call with constant address and device, without looking up the address or the device at run time
+ *
+ * Usage (in the board header of the backend):
+ *   #define FWC_XXX_CONST_REG_DEVICE    RFCB_DEV_SYS
+ *   #define FWC_XXX_REG_WRITE(handle, reg, data)  RFCFW_REG_WRITE(XXX, FWC_XXX_CONST_REG_DEVICE, handle, reg, data)
+ *   #define FWC_XXX_REG_READ(handle, reg, ptr)    RFCFW_REG_READ(XXX, FWC_XXX_CONST_REG_DEVICE, handle, reg, ptr)
+ * then FWC_XXX_REG_WRITE(boardHandle, SWITCH_CTRL, data) writes to CON_XXX_REG_ADDR_SWITCH_CTRL
+ *
+ * Fast path: the register space of a board can be memory mapped once (RFCFW_func_regWindowOpen), then the accessors
+ *   access the registers with volatile loads/stores instead of the driver calls (one system call per access). Boards
+ *   without mapping (the driver does not support mmap or the mapping is not enabled) use the driver calls as before.
+ *   The mapping is created at the IOC start and never removed while the IOC is running, it can only be disabled
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_REG_ACCESS_H
+#define RF_CONTROL_FIRMWARE_REG_ACCESS_H
+
+#include "RFControlBoard_availableInterface.h"                  /* only point to interact with the RFControlBoard module */
+#include "RFControlFirmware_regTrace.h"                         /* trace of the register accesses */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Constants
+ */
+#define RFCFW_CONST_REG_WINDOW_MAX      32                      /* maximum number of mapped register spaces (board and device) */
+#define RFCFW_CONST_REG_WINDOW_SIZE     0x10000                 /* default size of the mapping in bytes */
+
+/**
+ * Memory barrier for the mapped registers, make sure the accesses to the registers are not reordered with the accesses
+ *   before and after them (e.g. the data buffer filled before writing the register to start the transfer)
+ */
+#if defined(__GNUC__)
+#define RFCFW_REG_BARRIER()     __sync_synchronize()
+#else
+#define RFCFW_REG_BARRIER()
+#endif
+
+/**
+ * Mapped register space of a board
+ */
+typedef struct {
+    void                  *handle;                              /* handle of the RFControlBoard module */
+    int                    device;                              /* device mapped (RFCB_DEV_SYS or RFCB_DEV_USR) */
+    volatile unsigned int *base;                                /* start of the mapping */
+    unsigned long          size;                                /* size of the mapping in bytes */
+    unsigned int           bytesPerAddr;                        /* bytes of one step of the register address (4 for word addressed) */
+    volatile int           enabled;                             /* 1 to use the mapping, 0 to use the driver calls */
+} RFCFW_struc_regWindow;
+
+extern RFCFW_struc_regWindow RFCFW_gvar_regWindowList[RFCFW_CONST_REG_WINDOW_MAX];
+extern volatile int          RFCFW_gvar_regWindowNum;
+
+/**
+ * Get the mapped address of the register, NULL if the register space is not mapped
+ */
+static __inline__ volatile unsigned int *RFCFW_func_regWindowAddr(void *handle, unsigned int addr, int device)
+{
+    int i;
+    unsigned long var_offset;
+
+    for(i = 0; i < RFCFW_gvar_regWindowNum; i ++) {
+        if(RFCFW_gvar_regWindowList[i].handle != handle || RFCFW_gvar_regWindowList[i].device != device) continue;
+
+        var_offset = (unsigned long)addr * RFCFW_gvar_regWindowList[i].bytesPerAddr;
+
+        if(!RFCFW_gvar_regWindowList[i].enabled || var_offset + sizeof(unsigned int) > RFCFW_gvar_regWindowList[i].size) return NULL;
+
+        return (volatile unsigned int *)((volatile char *)RFCFW_gvar_regWindowList[i].base + var_offset);
+    }
+
+    return NULL;
+}
+
+/**
+ * Write/read the register, use the mapping if available, otherwise the driver
+ */
+static __inline__ int RFCFW_func_regWrite(void *handle, unsigned int addr, unsigned int data, int device)
+{
+    volatile unsigned int *ptr_reg;
+
+    RFCFW_REG_TRACE(handle, RFCFW_CONST_REG_TRACE_WRITE, addr, data, 1, device);
+
+    if(RFCFW_gvar_regWindowNum > 0 && (ptr_reg = RFCFW_func_regWindowAddr(handle, addr, device)) != NULL) {
+        RFCFW_REG_BARRIER();
+        *ptr_reg = data;
+        RFCFW_REG_BARRIER();
+        return 0;
+    }
+
+    return RFCB_API_writeRegister((RFCB_struc_moduleData *)handle, addr, data, device);
+}
+
+static __inline__ int RFCFW_func_regRead(void *handle, unsigned int addr, unsigned int *data, int device)
+{
+    int status = 0;
+    volatile unsigned int *ptr_reg;
+
+    if(RFCFW_gvar_regWindowNum > 0 && (ptr_reg = RFCFW_func_regWindowAddr(handle, addr, device)) != NULL) {
+        RFCFW_REG_BARRIER();
+        *data = *ptr_reg;
+        RFCFW_REG_BARRIER();
+    } else {
+        status = RFCB_API_readRegister((RFCB_struc_moduleData *)handle, addr, data, device);
+    }
+
+    RFCFW_REG_TRACE(handle, RFCFW_CONST_REG_TRACE_READ, addr, *data, 1, device);
+
+    return status;
+}
+
+/**
+ * Read a buffer of the board with the driver (size in 32-bit words)
+ */
+static __inline__ int RFCFW_func_bufRead(void *handle, unsigned int offset, unsigned int size, unsigned int *buf, int device)
+{
+    int status = RFCB_API_readBuffer((RFCB_struc_moduleData *)handle, offset, size, buf, device);
+
+    RFCFW_REG_TRACE(handle, RFCFW_CONST_REG_TRACE_BUF_READ, offset, size > 0 ? buf[0] : 0, size, device);
+
+    return status;
+}
+
+/**
+ * Access the register CON_<plat>_REG_ADDR_<reg> of the backend <plat> with the given device
+ */
+#define RFCFW_REG_WRITE(plat, device, handle, reg, data)    RFCFW_func_regWrite((void *)(handle), CON_##plat##_REG_ADDR_##reg, (data), (device))
+#define RFCFW_REG_READ(plat, device, handle, reg, ptr)      RFCFW_func_regRead((void *)(handle), CON_##plat##_REG_ADDR_##reg, (ptr), (device))
+
+/**
+ * Read num neighbouring registers starting from CON_<plat>_REG_ADDR_<reg>
+ */
+#define RFCFW_REG_READ_BLOCK(plat, device, stride, handle, reg, num, ptr)   RFCFW_func_regReadBlock((void *)(handle), CON_##plat##_REG_ADDR_##reg, (stride), (num), (ptr), (device))
+
+/**
+ * Routines
+ */
+int  RFCFW_func_regWindowOpen(void *handle, int device, unsigned long size, unsigned int bytesPerAddr, unsigned int checkAddr);
+int  RFCFW_func_regWindowEnable(void *handle, int device, int enable);
+int  RFCFW_func_regReadBlock(void *handle, unsigned int addr, unsigned int stride, unsigned int num, unsigned int *data, int device);
+int  RFCFW_func_regBenchmark(void *handle, int device, unsigned int readAddr, long writeAddr, long loops,
+                             double *apiRead_ns, double *apiWrite_ns, double *mapRead_ns, double *mapWrite_ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
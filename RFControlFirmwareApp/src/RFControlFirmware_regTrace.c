@@ -0,0 +1,209 @@
+/****************************************************
+ * RFControlFirmware_regTrace.c
+ *
+ * Trace of the register accesses at the boundary to the RFControlBoard module
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "EPICSLib_wrapper.h"
+#include "RFControlFirmware_timeStats.h"
+#include "RFControlFirmware_regTrace.h"
+
+#ifdef RFCFW_ENABLE_REG_TRACE
+/*======================================
+ * Global data
+ *======================================*/
+RFCFW_struc_regTrace RFCFW_gvar_regTrace;
+__thread int         RFCFW_gvar_regTraceCtx = RFCFW_CONST_REG_TRACE_CTX_OTHER;
+
+/*======================================
+ * Private Data and Routines
+ *======================================*/
+static const char *RFCFW_gvar_regTraceOpName[3] = {"RD", "WR", "BUF"};
+
+static const char *RFCFW_func_regTraceCtxName(int ctx)
+{
+    if(ctx >= 0 && ctx < RFCFW_CONST_PROF_FUNC_NUM) return RFCFW_gvar_profFuncName[ctx];
+    return "OTHER";
+}
+#endif
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Record an access, called by the accessors when the trace is armed
+ * Input:
+ *   handle     : Handle of the RFControlBoard module
+ *   op         : RFCFW_CONST_REG_TRACE_READ/WRITE/BUF_READ
+ *   addr       : Address of the register or the buffer
+ *   value      : Value read or written (first word for the buffer)
+ *   size       : Number of 32-bit words
+ *   device     : Device accessed
+ */
+void RFCFW_func_regTraceAdd(void *handle, int op, unsigned int addr, unsigned int value, unsigned int size, int device)
+{
+#ifdef RFCFW_ENABLE_REG_TRACE
+    unsigned long var_seq;
+    int var_ctx = RFCFW_gvar_regTraceCtx;
+
+    RFCFW_struc_regTraceEntry *ptr_entry;
+    RFCFW_struc_regTraceCnt   *ptr_cnt;
+
+    if(var_ctx < 0 || var_ctx >= RFCFW_CONST_REG_TRACE_CTX_NUM) var_ctx = RFCFW_CONST_REG_TRACE_CTX_OTHER;
+
+    /* counters */
+    ptr_cnt = &RFCFW_gvar_regTrace.cnt[var_ctx];
+
+    switch(op) {
+        case RFCFW_CONST_REG_TRACE_READ:     __sync_fetch_and_add(&ptr_cnt -> readCnt,  1); break;
+        case RFCFW_CONST_REG_TRACE_WRITE:    __sync_fetch_and_add(&ptr_cnt -> writeCnt, 1); break;
+        case RFCFW_CONST_REG_TRACE_BUF_READ: __sync_fetch_and_add(&ptr_cnt -> bufReadCnt, 1);
+                                             __sync_fetch_and_add(&ptr_cnt -> bufWordCnt, (long)size); break;
+        default: break;
+    }
+
+    /* take a slot and fill it, the sequence number is written last so that the dump can skip the incomplete entry */
+    var_seq   = __sync_fetch_and_add(&RFCFW_gvar_regTrace.head, 1);
+    ptr_entry = &RFCFW_gvar_regTrace.entry[var_seq & (RFCFW_CONST_REG_TRACE_SIZE - 1)];
+
+    ptr_entry -> seq     = 0;
+    ptr_entry -> time_us = RFCFW_func_getTime_us();
+    ptr_entry -> handle  = handle;
+    ptr_entry -> addr    = addr;
+    ptr_entry -> value   = value;
+    ptr_entry -> size    = size;
+    ptr_entry -> device  = (short)device;
+    ptr_entry -> op      = (short)op;
+    ptr_entry -> ctx     = var_ctx;
+
+    __sync_synchronize();
+    ptr_entry -> seq     = var_seq + 1;
+#endif
+}
+
+/**
+ * Start recording the accesses
+ * Input:
+ *   clear      : 1 to clear the ring and the counters
+ * Return:
+ *   0          : Successful
+ *  -1          : The trace is not compiled
+ */
+int RFCFW_func_regTraceArm(int clear)
+{
+#ifdef RFCFW_ENABLE_REG_TRACE
+    int i;
+
+    if(clear) {
+        RFCFW_gvar_regTrace.armed = 0;
+        __sync_synchronize();
+
+        RFCFW_gvar_regTrace.head = 0;
+        for(i = 0; i < RFCFW_CONST_REG_TRACE_SIZE; i ++)   RFCFW_gvar_regTrace.entry[i].seq = 0;
+        memset((void *)RFCFW_gvar_regTrace.cnt, 0, sizeof(RFCFW_gvar_regTrace.cnt));
+    }
+
+    __sync_synchronize();
+    RFCFW_gvar_regTrace.armed = 1;
+
+    return 0;
+#else
+    EPICSLIB_func_errlogPrintf("RFCFW_func_regTraceArm: The trace is not compiled (define RFCFW_ENABLE_REG_TRACE)\n");
+    return -1;
+#endif
+}
+
+/**
+ * Stop recording the accesses, the ring and the counters are kept
+ * Return:
+ *   0          : Successful
+ *  -1          : The trace is not compiled
+ */
+int RFCFW_func_regTraceFreeze(void)
+{
+#ifdef RFCFW_ENABLE_REG_TRACE
+    RFCFW_gvar_regTrace.armed = 0;
+    __sync_synchronize();
+
+    return 0;
+#else
+    EPICSLIB_func_errlogPrintf("RFCFW_func_regTraceFreeze: The trace is not compiled (define RFCFW_ENABLE_REG_TRACE)\n");
+    return -1;
+#endif
+}
+
+/**
+ * Print the latest entries of the ring (oldest first) and the counters per context. The time is relative to the first
+ *   entry printed, so that the dumps of different runs or releases can be compared with diff
+ * Input:
+ *   fileName   : File to write, print to the console if NULL or empty
+ *   num        : Number of entries, all entries in the ring if <= 0
+ * Return:
+ *   0          : Successful
+ *  -1          : Failed
+ */
+int RFCFW_func_regTraceDump(const char *fileName, long num)
+{
+#ifdef RFCFW_ENABLE_REG_TRACE
+    int   i;
+    FILE *ptr_file = stdout;
+    unsigned long var_head;
+    unsigned long var_seq;
+    double        var_startTime_us = -1.0;
+
+    RFCFW_struc_regTraceEntry *ptr_entry;
+    RFCFW_struc_regTraceCnt   *ptr_cnt;
+
+    if(fileName && fileName[0]) {
+        ptr_file = fopen(fileName, "w");
+
+        if(!ptr_file) {
+            EPICSLIB_func_errlogPrintf("RFCFW_func_regTraceDump: Failed to open the file %s\n", fileName);
+            return -1;
+        }
+    }
+
+    var_head = RFCFW_gvar_regTrace.head;
+
+    if(num <= 0 || num > RFCFW_CONST_REG_TRACE_SIZE) num = RFCFW_CONST_REG_TRACE_SIZE;
+    if((unsigned long)num > var_head) num = (long)var_head;
+
+    fprintf(ptr_file, "# register trace (%s), %lu accesses recorded, latest %ld:\n", RFCFW_gvar_regTrace.armed ? "armed" : "frozen", var_head, num);
+    fprintf(ptr_file, "# %10s %12s %-10s %-3s %3s %10s %10s %8s %-18s\n", "seq", "time(us)", "context", "op", "dev", "addr", "value", "size", "board");
+
+    for(var_seq = var_head - (unsigned long)num; var_seq < var_head; var_seq ++) {
+        ptr_entry = &RFCFW_gvar_regTrace.entry[var_seq & (RFCFW_CONST_REG_TRACE_SIZE - 1)];
+
+        if(ptr_entry -> seq != var_seq + 1) continue;                       /* being written or overwritten */
+
+        if(var_startTime_us < 0) var_startTime_us = ptr_entry -> time_us;
+
+        fprintf(ptr_file, "  %10lu %12.3f %-10s %-3s %3d 0x%08X 0x%08X %8u %p\n", var_seq, ptr_entry -> time_us - var_startTime_us,
+                RFCFW_func_regTraceCtxName(ptr_entry -> ctx),
+                (ptr_entry -> op >= 0 && ptr_entry -> op <= RFCFW_CONST_REG_TRACE_BUF_READ) ? RFCFW_gvar_regTraceOpName[ptr_entry -> op] : "?",
+                ptr_entry -> device, ptr_entry -> addr, ptr_entry -> value, ptr_entry -> size, ptr_entry -> handle);
+    }
+
+    fprintf(ptr_file, "# counters per context:\n");
+    fprintf(ptr_file, "# %-10s %10s %10s %10s %10s %12s %12s\n", "context", "calls", "reads", "writes", "bufReads", "bufWords", "ops/call");
+
+    for(i = 0; i < RFCFW_CONST_REG_TRACE_CTX_NUM; i ++) {
+        ptr_cnt = &RFCFW_gvar_regTrace.cnt[i];
+
+        fprintf(ptr_file, "  %-10s %10ld %10ld %10ld %10ld %12ld %12.2f\n", RFCFW_func_regTraceCtxName(i),
+                ptr_cnt -> callCnt, ptr_cnt -> readCnt, ptr_cnt -> writeCnt, ptr_cnt -> bufReadCnt, ptr_cnt -> bufWordCnt,
+                ptr_cnt -> callCnt > 0 ? (double)(ptr_cnt -> readCnt + ptr_cnt -> writeCnt + ptr_cnt -> bufReadCnt) / ptr_cnt -> callCnt : 0.0);
+    }
+
+    if(ptr_file != stdout) fclose(ptr_file);
+
+    return 0;
+#else
+    EPICSLIB_func_errlogPrintf("RFCFW_func_regTraceDump: The trace is not compiled (define RFCFW_ENABLE_REG_TRACE)\n");
+    return -1;
+#endif
+}
+
@@ -0,0 +1,103 @@
+/****************************************************
+ * RFControlFirmware_regTrace.h
+ *
+ * Trace of the register accesses at the boundary to the RFControlBoard module (register read/write and buffer read).
+ *   Each access is recorded in a ring (address, value, device, size and time), which is armed, frozen and dumped with
+ *   the iocsh commands. The accesses are also counted per context (the virtual function being dispatched, or "other"
+ *   for the EPICS record call backs and the initialization), so that the cost of a function in register operations
+ *   can be seen and the register traffic can be compared between releases
+ *
+ * The ring is lock free, the writers (any thread) take the slots with an atomic increment of the head. It is compiled
+ *   only if RFCFW_ENABLE_REG_TRACE is defined (see the Makefile), otherwise the hooks in the accessors are empty
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_REG_TRACE_H
+#define RF_CONTROL_FIRMWARE_REG_TRACE_H
+
+#include "RFControlFirmware_profile.h"                          /* the contexts are the functions profiled */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Constants
+ */
+#define RFCFW_CONST_REG_TRACE_SIZE      4096                    /* number of entries in the ring, must be power of 2 */
+
+#define RFCFW_CONST_REG_TRACE_READ      0                       /* operations */
+#define RFCFW_CONST_REG_TRACE_WRITE     1
+#define RFCFW_CONST_REG_TRACE_BUF_READ  2
+
+#define RFCFW_CONST_REG_TRACE_CTX_OTHER RFCFW_CONST_PROF_FUNC_NUM               /* context out of the virtual functions */
+#define RFCFW_CONST_REG_TRACE_CTX_NUM   (RFCFW_CONST_PROF_FUNC_NUM + 1)
+
+/**
+ * Entry of the trace
+ */
+typedef struct {
+    volatile unsigned long seq;                             /* sequence number of the access, written last */
+    double          time_us;                                /* time of the access */
+    void           *handle;                                 /* handle of the RFControlBoard module */
+    unsigned int    addr;                                   /* address of the register or the buffer */
+    unsigned int    value;                                  /* value read or written (first word for the buffer) */
+    unsigned int    size;                                   /* number of 32-bit words */
+    short           device;                                 /* RFCB_DEV_* */
+    short           op;                                     /* RFCFW_CONST_REG_TRACE_READ/WRITE/BUF_READ */
+    int             ctx;                                    /* context, RFCFW_CONST_PROF_* or RFCFW_CONST_REG_TRACE_CTX_OTHER */
+} RFCFW_struc_regTraceEntry;
+
+/**
+ * Counters of a context
+ */
+typedef struct {
+    volatile long   callCnt;                                /* number of calls of the function */
+    volatile long   readCnt;                                /* number of register reads */
+    volatile long   writeCnt;                               /* number of register writes */
+    volatile long   bufReadCnt;                             /* number of buffer reads */
+    volatile long   bufWordCnt;                             /* number of 32-bit words read from the buffers */
+} RFCFW_struc_regTraceCnt;
+
+/**
+ * Trace
+ */
+typedef struct {
+    volatile int           armed;                           /* 1 to record the accesses */
+    volatile unsigned long head;                            /* number of accesses recorded since armed */
+    RFCFW_struc_regTraceCnt cnt[RFCFW_CONST_REG_TRACE_CTX_NUM];
+    RFCFW_struc_regTraceEntry entry[RFCFW_CONST_REG_TRACE_SIZE];
+} RFCFW_struc_regTrace;
+
+/**
+ * Hooks in the accessors and the dispatch, empty if the trace is not compiled
+ */
+#ifdef RFCFW_ENABLE_REG_TRACE
+extern RFCFW_struc_regTrace RFCFW_gvar_regTrace;
+extern __thread int         RFCFW_gvar_regTraceCtx;
+
+#define RFCFW_REG_TRACE(handle, op, addr, value, size, device) \
+    do { if(RFCFW_gvar_regTrace.armed) RFCFW_func_regTraceAdd((handle), (op), (addr), (value), (size), (device)); } while(0)
+#define RFCFW_REG_TRACE_ENTER(ctx) \
+    do { RFCFW_gvar_regTraceCtx = (ctx); if(RFCFW_gvar_regTrace.armed) __sync_fetch_and_add(&RFCFW_gvar_regTrace.cnt[(ctx)].callCnt, 1); } while(0)
+#define RFCFW_REG_TRACE_LEAVE() \
+    (RFCFW_gvar_regTraceCtx = RFCFW_CONST_REG_TRACE_CTX_OTHER)
+#else
+#define RFCFW_REG_TRACE(handle, op, addr, value, size, device)  ((void)0)
+#define RFCFW_REG_TRACE_ENTER(ctx)                              ((void)0)
+#define RFCFW_REG_TRACE_LEAVE()                                 ((void)0)
+#endif
+
+/**
+ * Routines
+ */
+void RFCFW_func_regTraceAdd(void *handle, int op, unsigned int addr, unsigned int value, unsigned int size, int device);
+
+int  RFCFW_func_regTraceArm(int clear);                                                 /* start recording, clear the ring and counters if clear is 1 */
+int  RFCFW_func_regTraceFreeze(void);                                                   /* stop recording, the ring is kept for the dump */
+int  RFCFW_func_regTraceDump(const char *fileName, long num);                           /* print the latest num entries and the counters */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
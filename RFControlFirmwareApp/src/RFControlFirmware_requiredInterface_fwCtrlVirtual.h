@@ -34,6 +34,7 @@ extern "C" {
  * Function pointer definitions 
  */
 typedef int (*RFCFW_FUNCPTR_INIT)(void*);                                                    /* init the firmware control module */
+typedef int (*RFCFW_FUNCPTR_DEINIT)(void*);                                                  /* release the resources of the firmware control module before it is freed */
 
 typedef int (*RFCFW_FUNCPTR_CREATE_EPICS_DATA)(void*, const char*);                          /* create the internal data nodes for the firmware control */
 typedef int (*RFCFW_FUNCPTR_DELETE_EPICS_DATA)(void*, const char*);                          /* delete */
@@ -51,12 +52,25 @@ typedef int (*RFCFW_FUNCPTR_WAIT_INTR)(void*);
 
 typedef int (*RFCFW_FUNCPTR_MEA_INTR_LATENCY)(void*, long*, long*);                          /* measure the interrupt latency */
 
+typedef int (*RFCFW_FUNCPTR_BRING_UP)(void*, int);                                           /* bring up the board at the IOC start (setup SPI or not) */
+
+typedef int (*RFCFW_FUNCPTR_SAVE_CONFIG)(void*, const char*);                                /* save the settings to a file */
+typedef int (*RFCFW_FUNCPTR_RESTORE_CONFIG)(void*, const char*);                             /* restore the settings from a file and program the board */
+
+typedef int (*RFCFW_FUNCPTR_BURST_START)(void*, long);                                       /* start a burst capture of the ADC data (number of pulses), NULL if not supported */
+typedef int (*RFCFW_FUNCPTR_BURST_DUMP)(void*, const char*);                                 /* print the frames of the latest burst, NULL if not supported */
+
+typedef int (*RFCFW_FUNCPTR_SET_LOCK)(void*, epicsMutexId);                                /* share the lock of the control writes (fwMutex) */
+
+typedef int (*RFCFW_FUNCPTR_BENCH_DEINTERLEAVE)(long, double*, double*);                     /* time the deinterleave of the DAQ buffer (no board needed), NULL if not supported */
+
 /**
  * Structure of the virtual functions
  */
 typedef struct {
 
     RFCFW_FUNCPTR_INIT                FWC_func_init;
+    RFCFW_FUNCPTR_DEINIT              FWC_func_deinit;
 
     RFCFW_FUNCPTR_CREATE_EPICS_DATA   FWC_func_createEpicsData;
     RFCFW_FUNCPTR_DELETE_EPICS_DATA   FWC_func_deleteEpicsData;
@@ -73,6 +87,18 @@ typedef struct {
     RFCFW_FUNCPTR_WAIT_INTR           FWC_func_waitIntr;
     RFCFW_FUNCPTR_MEA_INTR_LATENCY    FWC_func_meaIntrLatency;
 
+    RFCFW_FUNCPTR_BRING_UP            FWC_func_bringUp;
+
+    RFCFW_FUNCPTR_SAVE_CONFIG         FWC_func_saveConfig;
+    RFCFW_FUNCPTR_RESTORE_CONFIG      FWC_func_restoreConfig;
+
+    RFCFW_FUNCPTR_BURST_START         FWC_func_burstStart;
+    RFCFW_FUNCPTR_BURST_DUMP          FWC_func_burstDump;
+
+    RFCFW_FUNCPTR_SET_LOCK            FWC_func_setLock;
+
+    RFCFW_FUNCPTR_BENCH_DEINTERLEAVE  FWC_func_benchDeinterleave;
+
 } RFCFW_struc_fwAccessFunc;
 
 #ifdef __cplusplus
@@ -0,0 +1,219 @@
+/****************************************************
+ * RFControlFirmware_roi.c
+ *
+ * Regions of interest (ROI) of the DAQ readout
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "InternalData.h"                                               /* to create EPICS data node */
+#include "RFControlFirmware_roi.h"
+
+/*======================================
+ * Private Data and Routines - call backs
+ *======================================*/
+/* Write callback function, the ROIs are applied at next pulse */
+static void w_setROI(void *ptr)
+{
+    INTD_struc_node *dataNode = (INTD_struc_node *)ptr;
+
+    if(!dataNode) return;
+    RFCFW_struc_roi *roi      = (RFCFW_struc_roi *)dataNode->privateData;
+
+    if(roi) roi -> pending = 1;
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Convert the ROIs to the segments of the readout. The start is rounded down and the end is rounded up to the
+ *   granularity, the segments are limited to the full readout, sorted and the overlapped ones are merged
+ * Input:
+ *   roi        : ROIs
+ *   freq_MHz   : Sampling frequency
+ *   pnoMax     : Point number of the full readout
+ *   align      : Granularity of the points of the device memory (e.g. 2 for 32-bit words of 16-bit data)
+ * Return:
+ *   Number of segments, 0 for the full readout
+ */
+long RFCFW_func_roiUpdate(RFCFW_struc_roi *roi, double freq_MHz, long pnoMax, long align)
+{
+    int  i, j;
+    long var_num = 0;
+    long var_start, var_end;
+    RFCFW_struc_roiSeg var_seg[RFCFW_CONST_ROI_NUM];
+    RFCFW_struc_roiSeg var_tmp;
+
+    if(!roi) return 0;
+
+    if(align < 1) align = 1;
+
+    roi -> pending  = 0;
+    roi -> freq_MHz = freq_MHz;
+    roi -> pnoMax   = pnoMax;
+    roi -> align    = align;
+
+    /* convert to points */
+    if(roi -> enable && freq_MHz > 0.0 && pnoMax > 0) {
+        for(i = 0; i < RFCFW_CONST_ROI_NUM; i ++) {
+            if(roi -> end_ns[i] <= roi -> start_ns[i]) continue;
+
+            var_start = (long)floor(roi -> start_ns[i] * freq_MHz / 1000.0);
+            var_end   = (long)ceil(roi -> end_ns[i]   * freq_MHz / 1000.0);
+
+            var_start = (var_start / align) * align;
+            var_end   = ((var_end + align - 1) / align) * align;
+
+            if(var_start < 0)      var_start = 0;
+            if(var_end   > pnoMax) var_end   = (pnoMax / align) * align;
+            if(var_end <= var_start) continue;
+
+            var_seg[var_num].id    = i;
+            var_seg[var_num].start = var_start;
+            var_seg[var_num].pno   = var_end - var_start;
+            var_num ++;
+        }
+    }
+
+    /* sort by the start (only a few) */
+    for(i = 1; i < var_num; i ++) {
+        for(j = i; j > 0 && var_seg[j].start < var_seg[j - 1].start; j --) {
+            var_tmp        = var_seg[j];
+            var_seg[j]     = var_seg[j - 1];
+            var_seg[j - 1] = var_tmp;
+        }
+    }
+
+    /* merge the overlapped or adjacent ones */
+    roi -> segNum = 0;
+    roi -> segPno = 0;
+    roi -> segEnd = 0;
+
+    for(i = 0; i < var_num; i ++) {
+        j = (int)roi -> segNum - 1;
+
+        if(j >= 0 && var_seg[i].start <= roi -> seg[j].start + roi -> seg[j].pno) {
+            var_end = var_seg[i].start + var_seg[i].pno;
+            if(var_end > roi -> seg[j].start + roi -> seg[j].pno) roi -> seg[j].pno = var_end - roi -> seg[j].start;
+        } else {
+            roi -> seg[roi -> segNum] = var_seg[i];
+            roi -> segNum ++;
+        }
+    }
+
+    for(i = 0; i < RFCFW_CONST_ROI_NUM; i ++) {
+        if(i < roi -> segNum) {
+            roi -> seg[i].start_ns = roi -> seg[i].start * 1000.0 / freq_MHz;
+            roi -> segPno         += roi -> seg[i].pno;
+            roi -> segEnd          = roi -> seg[i].start + roi -> seg[i].pno;
+            roi -> segStart[i]     = roi -> seg[i].start;
+            roi -> segLen[i]       = roi -> seg[i].pno;
+        } else {
+            roi -> segStart[i]     = 0;
+            roi -> segLen[i]       = 0;
+        }
+    }
+
+    return roi -> segNum;
+}
+
+/**
+ * Apply the ROIs at the pulse boundary if the settings, the sampling frequency or the point number of the full readout
+ *   are changed, should be called by the pulse thread before the readout
+ * Input:
+ *   roi        : ROIs
+ *   freq_MHz   : Sampling frequency
+ *   pnoMax     : Point number of the full readout
+ *   align      : Granularity of the points
+ * Return:
+ *   1          : The segments are changed, the points out of the segments in the waveforms are not valid any more
+ *   0          : Not changed
+ */
+int RFCFW_func_roiCheck(RFCFW_struc_roi *roi, double freq_MHz, long pnoMax, long align)
+{
+    if(!roi) return 0;
+
+    if(!roi -> pending && roi -> freq_MHz == freq_MHz && roi -> pnoMax == pnoMax && roi -> align == align) return 0;
+
+    RFCFW_func_roiUpdate(roi, freq_MHz, pnoMax, align);
+
+    return 1;
+}
+
+/**
+ * Point number of the DAQ window covering the RF pulse and the decay tail after it. The time axis of the waveforms starts
+ *   at the DAQ trigger delay relative to the RF pulse start (negative for the baseline before the pulse)
+ * Input:
+ *   pulseLength_ns : RF pulse length
+ *   DAQDelay_ns    : DAQ trigger delay relative to the RF pulse start
+ *   tail_ns        : Margin after the RF pulse end (decay of the cavity field)
+ *   freq_MHz       : Sampling frequency
+ *   gran           : Granularity of the point number of the firmware (e.g. 16), the result is rounded up
+ *   pnoMax         : Maximum point number of the buffers
+ * Return:
+ *   Point number, at least one granularity and at most pnoMax (rounded down to the granularity)
+ */
+long RFCFW_func_roiWindowPno(double pulseLength_ns, double DAQDelay_ns, double tail_ns, double freq_MHz, long gran, long pnoMax)
+{
+    double var_len_ns;
+    long   var_pno = 0;
+
+    if(gran < 1) gran = 1;
+
+    var_len_ns = pulseLength_ns + (tail_ns > 0.0 ? tail_ns : 0.0) - DAQDelay_ns;
+
+    if(freq_MHz > 0.0 && var_len_ns > 0.0)
+        var_pno = (long)ceil(var_len_ns * freq_MHz / 1000.0);
+
+    var_pno = ((var_pno + gran - 1) / gran) * gran;
+
+    if(var_pno > pnoMax) var_pno = (pnoMax / gran) * gran;
+    if(var_pno < gran)   var_pno = gran;
+
+    return var_pno;
+}
+
+/**
+ * Create data nodes for the ROIs, the names are ROI_ENABLE, ROI<n>_START/END for the settings and ROI_SEG<n>_START/PNO
+ *   for the segments
+ * Input:
+ *   moduleName     : Name of the high level module (RFControl)
+ *   roi            : ROIs
+ *   ioScan         : I/O interrupt scan of the settings (requested after a restore of the configuration)
+ * Return:
+ *   0              : Successful
+ *  <=-1            : Failed
+ */
+int RFCFW_func_roiCreateData(const char *moduleName, RFCFW_struc_roi *roi, IOSCANPVT *ioScan)
+{
+    int  i;
+    int  status = 0;
+    char var_dataName[64];
+
+    /* check the input */
+    if(!moduleName || !moduleName[0] || !roi) return -1;
+
+    status += INTD_API_createDataNode(moduleName, "ROI_ENABLE",  (void *)(&roi -> enable), (void *)roi, 1, ioScan, INTD_USHORT, NULL, w_setROI, NULL, NULL, INTD_BO, INTD_IOINT);  /* w */
+    status += INTD_API_createDataNode(moduleName, "ROI_SEG_NUM", (void *)(&roi -> segNum), (void *)roi, 1, NULL, INTD_LONG,   NULL, NULL,     NULL, NULL, INTD_LI, INTD_1S);       /* r */
+    status += INTD_API_createDataNode(moduleName, "ROI_SEG_PNO", (void *)(&roi -> segPno), (void *)roi, 1, NULL, INTD_LONG,   NULL, NULL,     NULL, NULL, INTD_LI, INTD_1S);       /* r */
+
+    for(i = 0; i < RFCFW_CONST_ROI_NUM; i ++) {
+        snprintf(var_dataName, sizeof(var_dataName), "ROI%d_START", i);
+        status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&roi -> start_ns[i]), (void *)roi, 1, ioScan, INTD_DOUBLE, NULL, w_setROI, NULL, NULL, INTD_AO, INTD_IOINT);  /* w */
+
+        snprintf(var_dataName, sizeof(var_dataName), "ROI%d_END", i);
+        status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&roi -> end_ns[i]),   (void *)roi, 1, ioScan, INTD_DOUBLE, NULL, w_setROI, NULL, NULL, INTD_AO, INTD_IOINT);  /* w */
+
+        snprintf(var_dataName, sizeof(var_dataName), "ROI_SEG%d_START", i);
+        status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&roi -> segStart[i]), (void *)roi, 1, NULL, INTD_LONG,   NULL, NULL,     NULL, NULL, INTD_LI, INTD_1S);       /* r */
+
+        snprintf(var_dataName, sizeof(var_dataName), "ROI_SEG%d_PNO", i);
+        status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&roi -> segLen[i]),   (void *)roi, 1, NULL, INTD_LONG,   NULL, NULL,     NULL, NULL, INTD_LI, INTD_1S);       /* r */
+    }
+
+    return status;
+}
+
@@ -0,0 +1,81 @@
+/****************************************************
+ * RFControlFirmware_roi.h
+ *
+ * Regions of interest (ROI) of the DAQ readout. The ROIs are given in ns relative to the DAQ trigger (e.g. the baseline
+ *   before the pulse, the flat top and the decay tail) and converted to the point ranges with the sampling frequency.
+ *   Only the points of the ROIs are transferred from the device memory, each ROI is delivered as a segment tagged with
+ *   its position, the data is placed in the waveform at the same position as the full readout
+ *
+ * The ROIs are applied at the pulse boundary by the backend (RFCFW_func_roiCheck), the overlapped ROIs are merged
+ *
+ * The saving depends on the device. On Struck the segments are read from the DRAM directly, only their points are
+ *   transferred. On EICSYS the FPGA transfers the DAQ to the DMA pool from the start, so the transfer is only trimmed
+ *   to the end of the last ROI, the gaps before are still transferred and only skipped by the deinterleave. The DAQ
+ *   size is written for the capture of the next pulse, the readout switches to the new segments one pulse later
+ *
+ * The DAQ window covering the RF pulse and its decay tail (RFCFW_func_roiWindowPno) is used for the automatic point
+ *   number of the DAQ
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_ROI_H
+#define RF_CONTROL_FIRMWARE_ROI_H
+
+#include <dbScan.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Constants
+ */
+#define RFCFW_CONST_ROI_NUM     4                           /* max. number of ROIs */
+
+/**
+ * Segment of the readout, the points [start, start + pno) of the waveforms
+ */
+typedef struct {
+    long   id;                                              /* index of the (first) ROI of the segment */
+    long   start;                                           /* first point */
+    long   pno;                                             /* number of points */
+    double start_ns;                                        /* time of the first point relative to the DAQ trigger */
+} RFCFW_struc_roiSeg;
+
+/**
+ * ROIs of a module
+ */
+typedef struct {
+    volatile unsigned short enable;                         /* 1 to read the ROIs only, 0 for the full readout */
+    volatile double start_ns[RFCFW_CONST_ROI_NUM];          /* start time of the ROIs relative to the DAQ trigger */
+    volatile double end_ns[RFCFW_CONST_ROI_NUM];            /* end time of the ROIs, the ROI is not used if end <= start */
+    volatile unsigned short pending;                        /* set when the settings above are changed, applied at next pulse */
+
+    /* applied at the pulse boundary */
+    volatile long      segNum;                              /* number of segments, 0 for the full readout */
+    RFCFW_struc_roiSeg seg[RFCFW_CONST_ROI_NUM];            /* segments sorted by the start */
+    volatile long      segPno;                              /* total points of the segments */
+    volatile long      segEnd;                              /* end of the last segment */
+    volatile long      segStart[RFCFW_CONST_ROI_NUM];       /* copy of the segments for the EPICS records */
+    volatile long      segLen[RFCFW_CONST_ROI_NUM];
+
+    double freq_MHz;                                        /* sampling frequency applied */
+    long   pnoMax;                                          /* point number of the full readout applied */
+    long   align;                                           /* granularity of the points applied */
+} RFCFW_struc_roi;
+
+/**
+ * Routines
+ */
+long RFCFW_func_roiUpdate(RFCFW_struc_roi *roi, double freq_MHz, long pnoMax, long align);       /* convert the ROIs to the segments */
+int  RFCFW_func_roiCheck(RFCFW_struc_roi *roi, double freq_MHz, long pnoMax, long align);        /* update at the pulse boundary if changed */
+
+long RFCFW_func_roiWindowPno(double pulseLength_ns, double DAQDelay_ns, double tail_ns,
+                             double freq_MHz, long gran, long pnoMax);                          /* DAQ window covering the RF pulse */
+
+int  RFCFW_func_roiCreateData(const char *moduleName, RFCFW_struc_roi *roi, IOSCANPVT *ioScan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,133 @@
+/****************************************************
+ * RFControlFirmware_timeStats.c
+ *
+ * Time measurement and statistics for the real-time parts of the firmware control
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "InternalData.h"                                               /* to create EPICS data node */
+#include "RFControlFirmware_timeStats.h"
+
+/*======================================
+ * Private Data and Routines - call backs
+ *======================================*/
+/* Write callback function, reset the statistics */
+static void w_resetStats(void *ptr)
+{
+    INTD_struc_node       *dataNode = (INTD_struc_node *)ptr;
+    RFCFW_struc_timeStats *stats;
+
+    if(!dataNode) return;
+    stats = (RFCFW_struc_timeStats *)dataNode->privateData;
+
+    if(stats && stats -> reset == 1) {
+        RFCFW_func_timeStatsReset(stats);
+    }
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Get the time from the monotonic clock, only used to measure time intervals
+ * Return:
+ *   Time in us
+ */
+double RFCFW_func_getTime_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec * 1.0e6 + (double)ts.tv_nsec * 1.0e-3;
+}
+
+/**
+ * Reset the statistics
+ */
+void RFCFW_func_timeStatsReset(RFCFW_struc_timeStats *stats)
+{
+    if(!stats) return;
+
+    stats -> cur_us  = 0.0;
+    stats -> min_us  = 0.0;
+    stats -> max_us  = 0.0;
+    stats -> avg_us  = 0.0;
+    stats -> cnt     = 0;
+    stats -> overrun = 0;
+    stats -> reset   = 0;
+}
+
+/**
+ * Add a new measurement to the statistics
+ * Input:
+ *   stats      : Statistics to be updated
+ *   time_us    : Measured time in us
+ *   budget_us  : Budget of the time, the overrun counter increases if exceeded (no check if <= 0)
+ */
+void RFCFW_func_timeStatsUpdate(RFCFW_struc_timeStats *stats, double time_us, double budget_us)
+{
+    if(!stats) return;
+
+    if(stats -> cnt <= 0) {
+        stats -> min_us = time_us;
+        stats -> max_us = time_us;
+        stats -> avg_us = time_us;
+        stats -> cnt    = 0;
+    } else {
+        if(time_us < stats -> min_us) stats -> min_us = time_us;
+        if(time_us > stats -> max_us) stats -> max_us = time_us;
+        stats -> avg_us += (time_us - stats -> avg_us) / (stats -> cnt + 1);
+    }
+
+    if(budget_us > 0.0 && time_us > budget_us) stats -> overrun ++;
+
+    stats -> cur_us = time_us;
+    stats -> cnt ++;
+}
+
+/**
+ * Create data nodes for the time statistics
+ * Input:
+ *   moduleName     : Name of the high level module (RFControl)
+ *   statsName      : Prefix of the data node names
+ *   stats          : Statistics
+ * Return:
+ *   0              : Successful
+ *  <=-1            : Failed
+ */
+int RFCFW_func_timeStatsCreateData(const char *moduleName, const char *statsName, RFCFW_struc_timeStats *stats)
+{
+    int  status = 0;
+    char var_dataName[64];
+
+    /* check the input */
+    if(!moduleName || !moduleName[0] || !statsName || !statsName[0] || !stats) return -1;
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_CUR", statsName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&stats -> cur_us),  (void *)stats, 1, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AI, INTD_1S);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_MIN", statsName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&stats -> min_us),  (void *)stats, 1, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AI, INTD_1S);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_MAX", statsName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&stats -> max_us),  (void *)stats, 1, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AI, INTD_1S);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_AVG", statsName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&stats -> avg_us),  (void *)stats, 1, NULL, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AI, INTD_1S);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_CNT", statsName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&stats -> cnt),     (void *)stats, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_OVR", statsName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&stats -> overrun), (void *)stats, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);  /* r */
+
+    snprintf(var_dataName, sizeof(var_dataName), "%s_RST", statsName);
+    status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&stats -> reset),   (void *)stats, 1, NULL, INTD_USHORT, NULL, w_resetStats, NULL, NULL, INTD_BO, INTD_PASSIVE);  /* w */
+
+    return status;
+}
+
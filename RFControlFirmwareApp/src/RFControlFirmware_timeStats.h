@@ -0,0 +1,46 @@
+/****************************************************
+ * RFControlFirmware_timeStats.h
+ *
+ * Time measurement and statistics for the real-time parts of the firmware control (e.g. the per-pulse processing)
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_TIME_STATS_H
+#define RF_CONTROL_FIRMWARE_TIME_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Default time budget of the per-pulse processing (one period of 120 Hz)
+ */
+#define RFCFW_CONST_PULSE_BUDGET_US     8333.0
+
+/**
+ * Statistics of a measured time
+ */
+typedef struct {
+    volatile double cur_us;                                 /* latest value in us */
+    volatile double min_us;                                 /* minimum value since the last reset */
+    volatile double max_us;                                 /* maximum value since the last reset */
+    volatile double avg_us;                                 /* average value since the last reset */
+    volatile long   cnt;                                    /* number of measurements since the last reset */
+    volatile long   overrun;                                /* number of measurements exceeded the budget */
+    volatile unsigned short reset;                          /* write 1 to reset the statistics */
+} RFCFW_struc_timeStats;
+
+/**
+ * Routines
+ */
+double RFCFW_func_getTime_us(void);                                                     /* monotonic time in us */
+
+void RFCFW_func_timeStatsReset(RFCFW_struc_timeStats *stats);
+void RFCFW_func_timeStatsUpdate(RFCFW_struc_timeStats *stats, double time_us, double budget_us);
+
+int  RFCFW_func_timeStatsCreateData(const char *moduleName, const char *statsName, RFCFW_struc_timeStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
@@ -0,0 +1,206 @@
+/****************************************************
+ * RFControlFirmware_wake.c
+ *
+ * Wake-up of the pulse thread, interrupt or hybrid sleep and spin on the pulse counter
+ ****************************************************/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include "InternalData.h"                                               /* to create EPICS data node */
+#include "RFControlFirmware_wake.h"
+
+/*======================================
+ * Private Data and Routines
+ *======================================*/
+static const char *RFCFW_gvar_wakeSrcName[RFCFW_CONST_WAKE_SRC_NUM] = {"INTR", "POLL", "FALLBACK"};
+
+/* Sleep until the time of the monotonic clock (same as RFCFW_func_getTime_us) */
+static void RFCFW_func_wakeSleepUntil(double time_us)
+{
+    struct timespec ts;
+
+    ts.tv_sec  = (time_t)(time_us / 1.0e6);
+    ts.tv_nsec = (long)((time_us - (double)ts.tv_sec * 1.0e6) * 1.0e3);
+
+    if(ts.tv_nsec < 0)           ts.tv_nsec = 0;
+    if(ts.tv_nsec >= 1000000000) ts.tv_nsec = 999999999;
+
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR);    /* interrupted by a signal, other errors fall through to the spin */
+}
+
+/*======================================
+ * Public Routines
+ *======================================*/
+/**
+ * Init the wake-up with the default settings, the interrupt mode is used
+ */
+void RFCFW_func_wakeInit(RFCFW_struc_wake *wake)
+{
+    if(!wake) return;
+
+    memset((void *)wake, 0, sizeof(RFCFW_struc_wake));
+
+    wake -> mode       = RFCFW_CONST_WAKE_MODE_INTR;
+    wake -> guard_us   = RFCFW_CONST_WAKE_GUARD_US;
+    wake -> timeout_us = RFCFW_CONST_WAKE_TIMEOUT_US;
+}
+
+/**
+ * Wait for the next pulse. In the hybrid mode, sleep until the guard time before the predicted trigger and spin on the
+ *   pulse counter until the timeout after the predicted trigger. When the counter changes, spin until the end of the
+ *   DAQ window so that the data is complete as with the interrupt. Otherwise (or if the trigger period is not known
+ *   yet) wait for the interrupt. The interrupts of the pulses already seen by the spin are not consumed by the spin, they
+ *   are drained until the pulse counter moves past the latest pulse seen
+ * Input:
+ *   wake       : Data of the wake-up
+ *   boardHandle: Handle of the board
+ *   period_ms  : Measured trigger period, the hybrid mode is not used if <= 0
+ *   window_us  : Time from the trigger to the end of the DAQ window
+ *   pullIntr   : Wait for the interrupt of the board
+ *   getPulCnt  : Read the pulse counter of the firmware, NULL to always wait for the interrupt (e.g. if the interrupt
+ *                marks the end of the data transfer)
+ * Return:
+ *   Status of the wait for the interrupt, 0 if woken up by the pulse counter
+ */
+int RFCFW_func_wakeWait(RFCFW_struc_wake *wake, void *boardHandle, double period_ms, double window_us,
+                        RFCFW_FUNCPTR_PULL_INTR pullIntr, RFCFW_FUNCPTR_GET_PUL_CNT getPulCnt)
+{
+    int    status = 0;
+    int    var_mode;
+    int    var_src = RFCFW_CONST_WAKE_SRC_INTR;
+    unsigned int var_cnt = 0;
+    double var_predTime_us;
+    double var_spinStart_us;
+    double var_time_us;
+    double var_detectTime_us = 0.0;
+
+    if(!wake || !pullIntr) return -1;
+
+    var_mode = (wake -> mode == RFCFW_CONST_WAKE_MODE_HYBRID && getPulCnt) ? RFCFW_CONST_WAKE_MODE_HYBRID : RFCFW_CONST_WAKE_MODE_INTR;
+
+    if(var_mode != RFCFW_CONST_WAKE_MODE_HYBRID) wake -> valid = 0;
+
+    /* sleep and spin on the pulse counter */
+    if(var_mode == RFCFW_CONST_WAKE_MODE_HYBRID && wake -> valid && period_ms > 0.0) {
+        var_predTime_us = wake -> trigTime_us + period_ms * 1000.0;
+
+        if(var_predTime_us - wake -> guard_us > RFCFW_func_getTime_us())
+            RFCFW_func_wakeSleepUntil(var_predTime_us - wake -> guard_us);
+
+        var_spinStart_us = RFCFW_func_getTime_us();
+        var_time_us      = var_spinStart_us;
+        var_src          = RFCFW_CONST_WAKE_SRC_FALLBACK;
+
+        do {
+            getPulCnt(boardHandle, &var_cnt);
+            var_time_us = RFCFW_func_getTime_us();
+
+            if(var_cnt != wake -> pulseCnt) {
+                var_detectTime_us = var_time_us;
+                var_src           = RFCFW_CONST_WAKE_SRC_POLL;
+                break;
+            }
+        } while(var_time_us < var_predTime_us + wake -> timeout_us);
+
+        /* wait until the end of the DAQ window */
+        if(var_src == RFCFW_CONST_WAKE_SRC_POLL) {
+            while(var_time_us < var_detectTime_us + window_us + wake -> settleMargin_us)
+                var_time_us = RFCFW_func_getTime_us();
+        }
+
+        RFCFW_func_timeStatsUpdate(&wake -> spin, var_time_us - var_spinStart_us, 0.0);
+    }
+
+    /* wait for the interrupt */
+    if(var_src != RFCFW_CONST_WAKE_SRC_POLL) {
+        status = pullIntr(boardHandle);
+
+        if(var_mode == RFCFW_CONST_WAKE_MODE_HYBRID) {
+            getPulCnt(boardHandle, &var_cnt);
+
+            /* interrupts of the pulses seen by the spin of the former wake-ups */
+            while(status == 0 && wake -> valid && var_cnt == wake -> pulseCnt) {
+                wake -> staleCnt ++;
+                status = pullIntr(boardHandle);
+                getPulCnt(boardHandle, &var_cnt);
+            }
+        }
+    }
+
+    var_time_us = RFCFW_func_getTime_us();
+
+    /* remember the wake-up, the trigger time is refined with the measured latency */
+    if(var_mode == RFCFW_CONST_WAKE_MODE_HYBRID) {
+        if(wake -> valid && var_cnt - wake -> pulseCnt > 1) wake -> missCnt += (long)(var_cnt - wake -> pulseCnt - 1);
+
+        wake -> pulseCnt    = var_cnt;
+        wake -> trigTime_us = (var_src == RFCFW_CONST_WAKE_SRC_POLL) ? var_detectTime_us : var_time_us;
+        wake -> valid       = 1;
+    }
+
+    wake -> source      = var_src;
+    wake -> wakeTime_us = var_time_us;
+    wake -> srcCnt[var_src] ++;
+
+    return status;
+}
+
+/**
+ * Add the wake-up latency of the latest wake-up (from the IRQ delay counter of the firmware) to the statistics of its
+ *   source, the latency is also used to estimate the time of the trigger for the prediction of the next one
+ * Input:
+ *   wake       : Data of the wake-up
+ *   latency_us : Time from the trigger to the wake-up
+ */
+void RFCFW_func_wakeLatency(RFCFW_struc_wake *wake, double latency_us)
+{
+    if(!wake || wake -> source < 0 || wake -> source >= RFCFW_CONST_WAKE_SRC_NUM) return;
+
+    RFCFW_func_timeStatsUpdate(&wake -> latency[wake -> source], latency_us, 0.0);
+
+    if(latency_us >= 0.0) wake -> trigTime_us = wake -> wakeTime_us - latency_us;
+}
+
+/**
+ * Create data nodes for the wake-up, the names are WAKE_MODE/GUARD/TIMEOUT/SETTLE for the settings, WAKE_CNT_<source>,
+ *   WAKE_MISS and WAKE_STALE for the counters, WAKE_LAT_<source>_* and WAKE_SPIN_* for the statistics
+ * Input:
+ *   moduleName     : Name of the high level module (RFControl)
+ *   wake           : Data of the wake-up
+ *   ioScan         : I/O interrupt scan of the settings (requested after a restore of the configuration)
+ * Return:
+ *   0              : Successful
+ *  <=-1            : Failed
+ */
+int RFCFW_func_wakeCreateData(const char *moduleName, RFCFW_struc_wake *wake, IOSCANPVT *ioScan)
+{
+    int  i;
+    int  status = 0;
+    char var_dataName[64];
+
+    /* check the input */
+    if(!moduleName || !moduleName[0] || !wake) return -1;
+
+    status += INTD_API_createDataNode(moduleName, "WAKE_MODE",    (void *)(&wake -> mode),            (void *)wake, 1, ioScan, INTD_USHORT, NULL, NULL, NULL, NULL, INTD_BO, INTD_IOINT);  /* w */
+    status += INTD_API_createDataNode(moduleName, "WAKE_GUARD",   (void *)(&wake -> guard_us),        (void *)wake, 1, ioScan, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AO, INTD_IOINT);  /* w */
+    status += INTD_API_createDataNode(moduleName, "WAKE_TIMEOUT", (void *)(&wake -> timeout_us),      (void *)wake, 1, ioScan, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AO, INTD_IOINT);  /* w */
+    status += INTD_API_createDataNode(moduleName, "WAKE_SETTLE",  (void *)(&wake -> settleMargin_us), (void *)wake, 1, ioScan, INTD_DOUBLE, NULL, NULL, NULL, NULL, INTD_AO, INTD_IOINT);  /* w */
+    status += INTD_API_createDataNode(moduleName, "WAKE_MISS",    (void *)(&wake -> missCnt),         (void *)wake, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);       /* r */
+    status += INTD_API_createDataNode(moduleName, "WAKE_STALE",   (void *)(&wake -> staleCnt),        (void *)wake, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);       /* r */
+
+    for(i = 0; i < RFCFW_CONST_WAKE_SRC_NUM; i ++) {
+        snprintf(var_dataName, sizeof(var_dataName), "WAKE_CNT_%s", RFCFW_gvar_wakeSrcName[i]);
+        status += INTD_API_createDataNode(moduleName, var_dataName, (void *)(&wake -> srcCnt[i]),     (void *)wake, 1, NULL, INTD_LONG,   NULL, NULL, NULL, NULL, INTD_LI, INTD_1S);       /* r */
+
+        snprintf(var_dataName, sizeof(var_dataName), "WAKE_LAT_%s", RFCFW_gvar_wakeSrcName[i]);
+        status += RFCFW_func_timeStatsCreateData(moduleName, var_dataName, &wake -> latency[i]);
+    }
+
+    status += RFCFW_func_timeStatsCreateData(moduleName, "WAKE_SPIN", &wake -> spin);
+
+    return status;
+}
+
@@ -0,0 +1,88 @@
+/****************************************************
+ * RFControlFirmware_wake.h
+ *
+ * Wake-up of the pulse thread. In the interrupt mode the thread sleeps in the wait of the interrupt of the board. In the
+ *   hybrid mode the thread sleeps until shortly before the predicted next trigger (the last wake-up plus the measured
+ *   trigger period), then spins on the pulse counter of the firmware, so that the kernel interrupt path and the scheduler
+ *   are not in the wake-up latency. The firmware does not have a DAQ-done status, after the counter changes the thread
+ *   spins until the end of the DAQ window given by the backend. If the counter does not change until the timeout after
+ *   the predicted trigger (e.g. the trigger is stopped), the wait falls back to the interrupt. The hybrid mode is only for
+ *   the boards whose data is complete in the board memory at the end of the DAQ window; if the interrupt marks the end
+ *   of the transfer to the host (e.g. the DMA-done interrupt of EICSYS), the backend passes no pulse counter and the
+ *   interrupt is always used.
+ *
+ * The wake-up latency is measured with the IRQ delay counter of the firmware by the backend and kept for each source
+ *   of the wake-up, so that both sources can be compared
+ ****************************************************/
+#ifndef RF_CONTROL_FIRMWARE_WAKE_H
+#define RF_CONTROL_FIRMWARE_WAKE_H
+
+#include <dbScan.h>
+
+#include "RFControlFirmware_timeStats.h"                        /* statistics of the latency */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Modes and sources of the wake-up
+ */
+#define RFCFW_CONST_WAKE_MODE_INTR      0                       /* always wait for the interrupt */
+#define RFCFW_CONST_WAKE_MODE_HYBRID    1                       /* sleep, spin on the pulse counter and fall back to the interrupt */
+
+#define RFCFW_CONST_WAKE_SRC_INTR       0                       /* interrupt in the interrupt mode */
+#define RFCFW_CONST_WAKE_SRC_POLL       1                       /* pulse counter seen in the spin */
+#define RFCFW_CONST_WAKE_SRC_FALLBACK   2                       /* interrupt after the timeout of the spin */
+#define RFCFW_CONST_WAKE_SRC_NUM        3
+
+#define RFCFW_CONST_WAKE_GUARD_US       200.0                   /* default wake-up before the predicted trigger */
+#define RFCFW_CONST_WAKE_TIMEOUT_US     500.0                   /* default spin after the predicted trigger */
+
+/**
+ * Functions of the board used by the wake-up
+ */
+typedef int  (*RFCFW_FUNCPTR_PULL_INTR)(void *);                        /* wait for the interrupt (board handle) */
+typedef void (*RFCFW_FUNCPTR_GET_PUL_CNT)(void *, unsigned int *);      /* read the pulse counter (board handle, counter) */
+
+/**
+ * Data of the wake-up
+ */
+typedef struct {
+    volatile unsigned short mode;                           /* RFCFW_CONST_WAKE_MODE_* */
+    volatile double guard_us;                               /* wake-up before the predicted trigger */
+    volatile double timeout_us;                             /* spin after the predicted trigger before falling back to the interrupt */
+    volatile double settleMargin_us;                        /* margin added to the DAQ window after the counter changes */
+
+    /* latest wake-up */
+    int          valid;                                     /* 1 if the pulse counter and the time of the latest wake-up are valid */
+    int          source;                                    /* source of the latest wake-up, RFCFW_CONST_WAKE_SRC_* */
+    unsigned int pulseCnt;                                  /* pulse counter at the latest wake-up */
+    double       wakeTime_us;                               /* time of the latest wake-up */
+    double       trigTime_us;                               /* estimated time of the latest trigger */
+
+    /* statistics */
+    volatile long srcCnt[RFCFW_CONST_WAKE_SRC_NUM];         /* wake-ups of each source */
+    volatile long missCnt;                                  /* pulses skipped (the counter changed more than one) */
+    volatile long staleCnt;                                 /* interrupts of the pulses already seen by the spin */
+
+    RFCFW_struc_timeStats latency[RFCFW_CONST_WAKE_SRC_NUM];/* wake-up latency of each source */
+    RFCFW_struc_timeStats spin;                             /* time spinning on the pulse counter */
+} RFCFW_struc_wake;
+
+/**
+ * Routines
+ */
+void RFCFW_func_wakeInit(RFCFW_struc_wake *wake);
+int  RFCFW_func_wakeWait(RFCFW_struc_wake *wake, void *boardHandle, double period_ms, double window_us,
+                         RFCFW_FUNCPTR_PULL_INTR pullIntr, RFCFW_FUNCPTR_GET_PUL_CNT getPulCnt);       /* wait for the next pulse */
+void RFCFW_func_wakeLatency(RFCFW_struc_wake *wake, double latency_us);                                /* wake-up latency of the latest wake-up */
+
+int  RFCFW_func_wakeCreateData(const char *moduleName, RFCFW_struc_wake *wake, IOSCANPVT *ioScan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+